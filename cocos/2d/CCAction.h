@@ -181,6 +181,11 @@ protected:
 #if CC_ENABLE_SCRIPT_BINDING
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
 #endif
+    /** The place of the action in a TweenBatch, -1 if it isn't batched. */
+    int     _tweenBucket;
+    ssize_t _tweenIndex;
+
+    friend class TweenBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
 };
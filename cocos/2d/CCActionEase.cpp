@@ -33,6 +33,7 @@ THE SOFTWARE.
 
 #include "2d/CCActionEase.h"
 #include "2d/CCTweenFunction.h"
+#include "2d/CCTweenBatch.h"
 
 NS_CC_BEGIN
 
@@ -81,6 +82,29 @@ void ActionEase::update(float time)
     _inner->update(time);
 }
 
+bool ActionEase::getTween(TweenDesc& desc) const
+{
+    // only one curve is batched, applied to an action without easing
+    if (! _inner->getTween(desc) || desc.easing != tweenfunc::Linear)
+    {
+        return false;
+    }
+
+    desc.easing = getEasing(&desc.easingParam);
+    return desc.easing != tweenfunc::CUSTOM_EASING;
+}
+
+void ActionEase::setTween(const TweenDesc& desc)
+{
+    _inner->setTween(desc);
+}
+
+tweenfunc::TweenType ActionEase::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::CUSTOM_EASING;
+}
+
 ActionInterval* ActionEase::getInnerAction()
 {
     return _inner;
@@ -280,6 +304,12 @@ void EaseExponentialIn::update(float time)
     _inner->update(tweenfunc::expoEaseIn(time));
 }
 
+tweenfunc::TweenType EaseExponentialIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Expo_EaseIn;
+}
+
 ActionEase * EaseExponentialIn::reverse() const
 {
     return EaseExponentialOut::create(_inner->reverse());
@@ -320,6 +350,12 @@ void EaseExponentialOut::update(float time)
     _inner->update(tweenfunc::expoEaseOut(time));
 }
 
+tweenfunc::TweenType EaseExponentialOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Expo_EaseOut;
+}
+
 ActionEase* EaseExponentialOut::reverse() const
 {
     return EaseExponentialIn::create(_inner->reverse());
@@ -361,6 +397,12 @@ void EaseExponentialInOut::update(float time)
     _inner->update(tweenfunc::expoEaseInOut(time));
 }
 
+tweenfunc::TweenType EaseExponentialInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Expo_EaseInOut;
+}
+
 EaseExponentialInOut* EaseExponentialInOut::reverse() const
 {
     return EaseExponentialInOut::create(_inner->reverse());
@@ -402,6 +444,12 @@ void EaseSineIn::update(float time)
     _inner->update(tweenfunc::sineEaseIn(time));
 }
 
+tweenfunc::TweenType EaseSineIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Sine_EaseIn;
+}
+
 ActionEase* EaseSineIn::reverse() const
 {
     return EaseSineOut::create(_inner->reverse());
@@ -443,6 +491,12 @@ void EaseSineOut::update(float time)
     _inner->update(tweenfunc::sineEaseOut(time));
 }
 
+tweenfunc::TweenType EaseSineOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Sine_EaseOut;
+}
+
 ActionEase* EaseSineOut::reverse(void) const
 {
     return EaseSineIn::create(_inner->reverse());
@@ -484,6 +538,12 @@ void EaseSineInOut::update(float time)
     _inner->update(tweenfunc::sineEaseInOut(time));
 }
 
+tweenfunc::TweenType EaseSineInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Sine_EaseInOut;
+}
+
 EaseSineInOut* EaseSineInOut::reverse() const
 {
     return EaseSineInOut::create(_inner->reverse());
@@ -545,6 +605,12 @@ void EaseElasticIn::update(float time)
     _inner->update(tweenfunc::elasticEaseIn(time, _period));
 }
 
+tweenfunc::TweenType EaseElasticIn::getEasing(float* easingParam) const
+{
+    *easingParam = _period;
+    return tweenfunc::Elastic_EaseIn;
+}
+
 EaseElastic* EaseElasticIn::reverse() const
 {
     return EaseElasticOut::create(_inner->reverse(), _period);
@@ -591,6 +657,12 @@ void EaseElasticOut::update(float time)
     _inner->update(tweenfunc::elasticEaseOut(time, _period));
 }
 
+tweenfunc::TweenType EaseElasticOut::getEasing(float* easingParam) const
+{
+    *easingParam = _period;
+    return tweenfunc::Elastic_EaseOut;
+}
+
 EaseElastic* EaseElasticOut::reverse() const
 {
     return EaseElasticIn::create(_inner->reverse(), _period);
@@ -637,6 +709,12 @@ void EaseElasticInOut::update(float time)
     _inner->update(tweenfunc::elasticEaseInOut(time, _period));
 }
 
+tweenfunc::TweenType EaseElasticInOut::getEasing(float* easingParam) const
+{
+    *easingParam = _period;
+    return tweenfunc::Elastic_EaseInOut;
+}
+
 EaseElasticInOut* EaseElasticInOut::reverse() const
 {
     return EaseElasticInOut::create(_inner->reverse(), _period);
@@ -682,6 +760,12 @@ void EaseBounceIn::update(float time)
     _inner->update(tweenfunc::bounceEaseIn(time));
 }
 
+tweenfunc::TweenType EaseBounceIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Bounce_EaseIn;
+}
+
 EaseBounce* EaseBounceIn::reverse() const
 {
     return EaseBounceOut::create(_inner->reverse());
@@ -723,6 +807,12 @@ void EaseBounceOut::update(float time)
     _inner->update(tweenfunc::bounceEaseOut(time));
 }
 
+tweenfunc::TweenType EaseBounceOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Bounce_EaseOut;
+}
+
 EaseBounce* EaseBounceOut::reverse() const
 {
     return EaseBounceIn::create(_inner->reverse());
@@ -764,6 +854,12 @@ void EaseBounceInOut::update(float time)
     _inner->update(tweenfunc::bounceEaseInOut(time));
 }
 
+tweenfunc::TweenType EaseBounceInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Bounce_EaseInOut;
+}
+
 EaseBounceInOut* EaseBounceInOut::reverse() const
 {
     return EaseBounceInOut::create(_inner->reverse());
@@ -805,6 +901,12 @@ void EaseBackIn::update(float time)
     _inner->update(tweenfunc::backEaseIn(time));
 }
 
+tweenfunc::TweenType EaseBackIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Back_EaseIn;
+}
+
 ActionEase* EaseBackIn::reverse() const
 {
     return EaseBackOut::create(_inner->reverse());
@@ -846,6 +948,12 @@ void EaseBackOut::update(float time)
     _inner->update(tweenfunc::backEaseOut(time));
 }
 
+tweenfunc::TweenType EaseBackOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Back_EaseOut;
+}
+
 ActionEase* EaseBackOut::reverse() const
 {
     return EaseBackIn::create(_inner->reverse());
@@ -887,6 +995,12 @@ void EaseBackInOut::update(float time)
     _inner->update(tweenfunc::backEaseInOut(time));
 }
 
+tweenfunc::TweenType EaseBackInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Back_EaseInOut;
+}
+
 EaseBackInOut* EaseBackInOut::reverse() const
 {
     return EaseBackInOut::create(_inner->reverse());
@@ -979,6 +1093,12 @@ void EaseQuadraticActionIn::update(float time)
 	_inner->update(tweenfunc::quadraticIn(time));
 }
 
+tweenfunc::TweenType EaseQuadraticActionIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quad_EaseIn;
+}
+
 EaseQuadraticActionIn* EaseQuadraticActionIn::reverse() const
 {
     return EaseQuadraticActionIn::create(_inner->reverse());
@@ -1020,6 +1140,12 @@ void EaseQuadraticActionOut::update(float time)
     _inner->update(tweenfunc::quadraticOut(time));
 }
 
+tweenfunc::TweenType EaseQuadraticActionOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quad_EaseOut;
+}
+
 EaseQuadraticActionOut* EaseQuadraticActionOut::reverse() const
 {
     return EaseQuadraticActionOut::create(_inner->reverse());
@@ -1061,6 +1187,12 @@ void EaseQuadraticActionInOut::update(float time)
     _inner->update(tweenfunc::quadraticInOut(time));
 }
 
+tweenfunc::TweenType EaseQuadraticActionInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quad_EaseInOut;
+}
+
 EaseQuadraticActionInOut* EaseQuadraticActionInOut::reverse() const
 {
     return EaseQuadraticActionInOut::create(_inner->reverse());
@@ -1102,6 +1234,12 @@ void EaseQuarticActionIn::update(float time)
     _inner->update(tweenfunc::quartEaseIn(time));
 }
 
+tweenfunc::TweenType EaseQuarticActionIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quart_EaseIn;
+}
+
 EaseQuarticActionIn* EaseQuarticActionIn::reverse() const
 {
     return EaseQuarticActionIn::create(_inner->reverse());
@@ -1143,6 +1281,12 @@ void EaseQuarticActionOut::update(float time)
     _inner->update(tweenfunc::quartEaseOut(time));
 }
 
+tweenfunc::TweenType EaseQuarticActionOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quart_EaseOut;
+}
+
 EaseQuarticActionOut* EaseQuarticActionOut::reverse() const
 {
     return EaseQuarticActionOut::create(_inner->reverse());
@@ -1184,6 +1328,12 @@ void EaseQuarticActionInOut::update(float time)
     _inner->update(tweenfunc::quartEaseInOut(time));
 }
 
+tweenfunc::TweenType EaseQuarticActionInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quart_EaseInOut;
+}
+
 EaseQuarticActionInOut* EaseQuarticActionInOut::reverse() const
 {
     return EaseQuarticActionInOut::create(_inner->reverse());
@@ -1225,6 +1375,12 @@ void EaseQuinticActionIn::update(float time)
     _inner->update(tweenfunc::quintEaseIn(time));
 }
 
+tweenfunc::TweenType EaseQuinticActionIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quint_EaseIn;
+}
+
 EaseQuinticActionIn* EaseQuinticActionIn::reverse() const
 {
     return EaseQuinticActionIn::create(_inner->reverse());
@@ -1266,6 +1422,12 @@ void EaseQuinticActionOut::update(float time)
     _inner->update(tweenfunc::quintEaseOut(time));
 }
 
+tweenfunc::TweenType EaseQuinticActionOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quint_EaseOut;
+}
+
 EaseQuinticActionOut* EaseQuinticActionOut::reverse() const
 {
     return EaseQuinticActionOut::create(_inner->reverse());
@@ -1307,6 +1469,12 @@ void EaseQuinticActionInOut::update(float time)
     _inner->update(tweenfunc::quintEaseInOut(time));
 }
 
+tweenfunc::TweenType EaseQuinticActionInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Quint_EaseInOut;
+}
+
 EaseQuinticActionInOut* EaseQuinticActionInOut::reverse() const
 {
     return EaseQuinticActionInOut::create(_inner->reverse());
@@ -1348,6 +1516,12 @@ void EaseCircleActionIn::update(float time)
     _inner->update(tweenfunc::circEaseIn(time));
 }
 
+tweenfunc::TweenType EaseCircleActionIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Circ_EaseIn;
+}
+
 EaseCircleActionIn* EaseCircleActionIn::reverse() const
 {
     return EaseCircleActionIn::create(_inner->reverse());
@@ -1389,6 +1563,12 @@ void EaseCircleActionOut::update(float time)
     _inner->update(tweenfunc::circEaseOut(time));
 }
 
+tweenfunc::TweenType EaseCircleActionOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Circ_EaseOut;
+}
+
 EaseCircleActionOut* EaseCircleActionOut::reverse() const
 {
     return EaseCircleActionOut::create(_inner->reverse());
@@ -1430,6 +1610,12 @@ void EaseCircleActionInOut::update(float time)
     _inner->update(tweenfunc::circEaseInOut(time));
 }
 
+tweenfunc::TweenType EaseCircleActionInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Circ_EaseInOut;
+}
+
 EaseCircleActionInOut* EaseCircleActionInOut::reverse() const
 {
     return EaseCircleActionInOut::create(_inner->reverse());
@@ -1471,6 +1657,12 @@ void EaseCubicActionIn::update(float time)
     _inner->update(tweenfunc::cubicEaseIn(time));
 }
 
+tweenfunc::TweenType EaseCubicActionIn::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Cubic_EaseIn;
+}
+
 EaseCubicActionIn* EaseCubicActionIn::reverse() const
 {
     return EaseCubicActionIn::create(_inner->reverse());
@@ -1512,6 +1704,12 @@ void EaseCubicActionOut::update(float time)
     _inner->update(tweenfunc::cubicEaseOut(time));
 }
 
+tweenfunc::TweenType EaseCubicActionOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Cubic_EaseOut;
+}
+
 EaseCubicActionOut* EaseCubicActionOut::reverse() const
 {
     return EaseCubicActionOut::create(_inner->reverse());
@@ -1553,6 +1751,12 @@ void EaseCubicActionInOut::update(float time)
     _inner->update(tweenfunc::cubicEaseInOut(time));
 }
 
+tweenfunc::TweenType EaseCubicActionInOut::getEasing(float* easingParam) const
+{
+    CC_UNUSED_PARAM(easingParam);
+    return tweenfunc::Cubic_EaseInOut;
+}
+
 EaseCubicActionInOut* EaseCubicActionInOut::reverse() const
 {
     return EaseCubicActionInOut::create(_inner->reverse());
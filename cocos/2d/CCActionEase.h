@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define __ACTION_CCEASE_ACTION_H__
 
 #include "2d/CCActionInterval.h"
+#include "2d/CCTweenFunction.h"
 
 NS_CC_BEGIN
 
@@ -71,6 +72,18 @@ public:
     virtual void startWithTarget(Node *target) override;
     virtual void stop() override;
     virtual void update(float time) override;
+    virtual bool getTween(TweenDesc& desc) const override;
+    virtual void setTween(const TweenDesc& desc) override;
+
+    /**
+    @brief Get the tweenfunc curve applied by the action, used to batch it.
+    @param easingParam The easing parameter of the curve, if it has one.
+    @return The curve, CUSTOM_EASING if the action doesn't apply one of them.
+    @since v3.10
+    @js NA
+    @lua NA
+    */
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const;
 
 CC_CONSTRUCTOR_ACCESS:
     ActionEase() {}
@@ -262,6 +275,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseExponentialIn* clone() const override;
     virtual ActionEase* reverse() const override;
 
@@ -292,6 +306,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseExponentialOut* clone() const override;
     virtual ActionEase* reverse() const override;
 
@@ -324,6 +339,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseExponentialInOut* clone() const override;
     virtual EaseExponentialInOut* reverse() const override;
 
@@ -354,6 +370,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseSineIn* clone() const override;
     virtual ActionEase* reverse() const override;
 
@@ -384,6 +401,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseSineOut* clone() const override;
     virtual ActionEase* reverse() const override;
 
@@ -414,6 +432,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseSineInOut* clone() const override;
     virtual EaseSineInOut* reverse() const override;
 
@@ -512,6 +531,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseElasticIn* clone() const override;
     virtual EaseElastic* reverse() const override;
 
@@ -554,6 +574,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseElasticOut* clone() const override;
     virtual EaseElastic* reverse() const override;
 
@@ -593,6 +614,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseElasticInOut* clone() const override;
     virtual EaseElasticInOut* reverse() const override;
 
@@ -655,6 +677,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseBounceIn* clone() const override;
     virtual EaseBounce* reverse() const override;
 
@@ -686,6 +709,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseBounceOut* clone() const override;
     virtual EaseBounce* reverse() const override;
 
@@ -717,6 +741,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseBounceInOut* clone() const override;
     virtual EaseBounceInOut* reverse() const override;
 
@@ -748,6 +773,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseBackIn* clone() const override;
     virtual ActionEase* reverse() const override;
 
@@ -779,6 +805,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseBackOut* clone() const override;
     virtual ActionEase* reverse() const override;
 
@@ -810,6 +837,7 @@ public:
 
     // Overrides
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseBackInOut* clone() const override;
     virtual EaseBackInOut* reverse() const override;
 
@@ -876,6 +904,7 @@ public:
     static EaseQuadraticActionIn* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuadraticActionIn* clone() const override;
     virtual EaseQuadraticActionIn* reverse() const override;
 
@@ -904,6 +933,7 @@ public:
     static EaseQuadraticActionOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuadraticActionOut* clone() const override;
     virtual EaseQuadraticActionOut* reverse() const override;
 
@@ -932,6 +962,7 @@ public:
     static EaseQuadraticActionInOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuadraticActionInOut* clone() const override;
     virtual EaseQuadraticActionInOut* reverse() const override;
 
@@ -959,6 +990,7 @@ public:
     static EaseQuarticActionIn* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuarticActionIn* clone() const override;
     virtual EaseQuarticActionIn* reverse() const override;
 
@@ -986,6 +1018,7 @@ public:
     static EaseQuarticActionOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuarticActionOut* clone() const override;
     virtual EaseQuarticActionOut* reverse() const override;
 
@@ -1013,6 +1046,7 @@ public:
     static EaseQuarticActionInOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuarticActionInOut* clone() const override;
     virtual EaseQuarticActionInOut* reverse() const override;
 
@@ -1041,6 +1075,7 @@ public:
     static EaseQuinticActionIn* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuinticActionIn* clone() const override;
     virtual EaseQuinticActionIn* reverse() const override;
 
@@ -1068,6 +1103,7 @@ public:
     static EaseQuinticActionOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuinticActionOut* clone() const override;
     virtual EaseQuinticActionOut* reverse() const override;
 
@@ -1095,6 +1131,7 @@ public:
     static EaseQuinticActionInOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseQuinticActionInOut* clone() const override;
     virtual EaseQuinticActionInOut* reverse() const override;
 
@@ -1122,6 +1159,7 @@ public:
     static EaseCircleActionIn* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseCircleActionIn* clone() const override;
     virtual EaseCircleActionIn* reverse() const override;
 
@@ -1149,6 +1187,7 @@ public:
     static EaseCircleActionOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseCircleActionOut* clone() const override;
     virtual EaseCircleActionOut* reverse() const override;
 
@@ -1176,6 +1215,7 @@ public:
     static EaseCircleActionInOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseCircleActionInOut* clone() const override;
     virtual EaseCircleActionInOut* reverse() const override;
 
@@ -1203,6 +1243,7 @@ public:
     static EaseCubicActionIn* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseCubicActionIn* clone() const override;
     virtual EaseCubicActionIn* reverse() const override;
 
@@ -1230,6 +1271,7 @@ public:
     static EaseCubicActionOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseCubicActionOut* clone() const override;
     virtual EaseCubicActionOut* reverse() const override;
 
@@ -1257,6 +1299,7 @@ public:
     static EaseCubicActionInOut* create(ActionInterval* action);
     
     virtual void update(float time) override;
+    virtual tweenfunc::TweenType getEasing(float* easingParam) const override;
     virtual EaseCubicActionInOut* clone() const override;
     virtual EaseCubicActionInOut* reverse() const override;
 
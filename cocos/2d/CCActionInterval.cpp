@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCActionInstant.h"
+#include "2d/CCTweenBatch.h"
 #include "base/CCDirector.h"
 #include "base/CCEventCustom.h"
 #include "base/CCEventDispatcher.h"
@@ -1036,6 +1037,21 @@ void RotateBy::update(float time)
     }
 }
 
+bool RotateBy::getTween(TweenDesc& desc) const
+{
+    if (_is3D)
+    {
+        desc.property = TweenDesc::Property::ROTATION_3D;
+    }
+    else
+    {
+        desc.property = TweenDesc::Property::ROTATION;
+    }
+    desc.start = _startAngle;
+    desc.delta = _deltaAngle;
+    return true;
+}
+
 RotateBy* RotateBy::reverse() const
 {
     if(_is3D)
@@ -1138,6 +1154,21 @@ void MoveBy::update(float t)
     }
 }
 
+bool MoveBy::getTween(TweenDesc& desc) const
+{
+    desc.property = TweenDesc::Property::POSITION;
+    desc.start = _startPosition;
+    desc.delta = _positionDelta;
+    desc.previous = _previousPosition;
+    return true;
+}
+
+void MoveBy::setTween(const TweenDesc& desc)
+{
+    _startPosition = desc.start;
+    _previousPosition = desc.previous;
+}
+
 //
 // MoveTo
 //
@@ -1762,6 +1793,14 @@ void ScaleTo::update(float time)
     }
 }
 
+bool ScaleTo::getTween(TweenDesc& desc) const
+{
+    desc.property = TweenDesc::Property::SCALE;
+    desc.start.set(_startScaleX, _startScaleY, _startScaleZ);
+    desc.delta.set(_deltaX, _deltaY, _deltaZ);
+    return true;
+}
+
 //
 // ScaleBy
 //
@@ -2042,6 +2081,14 @@ void FadeTo::update(float time)
     /*_target->setOpacity((GLubyte)(_fromOpacity + (_toOpacity - _fromOpacity) * time));*/
 }
 
+bool FadeTo::getTween(TweenDesc& desc) const
+{
+    desc.property = TweenDesc::Property::OPACITY;
+    desc.start.x = _fromOpacity;
+    desc.delta.x = _toOpacity - _fromOpacity;
+    return true;
+}
+
 //
 // TintTo
 //
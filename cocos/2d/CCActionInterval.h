@@ -40,6 +40,7 @@ NS_CC_BEGIN
 class Node;
 class SpriteFrame;
 class EventCustom;
+struct TweenDesc;
 
 /**
  * @addtogroup actions
@@ -105,6 +106,27 @@ public:
         return nullptr;
     }
 
+    /** Describes the action as a tween of a property of its target, so a TweenBatch can step it.
+     * It is called once the action is started. Subclasses that override update() of a batched
+     * action must return false.
+     *
+     * @param desc  The description to fill.
+     * @return False if the action can't be batched, the default.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    virtual bool getTween(TweenDesc& desc) const { CC_UNUSED_PARAM(desc); return false; }
+
+    /** Updates the state of the action from its tween when it leaves a TweenBatch.
+     *
+     * @param desc  The tween of the action.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    virtual void setTween(const TweenDesc& desc) { CC_UNUSED_PARAM(desc); }
+
 CC_CONSTRUCTOR_ACCESS:
     /** initializes the action */
     bool initWithDuration(float d);
@@ -113,6 +135,8 @@ protected:
     float _elapsed;
     bool   _firstTick;
 
+    friend class TweenBatch;
+
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
 };
@@ -548,6 +572,7 @@ public:
      * @param time In seconds.
      */
     virtual void update(float time) override;
+    virtual bool getTween(TweenDesc& desc) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     RotateBy();
@@ -609,6 +634,8 @@ public:
      * @param time in seconds
      */
     virtual void update(float time) override;
+    virtual bool getTween(TweenDesc& desc) const override;
+    virtual void setTween(const TweenDesc& desc) override;
     
 CC_CONSTRUCTOR_ACCESS:
     MoveBy():_is3D(false) {}
@@ -998,6 +1025,7 @@ public:
      * @param time In seconds.
      */
     virtual void update(float time) override;
+    virtual bool getTween(TweenDesc& desc) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     ScaleTo() {}
@@ -1156,6 +1184,7 @@ public:
      * @param time In seconds.
      */
     virtual void update(float time) override;
+    virtual bool getTween(TweenDesc& desc) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     FadeTo() {}
@@ -29,30 +29,18 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCTweenBatch.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
-#include "base/ccCArray.h"
-#include "base/uthash.h"
+
+#include <algorithm>
 
 NS_CC_BEGIN
-//
-// singleton stuff
-//
-typedef struct _hashElement
-{
-    struct _ccArray     *actions;
-    Node                *target;
-    int                 actionIndex;
-    Action              *currentAction;
-    bool                currentActionSalvaged;
-    bool                paused;
-    UT_hash_handle      hh;
-} tHashElement;
 
 ActionManager::ActionManager()
-: _targets(nullptr),
-  _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+: _updateLocked(false)
+, _hasEmptyTargets(false)
+, _tweenBatch(nullptr)
 {
 
 }
@@ -62,82 +50,104 @@ ActionManager::~ActionManager()
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+    CC_SAFE_DELETE(_tweenBatch);
 }
 
 // private
 
-void ActionManager::deleteHashElement(tHashElement *element)
+ssize_t ActionManager::findTarget(const Node *target) const
 {
-    ccArrayFree(element->actions);
-    HASH_DEL(_targets, element);
-    element->target->release();
-    free(element);
+    auto iter = _targetIndices.find(target);
+    return iter != _targetIndices.end() ? iter->second : -1;
 }
 
-void ActionManager::actionAllocWithHashElement(tHashElement *element)
+void ActionManager::removeTargetAtIndex(ssize_t targetIndex)
 {
-    // 4 actions per Node by default
-    if (element->actions == nullptr)
+    CCASSERT(_targets[targetIndex].actions.empty(), "The actions of the target should be removed first!");
+
+    // update() iterates over _targets, the target is removed once it is done
+    if (_updateLocked)
     {
-        element->actions = ccArrayNew(4);
-    }else 
-    if (element->actions->num == element->actions->max)
+        _hasEmptyTargets = true;
+        return;
+    }
+
+    Node *target = _targets[targetIndex].target;
+    _targetIndices.erase(target);
+
+    ssize_t lastIndex = (ssize_t)_targets.size() - 1;
+    if (targetIndex != lastIndex)
     {
-        ccArrayDoubleCapacity(element->actions);
+        _targets[targetIndex] = std::move(_targets[lastIndex]);
+        _targetIndices[_targets[targetIndex].target] = targetIndex;
     }
+    _targets.pop_back();
 
+    target->release();
 }
 
-void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
+void ActionManager::removeEmptyTargets()
 {
-    Action *action = (Action*)element->actions->arr[index];
+    _hasEmptyTargets = false;
 
-    if (action == element->currentAction && (! element->currentActionSalvaged))
+    for (ssize_t i = (ssize_t)_targets.size() - 1; i >= 0; --i)
     {
-        element->currentAction->retain();
-        element->currentActionSalvaged = true;
+        if (i < (ssize_t)_targets.size() && _targets[i].actions.empty())
+        {
+            removeTargetAtIndex(i);
+        }
     }
+}
 
-    ccArrayRemoveObjectAtIndex(element->actions, index, true);
+void ActionManager::removeActionAtIndex(ssize_t index, ssize_t targetIndex)
+{
+    auto& element = _targets[targetIndex];
+    Action *action = element.actions[index];
+
+    if (action == element.currentAction && (! element.currentActionSalvaged))
+    {
+        element.currentAction->retain();
+        element.currentActionSalvaged = true;
+    }
+
+    element.actions.erase(element.actions.begin() + index);
+
+    if (_tweenBatch)
+    {
+        _tweenBatch->removeAction(action);
+    }
 
     // update actionIndex in case we are in tick. looping over the actions
-    if (element->actionIndex >= index)
+    if (element.actionIndex >= index)
     {
-        element->actionIndex--;
+        element.actionIndex--;
     }
 
-    if (element->actions->num == 0)
+    if (element.actions.empty())
     {
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            deleteHashElement(element);
-        }
+        removeTargetAtIndex(targetIndex);
     }
+
+    action->release();
 }
 
 // pause / resume
 
 void ActionManager::pauseTarget(Node *target)
 {
-    tHashElement *element = nullptr;
-    HASH_FIND_PTR(_targets, &target, element);
-    if (element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex >= 0)
     {
-        element->paused = true;
+        _targets[targetIndex].paused = true;
     }
 }
 
 void ActionManager::resumeTarget(Node *target)
 {
-    tHashElement *element = nullptr;
-    HASH_FIND_PTR(_targets, &target, element);
-    if (element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex >= 0)
     {
-        element->paused = false;
+        _targets[targetIndex].paused = false;
     }
 }
 
@@ -145,12 +155,12 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
 {
     Vector<Node*> idsWithActions;
     
-    for (tHashElement *element=_targets; element != nullptr; element = (tHashElement *)element->hh.next) 
+    for (auto& element : _targets)
     {
-        if (! element->paused) 
+        if (! element.paused && ! element.actions.empty())
         {
-            element->paused = true;
-            idsWithActions.pushBack(element->target);
+            element.paused = true;
+            idsWithActions.pushBack(element.target);
         }
     }    
     
@@ -171,36 +181,82 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
     CCASSERT(action != nullptr, "action can't be nullptr!");
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
-    tHashElement *element = nullptr;
-    // we should convert it to Ref*, because we save it as Ref*
-    Ref *tmp = target;
-    HASH_FIND_PTR(_targets, &tmp, element);
-    if (! element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex < 0)
     {
-        element = (tHashElement*)calloc(sizeof(*element), 1);
-        element->paused = paused;
+        TargetActions element;
+        element.target = target;
+        element.actionIndex = 0;
+        element.currentAction = nullptr;
+        element.currentActionSalvaged = false;
+        element.paused = paused;
+        // 4 actions per Node by default
+        element.actions.reserve(4);
+
         target->retain();
-        element->target = target;
-        HASH_ADD_PTR(_targets, target, element);
+        targetIndex = (ssize_t)_targets.size();
+        _targets.push_back(std::move(element));
+        _targetIndices[target] = targetIndex;
     }
 
-     actionAllocWithHashElement(element);
- 
-     CCASSERT(! ccArrayContainsObject(element->actions, action), "action already be added!");
-     ccArrayAppendObject(element->actions, action);
- 
-     action->startWithTarget(target);
+    auto& actions = _targets[targetIndex].actions;
+    CCASSERT(std::find(actions.begin(), actions.end(), action) == actions.end(), "action already be added!");
+    action->retain();
+    actions.push_back(action);
+
+    action->startWithTarget(target);
+
+    if (_tweenBatch)
+    {
+        _tweenBatch->addAction(action);
+    }
+}
+
+// tween batch
+
+void ActionManager::setTweenBatchEnabled(bool enabled)
+{
+    CCASSERT(! _updateLocked, "The tween batch can't be changed while the actions are updated!");
+
+    if (enabled == isTweenBatchEnabled())
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        _tweenBatch = new (std::nothrow) TweenBatch();
+        for (auto& element : _targets)
+        {
+            for (auto action : element.actions)
+            {
+                _tweenBatch->addAction(action);
+            }
+        }
+    }
+    else
+    {
+        for (auto& element : _targets)
+        {
+            for (auto action : element.actions)
+            {
+                _tweenBatch->removeAction(action);
+            }
+        }
+        CC_SAFE_DELETE(_tweenBatch);
+    }
 }
 
 // remove
 
 void ActionManager::removeAllActions()
 {
-    for (tHashElement *element = _targets; element != nullptr; )
+    for (ssize_t i = (ssize_t)_targets.size() - 1; i >= 0; --i)
     {
-        auto target = element->target;
-        element = (tHashElement*)element->hh.next;
-        removeAllActionsFromTarget(target);
+        if (i < (ssize_t)_targets.size())
+        {
+            removeAllActionsFromTarget(_targets[i].target);
+        }
     }
 }
 
@@ -212,24 +268,28 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
         return;
     }
 
-    tHashElement *element = nullptr;
-    HASH_FIND_PTR(_targets, &target, element);
-    if (element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex >= 0)
     {
-        if (ccArrayContainsObject(element->actions, element->currentAction) && (! element->currentActionSalvaged))
+        auto& element = _targets[targetIndex];
+        if (std::find(element.actions.begin(), element.actions.end(), element.currentAction) != element.actions.end()
+            && (! element.currentActionSalvaged))
         {
-            element->currentAction->retain();
-            element->currentActionSalvaged = true;
+            element.currentAction->retain();
+            element.currentActionSalvaged = true;
         }
 
-        ccArrayRemoveAllObjects(element->actions);
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
+        std::vector<Action*> actions;
+        actions.swap(element.actions);
+        removeTargetAtIndex(targetIndex);
+
+        for (auto action : actions)
         {
-            deleteHashElement(element);
+            if (_tweenBatch)
+            {
+                _tweenBatch->removeAction(action);
+            }
+            action->release();
         }
     }
     else
@@ -246,15 +306,14 @@ void ActionManager::removeAction(Action *action)
         return;
     }
 
-    tHashElement *element = nullptr;
-    Ref *target = action->getOriginalTarget();
-    HASH_FIND_PTR(_targets, &target, element);
-    if (element)
+    ssize_t targetIndex = findTarget(action->getOriginalTarget());
+    if (targetIndex >= 0)
     {
-        auto i = ccArrayGetIndexOfObject(element->actions, action);
-        if (i != CC_INVALID_INDEX)
+        const auto& actions = _targets[targetIndex].actions;
+        auto iter = std::find(actions.begin(), actions.end(), action);
+        if (iter != actions.end())
         {
-            removeActionAtIndex(i, element);
+            removeActionAtIndex(iter - actions.begin(), targetIndex);
         }
     }
     else
@@ -268,19 +327,18 @@ void ActionManager::removeActionByTag(int tag, Node *target)
     CCASSERT(tag != Action::INVALID_TAG, "Invalid tag value!");
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
-    tHashElement *element = nullptr;
-    HASH_FIND_PTR(_targets, &target, element);
-
-    if (element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex >= 0)
     {
-        auto limit = element->actions->num;
-        for (int i = 0; i < limit; ++i)
+        const auto& actions = _targets[targetIndex].actions;
+        auto limit = (ssize_t)actions.size();
+        for (ssize_t i = 0; i < limit; ++i)
         {
-            Action *action = (Action*)element->actions->arr[i];
+            Action *action = actions[i];
 
             if (action->getTag() == (int)tag && action->getOriginalTarget() == target)
             {
-                removeActionAtIndex(i, element);
+                removeActionAtIndex(i, targetIndex);
                 break;
             }
         }
@@ -292,19 +350,18 @@ void ActionManager::removeAllActionsByTag(int tag, Node *target)
     CCASSERT(tag != Action::INVALID_TAG, "Invalid tag value!");
     CCASSERT(target != nullptr, "target can't be nullptr!");
     
-    tHashElement *element = nullptr;
-    HASH_FIND_PTR(_targets, &target, element);
-    
-    if (element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex >= 0)
     {
-        auto limit = element->actions->num;
-        for (int i = 0; i < limit;)
+        auto limit = (ssize_t)_targets[targetIndex].actions.size();
+        for (ssize_t i = 0; i < limit;)
         {
-            Action *action = (Action*)element->actions->arr[i];
+            Action *action = _targets[targetIndex].actions[i];
             
             if (action->getTag() == (int)tag && action->getOriginalTarget() == target)
             {
-                removeActionAtIndex(i, element);
+                // the target is removed with its last action
+                removeActionAtIndex(i, targetIndex);
                 --limit;
             }
             else
@@ -323,19 +380,18 @@ void ActionManager::removeActionsByFlags(unsigned int flags, Node *target)
     }
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
-    tHashElement *element = nullptr;
-    HASH_FIND_PTR(_targets, &target, element);
-
-    if (element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex >= 0)
     {
-        auto limit = element->actions->num;
-        for (int i = 0; i < limit;)
+        auto limit = (ssize_t)_targets[targetIndex].actions.size();
+        for (ssize_t i = 0; i < limit;)
         {
-            Action *action = (Action*)element->actions->arr[i];
+            Action *action = _targets[targetIndex].actions[i];
 
             if ((action->getFlags() & flags) != 0 && action->getOriginalTarget() == target)
             {
-                removeActionAtIndex(i, element);
+                // the target is removed with its last action
+                removeActionAtIndex(i, targetIndex);
                 --limit;
             }
             else
@@ -348,28 +404,18 @@ void ActionManager::removeActionsByFlags(unsigned int flags, Node *target)
 
 // get
 
-// FIXME: Passing "const O *" instead of "const O&" because HASH_FIND_IT requires the address of a pointer
-// and, it is not possible to get the address of a reference
 Action* ActionManager::getActionByTag(int tag, const Node *target) const
 {
     CCASSERT(tag != Action::INVALID_TAG, "Invalid tag value!");
 
-    tHashElement *element = nullptr;
-    HASH_FIND_PTR(_targets, &target, element);
-
-    if (element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex >= 0)
     {
-        if (element->actions != nullptr)
+        for (auto action : _targets[targetIndex].actions)
         {
-            auto limit = element->actions->num;
-            for (int i = 0; i < limit; ++i)
+            if (action->getTag() == (int)tag)
             {
-                Action *action = (Action*)element->actions->arr[i];
-
-                if (action->getTag() == (int)tag)
-                {
-                    return action;
-                }
+                return action;
             }
         }
         //CCLOG("cocos2d : getActionByTag(tag = %d): Action not found", tag);
@@ -382,15 +428,12 @@ Action* ActionManager::getActionByTag(int tag, const Node *target) const
     return nullptr;
 }
 
-// FIXME: Passing "const O *" instead of "const O&" because HASH_FIND_IT requires the address of a pointer
-// and, it is not possible to get the address of a reference
 ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) const
 {
-    tHashElement *element = nullptr;
-    HASH_FIND_PTR(_targets, &target, element);
-    if (element)
+    ssize_t targetIndex = findTarget(target);
+    if (targetIndex >= 0)
     {
-        return element->actions ? element->actions->num : 0;
+        return (ssize_t)_targets[targetIndex].actions.size();
     }
 
     return 0;
@@ -399,61 +442,69 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
 // main loop
 void ActionManager::update(float dt)
 {
-    for (tHashElement *elt = _targets; elt != nullptr; )
+    _updateLocked = true;
+
+    // the batched tweens are evaluated in bulk, each one is set on its target when it is stepped
+    if (_tweenBatch)
+    {
+        _tweenBatch->update(dt);
+    }
+
+    // The targets added by the actions are appended, they are updated in this loop too.
+    for (ssize_t targetIndex = 0; targetIndex < (ssize_t)_targets.size(); ++targetIndex)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+        if (_targets[targetIndex].paused)
+        {
+            continue;
+        }
 
-        if (! _currentTarget->paused)
+        // The actions of the target may change while inside this loop, and _targets may grow,
+        // so the target is fetched again after each step.
+        for (_targets[targetIndex].actionIndex = 0;
+             _targets[targetIndex].actionIndex < (ssize_t)_targets[targetIndex].actions.size();
+             _targets[targetIndex].actionIndex++)
         {
-            // The 'actions' MutableArray may change while inside this loop.
-            for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
-                _currentTarget->actionIndex++)
+            auto& element = _targets[targetIndex];
+            Action *action = element.actions[element.actionIndex];
+            element.currentAction = action;
+            element.currentActionSalvaged = false;
+
+            if (_tweenBatch && TweenBatch::isBatched(action))
             {
-                _currentTarget->currentAction = (Action*)_currentTarget->actions->arr[_currentTarget->actionIndex];
-                if (_currentTarget->currentAction == nullptr)
-                {
-                    continue;
-                }
-
-                _currentTarget->currentActionSalvaged = false;
-
-                _currentTarget->currentAction->step(dt);
-
-                if (_currentTarget->currentActionSalvaged)
-                {
-                    // The currentAction told the node to remove it. To prevent the action from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    _currentTarget->currentAction->release();
-                } else
-                if (_currentTarget->currentAction->isDone())
-                {
-                    _currentTarget->currentAction->stop();
-
-                    Action *action = _currentTarget->currentAction;
-                    // Make currentAction nil to prevent removeAction from salvaging it.
-                    _currentTarget->currentAction = nullptr;
-                    removeAction(action);
-                }
-
-                _currentTarget->currentAction = nullptr;
+                _tweenBatch->step(action);
+            }
+            else
+            {
+                action->step(dt);
             }
-        }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashElement*)(elt->hh.next);
+            if (_targets[targetIndex].currentActionSalvaged)
+            {
+                // The currentAction told the node to remove it. To prevent the action from
+                // accidentally deallocating itself before finishing its step, we retained
+                // it. Now that step is done, it's safe to release it.
+                action->release();
+            } else
+            if (action->isDone())
+            {
+                action->stop();
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->actions->num == 0)
-        {
-            deleteHashElement(_currentTarget);
+                // Make currentAction nil to prevent removeAction from salvaging it.
+                _targets[targetIndex].currentAction = nullptr;
+                removeAction(action);
+            }
+
+            _targets[targetIndex].currentAction = nullptr;
         }
     }
 
-    // issue #635
-    _currentTarget = nullptr;
+    _updateLocked = false;
+
+    // the targets left without actions are removed once the loop is done (issue #481)
+    if (_hasEmptyTargets)
+    {
+        removeEmptyTargets();
+    }
 }
 
 NS_CC_END
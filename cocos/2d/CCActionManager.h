@@ -29,6 +29,9 @@ THE SOFTWARE.
 #ifndef __ACTION_CCACTION_MANAGER_H__
 #define __ACTION_CCACTION_MANAGER_H__
 
+#include <unordered_map>
+#include <vector>
+
 #include "2d/CCAction.h"
 #include "base/CCVector.h"
 #include "base/CCRef.h"
@@ -36,8 +39,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Action;
-
-struct _hashElement;
+class TweenBatch;
 
 /**
  * @addtogroup actions
@@ -168,6 +170,29 @@ public:
      * @param targetsToResume   A set of targets need to be resumed.
      */
     void resumeTargets(const Vector<Node*>& targetsToResume);
+
+    /** Enables or disables the tween batch, disabled by default.
+     * While it is enabled, MoveBy, MoveTo, ScaleTo, ScaleBy, RotateBy, FadeTo, FadeIn and FadeOut,
+     * optionally wrapped in one of the tweenfunc ease actions, are evaluated together by a TweenBatch
+     * at the start of update(). The results are set on the targets in the usual order, they are the
+     * same as stepping the actions one by one.
+     * Subclasses of these actions that override update() must override getTween() to return false.
+     *
+     * @param enabled   True to batch the running and the new tweens, false to step them one by one again.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    void setTweenBatchEnabled(bool enabled);
+
+    /** Whether the tween batch is enabled.
+     *
+     * @return True if the tween batch is enabled.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    bool isTweenBatchEnabled() const { return _tweenBatch != nullptr; }
     
     /** Main loop of ActionManager.
      * @param dt    In seconds.
@@ -175,16 +200,32 @@ public:
     void update(float dt);
     
 protected:
-    // declared in ActionManager.m
-
-    void removeActionAtIndex(ssize_t index, struct _hashElement *element);
-    void deleteHashElement(struct _hashElement *element);
-    void actionAllocWithHashElement(struct _hashElement *element);
+    // the actions of a target
+    struct TargetActions
+    {
+        Node                 *target;
+        std::vector<Action*> actions;
+        ssize_t              actionIndex;
+        Action               *currentAction;
+        bool                 currentActionSalvaged;
+        bool                 paused;
+    };
+
+    ssize_t findTarget(const Node *target) const;
+    void removeActionAtIndex(ssize_t index, ssize_t targetIndex);
+    void removeTargetAtIndex(ssize_t targetIndex);
+    void removeEmptyTargets();
 
 protected:
-    struct _hashElement    *_targets;
-    struct _hashElement    *_currentTarget;
-    bool            _currentTargetSalvaged;
+    // packed, a removed target is replaced by the last one
+    std::vector<TargetActions> _targets;
+    // index of each target in _targets
+    std::unordered_map<const Node*, ssize_t> _targetIndices;
+    // while true the targets without actions are kept, so update() can iterate over _targets
+    bool _updateLocked;
+    bool _hasEmptyTargets;
+    // evaluates the batchable interval actions in bulk, nullptr while disabled
+    TweenBatch *_tweenBatch;
 };
 
 // end of actions group
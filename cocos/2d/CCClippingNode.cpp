@@ -211,9 +211,10 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
-    _beforeVisitCmd.init(_globalZOrder);
-    _beforeVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onBeforeVisit, _stencilStateManager);
-    renderer->addCommand(&_beforeVisitCmd);
+    auto beforeVisitCmd = renderer->generateTransientCustomCommand();
+    beforeVisitCmd->init(_globalZOrder);
+    beforeVisitCmd->func = CC_CALLBACK_0(StencilStateManager::onBeforeVisit, _stencilStateManager);
+    renderer->addCommand(beforeVisitCmd);
     
     auto alphaThreshold = this->getAlphaThreshold();
     if (alphaThreshold < 1)
@@ -235,9 +236,10 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     }
     _stencil->visit(renderer, _modelViewTransform, flags);
 
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterDrawStencil, _stencilStateManager);
-    renderer->addCommand(&_afterDrawStencilCmd);
+    auto afterDrawStencilCmd = renderer->generateTransientCustomCommand();
+    afterDrawStencilCmd->init(_globalZOrder);
+    afterDrawStencilCmd->func = CC_CALLBACK_0(StencilStateManager::onAfterDrawStencil, _stencilStateManager);
+    renderer->addCommand(afterDrawStencilCmd);
 
     int i = 0;
     bool visibleByCamera = isVisitableByVisitingCamera();
@@ -267,9 +269,10 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterVisit, _stencilStateManager);
-    renderer->addCommand(&_afterVisitCmd);
+    auto afterVisitCmd = renderer->generateTransientCustomCommand();
+    afterVisitCmd->init(_globalZOrder);
+    afterVisitCmd->func = CC_CALLBACK_0(StencilStateManager::onAfterVisit, _stencilStateManager);
+    renderer->addCommand(afterVisitCmd);
 
     renderer->popGroup();
     
@@ -160,9 +160,6 @@ protected:
     StencilStateManager* _stencilStateManager;
     
     GroupCommand _groupCommand;
-    CustomCommand _beforeVisitCmd;
-    CustomCommand _afterDrawStencilCmd;
-    CustomCommand _afterVisitCmd;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ClippingNode);
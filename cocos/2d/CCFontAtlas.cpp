@@ -30,11 +30,18 @@
 #include "android/jni/Java_org_cocos2dx_lib_Cocos2dxHelper.h"
 #endif
 #include "2d/CCFontFreeType.h"
+#include "2d/CCFontAtlasCache.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCParallelTaskPool.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCMappedFile.h"
+
+#include <algorithm>
+#include <zlib.h>
 
 NS_CC_BEGIN
 
@@ -42,6 +49,58 @@ const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
+bool FontAtlas::s_parallelRasterization = true;
+
+// below this number of new glyphs, waking up the worker threads costs more than it saves
+static const int PARALLEL_RASTERIZATION_MIN_GLYPHS = 16;
+
+// persistent atlas file: a header, the key, the letters, the kerning pairs and the zlib compressed pages
+static const char PERSISTENT_MAGIC[4] = { 'C', 'C', 'F', 'A' };
+static const uint32_t PERSISTENT_VERSION = 1;
+static const uint32_t PERSISTENT_BYTE_ORDER = 0x01020304;
+// when the pairs of the font can't be enumerated, asking FreeType about every pair is quadratic:
+// larger atlases don't save a kerning table and ask FreeType when the text is laid out
+static const size_t PERSISTENT_KERNING_MAX_LETTERS = 96;
+
+namespace {
+struct PersistentHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t keyLength;
+    uint32_t pageWidth;
+    uint32_t pageHeight;
+    uint32_t pageDataSize;
+    uint32_t pageCount;
+    uint32_t letterCount;
+    uint32_t hasKerningTable;
+    uint32_t kerningCount;
+    float currentPageOrigX;
+    float currentPageOrigY;
+    int32_t currLineHeight;
+};
+
+struct PersistentLetter
+{
+    uint32_t code;
+    float U;
+    float V;
+    float width;
+    float height;
+    float offsetX;
+    float offsetY;
+    int32_t textureID;
+    int32_t xAdvance;
+    uint32_t validDefinition;
+};
+
+struct PersistentKerning
+{
+    uint32_t pair;
+    int32_t amount;
+};
+}
 
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
@@ -50,8 +109,11 @@ FontAtlas::FontAtlas(Font &theFont)
 , _currentPageData(nullptr)
 , _fontAscender(0)
 , _rendererRecreatedListener(nullptr)
+, _dirtyRowBegin(CacheTextureHeight)
+, _dirtyRowEnd(0)
 , _antialiasEnabled(true)
 , _currLineHeight(0)
+, _persistedLetterCount(0)
 {
     _font->retain();
 
@@ -100,6 +162,8 @@ FontAtlas::FontAtlas(Font &theFont)
 
 FontAtlas::~FontAtlas()
 {
+    FontAtlasCache::removeDirtyAtlas(this);
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     if (_fontFreeType && _rendererRecreatedListener)
     {
@@ -298,6 +362,19 @@ void FontAtlas::findNewCharacters(const std::u16string& u16Text, std::unordered_
     }
 }
 
+static void copyGlyphToPage(unsigned char* page, const FontFreeType::GlyphBitmap& glyph, int posX, int posY)
+{
+    // like FontFreeType::renderCharAt()
+    size_t bytesPerPixel = glyph.pixels.size() / (glyph.pixelsWide * glyph.pixelsHigh);
+    size_t rowBytes = glyph.pixelsWide * bytesPerPixel;
+    for (long y = 0; y < glyph.pixelsHigh && posY + y < FontAtlas::CacheTextureHeight; ++y)
+    {
+        memcpy(page + ((posY + y) * FontAtlas::CacheTextureWidth + posX) * bytesPerPixel,
+               glyph.pixels.data() + y * rowBytes,
+               rowBytes);
+    }
+}
+
 bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
 {
     if (_fontFreeType == nullptr)
@@ -312,23 +389,46 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
         return false;
     }
 
+    // render the glyphs first, on the worker threads when there are enough of them
+    std::vector<std::pair<unsigned short, unsigned short>> newChars(codeMapOfNewChar.begin(), codeMapOfNewChar.end());
+    int glyphCount = static_cast<int>(newChars.size());
+    std::vector<FontFreeType::GlyphBitmap> glyphs(glyphCount);
+
+    auto pool = ParallelTaskPool::getInstance();
+    if (s_parallelRasterization
+        && glyphCount >= PARALLEL_RASTERIZATION_MIN_GLYPHS
+        && pool->getWorkerCount() > 0
+        && pool->getCurrentThreadIndex() == 0
+        && _fontFreeType->prepareThreadFaces(pool->getWorkerCount() + 1))
+    {
+        pool->run(glyphCount, [&](int index) {
+            _fontFreeType->rasterizeGlyph(newChars[index].second, pool->getCurrentThreadIndex(), glyphs[index]);
+        });
+    }
+    else
+    {
+        for (int index = 0; index < glyphCount; ++index)
+        {
+            _fontFreeType->rasterizeGlyph(newChars[index].second, 0, glyphs[index]);
+        }
+    }
+
     int adjustForDistanceMap = _letterPadding / 2;
     int adjustForExtend = _letterEdgeExtend / 2;
-    long bitmapWidth;
-    long bitmapHeight;
     Rect tempRect;
     FontLetterDefinition tempDef;
 
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
     auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
 
-    float startY = _currentPageOrigY;
-
-    for (auto&& it : codeMapOfNewChar)
+    for (int index = 0; index < glyphCount; ++index)
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+        const auto& glyph = glyphs[index];
+        tempRect = glyph.rect;
+        tempDef.xAdvance = glyph.xAdvance;
+        if (glyph.valid)
         {
+            long bitmapHeight = glyph.bitmapHeight;
             tempDef.validDefinition = true;
             tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
             tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
@@ -346,19 +446,12 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
                 _currentPageOrigX = 0;
                 if (_currentPageOrigY + _lineHeight >= CacheTextureHeight)
                 {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == Texture2D::PixelFormat::AI88)
+                    // the page is full, send its last glyphs before reusing the buffer
+                    uploadDirtyTextures();
+                    if (!_persistentFile.empty())
                     {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+                        _fullPagesData.push_back(std::vector<unsigned char>(_currentPageData, _currentPageData + _currentPageDataSize));
                     }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
 
                     _currentPageOrigY = 0;
                     memset(_currentPageData, 0, _currentPageDataSize);
@@ -378,7 +471,12 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
                     tex->release();
                 }
             }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
+            int glyphX = static_cast<int>(_currentPageOrigX) + adjustForExtend;
+            int glyphY = static_cast<int>(_currentPageOrigY) + adjustForExtend;
+            copyGlyphToPage(_currentPageData, glyph, glyphX, glyphY);
+            _dirtyRowBegin = std::min(_dirtyRowBegin, glyphY);
+            _dirtyRowEnd = std::max(_dirtyRowEnd, std::min(glyphY + static_cast<int>(glyph.pixelsHigh), CacheTextureHeight));
+            FontAtlasCache::addDirtyAtlas(this);
 
             tempDef.U = _currentPageOrigX;
             tempDef.V = _currentPageOrigY;
@@ -406,20 +504,309 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
             _currentPageOrigX += 1;
         }
 
-        _letterDefinitions[it.first] = tempDef;
+        _letterDefinitions[newChars[index].first] = tempDef;
+    }
+
+    return true;
+}
+
+void FontAtlas::uploadDirtyTextures()
+{
+    if (_dirtyRowEnd <= _dirtyRowBegin)
+    {
+        return;
+    }
+
+    int bytesPerPixel = _fontFreeType->getOutlineSize() > 0 ? 2 : 1;
+    unsigned char *data = _currentPageData + CacheTextureWidth * _dirtyRowBegin * bytesPerPixel;
+    _atlasTextures[_currentPage]->updateWithData(data, 0, _dirtyRowBegin, CacheTextureWidth, _dirtyRowEnd - _dirtyRowBegin);
+
+    _dirtyRowBegin = CacheTextureHeight;
+    _dirtyRowEnd = 0;
+}
+
+bool FontAtlas::loadPersistentFile(const std::string& fullPath, const std::string& key)
+{
+    CCASSERT(_letterDefinitions.empty(), "the atlas should not have letters yet");
+    if (_fontFreeType == nullptr || !_letterDefinitions.empty())
+    {
+        return false;
     }
+    _persistentFile = fullPath;
+    _persistentKey = key;
 
-    unsigned char *data = nullptr;
-    if (pixelFormat == Texture2D::PixelFormat::AI88)
+    MappedFile file;
+    if (!FileUtils::getInstance()->isFileExist(fullPath) || !file.open(fullPath))
+    {
+        return false;
+    }
+    const unsigned char* bytes = file.getBytes();
+    size_t size = static_cast<size_t>(file.getSize());
+    size_t offset = 0;
+    auto read = [&](void* dest, size_t length) {
+        if (size - offset < length)
+            return false;
+        memcpy(dest, bytes + offset, length);
+        offset += length;
+        return true;
+    };
+
+    PersistentHeader header;
+    if (!read(&header, sizeof(header))
+        || memcmp(header.magic, PERSISTENT_MAGIC, sizeof(PERSISTENT_MAGIC)) != 0
+        || header.version != PERSISTENT_VERSION
+        || header.byteOrder != PERSISTENT_BYTE_ORDER
+        || header.keyLength != key.size()
+        || size - offset < header.keyLength
+        || key.compare(0, key.size(), reinterpret_cast<const char*>(bytes + offset), header.keyLength) != 0)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        CCLOG("cocos2d: FontAtlas: %s is outdated", fullPath.c_str());
+        return false;
     }
-    else
+    offset += header.keyLength;
+
+    if (header.pageWidth != static_cast<uint32_t>(CacheTextureWidth)
+        || header.pageHeight != static_cast<uint32_t>(CacheTextureHeight)
+        || header.pageDataSize != static_cast<uint32_t>(_currentPageDataSize)
+        || header.pageCount == 0
+        || header.letterCount > (size - offset) / sizeof(PersistentLetter)
+        // the next glyphs are written at this position, a glyph ending at the right edge leaves it one pixel past it
+        || !(header.currentPageOrigX >= 0 && header.currentPageOrigX <= CacheTextureWidth + 1)
+        || !(header.currentPageOrigY >= 0 && header.currentPageOrigY < CacheTextureHeight)
+        || header.currLineHeight < 0
+        || header.currentPageOrigY + header.currLineHeight > CacheTextureHeight)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        CCLOG("cocos2d: FontAtlas: %s is invalid", fullPath.c_str());
+        return false;
+    }
+
+    std::unordered_map<char16_t, FontLetterDefinition> letterDefinitions;
+    std::u16string letters;
+    letterDefinitions.reserve(header.letterCount);
+    letters.reserve(header.letterCount);
+    for (uint32_t i = 0; i < header.letterCount; ++i)
+    {
+        PersistentLetter letter;
+        read(&letter, sizeof(letter));
+        if (letter.textureID < 0 || static_cast<uint32_t>(letter.textureID) >= header.pageCount)
+        {
+            CCLOG("cocos2d: FontAtlas: %s is invalid", fullPath.c_str());
+            return false;
+        }
+        FontLetterDefinition& definition = letterDefinitions[static_cast<char16_t>(letter.code)];
+        definition.U = letter.U;
+        definition.V = letter.V;
+        definition.width = letter.width;
+        definition.height = letter.height;
+        definition.offsetX = letter.offsetX;
+        definition.offsetY = letter.offsetY;
+        definition.textureID = letter.textureID;
+        definition.xAdvance = letter.xAdvance;
+        definition.validDefinition = letter.validDefinition != 0;
+        letters.push_back(static_cast<char16_t>(letter.code));
+    }
+
+    std::unordered_map<unsigned int, int> kernings;
+    for (uint32_t i = 0; i < header.kerningCount; ++i)
+    {
+        PersistentKerning kerning;
+        if (!read(&kerning, sizeof(kerning)))
+        {
+            CCLOG("cocos2d: FontAtlas: %s is invalid", fullPath.c_str());
+            return false;
+        }
+        kernings[kerning.pair] = kerning.amount;
+    }
+
+    std::vector<std::vector<unsigned char>> pagesData(header.pageCount);
+    for (auto& pageData : pagesData)
+    {
+        uint32_t compressedSize = 0;
+        uLongf pageDataSize = _currentPageDataSize;
+        pageData.resize(_currentPageDataSize);
+        if (!read(&compressedSize, sizeof(compressedSize))
+            || size - offset < compressedSize
+            || uncompress(pageData.data(), &pageDataSize, bytes + offset, compressedSize) != Z_OK
+            || pageDataSize != static_cast<uLongf>(_currentPageDataSize))
+        {
+            CCLOG("cocos2d: FontAtlas: %s is invalid", fullPath.c_str());
+            return false;
+        }
+        offset += compressedSize;
+    }
+
+    // everything was read, replace the empty atlas
+    auto pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    for (uint32_t page = 0; page < header.pageCount; ++page)
+    {
+        if (page == 0)
+        {
+            _atlasTextures[0]->updateWithData(pagesData[0].data(), 0, 0, CacheTextureWidth, CacheTextureHeight);
+        }
+        else
+        {
+            auto tex = new (std::nothrow) Texture2D;
+            if (_antialiasEnabled)
+            {
+                tex->setAntiAliasTexParameters();
+            }
+            else
+            {
+                tex->setAliasTexParameters();
+            }
+            tex->initWithData(pagesData[page].data(), _currentPageDataSize,
+                pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
+            addTexture(tex, page);
+            tex->release();
+        }
+    }
+    _currentPage = header.pageCount - 1;
+    memcpy(_currentPageData, pagesData.back().data(), _currentPageDataSize);
+    pagesData.pop_back();
+    _fullPagesData = std::move(pagesData);
+    _currentPageOrigX = header.currentPageOrigX;
+    _currentPageOrigY = header.currentPageOrigY;
+    _currLineHeight = header.currLineHeight;
+    _letterDefinitions = std::move(letterDefinitions);
+    _persistedLetterCount = _letterDefinitions.size();
+
+    if (header.hasKerningTable)
+    {
+        _fontFreeType->setKerningTable(letters, std::move(kernings));
+    }
+
+    return true;
+}
+
+bool FontAtlas::savePersistentFile()
+{
+    if (_fontFreeType == nullptr || _persistentFile.empty())
+    {
+        return false;
+    }
+    if (_letterDefinitions.size() == _persistedLetterCount)
+    {
+        return true;
+    }
+
+    std::vector<unsigned char> buffer;
+    auto write = [&buffer](const void* source, size_t length) {
+        auto bytes = static_cast<const unsigned char*>(source);
+        buffer.insert(buffer.end(), bytes, bytes + length);
+    };
+
+    // sorted, so that the same atlas always gives the same file
+    std::u16string letters;
+    letters.reserve(_letterDefinitions.size());
+    for (const auto& item : _letterDefinitions)
+    {
+        letters.push_back(item.first);
+    }
+    std::sort(letters.begin(), letters.end());
+
+    // saved on the cocos thread, so the pairs are read from the font's kern table when possible
+    std::vector<PersistentKerning> kernings;
+    std::unordered_map<unsigned int, int> kerningPairs;
+    bool hasKerningTable = false;
+    if (_fontFreeType->hasKerning())
+    {
+        if (_fontFreeType->getKerningPairs(letters, &kerningPairs))
+        {
+            hasKerningTable = true;
+            kernings.reserve(kerningPairs.size());
+            for (const auto& item : kerningPairs)
+            {
+                kernings.push_back({ item.first, item.second });
+            }
+            std::sort(kernings.begin(), kernings.end(), [](const PersistentKerning& a, const PersistentKerning& b) {
+                return a.pair < b.pair;
+            });
+        }
+        else if (letters.size() <= PERSISTENT_KERNING_MAX_LETTERS)
+        {
+            hasKerningTable = true;
+            for (auto first : letters)
+            {
+                for (auto second : letters)
+                {
+                    int amount = _fontFreeType->getHorizontalKerningForChars(first, second);
+                    if (amount != 0)
+                    {
+                        kernings.push_back({ (static_cast<uint32_t>(first) << 16) | second, amount });
+                    }
+                }
+            }
+        }
+    }
+
+    PersistentHeader header;
+    memcpy(header.magic, PERSISTENT_MAGIC, sizeof(PERSISTENT_MAGIC));
+    header.version = PERSISTENT_VERSION;
+    header.byteOrder = PERSISTENT_BYTE_ORDER;
+    header.keyLength = static_cast<uint32_t>(_persistentKey.size());
+    header.pageWidth = CacheTextureWidth;
+    header.pageHeight = CacheTextureHeight;
+    header.pageDataSize = _currentPageDataSize;
+    header.pageCount = static_cast<uint32_t>(_fullPagesData.size() + 1);
+    header.letterCount = static_cast<uint32_t>(letters.size());
+    header.hasKerningTable = hasKerningTable ? 1 : 0;
+    header.kerningCount = static_cast<uint32_t>(kernings.size());
+    header.currentPageOrigX = _currentPageOrigX;
+    header.currentPageOrigY = _currentPageOrigY;
+    header.currLineHeight = _currLineHeight;
+    write(&header, sizeof(header));
+    write(_persistentKey.data(), _persistentKey.size());
+
+    for (auto code : letters)
+    {
+        const FontLetterDefinition& definition = _letterDefinitions[code];
+        PersistentLetter letter;
+        letter.code = code;
+        letter.U = definition.U;
+        letter.V = definition.V;
+        letter.width = definition.width;
+        letter.height = definition.height;
+        letter.offsetX = definition.offsetX;
+        letter.offsetY = definition.offsetY;
+        letter.textureID = definition.textureID;
+        letter.xAdvance = definition.xAdvance;
+        letter.validDefinition = definition.validDefinition ? 1 : 0;
+        write(&letter, sizeof(letter));
+    }
+    if (!kernings.empty())
+    {
+        write(kernings.data(), kernings.size() * sizeof(PersistentKerning));
+    }
+
+    std::vector<unsigned char> compressed(compressBound(_currentPageDataSize));
+    for (size_t page = 0; page <= _fullPagesData.size(); ++page)
+    {
+        const unsigned char* pageData = page < _fullPagesData.size() ? _fullPagesData[page].data() : _currentPageData;
+        uLongf compressedSize = static_cast<uLongf>(compressed.size());
+        if (compress(compressed.data(), &compressedSize, pageData, _currentPageDataSize) != Z_OK)
+        {
+            return false;
+        }
+        uint32_t size = static_cast<uint32_t>(compressedSize);
+        write(&size, sizeof(size));
+        write(compressed.data(), compressedSize);
+    }
+
+    auto fileUtils = FileUtils::getInstance();
+    auto separator = _persistentFile.find_last_of("/\\");
+    if (separator != std::string::npos)
+    {
+        fileUtils->createDirectory(_persistentFile.substr(0, separator + 1));
+    }
+    Data data;
+    data.copy(buffer.data(), buffer.size());
+    if (!fileUtils->writeDataToFile(data, _persistentFile))
+    {
+        CCLOG("cocos2d: FontAtlas: can't write %s", _persistentFile.c_str());
+        return false;
     }
-    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _lineHeight);
 
+    _persistedLetterCount = _letterDefinitions.size();
     return true;
 }
 
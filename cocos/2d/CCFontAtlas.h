@@ -30,6 +30,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
@@ -78,6 +79,32 @@ public:
     
     bool prepareLetterDefinitions(const std::u16string& utf16String);
 
+    /** Sends the glyphs added to the current page since the last upload to its texture, in one update.
+     * Renderer::render() calls it through FontAtlasCache::uploadDirtyAtlases() before executing the render commands,
+     * so it only needs to be called when the textures are used without the Renderer, e.g. by custom GL code.
+     * @since v3.10
+     */
+    void uploadDirtyTextures();
+
+    /** Enables or disables rendering the new glyphs with the worker threads of ParallelTaskPool. Enabled by default.
+     * Each worker thread gets its own FreeType face, and the glyphs are then packed in the pages by the calling thread.
+     * @since v3.10
+     */
+    static void setParallelRasterizationEnabled(bool enabled) { s_parallelRasterization = enabled; }
+    static bool isParallelRasterizationEnabled() { return s_parallelRasterization; }
+
+    /** Reads the pages, letter definitions and kerning written by savePersistentFile(), if the file exists and was
+     * written with the same key, so that these letters don't go through FreeType again.
+     * The atlas must not have letters yet. It remembers the file for savePersistentFile() even if it can't be read.
+     * @since v3.10
+     */
+    bool loadPersistentFile(const std::string& fullPath, const std::string& key);
+
+    /** Writes the atlas to the file given to loadPersistentFile(), if letters were added since it was read or written.
+     * @since v3.10
+     */
+    bool savePersistentFile();
+
     inline const std::unordered_map<ssize_t, Texture2D*>& getTextures() const{ return _atlasTextures;}
     void  addTexture(Texture2D *texture, int slot);
     float getLineHeight() const { return _lineHeight; }
@@ -140,9 +167,21 @@ protected:
 
     int _fontAscender;
     EventListenerCustom* _rendererRecreatedListener;
+    // rows of the current page changed since its last upload, none if _dirtyRowEnd <= _dirtyRowBegin
+    int _dirtyRowBegin;
+    int _dirtyRowEnd;
     bool _antialiasEnabled;
     int _currLineHeight;
 
+    // persistent file, see loadPersistentFile()
+    std::string _persistentFile;
+    std::string _persistentKey;
+    size_t _persistedLetterCount;
+    // the data of the full pages, only kept to write them in the persistent file
+    std::vector<std::vector<unsigned char>> _fullPagesData;
+
+    static bool s_parallelRasterization;
+
     friend class Label;
 };
 
@@ -24,6 +24,7 @@
  ****************************************************************************/
 #include "2d/CCFontAtlasCache.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include "base/CCDirector.h"
@@ -32,10 +33,14 @@
 #include "2d/CCFontAtlas.h"
 #include "2d/CCFontCharMap.h"
 #include "2d/CCLabel.h"
+#include "platform/CCFileUtils.h"
+#include "xxhash.h"
 
 NS_CC_BEGIN
 
 std::unordered_map<std::string, FontAtlas *> FontAtlasCache::_atlasMap;
+std::vector<FontAtlas*> FontAtlasCache::_dirtyAtlases;
+bool FontAtlasCache::_persistentCacheEnabled = false;
 
 void FontAtlasCache::purgeCachedData()
 {
@@ -68,6 +73,15 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
             config->customGlyphs, useDistanceField, config->outlineSize);
         if (font)
         {
+            if (_persistentCacheEnabled)
+            {
+                auto key = generatePersistentKey(atlasName, config, font);
+                auto hash = XXH32(key.data(), static_cast<int>(key.size()), 0);
+                char fileName[16];
+                snprintf(fileName, sizeof(fileName), "%08x.ccfa", hash);
+                font->setPersistentAtlasFile(getPersistentCachePath() + fileName, key);
+            }
+
             auto tempAtlas = font->createFontAtlas();
             if (tempAtlas)
             {
@@ -202,6 +216,64 @@ FontAtlas* FontAtlasCache::getFontAtlasCharMap(const std::string& charMapFile, i
     return nullptr;
 }
 
+std::string FontAtlasCache::generatePersistentKey(const std::string& atlasName, const _ttfConfig* config, const FontFreeType* font)
+{
+    // everything that changes the rendered glyphs
+    std::stringstream ss;
+    ss << atlasName
+        << "|font:" << font->getFontDataHash()
+        << "|glyphs:" << static_cast<int>(config->glyphs);
+    if (config->glyphs == GlyphCollection::CUSTOM && config->customGlyphs)
+    {
+        ss << "|custom:" << XXH32(config->customGlyphs, static_cast<int>(strlen(config->customGlyphs)), 0);
+    }
+    ss.precision(2);
+    ss << "|scale:" << std::fixed << CC_CONTENT_SCALE_FACTOR();
+    return ss.str();
+}
+
+void FontAtlasCache::savePersistentCache()
+{
+    if (!_persistentCacheEnabled)
+        return;
+
+    for (auto&& atlas : _atlasMap)
+    {
+        atlas.second->savePersistentFile();
+    }
+}
+
+void FontAtlasCache::uploadDirtyAtlases()
+{
+    for (auto atlas : _dirtyAtlases)
+    {
+        atlas->uploadDirtyTextures();
+    }
+    _dirtyAtlases.clear();
+}
+
+void FontAtlasCache::addDirtyAtlas(FontAtlas* atlas)
+{
+    if (std::find(_dirtyAtlases.begin(), _dirtyAtlases.end(), atlas) == _dirtyAtlases.end())
+    {
+        _dirtyAtlases.push_back(atlas);
+    }
+}
+
+void FontAtlasCache::removeDirtyAtlas(FontAtlas* atlas)
+{
+    auto iter = std::find(_dirtyAtlases.begin(), _dirtyAtlases.end(), atlas);
+    if (iter != _dirtyAtlases.end())
+    {
+        _dirtyAtlases.erase(iter);
+    }
+}
+
+std::string FontAtlasCache::getPersistentCachePath()
+{
+    return FileUtils::getInstance()->getWritablePath() + "fontatlas/";
+}
+
 std::string FontAtlasCache::generateFontName(const std::string& fontFileName, float size, bool useDistanceField)
 {
     std::string tempName(fontFileName);
@@ -225,6 +297,10 @@ bool FontAtlasCache::releaseFontAtlas(FontAtlas *atlas)
             {
                 if (atlas->getReferenceCount() == 1)
                 {
+                  if (_persistentCacheEnabled)
+                  {
+                      atlas->savePersistentFile();
+                  }
                   _atlasMap.erase(item.first);
                 }
                 
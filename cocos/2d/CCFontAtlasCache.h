@@ -29,11 +29,13 @@
 /// @cond DO_NOT_SHOW
 
 #include <unordered_map>
+#include <vector>
 #include "base/ccTypes.h"
 
 NS_CC_BEGIN
 
 class FontAtlas;
+class FontFreeType;
 class Texture2D;
 struct _ttfConfig;
 
@@ -53,10 +55,45 @@ public:
      It will purge the textures atlas and if multiple texture exist in one FontAtlas.
      */
     static void purgeCachedData();
+
+    /** Enables or disables persisting the atlases of the TTF fonts. Disabled by default.
+     When enabled, the atlases are saved in getPersistentCachePath() when they are released, and when
+     savePersistentCache() is called, and the next getFontAtlasTTF() calls with the same font file and
+     config read them back instead of rendering their glyphs with FreeType again.
+     @since v3.10
+     */
+    static void setPersistentCacheEnabled(bool enabled) { _persistentCacheEnabled = enabled; }
+    static bool isPersistentCacheEnabled() { return _persistentCacheEnabled; }
+
+    /** Saves the atlases of the TTF fonts that got new glyphs, e.g. when the application enters the background.
+     @since v3.10
+     */
+    static void savePersistentCache();
+
+    /** Returns the directory of the persisted atlases, in the writable path.
+     @since v3.10
+     */
+    static std::string getPersistentCachePath();
+
+    /** Sends the glyphs added to the atlases since the last call to their textures.
+     Renderer::render() calls it before executing the render commands, so the glyphs of the labels are on their
+     textures when the labels are drawn.
+     @since v3.10
+     */
+    static void uploadDirtyAtlases();
+
+    /** Lets uploadDirtyAtlases() upload the new glyphs of an atlas, or forget it when it is destroyed.
+     @since v3.10
+     */
+    static void addDirtyAtlas(FontAtlas* atlas);
+    static void removeDirtyAtlas(FontAtlas* atlas);
     
 private:
     static std::string generateFontName(const std::string& fontFileName, float size, bool useDistanceField);
+    static std::string generatePersistentKey(const std::string& atlasName, const _ttfConfig* config, const FontFreeType* font);
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
+    static std::vector<FontAtlas*> _dirtyAtlases;
+    static bool _persistentCacheEnabled;
 };
 
 NS_CC_END
@@ -24,12 +24,15 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "2d/CCFontFreeType.h"
+#include <algorithm>
 #include FT_BBOX_H
-#include "edtaa3func.h"
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
 #include "CCFontAtlas.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
+#include "xxhash.h"
 
 NS_CC_BEGIN
 
@@ -38,6 +41,8 @@ FT_Library FontFreeType::_FTlibrary;
 bool       FontFreeType::_FTInitialized = false;
 const int  FontFreeType::DistanceMapSpread = 3;
 
+static const float DISTANCE_INFINITY = 1e20f;
+
 const char* FontFreeType::_glyphASCII = "\"!#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~¡¢£¤¥¦§¨©ª«¬­®¯°±²³´µ¶·¸¹º»¼½¾¿ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖ×ØÙÚÛÜÝÞßàáâãäåæçèéêëìíîïðñòóôõö÷øùúûüýþ ";
 const char* FontFreeType::_glyphNEHE = "!\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~ ";
 
@@ -45,6 +50,8 @@ typedef struct _DataRef
 {
     Data data;
     unsigned int referenceCount;
+    unsigned int hash;
+    bool hashed;
 }DataRef;
 
 static std::unordered_map<std::string, DataRef> s_cacheFontData;
@@ -99,6 +106,7 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /
 : _fontRef(nullptr)
 , _stroker(nullptr)
 , _distanceFieldEnabled(distanceFieldEnabled)
+, _fontSizePoints(0)
 , _outlineSize(0.0f)
 , _lineHeight(0)
 , _fontAtlas(nullptr)
@@ -131,6 +139,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     else
     {
         s_cacheFontData[fontName].referenceCount = 1;
+        s_cacheFontData[fontName].hashed = false;
         s_cacheFontData[fontName].data = FileUtils::getInstance()->getDataFromFile(fontName);    
 
         if (s_cacheFontData[fontName].data.isNull())
@@ -171,6 +180,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     int fontSizePoints = (int)(64.f * fontSize * CC_CONTENT_SCALE_FACTOR());
     if (FT_Set_Char_Size(face, fontSizePoints, fontSizePoints, dpi, dpi))
         return false;
+    _fontSizePoints = fontSizePoints;
     
     // store the face globally
     _fontRef = face;
@@ -182,6 +192,16 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
 FontFreeType::~FontFreeType()
 {
+    for (size_t i = 1; i < _threadFaces.size(); ++i)
+    {
+        if (_threadFaces[i].stroker)
+        {
+            FT_Stroker_Done(_threadFaces[i].stroker);
+        }
+        FT_Done_Face(_threadFaces[i].face);
+        FT_Done_FreeType(_threadFaces[i].library);
+    }
+
     if (_FTInitialized)
     {
         if (_stroker)
@@ -206,6 +226,11 @@ FontAtlas * FontFreeType::createFontAtlas()
     if (_fontAtlas == nullptr)
     {
         _fontAtlas = new (std::nothrow) FontAtlas(*this);
+        if (_fontAtlas && !_persistentAtlasFile.empty())
+        {
+            // before the glyph collection, so that its persisted glyphs aren't rendered again
+            _fontAtlas->loadPersistentFile(_persistentAtlasFile, _persistentAtlasKey);
+        }
         if (_fontAtlas && _usedGlyphs != GlyphCollection::DYNAMIC)
         {
             std::u16string utf16;
@@ -249,6 +274,13 @@ int * FontFreeType::getHorizontalKerningForTextUTF16(const std::u16string& text,
 
 int  FontFreeType::getHorizontalKerningForChars(unsigned short firstChar, unsigned short secondChar) const
 {
+    if (_kerningTableLetters.find(firstChar) != _kerningTableLetters.end()
+        && _kerningTableLetters.find(secondChar) != _kerningTableLetters.end())
+    {
+        auto it = _kerningTable.find((static_cast<unsigned int>(firstChar) << 16) | secondChar);
+        return it != _kerningTable.end() ? it->second : 0;
+    }
+
     // get the ID to the char we need
     int glyphIndex1 = FT_Get_Char_Index(_fontRef, firstChar);
     
@@ -269,43 +301,189 @@ int  FontFreeType::getHorizontalKerningForChars(unsigned short firstChar, unsign
     return (static_cast<int>(kerning.x >> 6));
 }
 
+void FontFreeType::setKerningTable(const std::u16string& letters, std::unordered_map<unsigned int, int> kernings)
+{
+    _kerningTableLetters.clear();
+    _kerningTableLetters.insert(letters.begin(), letters.end());
+    _kerningTable = std::move(kernings);
+}
+
+bool FontFreeType::getKerningPairs(const std::u16string& letters, std::unordered_map<unsigned int, int>* kernings) const
+{
+    if (!_fontRef || !FT_HAS_KERNING(_fontRef))
+        return false;
+
+    FT_ULong length = 0;
+    if (FT_Load_Sfnt_Table(_fontRef, TTAG_kern, 0, nullptr, &length) || length < 4)
+        return false;
+    std::vector<FT_Byte> table(length);
+    if (FT_Load_Sfnt_Table(_fontRef, TTAG_kern, 0, table.data(), &length))
+        return false;
+
+    auto readUShort = [&table](size_t offset) {
+        return static_cast<unsigned int>((table[offset] << 8) | table[offset + 1]);
+    };
+
+    // only the Microsoft version of the table is read by FreeType
+    if (readUShort(0) != 0)
+        return false;
+
+    std::unordered_map<FT_UInt, std::vector<unsigned short>> glyphLetters;
+    for (auto letter : letters)
+    {
+        FT_UInt glyphIndex = FT_Get_Char_Index(_fontRef, letter);
+        if (glyphIndex)
+            glyphLetters[glyphIndex].push_back(letter);
+    }
+
+    // the subtables are walked like FreeType does, only the horizontal format 0 ones are used
+    const unsigned int tableCount = readUShort(2);
+    size_t offset = 4;
+    for (unsigned int i = 0; i < tableCount && offset + 6 <= length; ++i)
+    {
+        size_t subtableLength = readUShort(offset + 2);
+        unsigned int coverage = readUShort(offset + 4);
+        if (subtableLength <= 14)
+            break;
+        size_t subtableEnd = std::min(offset + subtableLength, static_cast<size_t>(length));
+        if ((coverage >> 8) == 0 && (coverage & 3U) == 1 && offset + 14 <= subtableEnd)
+        {
+            size_t pairCount = readUShort(offset + 6);
+            size_t pairs = offset + 14;
+            pairCount = std::min(pairCount, (subtableEnd - pairs) / 6);
+            for (size_t pair = 0; pair < pairCount; ++pair)
+            {
+                auto first = glyphLetters.find(readUShort(pairs + pair * 6));
+                if (first == glyphLetters.end())
+                    continue;
+                auto second = glyphLetters.find(readUShort(pairs + pair * 6 + 2));
+                if (second == glyphLetters.end())
+                    continue;
+
+                // FreeType scales the value and combines the subtables
+                FT_Vector kerning;
+                if (FT_Get_Kerning(_fontRef, first->first, second->first, FT_KERNING_DEFAULT, &kerning))
+                    continue;
+                int amount = static_cast<int>(kerning.x >> 6);
+                if (amount == 0)
+                    continue;
+
+                for (auto firstLetter : first->second)
+                {
+                    for (auto secondLetter : second->second)
+                    {
+                        (*kernings)[(static_cast<unsigned int>(firstLetter) << 16) | secondLetter] = amount;
+                    }
+                }
+            }
+        }
+        offset = subtableEnd;
+    }
+    return true;
+}
+
+unsigned int FontFreeType::getFontDataHash() const
+{
+    auto& dataRef = s_cacheFontData[_fontName];
+    if (!dataRef.hashed)
+    {
+        dataRef.hash = XXH32(dataRef.data.getBytes(), static_cast<int>(dataRef.data.getSize()), 0);
+        dataRef.hashed = true;
+    }
+    return dataRef.hash;
+}
+
+void FontFreeType::setPersistentAtlasFile(const std::string& fullPath, const std::string& key)
+{
+    _persistentAtlasFile = fullPath;
+    _persistentAtlasKey = key;
+}
+
 int FontFreeType::getFontAscender() const
 {
     return (static_cast<int>(_fontRef->size->metrics.ascender >> 6));
 }
 
 unsigned char* FontFreeType::getGlyphBitmap(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance)
+{
+    FaceContext context = { _FTlibrary, _fontRef, _stroker };
+    return getGlyphBitmap(context, theChar, outWidth, outHeight, outRect, xAdvance);
+}
+
+bool FontFreeType::prepareThreadFaces(int count)
+{
+    if (_fontRef == nullptr)
+        return false;
+
+    if (_threadFaces.empty())
+    {
+        FaceContext context = { _FTlibrary, _fontRef, _stroker };
+        _threadFaces.push_back(context);
+    }
+
+    const Data& data = s_cacheFontData[_fontName].data;
+    while ((int)_threadFaces.size() < count)
+    {
+        FaceContext context = { nullptr, nullptr, nullptr };
+        if (FT_Init_FreeType(&context.library))
+            return false;
+
+        if (FT_New_Memory_Face(context.library, data.getBytes(), data.getSize(), 0, &context.face)
+            || FT_Select_Charmap(context.face, _encoding)
+            || FT_Set_Char_Size(context.face, _fontSizePoints, _fontSizePoints, 72, 72))
+        {
+            FT_Done_FreeType(context.library);
+            return false;
+        }
+
+        if (_stroker)
+        {
+            FT_Stroker_New(context.library, &context.stroker);
+            FT_Stroker_Set(context.stroker,
+                (int)(_outlineSize * 64),
+                FT_STROKER_LINECAP_ROUND,
+                FT_STROKER_LINEJOIN_ROUND,
+                0);
+        }
+        _threadFaces.push_back(context);
+    }
+
+    return true;
+}
+
+unsigned char* FontFreeType::getGlyphBitmap(const FaceContext& context, unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance)
 {
     bool invalidChar = true;
     unsigned char* ret = nullptr;
+    FT_Face fontRef = context.face;
 
     do
     {
-        if (_fontRef == nullptr)
+        if (fontRef == nullptr)
             break;
 
         if (_distanceFieldEnabled)
         {
-            if (FT_Load_Char(_fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
+            if (FT_Load_Char(fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
                 break;
         }
         else
         {
-            if (FT_Load_Char(_fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT))
+            if (FT_Load_Char(fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT))
                 break;
         }
 
-        auto& metrics = _fontRef->glyph->metrics;
+        auto& metrics = fontRef->glyph->metrics;
         outRect.origin.x = metrics.horiBearingX >> 6;
         outRect.origin.y = -(metrics.horiBearingY >> 6);
         outRect.size.width = (metrics.width >> 6);
         outRect.size.height = (metrics.height >> 6);
 
-        xAdvance = (static_cast<int>(_fontRef->glyph->metrics.horiAdvance >> 6));
+        xAdvance = (static_cast<int>(fontRef->glyph->metrics.horiAdvance >> 6));
 
-        outWidth  = _fontRef->glyph->bitmap.width;
-        outHeight = _fontRef->glyph->bitmap.rows;
-        ret = _fontRef->glyph->bitmap.buffer;
+        outWidth  = fontRef->glyph->bitmap.width;
+        outHeight = fontRef->glyph->bitmap.rows;
+        ret = fontRef->glyph->bitmap.buffer;
 
         if (_outlineSize > 0)
         {
@@ -313,7 +491,7 @@ unsigned char* FontFreeType::getGlyphBitmap(unsigned short theChar, long &outWid
             memcpy(copyBitmap,ret,outWidth * outHeight * sizeof(unsigned char));
 
             FT_BBox bbox;
-            auto outlineBitmap = getGlyphBitmapWithOutline(theChar,bbox);
+            auto outlineBitmap = getGlyphBitmapWithOutline(context, theChar, bbox);
             if(outlineBitmap == nullptr)
             {
                 ret = nullptr;
@@ -396,17 +574,17 @@ unsigned char* FontFreeType::getGlyphBitmap(unsigned short theChar, long &outWid
     }
 }
 
-unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar, FT_BBox &bbox)
+unsigned char * FontFreeType::getGlyphBitmapWithOutline(const FaceContext& context, unsigned short theChar, FT_BBox &bbox)
 {   
     unsigned char* ret = nullptr;
-    if (FT_Load_Char(_fontRef, theChar, FT_LOAD_NO_BITMAP) == 0)
+    if (FT_Load_Char(context.face, theChar, FT_LOAD_NO_BITMAP) == 0)
     {
-        if (_fontRef->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+        if (context.face->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
         {
             FT_Glyph glyph;
-            if (FT_Get_Glyph(_fontRef->glyph, &glyph) == 0)
+            if (FT_Get_Glyph(context.face->glyph, &glyph) == 0)
             {
-                FT_Glyph_StrokeBorder(&glyph, _stroker, 0, 1);
+                FT_Glyph_StrokeBorder(&glyph, context.stroker, 0, 1);
                 if (glyph->format == FT_GLYPH_FORMAT_OUTLINE)
                 {
                     FT_Outline *outline = &reinterpret_cast<FT_OutlineGlyph>(glyph)->outline;
@@ -429,7 +607,7 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar,
                     params.target = &bmp;
                     params.flags = FT_RASTER_FLAG_AA;
                     FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
+                    FT_Outline_Render(context.library, outline, &params);
 
                     ret = bmp.buffer;
                 }
@@ -441,83 +619,92 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar,
     return ret;
 }
 
+// Squared distance transform of one row or column of the grid, see "Distance Transforms of Sampled Functions"
+// by P. Felzenszwalb and D. Huttenlocher. Linear in the length, f, v and z are scratch buffers of length + 1 values.
+static void distanceTransform1D(float* grid, long offset, long stride, long length, float* f, int* v, float* z)
+{
+    v[0] = 0;
+    z[0] = -DISTANCE_INFINITY;
+    z[1] = DISTANCE_INFINITY;
+    f[0] = grid[offset];
+    for (int q = 1, k = 0; q < length; ++q)
+    {
+        f[q] = grid[offset + q * stride];
+        float s;
+        do
+        {
+            int r = v[k];
+            // the infinite values cancel out before the small ones are added
+            s = (f[q] - f[r] + q * q - r * r) / (q - r) / 2;
+        } while (s <= z[k] && --k > -1);
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = DISTANCE_INFINITY;
+    }
+    for (int q = 0, k = 0; q < length; ++q)
+    {
+        while (z[k + 1] < q)
+            ++k;
+        int r = v[k];
+        grid[offset + q * stride] = f[r] + (q - r) * (q - r);
+    }
+}
+
+static void distanceTransform2D(float* grid, long width, long height, float* f, int* v, float* z)
+{
+    for (long x = 0; x < width; ++x)
+        distanceTransform1D(grid, x, width, height, f, v, z);
+    for (long y = 0; y < height; ++y)
+        distanceTransform1D(grid, y * width, 1, width, f, v, z);
+}
+
 unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
 {
-    long pixelAmount = (width + 2 * FontFreeType::DistanceMapSpread) * (height + 2 * FontFreeType::DistanceMapSpread);
-
-    short * xdist = (short *)  malloc( pixelAmount * sizeof(short) );
-    short * ydist = (short *)  malloc( pixelAmount * sizeof(short) );
-    double * gx   = (double *) calloc( pixelAmount, sizeof(double) );
-    double * gy      = (double *) calloc( pixelAmount, sizeof(double) );
-    double * data    = (double *) calloc( pixelAmount, sizeof(double) );
-    double * outside = (double *) calloc( pixelAmount, sizeof(double) );
-    double * inside  = (double *) calloc( pixelAmount, sizeof(double) );
-    long i,j;
-
-    // Convert img into double (data) rescale image levels between 0 and 1
     long outWidth = width + 2 * FontFreeType::DistanceMapSpread;
-    for (i = 0; i < width; ++i)
+    long outHeight = height + 2 * FontFreeType::DistanceMapSpread;
+    long pixelAmount = outWidth * outHeight;
+    long maxLength = std::max(outWidth, outHeight) + 1;
+
+    // squared distances to the closest pixel outside (inside) the glyph, the spread around the glyph is outside.
+    // Pixels partly covered start at the distance from their center to an edge given by their coverage.
+    std::vector<float> outside(pixelAmount, DISTANCE_INFINITY);
+    std::vector<float> inside(pixelAmount, 0.0f);
+    for (long j = 0; j < height; ++j)
     {
-        for (j = 0; j < height; ++j)
+        const unsigned char* src = img + j * width;
+        long index = (j + FontFreeType::DistanceMapSpread) * outWidth + FontFreeType::DistanceMapSpread;
+        for (long i = 0; i < width; ++i, ++index)
         {
-            data[j * outWidth + FontFreeType::DistanceMapSpread + i] = img[j * width + i] / 255.0;
+            unsigned char coverage = src[i];
+            if (coverage == 255)
+            {
+                outside[index] = 0.0f;
+                inside[index] = DISTANCE_INFINITY;
+            }
+            else if (coverage > 0)
+            {
+                float d = 0.5f - coverage / 255.0f;
+                outside[index] = d > 0.0f ? d * d : 0.0f;
+                inside[index] = d < 0.0f ? d * d : 0.0f;
+            }
         }
     }
 
-    width += 2 * FontFreeType::DistanceMapSpread;
-    height += 2 * FontFreeType::DistanceMapSpread;
-
-    // Transform background (outside contour, in areas of 0's)   
-    computegradient( data, (int)width, (int)height, gx, gy);
-    edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, outside);
-    for( i=0; i< pixelAmount; i++)
-        if( outside[i] < 0.0 )
-            outside[i] = 0.0;
-
-    // Transform foreground (inside contour, in areas of 1's)   
-    for( i=0; i< pixelAmount; i++)
-        data[i] = 1 - data[i];
-    computegradient( data, (int)width, (int)height, gx, gy);
-    edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, inside);
-    for( i=0; i< pixelAmount; i++)
-        if( inside[i] < 0.0 )
-            inside[i] = 0.0;
-
-    // The bipolar distance field is now outside-inside
-    double dist;
-    /* Single channel 8-bit output (bad precision and range, but simple) */    
+    std::vector<float> f(maxLength);
+    std::vector<float> z(maxLength + 1);
+    std::vector<int> v(maxLength);
+    distanceTransform2D(outside.data(), outWidth, outHeight, f.data(), v.data(), z.data());
+    distanceTransform2D(inside.data(), outWidth, outHeight, f.data(), v.data(), z.data());
+
+    /* Single channel 8-bit output (bad precision and range, but simple) */
     unsigned char *out = (unsigned char *) malloc( pixelAmount * sizeof(unsigned char) );
-    for( i=0; i < pixelAmount; i++)
-    {
-        dist = outside[i] - inside[i];
-        dist = 128.0 - dist*16;
-        if( dist < 0 ) dist = 0;
-        if( dist > 255 ) dist = 255;
-        out[i] = (unsigned char) dist;
-    }
-    /* Dual channel 16-bit output (more complicated, but good precision and range) */
-    /*unsigned char *out = (unsigned char *) malloc( pixelAmount * 3 * sizeof(unsigned char) ); 
-    for( i=0; i< pixelAmount; i++)
-    {
-        dist = outside[i] - inside[i];
-        dist = 128.0 - dist*16;
-        if( dist < 0.0 ) dist = 0.0;
-        if( dist >= 256.0 ) dist = 255.999;
-        // R channel is a copy of the original grayscale image
-        out[3*i] = img[i];
-        // G channel is fraction
-        out[3*i + 1] = (unsigned char) ( 256 - (dist - floor(dist)* 256.0 ));
-        // B channel is truncated integer part
-        out[3*i + 2] = (unsigned char)dist; 
-    }*/
-    
-    free( xdist );
-    free( ydist );
-    free( gx );
-    free( gy );
-    free( data );
-    free( outside );
-    free( inside );
+    for (long i = 0; i < pixelAmount; ++i)
+    {
+        // the bipolar distance field is outside - inside
+        float dist = 128.0f - (sqrtf(outside[i]) - sqrtf(inside[i])) * 16.0f;
+        out[i] = static_cast<unsigned char>(std::min(std::max(dist, 0.0f), 255.0f));
+    }
 
     return out;
 }
@@ -602,6 +789,52 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
     } 
 }
 
+void FontFreeType::rasterizeGlyph(unsigned short charCode, int threadIndex, GlyphBitmap& glyph)
+{
+    FaceContext context = { _FTlibrary, _fontRef, _stroker };
+    if (threadIndex > 0)
+    {
+        CCASSERT(threadIndex < (int)_threadFaces.size(), "prepareThreadFaces() wasn't called for this thread index");
+        context = _threadFaces[threadIndex];
+    }
+
+    long bitmapWidth = 0;
+    long bitmapHeight = 0;
+    auto bitmap = getGlyphBitmap(context, charCode, bitmapWidth, bitmapHeight, glyph.rect, glyph.xAdvance);
+    glyph.valid = bitmap && bitmapWidth > 0 && bitmapHeight > 0;
+    glyph.bitmapWidth = bitmapWidth;
+    glyph.bitmapHeight = bitmapHeight;
+    glyph.pixelsWide = 0;
+    glyph.pixelsHigh = 0;
+    glyph.pixels.clear();
+
+    if (glyph.valid)
+    {
+        // the same pixels as renderCharAt()
+        if (_distanceFieldEnabled)
+        {
+            auto distanceMap = makeDistanceMap(bitmap, bitmapWidth, bitmapHeight);
+            glyph.pixelsWide = bitmapWidth + 2 * DistanceMapSpread;
+            glyph.pixelsHigh = bitmapHeight + 2 * DistanceMapSpread;
+            glyph.pixels.assign(distanceMap, distanceMap + glyph.pixelsWide * glyph.pixelsHigh);
+            free(distanceMap);
+        }
+        else
+        {
+            long bytesPerPixel = _outlineSize > 0 ? 2 : 1;
+            glyph.pixelsWide = bitmapWidth;
+            glyph.pixelsHigh = bitmapHeight;
+            glyph.pixels.assign(bitmap, bitmap + bitmapWidth * bitmapHeight * bytesPerPixel);
+        }
+    }
+
+    // with an outline, the bitmap is a blend image allocated by getGlyphBitmap()
+    if (bitmap && _outlineSize > 0)
+    {
+        delete [] bitmap;
+    }
+}
+
 void FontFreeType::setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs /* = nullptr */)
 {
     _usedGlyphs = glyphs;
@@ -31,6 +31,9 @@
 #include "CCFont.h"
 
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <ft2build.h>
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -69,9 +72,62 @@ public:
     int* getHorizontalKerningForTextUTF16(const std::u16string& text, int &outNumLetters) const override;
     
     unsigned char* getGlyphBitmap(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
+
+    /** A glyph rendered by rasterizeGlyph(), with the pixels renderCharAt() would copy into an atlas page. */
+    struct GlyphBitmap
+    {
+        std::vector<unsigned char> pixels;  // pixelsWide * pixelsHigh pixels, 2 bytes per pixel with an outline
+        long pixelsWide;
+        long pixelsHigh;
+        long bitmapWidth;                   // size returned by getGlyphBitmap(), without the distance map spread
+        long bitmapHeight;
+        Rect rect;
+        int xAdvance;
+        bool valid;
+    };
+
+    /** Renders a glyph with its outline or distance map into a buffer owned by the GlyphBitmap.
+     * Threads may render glyphs at the same time as long as they use different thread indices.
+     * Index 0 uses the face used by the other methods, the others need prepareThreadFaces().
+     * @since v3.10
+     */
+    void rasterizeGlyph(unsigned short charCode, int threadIndex, GlyphBitmap& glyph);
+
+    /** Creates the FreeType library, face and stroker of the thread indices 1 to count - 1.
+     * Each thread gets its own library, since a library can't be used by several threads at the same time.
+     * @return False if they couldn't be created, then only index 0 can be used.
+     * @since v3.10
+     */
+    bool prepareThreadFaces(int count);
     
     int getFontAscender() const;
 
+    /** Returns a hash of the font file, to tell whether a file saved for it is still valid.
+     * @since v3.10
+     */
+    unsigned int getFontDataHash() const;
+
+    /** Sets the file createFontAtlas() reads the atlas from, see FontAtlas::loadPersistentFile().
+     * @since v3.10
+     */
+    void setPersistentAtlasFile(const std::string& fullPath, const std::string& key);
+
+    /** Returns true if the font has a kerning table. */
+    bool hasKerning() const { return _fontRef && FT_HAS_KERNING(_fontRef) != 0; }
+
+    /** Sets the kerning of all the pairs of the given letters, the pairs missing from kernings have none.
+     * The kerning of these pairs is then read from the table instead of FreeType.
+     * @since v3.10
+     */
+    void setKerningTable(const std::u16string& letters, std::unordered_map<unsigned int, int> kernings);
+    /** Adds the kerning of the pairs of the given letters which have one to kernings, keyed by (first << 16) | second.
+     * The pairs are read from the kern table of the font, so FreeType is only asked about the pairs it defines.
+     * @return false if the font has no kern table which can be read this way, e.g. it isn't a TrueType font.
+     * @since v3.10
+     */
+    bool getKerningPairs(const std::u16string& letters, std::unordered_map<unsigned int, int>* kernings) const;
+    int getHorizontalKerningForChars(unsigned short firstChar, unsigned short secondChar) const;
+
     virtual FontAtlas* createFontAtlas() override;
     virtual int getFontMaxHeight() const override { return _lineHeight; }
 private:
@@ -83,13 +139,20 @@ private:
     FontFreeType(bool distanceFieldEnabled = false, int outline = 0);
     virtual ~FontFreeType();
 
+    struct FaceContext
+    {
+        FT_Library library;
+        FT_Face face;
+        FT_Stroker stroker;
+    };
+
     bool createFontObject(const std::string &fontName, float fontSize);
 
     bool initFreeType();
     FT_Library getFTLibrary();
     
-    int getHorizontalKerningForChars(unsigned short firstChar, unsigned short secondChar) const;
-    unsigned char* getGlyphBitmapWithOutline(unsigned short code, FT_BBox &bbox);
+    unsigned char* getGlyphBitmap(const FaceContext& context, unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance);
+    unsigned char* getGlyphBitmapWithOutline(const FaceContext& context, unsigned short code, FT_BBox &bbox);
 
     void setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs = nullptr);
     const char* getGlyphCollection() const;
@@ -99,6 +162,8 @@ private:
     FT_Encoding _encoding;
 
     std::string _fontName;
+    int _fontSizePoints;
+    std::vector<FaceContext> _threadFaces;
     bool _distanceFieldEnabled;
     float _outlineSize;
     int _lineHeight;
@@ -106,6 +171,11 @@ private:
 
     GlyphCollection _usedGlyphs;
     std::string _customGlyphs;
+
+    std::string _persistentAtlasFile;
+    std::string _persistentAtlasKey;
+    std::unordered_set<unsigned short> _kerningTableLetters;
+    std::unordered_map<unsigned int, int> _kerningTable;
 };
 
 /// @endcond
@@ -1436,10 +1436,11 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
         }
         else
         {
-            _customCommand.init(_globalZOrder, transform, flags);
-            _customCommand.func = CC_CALLBACK_0(Label::onDraw, this, transform, transformUpdated);
+            auto customCommand = renderer->generateTransientCustomCommand();
+            customCommand->init(_globalZOrder, transform, flags);
+            customCommand->func = CC_CALLBACK_0(Label::onDraw, this, transform, transformUpdated);
 
-            renderer->addCommand(&_customCommand);
+            renderer->addCommand(customCommand);
         }
     }
 }
@@ -660,7 +660,6 @@ protected:
     Color4F _textColorF;
 
     QuadCommand _quadCommand;
-    CustomCommand _customCommand;
     Mat4  _shadowTransform;
     GLuint _uniformEffectColor;
     GLuint _uniformTextColor;
@@ -37,13 +37,16 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCParallelTaskPool.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "3d/CCAABB.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 #include "deprecated/CCString.h"
 
@@ -64,9 +67,44 @@ bool nodeComparisonLess(Node* n1, Node* n2)
            );
 }
 
+// Number of elements the binary insertion of sortNodes() may move per node before it gives up and uses std::sort
+static const ssize_t SORT_NODES_MAX_MOVES_PER_NODE = 16;
+
+void sortNodes(Vector<Node*>& nodes)
+{
+    if (nodes.size() < 2)
+        return;
+
+    auto first = nodes.begin();
+    auto last = nodes.end();
+    ssize_t movesLeft = nodes.size() * SORT_NODES_MAX_MOVES_PER_NODE;
+
+    // [first, it) is always sorted, so only nodes that are out of place are searched for
+    for (auto it = first + 1; it != last; ++it)
+    {
+        if (!nodeComparisonLess(*it, *(it - 1)))
+            continue;
+
+        auto node = *it;
+        auto position = std::upper_bound(first, it, node, nodeComparisonLess);
+        movesLeft -= (it - position);
+        if (movesLeft < 0)
+        {
+            std::sort(first, last, nodeComparisonLess);
+            return;
+        }
+
+        std::move_backward(position, it, it + 1);
+        *position = node;
+    }
+}
+
 // FIXME:: Yes, nodes might have a sort problem once every 15 days if the game runs at 60 FPS and each frame sprites are reordered.
 int Node::s_globalOrderOfArrival = 1;
 
+// fewer children than this per task are not worth waking up a worker thread
+static const ssize_t PARALLEL_VISIT_MIN_CHILDREN_PER_TASK = 256;
+
 // MARK: Constructor, Destructor, Init
 
 Node::Node()
@@ -106,6 +144,13 @@ Node::Node()
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _parallelVisitEnabled(false)
+, _transformCache(nullptr)
+, _subtreeBoundsDirty(true)
+, _subtreeCullingEnabled(false)
+, _subtreeCulled(false)
+, _touchBoundsCount(0)
+, _touchBoundsDirty(false)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -178,6 +223,7 @@ Node::~Node()
     removeAllComponents();
     
     CC_SAFE_DELETE(_componentContainer);
+    CC_SAFE_DELETE(_transformCache);
     
     stopAllActions();
     unscheduleAllCallbacks();
@@ -241,6 +287,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 float Node::getSkewY() const
@@ -255,6 +302,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 void Node::setLocalZOrder(int z)
@@ -302,6 +350,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
     
     updateRotationQuat();
 }
@@ -319,6 +368,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -370,6 +420,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -384,6 +435,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
     
     updateRotationQuat();
 }
@@ -400,6 +452,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
     
     updateRotationQuat();
 }
@@ -419,6 +472,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 /// scaleX getter
@@ -436,6 +490,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 /// scaleX setter
@@ -446,6 +501,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 /// scaleY getter
@@ -462,6 +518,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 /// scaleY getter
@@ -478,6 +535,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 
@@ -508,6 +566,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
     _usingNormalizedPosition = false;
 }
 
@@ -553,6 +612,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 
     _positionZ = positionZ;
 }
@@ -573,6 +633,7 @@ void Node::setNormalizedPosition(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -615,6 +676,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setParentSubtreeBoundsDirty();
     }
 }
 
@@ -632,6 +694,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        setSubtreeBoundsDirty();
     }
 }
 
@@ -644,8 +707,10 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    setParentSubtreeBoundsDirty();
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 /// isRelativeAnchorPoint getter
@@ -660,6 +725,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setParentSubtreeBoundsDirty();
     }
 }
 
@@ -1122,11 +1188,33 @@ void Node::reorderChild(Node *child, int zOrder)
     child->_localZOrder = zOrder;
 }
 
+void Node::reorderChildren(const std::vector<std::pair<Node*, int>>& childrenZOrders)
+{
+    bool reordered = false;
+    for (const auto& childZOrder : childrenZOrders)
+    {
+        Node* child = childZOrder.first;
+        CCASSERT(child != nullptr && child->_parent == this, "Child must be non-nil and a child of this node");
+        if (child->_localZOrder == childZOrder.second)
+            continue;
+
+        reorderChild(child, childZOrder.second);
+        child->_localZOrder = childZOrder.second;
+        reordered = true;
+    }
+
+    if (reordered)
+    {
+        // marks the children as well
+        _eventDispatcher->setDirtyForNode(this);
+    }
+}
+
 void Node::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        sortNodes(_children);
         _reorderChildDirty = false;
     }
 }
@@ -1171,17 +1259,22 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
 //    if (!isVisitableByVisitingCamera())
 //        return parentFlags;
     
-    uint32_t flags = parentFlags;
+    // FLAGS_TRANSFORM_CACHED only applies to this node, not to its children
+    uint32_t flags = parentFlags & ~FLAGS_TRANSFORM_CACHED;
     flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
     flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
     
 
-    if(flags & FLAGS_DIRTY_MASK)
+    if((flags & FLAGS_DIRTY_MASK) && !(parentFlags & FLAGS_TRANSFORM_CACHED))
         _modelViewTransform = this->transform(parentTransform);
     
     _transformUpdated = false;
     _contentSizeDirty = false;
 
+    // the touch broadphase follows the world bounds of the nodes with touch listeners
+    if (_touchBoundsCount > 0 && (flags & (FLAGS_TRANSFORM_DIRTY | FLAGS_CONTENT_SIZE_DIRTY)))
+        _eventDispatcher->setTouchBoundsDirty(this);
+
     return flags;
 }
 
@@ -1202,11 +1295,35 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
 
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
+#if CC_USE_CULLING
+    if (_subtreeCullingEnabled)
+    {
+        if (!isSubtreeVisible(renderer))
+        {
+            _subtreeCulled = true;
+            return;
+        }
+
+        // the descendants missed the transform changes while the subtree was culled
+        if (_subtreeCulled)
+        {
+            flags |= FLAGS_TRANSFORM_DIRTY;
+            _subtreeCulled = false;
+        }
+    }
+#endif
+
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
-    // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    // but it is deprecated and your code should not rely on it.
+    // The stack is not thread safe, so it is not updated by nodes visited on worker threads,
+    // nor by nodes whose parent caches the transforms of its children.
+    bool useMatrixStack = !(flags & (FLAGS_PARALLEL_VISIT | FLAGS_NO_MATRIX_STACK));
+    if (useMatrixStack)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     bool visibleByCamera = isVisitableByVisitingCamera();
 
@@ -1215,29 +1332,50 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     if(!_children.empty())
     {
         sortAllChildren();
-        // draw children zOrder < 0
-        for( ; i < _children.size(); i++ )
-        {
-            auto node = _children.at(i);
 
-            if (node && node->_localZOrder < 0)
-                node->visit(renderer, _modelViewTransform, flags);
-            else
-                break;
+        if (_transformCache)
+            updateChildrenTransforms(flags);
+
+        if (_parallelVisitEnabled && !(flags & FLAGS_PARALLEL_VISIT))
+        {
+            ssize_t count = _children.size();
+            while (i < count && _children.at(i)->_localZOrder < 0)
+                ++i;
+
+            visitChildrenInParallel(renderer, 0, i, flags);
+            if (visibleByCamera)
+                this->draw(renderer, _modelViewTransform, flags);
+            visitChildrenInParallel(renderer, i, count, flags);
         }
-        // self draw
-        if (visibleByCamera)
-            this->draw(renderer, _modelViewTransform, flags);
+        else
+        {
+            // draw children zOrder < 0
+            for( ; i < _children.size(); i++ )
+            {
+                auto node = _children.at(i);
 
-        for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+                if (node && node->_localZOrder < 0)
+                    node->visit(renderer, _modelViewTransform, getChildVisitFlags(i, flags));
+                else
+                    break;
+            }
+            // self draw
+            if (visibleByCamera)
+                this->draw(renderer, _modelViewTransform, flags);
+
+            for(ssize_t count = _children.size(); i < count; ++i)
+                _children.at(i)->visit(renderer, _modelViewTransform, getChildVisitFlags(i, flags));
+        }
     }
     else if (visibleByCamera)
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (useMatrixStack)
+    {
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1245,6 +1383,154 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+void Node::visitChildrenInParallel(Renderer* renderer, ssize_t first, ssize_t last, uint32_t flags)
+{
+    auto pool = ParallelTaskPool::getInstance();
+    ssize_t count = last - first;
+    int taskCount = (int)std::min((ssize_t)pool->getWorkerCount() + 1, count / PARALLEL_VISIT_MIN_CHILDREN_PER_TASK);
+
+    if (taskCount <= 1)
+    {
+        for (ssize_t i = first; i < last; ++i)
+            _children.at(i)->visit(renderer, _modelViewTransform, getChildVisitFlags(i, flags));
+        return;
+    }
+
+    // the visiting camera computes its matrices lazily, update them here so the tasks only read them
+    auto camera = Camera::getVisitingCamera();
+    if (camera)
+    {
+        AABB aabb;
+        camera->getViewProjectionMatrix();
+        camera->isVisibleInFrustum(&aabb);
+    }
+
+    // every task records a contiguous range of children into its own queue,
+    // the queues are appended in task order by endParallelRecording()
+    renderer->beginParallelRecording(taskCount);
+    pool->run(taskCount, [=](int task) {
+        ssize_t begin = first + count * task / taskCount;
+        ssize_t end = first + count * (task + 1) / taskCount;
+
+        renderer->setRecordingQueue(task);
+        for (ssize_t i = begin; i < end; ++i)
+            _children.at(i)->visit(renderer, _modelViewTransform, getChildVisitFlags(i, flags) | FLAGS_PARALLEL_VISIT);
+        renderer->setRecordingQueue(-1);
+    });
+    renderer->endParallelRecording();
+}
+
+bool Node::isSubtreeVisible(Renderer* renderer)
+{
+    const Rect& bounds = getSubtreeBoundingBox();
+    if (bounds.size.equals(Size::ZERO))
+        return true;
+
+    Mat4 transform = _modelViewTransform;
+    transform.translate(bounds.origin.x, bounds.origin.y, 0);
+    return renderer->checkVisibility(transform, bounds.size);
+}
+
+const Rect& Node::getSubtreeBoundingBox()
+{
+    if (_subtreeBoundsDirty)
+    {
+        Rect bounds(Vec2::ZERO, _contentSize);
+        bool empty = _contentSize.equals(Size::ZERO);
+        for (const auto& child : _children)
+        {
+            // the bounding boxes of the children that didn't change are cached
+            const Rect& childBounds = child->getSubtreeBoundingBox();
+            if (childBounds.size.equals(Size::ZERO))
+                continue;
+
+            Rect rect = RectApplyTransform(childBounds, child->getNodeToParentTransform());
+            bounds = empty ? rect : bounds.unionWithRect(rect);
+            empty = false;
+        }
+
+        _subtreeBounds = bounds;
+        _subtreeBoundsDirty = false;
+    }
+    return _subtreeBounds;
+}
+
+void Node::setSubtreeBoundsDirty()
+{
+    // the ancestors of a dirty node are dirty too, so the walk stops at the first dirty node
+    for (Node* node = this; node && !node->_subtreeBoundsDirty; node = node->_parent)
+    {
+        node->_subtreeBoundsDirty = true;
+    }
+}
+
+void Node::setTransformCacheEnabled(bool enabled)
+{
+    if (enabled && !_transformCache)
+    {
+        _transformCache = new (std::nothrow) TransformCache();
+    }
+    else if (!enabled)
+    {
+        CC_SAFE_DELETE(_transformCache);
+    }
+}
+
+void Node::updateChildrenTransforms(uint32_t flags)
+{
+    auto& cache = *_transformCache;
+    ssize_t count = _children.size();
+    if ((ssize_t)cache.children.size() != count)
+    {
+        cache.children.resize(count, nullptr);
+        cache.localTransforms.resize(count);
+        cache.modelViewTransforms.resize(count);
+        cache.childFlags.resize(count);
+    }
+
+    // Find the children that need a new model view transform. Their local transform is refreshed,
+    // the local transforms of the others are kept from the previous frames.
+    bool parentDirty = (flags & FLAGS_DIRTY_MASK) != 0;
+    cache.dirtyChildren.clear();
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        auto child = _children.at(i);
+        if (!child->_visible || child->_usingNormalizedPosition)
+        {
+            // the child computes its transform itself, if it is visited at all
+            cache.children[i] = nullptr;
+            cache.childFlags[i] = FLAGS_NO_MATRIX_STACK;
+            continue;
+        }
+
+        if (cache.children[i] != child || child->_transformUpdated)
+        {
+            cache.children[i] = child;
+            cache.localTransforms[i] = child->getNodeToParentTransform();
+            cache.dirtyChildren.push_back(i);
+        }
+        else if (parentDirty)
+        {
+            cache.dirtyChildren.push_back(i);
+        }
+        else
+        {
+            cache.childFlags[i] = FLAGS_NO_MATRIX_STACK | FLAGS_TRANSFORM_CACHED;
+        }
+    }
+
+    // multiply the contiguous matrices, then hand the results to the children
+    for (auto i : cache.dirtyChildren)
+    {
+        Mat4::multiply(_modelViewTransform, cache.localTransforms[i], &cache.modelViewTransforms[i]);
+    }
+    for (auto i : cache.dirtyChildren)
+    {
+        _children.at(i)->_modelViewTransform = cache.modelViewTransforms[i];
+        cache.childFlags[i] = FLAGS_NO_MATRIX_STACK | FLAGS_TRANSFORM_CACHED | FLAGS_TRANSFORM_DIRTY;
+    }
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
@@ -1744,6 +2030,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    setParentSubtreeBoundsDirty();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1765,6 +2052,7 @@ void Node::setAdditionalTransform(Mat4* additionalTransform)
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setParentSubtreeBoundsDirty();
 }
 
 
@@ -73,6 +73,13 @@ enum {
 
 bool CC_DLL nodeComparisonLess(Node* n1, Node* n2);
 
+/**
+ * Sorts the nodes by local z order, then by order of arrival, the same order `nodeComparisonLess` gives.
+ * Nodes that are out of place are moved with a binary insertion, so when only a few nodes were added or
+ * reordered since the last sort it runs in about linear time. It falls back to `std::sort` otherwise.
+ */
+void CC_DLL sortNodes(Vector<Node*>& nodes);
+
 class EventListener;
 
 /** @class Node
@@ -112,6 +119,9 @@ public:
         FLAGS_TRANSFORM_DIRTY = (1 << 0),
         FLAGS_CONTENT_SIZE_DIRTY = (1 << 1),
         FLAGS_RENDER_AS_3D = (1 << 3),
+        FLAGS_PARALLEL_VISIT = (1 << 4),
+        FLAGS_TRANSFORM_CACHED = (1 << 5),
+        FLAGS_NO_MATRIX_STACK = (1 << 6),
 
         FLAGS_DIRTY_MASK = (FLAGS_TRANSFORM_DIRTY | FLAGS_CONTENT_SIZE_DIRTY),
     };
@@ -923,6 +933,16 @@ public:
      */
     virtual void reorderChild(Node * child, int localZOrder);
 
+    /**
+     * Sets the local z order of many children at once.
+     * The children are only sorted once before the next draw, and the event dispatcher is notified
+     * once for the whole container instead of once per child, as calling `setLocalZOrder` in a loop does.
+     *
+     * @param childrenZOrders   Pairs of an already added child and its new local z order.
+     * @note The children's `setLocalZOrder` is not called, only `reorderChild`.
+     */
+    void reorderChildren(const std::vector<std::pair<Node*, int>>& childrenZOrders);
+
     /**
      * Sorts the children array once before drawing, instead of every time when a child is added or reordered.
      * This approach can improves the performance massively.
@@ -1153,6 +1173,71 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Enables visiting the children of this node on the threads of `ParallelTaskPool`.
+     * Each thread visits a contiguous range of children and records its commands into its own render queue,
+     * the queues are merged in children order so the draw order is the same as a serial visit.
+     * The deprecated Director matrix stack is not updated while visiting those children.
+     *
+     * @note Only use it for children whose visit() and draw() just update their own state and add render commands,
+     * like `Sprite`s. Nodes that push render groups (`ClippingNode`, `RenderTexture`, `NodeGrid`...), rebuild
+     * their content while being visited (`Label`) or read the matrix stack are not supported.
+     * @param enabled True to visit the children in parallel.
+     */
+    void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+    /**
+     * Whether the children of this node are visited in parallel.
+     *
+     * @return True if the children of this node are visited in parallel.
+     */
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
+    /**
+     * Enables caching the transforms of the children of this node in contiguous arrays.
+     * Before the children are visited, the model view transforms of the children that moved (or of all of them
+     * if this node moved) are computed in a single pass, and the children and their descendants don't update
+     * the deprecated Director matrix stack. Static children cost no matrix operation at all.
+     *
+     * @note Meant for containers of many children, like big layers of sprites.
+     * Don't use it if the children, or their descendants, read the matrix stack.
+     * @param enabled True to cache the transforms of the children.
+     */
+    void setTransformCacheEnabled(bool enabled);
+    /**
+     * Whether the transforms of the children of this node are cached.
+     *
+     * @return True if the transforms of the children of this node are cached.
+     */
+    bool isTransformCacheEnabled() const { return _transformCache != nullptr; }
+
+    /**
+     * Enables culling the whole subtree of this node when it is off-screen.
+     * The node keeps the bounding box of its content and of all its descendants, rebuilt only when one of them
+     * moved, was resized, added or removed. When that box is not visible by the default camera, visit() returns
+     * before transforming, sorting or drawing this node and its descendants.
+     *
+     * @note Meant for big containers whose content is mostly off-screen, like the chunks of a scrolling world.
+     * The box is built from the content sizes of the nodes, so the subtree must not contain nodes that draw
+     * outside of their content size, like `ParticleSystem` or `DrawNode`. Only `Node::visit()` culls, subclasses
+     * overriding visit() (like `SpriteBatchNode`) should be put inside a culled container instead.
+     * @param enabled True to cull the subtree of this node when it is off-screen.
+     */
+    void setSubtreeCullingEnabled(bool enabled) { _subtreeCullingEnabled = enabled; }
+    /**
+     * Whether the subtree of this node is culled when it is off-screen.
+     *
+     * @return True if the subtree of this node is culled when it is off-screen.
+     */
+    bool isSubtreeCullingEnabled() const { return _subtreeCullingEnabled; }
+
+    /**
+     * Returns the bounding box of the content of this node and of all its descendants, in the coordinates of this node.
+     * It is cached, and only recomputed for the parts of the subtree that changed.
+     *
+     * @return The bounding box of the subtree, `Rect::ZERO` if no node of the subtree has a content size.
+     */
+    const Rect& getSubtreeBoundingBox();
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1737,6 +1822,27 @@ protected:
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
 
+    /// Visits children in [first, last) on the threads of ParallelTaskPool.
+    void visitChildrenInParallel(Renderer* renderer, ssize_t first, ssize_t last, uint32_t flags);
+
+    /// Computes the model view transforms of the children that need it, see setTransformCacheEnabled().
+    void updateChildrenTransforms(uint32_t flags);
+    /// Whether the bounding box of the subtree is visible by the visiting camera, see setSubtreeCullingEnabled().
+    bool isSubtreeVisible(Renderer* renderer);
+    /// Marks the subtree bounding box of this node and of its ancestors dirty, when the content of this node changed.
+    void setSubtreeBoundsDirty();
+    /// Marks the subtree bounding boxes of the ancestors dirty, when this node moved inside of its parent.
+    void setParentSubtreeBoundsDirty()
+    {
+        if (_parent)
+            _parent->setSubtreeBoundsDirty();
+    }
+    /// Flags passed to the child at `index` when this node is visited with `flags`.
+    uint32_t getChildVisitFlags(ssize_t index, uint32_t flags) const
+    {
+        return _transformCache ? flags | _transformCache->childFlags[index] : flags;
+    }
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -1830,6 +1936,24 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _parallelVisitEnabled;       ///< children are visited on worker threads
+
+    /// transforms of the children, stored by child index
+    struct TransformCache
+    {
+        std::vector<Node*> children;            ///< child the entry was computed for, only used to detect changes
+        std::vector<Mat4> localTransforms;      ///< node to parent transform of each child
+        std::vector<Mat4> modelViewTransforms;  ///< model view transform of each child
+        std::vector<uint32_t> childFlags;       ///< flags added to the visit flags of each child
+        std::vector<ssize_t> dirtyChildren;     ///< children whose model view transform is recomputed this frame
+    };
+    TransformCache* _transformCache;  ///< nullptr unless the transforms of the children are cached
+    Rect _subtreeBounds;              ///< bounding box of the content and of the descendants, in local coordinates
+    bool _subtreeBoundsDirty;         ///< _subtreeBounds must be recomputed. The ancestors of a dirty node are dirty too
+    bool _subtreeCullingEnabled;      ///< the subtree isn't visited when _subtreeBounds is off-screen
+    bool _subtreeCulled;              ///< the subtree was culled by the last visit
+    unsigned int _touchBoundsCount;   ///< number of listeners in the touch broadphase of the event dispatcher
+    bool _touchBoundsDirty;           ///< the world bounds of the node changed since the touch broadphase was updated
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -1871,6 +1995,9 @@ public:
     friend class PhysicsBody;
 #endif
 
+    // the touch broadphase updates _touchBoundsCount and _touchBoundsDirty
+    friend class EventDispatcher;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
@@ -121,9 +121,10 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t p
         _nodeGrid->set2DProjection();
     }
 
-    _gridBeginCommand.init(_globalZOrder);
-    _gridBeginCommand.func = CC_CALLBACK_0(NodeGrid::onGridBeginDraw, this);
-    renderer->addCommand(&_gridBeginCommand);
+    auto gridBeginCommand = renderer->generateTransientCustomCommand();
+    gridBeginCommand->init(_globalZOrder);
+    gridBeginCommand->func = CC_CALLBACK_0(NodeGrid::onGridBeginDraw, this);
+    renderer->addCommand(gridBeginCommand);
 
 
     if(_gridTarget)
@@ -170,9 +171,10 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t p
         director->setProjection(beforeProjectionType);
     }
 
-    _gridEndCommand.init(_globalZOrder);
-    _gridEndCommand.func = CC_CALLBACK_0(NodeGrid::onGridEndDraw, this);
-    renderer->addCommand(&_gridEndCommand);
+    auto gridEndCommand = renderer->generateTransientCustomCommand();
+    gridEndCommand->init(_globalZOrder);
+    gridEndCommand->func = CC_CALLBACK_0(NodeGrid::onGridEndDraw, this);
+    renderer->addCommand(gridEndCommand);
 
     renderer->popGroup();
  
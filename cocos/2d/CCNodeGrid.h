@@ -100,8 +100,6 @@ protected:
     Node* _gridTarget;
     GridBase* _nodeGrid;
     GroupCommand _groupCommand;
-    CustomCommand _gridBeginCommand;
-    CustomCommand _gridEndCommand;
     
     Rect _gridRect;
 
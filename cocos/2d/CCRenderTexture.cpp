@@ -338,9 +338,11 @@ void RenderTexture::beginWithClear(float r, float g, float b, float a, float dep
     this->begin();
 
     //clear screen
-    _beginWithClearCommand.init(_globalZOrder);
-    _beginWithClearCommand.func = CC_CALLBACK_0(RenderTexture::onClear, this);
-    Director::getInstance()->getRenderer()->addCommand(&_beginWithClearCommand);
+    Renderer *renderer = Director::getInstance()->getRenderer();
+    auto beginWithClearCommand = renderer->generateTransientCustomCommand();
+    beginWithClearCommand->init(_globalZOrder);
+    beginWithClearCommand->func = CC_CALLBACK_0(RenderTexture::onClear, this);
+    renderer->addCommand(beginWithClearCommand);
 }
 
 //TODO: find a better way to clear the screen, there is no need to rebind render buffer there.
@@ -356,10 +358,12 @@ void RenderTexture::clearDepth(float depthValue)
 
     this->begin();
 
-    _clearDepthCommand.init(_globalZOrder);
-    _clearDepthCommand.func = CC_CALLBACK_0(RenderTexture::onClearDepth, this);
+    Renderer *renderer = Director::getInstance()->getRenderer();
+    auto clearDepthCommand = renderer->generateTransientCustomCommand();
+    clearDepthCommand->init(_globalZOrder);
+    clearDepthCommand->func = CC_CALLBACK_0(RenderTexture::onClearDepth, this);
 
-    Director::getInstance()->getRenderer()->addCommand(&_clearDepthCommand);
+    renderer->addCommand(clearDepthCommand);
 
     this->end();
 }
@@ -675,9 +679,10 @@ void RenderTexture::draw(Renderer *renderer, const Mat4 &transform, uint32_t fla
         begin();
 
         //clear screen
-        _clearCommand.init(_globalZOrder);
-        _clearCommand.func = CC_CALLBACK_0(RenderTexture::onClear, this);
-        renderer->addCommand(&_clearCommand);
+        auto clearCommand = renderer->generateTransientCustomCommand();
+        clearCommand->init(_globalZOrder);
+        clearCommand->func = CC_CALLBACK_0(RenderTexture::onClear, this);
+        renderer->addCommand(clearCommand);
 
         //! make sure all children are drawn
         sortAllChildren();
@@ -727,22 +732,23 @@ void RenderTexture::begin()
     renderer->addCommand(&_groupCommand);
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
-    _beginCommand.init(_globalZOrder);
-    _beginCommand.func = CC_CALLBACK_0(RenderTexture::onBegin, this);
+    auto beginCommand = renderer->generateTransientCustomCommand();
+    beginCommand->init(_globalZOrder);
+    beginCommand->func = CC_CALLBACK_0(RenderTexture::onBegin, this);
 
-    Director::getInstance()->getRenderer()->addCommand(&_beginCommand);
+    renderer->addCommand(beginCommand);
 }
 
 void RenderTexture::end()
 {
-    _endCommand.init(_globalZOrder);
-    _endCommand.func = CC_CALLBACK_0(RenderTexture::onEnd, this);
-
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when setting matrix stack");
     
     Renderer *renderer = director->getRenderer();
-    renderer->addCommand(&_endCommand);
+    auto endCommand = renderer->generateTransientCustomCommand();
+    endCommand->init(_globalZOrder);
+    endCommand->func = CC_CALLBACK_0(RenderTexture::onEnd, this);
+    renderer->addCommand(endCommand);
     renderer->popGroup();
     
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
@@ -34,7 +34,9 @@ THE SOFTWARE.
 
 #include "2d/CCSprite.h"
 #include "2d/CCAutoPolygon.h"
+#include "2d/CCSpriteSheetBinary.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCMappedFile.h"
 #include "base/CCNS.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
@@ -77,6 +79,11 @@ bool SpriteFrameCache::init()
 
 SpriteFrameCache::~SpriteFrameCache()
 {
+    for (auto& sheet : _lazySheets)
+    {
+        if (sheet.descriptorCount > 0)
+            CC_SAFE_RELEASE(sheet.texture);
+    }
     CC_SAFE_DELETE(_loadedFileNames);
 }
 
@@ -137,7 +144,32 @@ void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
     info.rect = Rect(0, 0, spriteSize.width, spriteSize.height);
 }
 
-void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D* texture)
+/** Returns the texture file of a sprite sheet: the name stored in the sheet relative to it,
+ * or the name of the sheet with a .png extension.
+ */
+static std::string getSheetTexturePath(const std::string& textureFileName, const std::string& sheetFile)
+{
+    if (!textureFileName.empty())
+    {
+        // build texture path relative to plist file
+        return FileUtils::getInstance()->fullPathFromRelativeFile(textureFileName, sheetFile);
+    }
+
+    // build texture path by replacing file extension
+    std::string texturePath = sheetFile;
+
+    // remove .xxx
+    size_t startPos = texturePath.find_last_of(".");
+    texturePath = texturePath.erase(startPos);
+
+    // append .png
+    texturePath = texturePath.append(".png");
+
+    CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    return texturePath;
+}
+
+void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D* texture, const std::string& file)
 {
     /*
     Supported Zwoptex Formats:
@@ -172,18 +204,30 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
     CCASSERT(format >=0 && format <= 3, "format is not supported for SpriteFrameCache addSpriteFramesWithDictionary:textureFilename:");
 
     auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    uint32_t lazySheet = _lazyLoadingEnabled ? getLazySheet(file.empty() ? textureFileName : file, texture, textureSize) : 0;
     Image* image = nullptr;
     NinePatchImageParser parser;
+    std::vector<int> vertices;
+    std::vector<int> verticesUV;
+    std::vector<int> indices;
     for (auto iter = framesDict.begin(); iter != framesDict.end(); ++iter)
     {
         ValueMap& frameDict = iter->second.asValueMap();
         std::string spriteFrameName = iter->first;
         SpriteFrame* spriteFrame = _spriteFrames.at(spriteFrameName);
-        if (spriteFrame)
+        if (spriteFrame || _frameDescriptors.find(spriteFrameName) != _frameDescriptors.end())
         {
             continue;
         }
-        
+
+        Rect rect;
+        bool rotated = false;
+        Vec2 offset;
+        Size sourceSize;
+        vertices.clear();
+        verticesUV.clear();
+        indices.clear();
+
         if(format == 0) 
         {
             float x = frameDict["x"].asFloat();
@@ -202,18 +246,14 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
             // abs ow/oh
             ow = abs(ow);
             oh = abs(oh);
-            // create frame
-            spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         Rect(x, y, w, h),
-                                                         false,
-                                                         Vec2(ox, oy),
-                                                         Size((float)ow, (float)oh)
-                                                         );
+
+            rect.setRect(x, y, w, h);
+            offset.set(ox, oy);
+            sourceSize.setSize((float)ow, (float)oh);
         } 
         else if(format == 1 || format == 2) 
         {
-            Rect frame = RectFromString(frameDict["frame"].asString());
-            bool rotated = false;
+            rect = RectFromString(frameDict["frame"].asString());
 
             // rotation
             if (format == 2)
@@ -221,25 +261,18 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
                 rotated = frameDict["rotated"].asBool();
             }
 
-            Vec2 offset = PointFromString(frameDict["offset"].asString());
-            Size sourceSize = SizeFromString(frameDict["sourceSize"].asString());
-
-            // create frame
-            spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         frame,
-                                                         rotated,
-                                                         offset,
-                                                         sourceSize
-                                                         );
+            offset = PointFromString(frameDict["offset"].asString());
+            sourceSize = SizeFromString(frameDict["sourceSize"].asString());
         } 
         else if (format == 3)
         {
             // get values
             Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
-            Vec2 spriteOffset = PointFromString(frameDict["spriteOffset"].asString());
-            Size spriteSourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
+            offset = PointFromString(frameDict["spriteOffset"].asString());
+            sourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
             Rect textureRect = RectFromString(frameDict["textureRect"].asString());
-            bool textureRotated = frameDict["textureRotated"].asBool();
+            rotated = frameDict["textureRotated"].asBool();
+            rect.setRect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height);
 
             // get aliases
             ValueVector& aliases = frameDict["aliases"].asValueVector();
@@ -254,29 +287,37 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
                 _spriteFramesAliases[oneAlias] = Value(spriteFrameName);
             }
 
-            // create frame
-            spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height),
-                                                         textureRotated,
-                                                         spriteOffset,
-                                                         spriteSourceSize);
-
             if(frameDict.find("vertices") != frameDict.end())
             {
-                std::vector<int> vertices;
                 parseIntegerList(frameDict["vertices"].asString(), vertices);
-                std::vector<int> verticesUV;
                 parseIntegerList(frameDict["verticesUV"].asString(), verticesUV);
-                std::vector<int> indices;
                 parseIntegerList(frameDict["triangles"].asString(), indices);
-
-                PolygonInfo info;
-                initializePolygonInfo(textureSize, spriteSourceSize, vertices, verticesUV, indices, info);
-                spriteFrame->setPolygonInfo(info);
             }
         }
 
         bool flag = NinePatchImageParser::isNinePatchImage(spriteFrameName);
+
+        // the cap insets of nine-patch frames are parsed from the image now, while it is loaded
+        if (_lazyLoadingEnabled && !flag)
+        {
+            addFrameDescriptor(spriteFrameName, lazySheet, rect, rotated, offset, sourceSize, vertices, verticesUV, indices);
+            continue;
+        }
+
+        // create frame
+        spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                     rect,
+                                                     rotated,
+                                                     offset,
+                                                     sourceSize);
+
+        if (!vertices.empty())
+        {
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, sourceSize, vertices, verticesUV, indices, info);
+            spriteFrame->setPolygonInfo(info);
+        }
+
         if(flag)
         {
             if (image == nullptr) {
@@ -292,8 +333,150 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
     CC_SAFE_DELETE(image);
 }
 
+void SpriteFrameCache::addSpriteFramesWithBinary(const SpriteSheetBinary& sheet, Texture2D* texture, const std::string& file)
+{
+    uint32_t frameCount = sheet.getFrameCount();
+    if (_lazyLoadingEnabled)
+    {
+        _frameDescriptors.reserve(_frameDescriptors.size() + frameCount);
+    }
+    else
+    {
+        _spriteFrames.reserve(_spriteFrames.size() + frameCount);
+    }
+
+    Size textureSize = sheet.getTextureSize();
+    auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    uint32_t lazySheet = _lazyLoadingEnabled ? getLazySheet(file.empty() ? textureFileName : file, texture, textureSize) : 0;
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+    std::vector<bool> added(frameCount, false);
+    std::string spriteFrameName;
+    std::vector<int> vertices;
+    std::vector<int> verticesUV;
+    std::vector<int> indices;
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        const SpriteSheetBinary::Frame& frame = sheet.getFrame(i);
+        spriteFrameName.assign(sheet.getString(frame.name), frame.nameLength);
+        if (_spriteFrames.at(spriteFrameName) || _frameDescriptors.find(spriteFrameName) != _frameDescriptors.end())
+        {
+            continue;
+        }
+
+        Rect rect(frame.x, frame.y, frame.width, frame.height);
+        Vec2 offset(frame.offsetX, frame.offsetY);
+        Size sourceSize(frame.sourceWidth, frame.sourceHeight);
+        vertices.clear();
+        verticesUV.clear();
+        indices.clear();
+        if (frame.polygon != SpriteSheetBinary::NONE)
+        {
+            const int32_t* data = sheet.getPolygonData(frame);
+            vertices.assign(data, data + frame.vertexCount);
+            verticesUV.assign(data + frame.vertexCount, data + 2 * frame.vertexCount);
+            indices.assign(data + 2 * frame.vertexCount, data + 2 * frame.vertexCount + frame.indexCount);
+        }
+
+        bool flag = NinePatchImageParser::isNinePatchImage(spriteFrameName);
+        added[i] = true;
+
+        if (_lazyLoadingEnabled && !flag)
+        {
+            addFrameDescriptor(spriteFrameName, lazySheet, rect, frame.rotated != 0, offset, sourceSize, vertices, verticesUV, indices);
+            continue;
+        }
+
+        SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture, rect, frame.rotated != 0, offset, sourceSize);
+
+        if (!vertices.empty())
+        {
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, sourceSize, vertices, verticesUV, indices, info);
+            spriteFrame->setPolygonInfo(info);
+        }
+
+        if (flag)
+        {
+            if (image == nullptr) {
+                image = new Image();
+                image->initWithImageFile(textureFileName);
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+        }
+
+        _spriteFrames.insert(spriteFrameName, spriteFrame);
+    }
+    CC_SAFE_DELETE(image);
+
+    // like the plist path, only the aliases of the frames added here are registered
+    for (uint32_t i = 0, aliasCount = sheet.getAliasCount(); i < aliasCount; ++i)
+    {
+        const SpriteSheetBinary::Alias& alias = sheet.getAlias(i);
+        if (!added[alias.frame])
+        {
+            continue;
+        }
+
+        std::string aliasName(sheet.getString(alias.name), alias.nameLength);
+        if (_spriteFramesAliases.find(aliasName) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", aliasName.c_str());
+        }
+
+        const SpriteSheetBinary::Frame& frame = sheet.getFrame(alias.frame);
+        _spriteFramesAliases[aliasName] = Value(std::string(sheet.getString(frame.name), frame.nameLength));
+    }
+}
+
+void SpriteFrameCache::addSpriteFramesWithBinaryFile(const std::string& file, Texture2D* texture)
+{
+    CCASSERT(file.size()>0, "file name should not be empty");
+
+    if (_loadedFileNames->find(file) != _loadedFileNames->end())
+    {
+        return; // We already added it
+    }
+
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(file);
+    MappedFile mappedFile;
+    if (!mappedFile.open(fullPath))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: can not find %s", file.c_str());
+        return;
+    }
+
+    SpriteSheetBinary sheet;
+    if (!sheet.initWithData(mappedFile.getBytes(), mappedFile.getSize()))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: %s is not a valid binary sprite sheet", file.c_str());
+        return;
+    }
+
+    if (!texture)
+    {
+        std::string texturePath = getSheetTexturePath(sheet.getTextureFileName(), file);
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        if (!texture)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            return;
+        }
+    }
+
+    addSpriteFramesWithBinary(sheet, texture, file);
+    _loadedFileNames->insert(file);
+}
+
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
 {
+    if (SpriteSheetBinary::isBinaryFile(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist, texture);
+        return;
+    }
+
     if (_loadedFileNames->find(plist) != _loadedFileNames->end())
     {
         return; // We already added it
@@ -302,7 +485,7 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
-    addSpriteFramesWithDictionary(dict, texture);
+    addSpriteFramesWithDictionary(dict, texture, plist);
     _loadedFileNames->insert(plist);
 }
 
@@ -330,6 +513,12 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const s
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
 {
     CCASSERT(plist.size()>0, "plist filename should not be nullptr");
+
+    if (SpriteSheetBinary::isBinaryFile(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist);
+        return;
+    }
     
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     if (fullPath.size() == 0)
@@ -353,31 +542,13 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
             texturePath = metadataDict["textureFileName"].asString();
         }
 
-        if (!texturePath.empty())
-        {
-            // build texture path relative to plist file
-            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath.c_str(), plist);
-        }
-        else
-        {
-            // build texture path by replacing file extension
-            texturePath = plist;
-
-            // remove .xxx
-            size_t startPos = texturePath.find_last_of("."); 
-            texturePath = texturePath.erase(startPos);
-
-            // append .png
-            texturePath = texturePath.append(".png");
-
-            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
-        }
+        texturePath = getSheetTexturePath(texturePath, plist);
 
         Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(texturePath.c_str());
 
         if (texture)
         {
-            addSpriteFramesWithDictionary(dict, texture);
+            addSpriteFramesWithDictionary(dict, texture, plist);
             _loadedFileNames->insert(plist);
         }
         else
@@ -401,14 +572,127 @@ bool SpriteFrameCache::isSpriteFramesWithFileLoaded(const std::string& plist) co
 
 void SpriteFrameCache::addSpriteFrame(SpriteFrame* frame, const std::string& frameName)
 {
+    // the frame replaces the one of a lazy sheet with the same name
+    removeFrameDescriptor(frameName);
     _spriteFrames.insert(frameName, frame);
 }
 
+uint32_t SpriteFrameCache::getLazySheet(const std::string& file, Texture2D* texture, const Size& textureSize)
+{
+    for (uint32_t i = 0, count = static_cast<uint32_t>(_lazySheets.size()); i < count; ++i)
+    {
+        LazySheet& sheet = _lazySheets[i];
+        if (sheet.file == file && (sheet.texture == texture || sheet.descriptorCount == 0))
+        {
+            sheet.texture = texture;
+            sheet.textureSize = textureSize;
+            return i;
+        }
+    }
+
+    LazySheet sheet;
+    sheet.file = file;
+    sheet.texture = texture;
+    sheet.textureSize = textureSize;
+    sheet.descriptorCount = 0;
+    _lazySheets.push_back(sheet);
+    return static_cast<uint32_t>(_lazySheets.size() - 1);
+}
+
+void SpriteFrameCache::addFrameDescriptor(const std::string& name, uint32_t sheet, const Rect& rect, bool rotated,
+                                          const Vec2& offset, const Size& originalSize, const std::vector<int>& vertices,
+                                          const std::vector<int>& verticesUV, const std::vector<int>& triangleIndices)
+{
+    FrameDescriptor& descriptor = _frameDescriptors[name];
+    descriptor.rect = rect;
+    descriptor.offset = offset;
+    descriptor.originalSize = originalSize;
+    descriptor.rotated = rotated;
+    descriptor.sheet = sheet;
+    descriptor.vertexCount = static_cast<uint32_t>(vertices.size());
+    if (!vertices.empty())
+    {
+        descriptor.polygon.reserve(vertices.size() * 2 + triangleIndices.size());
+        descriptor.polygon.insert(descriptor.polygon.end(), vertices.begin(), vertices.end());
+        descriptor.polygon.insert(descriptor.polygon.end(), verticesUV.begin(), verticesUV.end());
+        descriptor.polygon.insert(descriptor.polygon.end(), triangleIndices.begin(), triangleIndices.end());
+    }
+
+    LazySheet& lazySheet = _lazySheets[sheet];
+    if (lazySheet.descriptorCount++ == 0)
+    {
+        CC_SAFE_RETAIN(lazySheet.texture);
+    }
+}
+
+SpriteFrame* SpriteFrameCache::materializeSpriteFrame(const std::string& name)
+{
+    auto iter = _frameDescriptors.find(name);
+    if (iter == _frameDescriptors.end())
+    {
+        return nullptr;
+    }
+
+    const FrameDescriptor& descriptor = iter->second;
+    const LazySheet& sheet = _lazySheets[descriptor.sheet];
+    SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(sheet.texture,
+                                                              descriptor.rect,
+                                                              descriptor.rotated,
+                                                              descriptor.offset,
+                                                              descriptor.originalSize);
+
+    if (!descriptor.polygon.empty())
+    {
+        auto vertices = descriptor.polygon.begin();
+        auto verticesUV = vertices + descriptor.vertexCount;
+        auto indices = verticesUV + descriptor.vertexCount;
+
+        PolygonInfo info;
+        initializePolygonInfo(sheet.textureSize,
+                              descriptor.originalSize,
+                              std::vector<int>(vertices, verticesUV),
+                              std::vector<int>(verticesUV, indices),
+                              std::vector<int>(indices, descriptor.polygon.end()),
+                              info);
+        spriteFrame->setPolygonInfo(info);
+    }
+
+    _spriteFrames.insert(name, spriteFrame);
+    return spriteFrame;
+}
+
+void SpriteFrameCache::removeFrameDescriptor(const std::string& name)
+{
+    auto iter = _frameDescriptors.find(name);
+    if (iter != _frameDescriptors.end())
+    {
+        removeFrameDescriptor(iter);
+    }
+}
+
+std::unordered_map<std::string, SpriteFrameCache::FrameDescriptor>::iterator SpriteFrameCache::removeFrameDescriptor(std::unordered_map<std::string, FrameDescriptor>::iterator iter)
+{
+    LazySheet& sheet = _lazySheets[iter->second.sheet];
+    if (--sheet.descriptorCount == 0)
+    {
+        CC_SAFE_RELEASE_NULL(sheet.texture);
+    }
+    return _frameDescriptors.erase(iter);
+}
+
 void SpriteFrameCache::removeSpriteFrames()
 {
     _spriteFrames.clear();
     _spriteFramesAliases.clear();
     _loadedFileNames->clear();
+
+    for (auto& sheet : _lazySheets)
+    {
+        if (sheet.descriptorCount > 0)
+            CC_SAFE_RELEASE(sheet.texture);
+    }
+    _lazySheets.clear();
+    _frameDescriptors.clear();
 }
 
 void SpriteFrameCache::removeUnusedSpriteFrames()
@@ -430,6 +714,20 @@ void SpriteFrameCache::removeUnusedSpriteFrames()
 
     _spriteFrames.erase(toRemoveFrames);
 
+    // the frames of lazy sheets that aren't created are unused too
+    for (auto iter = _frameDescriptors.begin(); iter != _frameDescriptors.end();)
+    {
+        if (!_spriteFrames.at(iter->first))
+        {
+            iter = removeFrameDescriptor(iter);
+            removed = true;
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
     // FIXME:. Since we don't know the .plist file that originated the frame, we must remove all .plist from the cache
     if( removed )
     {
@@ -451,10 +749,12 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
     {
         _spriteFrames.erase(key);
         _spriteFramesAliases.erase(key);
+        removeFrameDescriptor(key);
     }
     else
     {
         _spriteFrames.erase(name);
+        removeFrameDescriptor(name);
     }
 
     // FIXME:. Since we don't know the .plist file that originated the frame, we must remove all .plist from the cache
@@ -464,6 +764,20 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (SpriteSheetBinary::isBinaryFile(plist))
+    {
+        MappedFile mappedFile;
+        SpriteSheetBinary sheet;
+        if (!mappedFile.open(fullPath) || !sheet.initWithData(mappedFile.getBytes(), mappedFile.getSize()))
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: can not read %s.", plist.c_str());
+            return;
+        }
+        removeSpriteFramesFromBinary(sheet);
+        _loadedFileNames->erase(plist);
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     if (dict.empty())
     {
@@ -502,11 +816,24 @@ void SpriteFrameCache::removeSpriteFramesFromDictionary(ValueMap& dictionary)
         {
             keysToRemove.push_back(iter->first);
         }
+        removeFrameDescriptor(iter->first);
     }
 
     _spriteFrames.erase(keysToRemove);
 }
 
+void SpriteFrameCache::removeSpriteFramesFromBinary(const SpriteSheetBinary& sheet)
+{
+    std::string name;
+    for (uint32_t i = 0, frameCount = sheet.getFrameCount(); i < frameCount; ++i)
+    {
+        const SpriteSheetBinary::Frame& frame = sheet.getFrame(i);
+        name.assign(sheet.getString(frame.name), frame.nameLength);
+        _spriteFrames.erase(name);
+        removeFrameDescriptor(name);
+    }
+}
+
 void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
 {
     std::vector<std::string> keysToRemove;
@@ -522,12 +849,28 @@ void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
     }
 
     _spriteFrames.erase(keysToRemove);
+
+    for (auto iter = _frameDescriptors.begin(); iter != _frameDescriptors.end();)
+    {
+        if (_lazySheets[iter->second.sheet].texture == texture)
+        {
+            iter = removeFrameDescriptor(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
 }
 
 SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
 {
     SpriteFrame* frame = _spriteFrames.at(name);
     if (!frame)
+    {
+        frame = materializeSpriteFrame(name);
+    }
+    if (!frame)
     {
         // try alias dictionary
         std::string key = _spriteFramesAliases[name].asString();
@@ -535,6 +878,10 @@ SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
         {
             frame = _spriteFrames.at(key);
             if (!frame)
+            {
+                frame = materializeSpriteFrame(key);
+            }
+            if (!frame)
             {
                 CCLOG("cocos2d: SpriteFrameCache: Frame '%s' not found", name.c_str());
             }
@@ -543,4 +890,96 @@ SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
     return frame;
 }
 
+static size_t getSpriteFrameMemory(const std::string& name, SpriteFrame* frame)
+{
+    size_t bytes = sizeof(SpriteFrame) + name.capacity();
+    const PolygonInfo& info = frame->getPolygonInfo();
+    if (frame->hasPolygonInfo())
+    {
+        bytes += info.triangles.vertCount * sizeof(V3F_C4B_T2F) + info.triangles.indexCount * sizeof(unsigned short);
+    }
+    return bytes;
+}
+
+std::string SpriteFrameCache::getCachedSpriteFrameInfo() const
+{
+    struct Usage
+    {
+        unsigned int frames = 0;
+        unsigned int created = 0;
+        size_t descriptorBytes = 0;
+        size_t frameBytes = 0;
+    };
+    std::vector<Usage> sheetUsage(_lazySheets.size());
+    std::unordered_map<Texture2D*, Usage> textureUsage;
+
+    for (const auto& iter : _frameDescriptors)
+    {
+        Usage& usage = sheetUsage[iter.second.sheet];
+        usage.frames++;
+        usage.descriptorBytes += sizeof(FrameDescriptor) + iter.first.capacity() + iter.second.polygon.capacity() * sizeof(int);
+    }
+
+    for (const auto& iter : _spriteFrames)
+    {
+        auto descriptor = _frameDescriptors.find(iter.first);
+        Usage& usage = descriptor != _frameDescriptors.end() ? sheetUsage[descriptor->second.sheet] : textureUsage[iter.second->getTexture()];
+        if (descriptor == _frameDescriptors.end())
+        {
+            usage.frames++;
+        }
+        usage.created++;
+        usage.frameBytes += getSpriteFrameMemory(iter.first, iter.second);
+    }
+
+    std::string buffer;
+    char buftmp[4096];
+    auto textureCache = Director::getInstance()->getTextureCache();
+    Usage total;
+
+    for (size_t i = 0; i < _lazySheets.size(); ++i)
+    {
+        const Usage& usage = sheetUsage[i];
+        if (usage.frames == 0)
+            continue;
+
+        snprintf(buftmp, sizeof(buftmp)-1, "\"%s\" lazy, texture=\"%s\" frames=%u created=%u => descriptors %lu KB, frames %lu KB\n",
+                 _lazySheets[i].file.c_str(),
+                 textureCache->getTextureFilePath(_lazySheets[i].texture).c_str(),
+                 usage.frames,
+                 usage.created,
+                 (unsigned long)usage.descriptorBytes / 1024,
+                 (unsigned long)usage.frameBytes / 1024);
+        buffer += buftmp;
+        total.frames += usage.frames;
+        total.created += usage.created;
+        total.descriptorBytes += usage.descriptorBytes;
+        total.frameBytes += usage.frameBytes;
+    }
+
+    for (const auto& iter : textureUsage)
+    {
+        const Usage& usage = iter.second;
+        snprintf(buftmp, sizeof(buftmp)-1, "texture=\"%s\" frames=%u => frames %lu KB\n",
+                 iter.first ? textureCache->getTextureFilePath(iter.first).c_str() : "",
+                 usage.frames,
+                 (unsigned long)usage.frameBytes / 1024);
+        buffer += buftmp;
+        total.frames += usage.frames;
+        total.created += usage.created;
+        total.frameBytes += usage.frameBytes;
+    }
+
+    size_t totalBytes = total.descriptorBytes + total.frameBytes;
+    snprintf(buftmp, sizeof(buftmp)-1, "SpriteFrameCache dumpDebugInfo: %u frames, %u created, %lu aliases, for %lu KB (%.2f MB)\n",
+             total.frames,
+             total.created,
+             (unsigned long)_spriteFramesAliases.size(),
+             (unsigned long)totalBytes / 1024,
+             totalBytes / (1024.0f*1024.0f));
+    buffer += buftmp;
+
+    return buffer;
+}
+
 NS_CC_END
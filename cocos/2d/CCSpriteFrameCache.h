@@ -32,6 +32,8 @@ THE SOFTWARE.
 
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "2d/CCSpriteFrame.h"
 #include "base/CCRef.h"
 #include "base/CCValue.h"
@@ -42,6 +44,7 @@ NS_CC_BEGIN
 class Sprite;
 class Texture2D;
 class PolygonInfo;
+class SpriteSheetBinary;
 
 /**
  * @addtogroup _2d
@@ -120,6 +123,24 @@ public:
      */
     bool init();
 
+    /** Enables or disables the lazy loading of the sprite frames. Disabled by default.
+     * When it is enabled, the sprite sheets loaded afterwards only record a small descriptor for each frame, and
+     * the SpriteFrame is created the first time getSpriteFrameByName() asks for it. The texture of a sheet is
+     * retained while it has frame descriptors. Frames with a nine-patch name are still created when the sheet is loaded.
+     * Turning it off doesn't create the frames recorded before, they are still created on demand.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    void setLazyLoadingEnabled(bool enabled) { _lazyLoadingEnabled = enabled; }
+
+    /** Whether the sprite frames of the sheets loaded from now on are created on demand.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    bool isLazyLoadingEnabled() const { return _lazyLoadingEnabled; }
+
     /** Adds multiple Sprite Frames from a plist file.
      * A texture will be loaded automatically. The texture name will composed by replacing the .plist suffix with .png.
      * If you want to use another texture, you should use the addSpriteFramesWithFile(const std::string& plist, const std::string& textureFileName) method.
@@ -158,6 +179,19 @@ public:
      */
     void addSpriteFramesWithFileContent(const std::string& plist_content, Texture2D *texture);
 
+    /** Adds multiple Sprite Frames from a binary sprite sheet, see SpriteSheetBinary.
+     * The file is memory-mapped when possible and the frames are registered without creating a ValueMap.
+     * addSpriteFramesWithFile() calls this method for the files with the SpriteSheetBinary::FILE_EXTENSION extension.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     *
+     * @param file Binary sprite sheet file name.
+     * @param texture Texture pointer. If it is null, the texture named in the sheet is loaded,
+     * or the one named by replacing the extension of the file with .png.
+     */
+    void addSpriteFramesWithBinaryFile(const std::string& file, Texture2D* texture = nullptr);
+
     /** Adds an sprite frame with a given name.
      If the name already exists, then the contents of the old name will be replaced with the new one.
      *
@@ -236,19 +270,62 @@ public:
     /** @deprecated use getSpriteFrameByName() instead */
     CC_DEPRECATED_ATTRIBUTE SpriteFrame* spriteFrameByName(const std::string&name) { return getSpriteFrameByName(name); }
 
+    /** Returns a description of the current contents of this SpriteFrameCache.
+     * This will attempt to estimate the memory used by the frame descriptors of each lazily loaded sheet
+     * and by the created sprite frames, grouped by sheet, or by texture for the other frames.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    std::string getCachedSpriteFrameInfo() const;
+
 protected:
+    /** A sprite frame of a lazily loaded sheet, created by getSpriteFrameByName() on first use.
+     * It is kept after the frame is created, so that memory can be accounted per sheet.
+     */
+    struct FrameDescriptor
+    {
+        Rect rect;
+        Vec2 offset;
+        Size originalSize;
+        bool rotated;
+        uint32_t sheet;             // index in _lazySheets
+        uint32_t vertexCount;       // number of ints of the vertices, and of the verticesUV
+        std::vector<int> polygon;   // vertices, verticesUV then triangle indices. Empty if it isn't a polygon
+    };
+
+    struct LazySheet
+    {
+        std::string file;
+        Texture2D* texture;         // retained while the sheet has frame descriptors
+        Size textureSize;
+        uint32_t descriptorCount;
+    };
+
     // MARMALADE: Made this protected not private, as deriving from this class is pretty useful
-    SpriteFrameCache(){}
+    SpriteFrameCache()
+    : _lazyLoadingEnabled(false)
+    {}
 
     /*Adds multiple Sprite Frames with a dictionary. The texture will be associated with the created sprite frames.
      */
-    void addSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture);
+    void addSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture, const std::string& file = "");
 
     /** Removes multiple Sprite Frames from Dictionary.
     * @since v0.99.5
     */
     void removeSpriteFramesFromDictionary(ValueMap& dictionary);
 
+    /** Adds the Sprite Frames of a binary sprite sheet. The texture will be associated with the created sprite frames.
+     * @since v3.10
+     */
+    void addSpriteFramesWithBinary(const SpriteSheetBinary& sheet, Texture2D* texture, const std::string& file = "");
+
+    /** Removes the Sprite Frames of a binary sprite sheet.
+     * @since v3.10
+     */
+    void removeSpriteFramesFromBinary(const SpriteSheetBinary& sheet);
+
     /** Parses list of space-separated integers */
     void parseIntegerList(const std::string &string, std::vector<int> &res);
     
@@ -260,9 +337,35 @@ protected:
                                const std::vector<int> &triangleIndices,
                                PolygonInfo &polygonInfo);
 
+    /** Returns the lazy sheet of a file, creating it when the file or the texture is new.
+     * @since v3.10
+     */
+    uint32_t getLazySheet(const std::string& file, Texture2D* texture, const Size& textureSize);
+
+    /** Records a frame of a lazy sheet. The polygon vectors are empty if the frame isn't a polygon.
+     * @since v3.10
+     */
+    void addFrameDescriptor(const std::string& name, uint32_t sheet, const Rect& rect, bool rotated,
+                            const Vec2& offset, const Size& originalSize, const std::vector<int>& vertices,
+                            const std::vector<int>& verticesUV, const std::vector<int>& triangleIndices);
+
+    /** Creates and adds the sprite frame of a frame descriptor, returns nullptr if there is no descriptor with this name.
+     * @since v3.10
+     */
+    SpriteFrame* materializeSpriteFrame(const std::string& name);
+
+    /** Removes a frame descriptor, and releases the texture of its sheet with its last descriptor.
+     * @since v3.10
+     */
+    void removeFrameDescriptor(const std::string& name);
+    std::unordered_map<std::string, FrameDescriptor>::iterator removeFrameDescriptor(std::unordered_map<std::string, FrameDescriptor>::iterator iter);
+
     Map<std::string, SpriteFrame*> _spriteFrames;
     ValueMap _spriteFramesAliases;
     std::set<std::string>*  _loadedFileNames;
+    std::unordered_map<std::string, FrameDescriptor> _frameDescriptors;
+    std::vector<LazySheet> _lazySheets;
+    bool _lazyLoadingEnabled;
 };
 
 // end of _2d group
@@ -0,0 +1,349 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCSpriteSheetBinary.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "base/CCNS.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+static const char SHEET_MAGIC[4] = { 'C', 'C', 'S', 'F' };
+static const uint32_t SHEET_BYTE_ORDER = 0x01020304;
+
+const char* const SpriteSheetBinary::FILE_EXTENSION = ".ccsheet";
+
+static const Value& valueForKey(const ValueMap& dictionary, const std::string& key)
+{
+    auto iter = dictionary.find(key);
+    return iter != dictionary.end() ? iter->second : Value::Null;
+}
+
+static void parseIntegerList(const std::string& string, std::vector<int32_t>& res)
+{
+    res.clear();
+    const char* p = string.c_str();
+    char* end = nullptr;
+    while (*p)
+    {
+        long value = strtol(p, &end, 10);
+        if (end == p)
+            break;
+        res.push_back(static_cast<int32_t>(value));
+        p = end;
+    }
+}
+
+bool SpriteSheetBinary::isBinaryFile(const std::string& filename)
+{
+    size_t extensionLength = strlen(FILE_EXTENSION);
+    return filename.size() > extensionLength
+        && filename.compare(filename.size() - extensionLength, extensionLength, FILE_EXTENSION) == 0;
+}
+
+bool SpriteSheetBinary::createWithDictionary(const ValueMap& dictionary, Data* out)
+{
+    CCASSERT(out, "out should not be null");
+
+    const Value& framesValue = valueForKey(dictionary, "frames");
+    if (framesValue.getType() != Value::Type::MAP)
+        return false;
+    const ValueMap& framesDict = framesValue.asValueMap();
+
+    int format = 0;
+    Size textureSize;
+    std::string textureFileName;
+    const Value& metadataValue = valueForKey(dictionary, "metadata");
+    if (metadataValue.getType() == Value::Type::MAP)
+    {
+        const ValueMap& metadataDict = metadataValue.asValueMap();
+        format = valueForKey(metadataDict, "format").asInt();
+        const Value& size = valueForKey(metadataDict, "size");
+        if (!size.isNull())
+            textureSize = SizeFromString(size.asString());
+        textureFileName = valueForKey(metadataDict, "textureFileName").asString();
+    }
+    if (format < 0 || format > 3)
+    {
+        CCLOG("cocos2d: SpriteSheetBinary: plist format %d is not supported", format);
+        return false;
+    }
+
+    std::string strings;
+    auto addString = [&strings](const std::string& string) {
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(string.c_str(), string.size() + 1);
+        return offset;
+    };
+
+    // sorted, so that converting the same plist always gives the same file
+    std::vector<const std::string*> names;
+    names.reserve(framesDict.size());
+    for (const auto& iter : framesDict)
+    {
+        if (iter.second.getType() == Value::Type::MAP)
+            names.push_back(&iter.first);
+    }
+    std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+
+    std::vector<Frame> frames;
+    std::vector<Alias> aliases;
+    std::vector<int32_t> polygonData;
+    std::vector<int32_t> vertices, verticesUV, indices;
+    frames.reserve(names.size());
+
+    for (const std::string* name : names)
+    {
+        const ValueMap& frameDict = framesDict.at(*name).asValueMap();
+
+        Rect rect;
+        bool rotated = false;
+        Vec2 offset;
+        Size sourceSize;
+
+        if (format == 0)
+        {
+            rect.setRect(valueForKey(frameDict, "x").asFloat(),
+                         valueForKey(frameDict, "y").asFloat(),
+                         valueForKey(frameDict, "width").asFloat(),
+                         valueForKey(frameDict, "height").asFloat());
+            offset.set(valueForKey(frameDict, "offsetX").asFloat(), valueForKey(frameDict, "offsetY").asFloat());
+            sourceSize.setSize((float)abs(valueForKey(frameDict, "originalWidth").asInt()),
+                               (float)abs(valueForKey(frameDict, "originalHeight").asInt()));
+        }
+        else if (format == 1 || format == 2)
+        {
+            rect = RectFromString(valueForKey(frameDict, "frame").asString());
+            if (format == 2)
+                rotated = valueForKey(frameDict, "rotated").asBool();
+            offset = PointFromString(valueForKey(frameDict, "offset").asString());
+            sourceSize = SizeFromString(valueForKey(frameDict, "sourceSize").asString());
+        }
+        else
+        {
+            Size spriteSize = SizeFromString(valueForKey(frameDict, "spriteSize").asString());
+            Rect textureRect = RectFromString(valueForKey(frameDict, "textureRect").asString());
+            rect.setRect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height);
+            rotated = valueForKey(frameDict, "textureRotated").asBool();
+            offset = PointFromString(valueForKey(frameDict, "spriteOffset").asString());
+            sourceSize = SizeFromString(valueForKey(frameDict, "spriteSourceSize").asString());
+        }
+
+        Frame frame;
+        frame.nameLength = static_cast<uint32_t>(name->size());
+        frame.name = addString(*name);
+        frame.x = rect.origin.x;
+        frame.y = rect.origin.y;
+        frame.width = rect.size.width;
+        frame.height = rect.size.height;
+        frame.offsetX = offset.x;
+        frame.offsetY = offset.y;
+        frame.sourceWidth = sourceSize.width;
+        frame.sourceHeight = sourceSize.height;
+        frame.rotated = rotated ? 1 : 0;
+        frame.polygon = NONE;
+        frame.vertexCount = 0;
+        frame.indexCount = 0;
+
+        if (format == 3)
+        {
+            const Value& aliasesValue = valueForKey(frameDict, "aliases");
+            if (aliasesValue.getType() == Value::Type::VECTOR)
+            {
+                for (const auto& value : aliasesValue.asValueVector())
+                {
+                    std::string aliasName = value.asString();
+                    Alias alias;
+                    alias.nameLength = static_cast<uint32_t>(aliasName.size());
+                    alias.name = addString(aliasName);
+                    alias.frame = static_cast<uint32_t>(frames.size());
+                    aliases.push_back(alias);
+                }
+            }
+
+            const Value& verticesValue = valueForKey(frameDict, "vertices");
+            if (!verticesValue.isNull())
+            {
+                parseIntegerList(verticesValue.asString(), vertices);
+                parseIntegerList(valueForKey(frameDict, "verticesUV").asString(), verticesUV);
+                parseIntegerList(valueForKey(frameDict, "triangles").asString(), indices);
+                if (vertices.size() != verticesUV.size())
+                {
+                    CCLOG("cocos2d: SpriteSheetBinary: vertices and verticesUV of %s don't match", name->c_str());
+                    return false;
+                }
+
+                frame.polygon = static_cast<uint32_t>(polygonData.size());
+                frame.vertexCount = static_cast<uint32_t>(vertices.size());
+                frame.indexCount = static_cast<uint32_t>(indices.size());
+                polygonData.insert(polygonData.end(), vertices.begin(), vertices.end());
+                polygonData.insert(polygonData.end(), verticesUV.begin(), verticesUV.end());
+                polygonData.insert(polygonData.end(), indices.begin(), indices.end());
+            }
+        }
+
+        frames.push_back(frame);
+    }
+
+    Header header;
+    memcpy(header.magic, SHEET_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.byteOrder = SHEET_BYTE_ORDER;
+    header.frameCount = static_cast<uint32_t>(frames.size());
+    header.aliasCount = static_cast<uint32_t>(aliases.size());
+    header.polygonDataCount = static_cast<uint32_t>(polygonData.size());
+    header.textureFileName = textureFileName.empty() ? NONE : addString(textureFileName);
+    header.textureWidth = textureSize.width;
+    header.textureHeight = textureSize.height;
+
+    // keep the file size a multiple of 4
+    strings.resize((strings.size() + 3) & ~size_t(3), '\0');
+    header.stringTableSize = static_cast<uint32_t>(strings.size());
+
+    size_t framesSize = frames.size() * sizeof(Frame);
+    size_t aliasesSize = aliases.size() * sizeof(Alias);
+    size_t polygonSize = polygonData.size() * sizeof(int32_t);
+    size_t size = sizeof(Header) + framesSize + aliasesSize + polygonSize + strings.size();
+
+    unsigned char* bytes = (unsigned char*)malloc(size);
+    if (!bytes)
+        return false;
+
+    unsigned char* p = bytes;
+    memcpy(p, &header, sizeof(Header));
+    p += sizeof(Header);
+    if (framesSize)
+        memcpy(p, frames.data(), framesSize);
+    p += framesSize;
+    if (aliasesSize)
+        memcpy(p, aliases.data(), aliasesSize);
+    p += aliasesSize;
+    if (polygonSize)
+        memcpy(p, polygonData.data(), polygonSize);
+    p += polygonSize;
+    memcpy(p, strings.data(), strings.size());
+
+    out->fastSet(bytes, size);
+    return true;
+}
+
+SpriteSheetBinary::SpriteSheetBinary()
+: _header(nullptr)
+, _frames(nullptr)
+, _aliases(nullptr)
+, _polygonData(nullptr)
+, _strings(nullptr)
+{
+    static_assert(sizeof(Header) % 4 == 0 && sizeof(Frame) % 4 == 0 && sizeof(Alias) % 4 == 0,
+                  "the records of a binary sprite sheet must stay 4 bytes aligned");
+}
+
+bool SpriteSheetBinary::initWithData(const unsigned char* bytes, ssize_t size)
+{
+    _header = nullptr;
+
+    if (!bytes || size < (ssize_t)sizeof(Header) || ((uintptr_t)bytes & 3) != 0)
+        return false;
+
+    const Header* header = reinterpret_cast<const Header*>(bytes);
+    if (memcmp(header->magic, SHEET_MAGIC, sizeof(header->magic)) != 0)
+        return false;
+    if (header->byteOrder != SHEET_BYTE_ORDER)
+    {
+        CCLOG("cocos2d: SpriteSheetBinary: the sheet was written with another byte order");
+        return false;
+    }
+    if (header->version != VERSION)
+    {
+        CCLOG("cocos2d: SpriteSheetBinary: version %u is not supported", header->version);
+        return false;
+    }
+
+    // 64 bits, so that corrupted counts can't overflow
+    uint64_t framesOffset = sizeof(Header);
+    uint64_t aliasesOffset = framesOffset + (uint64_t)header->frameCount * sizeof(Frame);
+    uint64_t polygonOffset = aliasesOffset + (uint64_t)header->aliasCount * sizeof(Alias);
+    uint64_t stringsOffset = polygonOffset + (uint64_t)header->polygonDataCount * sizeof(int32_t);
+    uint64_t end = stringsOffset + header->stringTableSize;
+    if (end > (uint64_t)size)
+        return false;
+
+    const Frame* frames = reinterpret_cast<const Frame*>(bytes + framesOffset);
+    const Alias* aliases = reinterpret_cast<const Alias*>(bytes + aliasesOffset);
+    const char* strings = reinterpret_cast<const char*>(bytes + stringsOffset);
+    uint64_t stringTableSize = header->stringTableSize;
+
+    auto isValidString = [strings, stringTableSize](uint32_t offset, uint32_t length) {
+        return (uint64_t)offset + length < stringTableSize && strings[offset + length] == '\0';
+    };
+
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        const Frame& frame = frames[i];
+        if (!isValidString(frame.name, frame.nameLength))
+            return false;
+        if (frame.polygon != NONE
+            && (uint64_t)frame.polygon + 2 * (uint64_t)frame.vertexCount + frame.indexCount > header->polygonDataCount)
+            return false;
+    }
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        const Alias& alias = aliases[i];
+        if (alias.frame >= header->frameCount || !isValidString(alias.name, alias.nameLength))
+            return false;
+    }
+    // the length of the texture file name isn't stored, look for its terminator
+    if (header->textureFileName != NONE
+        && (header->textureFileName >= stringTableSize
+            || !memchr(strings + header->textureFileName, '\0', (size_t)(stringTableSize - header->textureFileName))))
+        return false;
+
+    _header = header;
+    _frames = frames;
+    _aliases = aliases;
+    _polygonData = reinterpret_cast<const int32_t*>(bytes + polygonOffset);
+    _strings = strings;
+    return true;
+}
+
+std::string SpriteSheetBinary::getTextureFileName() const
+{
+    if (!_header || _header->textureFileName == NONE)
+        return "";
+    return _strings + _header->textureFileName;
+}
+
+Size SpriteSheetBinary::getTextureSize() const
+{
+    if (!_header)
+        return Size::ZERO;
+    return Size(_header->textureWidth, _header->textureHeight);
+}
+
+NS_CC_END
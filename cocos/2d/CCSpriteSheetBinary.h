@@ -0,0 +1,153 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __SPRITE_CCSPRITE_SHEET_BINARY_H__
+#define __SPRITE_CCSPRITE_SHEET_BINARY_H__
+
+#include <cstdint>
+#include <string>
+
+#include "base/CCData.h"
+#include "base/CCValue.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class SpriteSheetBinary
+ * @brief A read-only view of a binary sprite sheet, the compact counterpart of the sprite sheet .plist files.
+ *
+ * A binary sprite sheet is made of a header followed by:
+ * - the frame table, one Frame per sprite frame, already converted to the format 3 values;
+ * - the alias table, one Alias per alias of a frame;
+ * - the polygon data: the vertices, verticesUV and triangle indices of the frames packed as polygons, as int32;
+ * - the string table, holding the null terminated frame, alias and texture names.
+ *
+ * Every record is 4 bytes aligned and stored in the byte order of the device, so the file can be memory-mapped
+ * and read in place. SpriteFrameCache loads files with the FILE_EXTENSION extension this way, without creating
+ * a ValueMap. Use the sprite-sheet-converter tool or createWithDictionary() to convert a .plist file.
+ * @since v3.10
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL SpriteSheetBinary
+{
+public:
+    /** Extension of the binary sprite sheet files. */
+    static const char* const FILE_EXTENSION;
+    /** Version of the format written by createWithDictionary(). */
+    static const uint32_t VERSION = 1;
+    /** Value of a string offset or a polygon index when there is none. */
+    static const uint32_t NONE = 0xffffffff;
+
+    struct Header
+    {
+        char magic[4];              ///< "CCSF"
+        uint32_t version;
+        uint32_t byteOrder;         ///< 0x01020304, written in the byte order of the writer
+        uint32_t frameCount;
+        uint32_t aliasCount;
+        uint32_t polygonDataCount;  ///< number of int32 in the polygon data
+        uint32_t stringTableSize;
+        uint32_t textureFileName;   ///< offset in the string table, or NONE
+        float textureWidth;
+        float textureHeight;
+    };
+
+    struct Frame
+    {
+        uint32_t name;              ///< offset in the string table
+        uint32_t nameLength;
+        float x, y, width, height;  ///< rect in the texture
+        float offsetX, offsetY;
+        float sourceWidth, sourceHeight;
+        uint32_t rotated;
+        uint32_t polygon;           ///< index in the polygon data, or NONE
+        uint32_t vertexCount;       ///< number of int32 of the vertices, and of the verticesUV
+        uint32_t indexCount;
+    };
+
+    struct Alias
+    {
+        uint32_t name;              ///< offset in the string table
+        uint32_t nameLength;
+        uint32_t frame;             ///< index in the frame table
+    };
+
+    /** Whether a file name has the binary sprite sheet extension. */
+    static bool isBinaryFile(const std::string& filename);
+
+    /** Converts the dictionary of a sprite sheet .plist file, in any format SpriteFrameCache supports.
+     *
+     * @param dictionary The content of the .plist file.
+     * @param out Receives the binary sprite sheet.
+     * @return False if the dictionary isn't a sprite sheet.
+     */
+    static bool createWithDictionary(const ValueMap& dictionary, Data* out);
+
+    SpriteSheetBinary();
+
+    /** Validates a binary sprite sheet and points the tables into it.
+     * The bytes are not copied and must outlive this object.
+     *
+     * @return False if the data is not a binary sprite sheet of this version and byte order, or if it is truncated.
+     */
+    bool initWithData(const unsigned char* bytes, ssize_t size);
+
+    uint32_t getFrameCount() const { return _header ? _header->frameCount : 0; }
+    const Frame& getFrame(uint32_t index) const { return _frames[index]; }
+
+    uint32_t getAliasCount() const { return _header ? _header->aliasCount : 0; }
+    const Alias& getAlias(uint32_t index) const { return _aliases[index]; }
+
+    /** Returns the null terminated string at an offset of the string table. */
+    const char* getString(uint32_t offset) const { return _strings + offset; }
+
+    /** Returns the polygon data of a frame: vertexCount vertices, then vertexCount verticesUV, then indexCount indices. */
+    const int32_t* getPolygonData(const Frame& frame) const { return _polygonData + frame.polygon; }
+
+    /** The texture file name stored in the sheet, relative to the sheet. Empty if there is none. */
+    std::string getTextureFileName() const;
+
+    /** The size of the texture in pixels, zero if the sheet doesn't store it. */
+    Size getTextureSize() const;
+
+private:
+    const Header* _header;
+    const Frame* _frames;
+    const Alias* _aliases;
+    const int32_t* _polygonData;
+    const char* _strings;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __SPRITE_CCSPRITE_SHEET_BINARY_H__
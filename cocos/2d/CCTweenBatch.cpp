@@ -0,0 +1,511 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCTweenBatch.h"
+#include "2d/CCActionInterval.h"
+#include "2d/CCNode.h"
+#include "base/ccMacros.h"
+#include "math/MathUtil.h"
+
+#include <float.h>
+
+//#define INCLUDE_SSE       : the easing curves are evaluated with SSE2
+//#define INCLUDE_NEON      : the easing curves are evaluated with NEON, detected at runtime on Android armv7
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INCLUDE_SSE
+    #include <emmintrin.h>
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON) || defined (__aarch64__)
+    #define INCLUDE_NEON
+    #include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+//////////////////////////////////////////////////////////////////////////
+// easing curves
+
+// The same curves as the ActionEase classes, the quadratic ones use tweenfunc::quadratic*().
+static float easeTime(tweenfunc::TweenType easing, float time, float easingParam)
+{
+    switch (easing)
+    {
+    case tweenfunc::Quad_EaseIn:
+        return tweenfunc::quadraticIn(time);
+    case tweenfunc::Quad_EaseOut:
+        return tweenfunc::quadraticOut(time);
+    case tweenfunc::Quad_EaseInOut:
+        return tweenfunc::quadraticInOut(time);
+    default:
+        return tweenfunc::tweenTo(time, easing, &easingParam);
+    }
+}
+
+#if defined (INCLUDE_SSE) || defined (INCLUDE_NEON)
+
+#ifdef INCLUDE_SSE
+
+typedef __m128 float4;
+typedef __m128 mask4;
+
+static inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+static inline void store4(float* p, float4 v) { _mm_storeu_ps(p, v); }
+static inline float4 set4(float f) { return _mm_set1_ps(f); }
+static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+static inline float4 neg4(float4 a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+static inline mask4 less4(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+static inline float4 select4(mask4 mask, float4 a, float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+static bool isSimdSupported()
+{
+    return true;
+}
+
+#else
+
+typedef float32x4_t float4;
+typedef uint32x4_t mask4;
+
+static inline float4 load4(const float* p) { return vld1q_f32(p); }
+static inline void store4(float* p, float4 v) { vst1q_f32(p, v); }
+static inline float4 set4(float f) { return vdupq_n_f32(f); }
+static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+static inline float4 neg4(float4 a) { return vnegq_f32(a); }
+static inline mask4 less4(float4 a, float4 b) { return vcltq_f32(a, b); }
+static inline float4 select4(mask4 mask, float4 a, float4 b) { return vbslq_f32(mask, a, b); }
+
+static bool isSimdSupported()
+{
+    static bool supported = MathUtil::isNeon32Enabled() || MathUtil::isNeon64Enabled();
+    return supported;
+}
+
+#endif // INCLUDE_SSE
+
+static bool isVectorEasing(tweenfunc::TweenType easing)
+{
+    return easing >= tweenfunc::Quad_EaseIn && easing <= tweenfunc::Quint_EaseInOut;
+}
+
+// The polynomial curves, with the operations in the order of tweenfunc so the results are the same.
+// Both sides of the in-out curves are evaluated and the right one is selected.
+static inline float4 easeVector(tweenfunc::TweenType easing, float4 t)
+{
+    const float4 one = set4(1.0f);
+    const float4 two = set4(2.0f);
+    const float4 half = set4(0.5f);
+
+    switch (easing)
+    {
+    case tweenfunc::Quad_EaseIn:
+        return mul4(t, t);
+    case tweenfunc::Quad_EaseOut:
+        return mul4(neg4(t), sub4(t, two));
+    case tweenfunc::Quad_EaseInOut:
+        {
+            float4 t2 = mul4(t, two);
+            float4 u = sub4(t2, one);
+            float4 in = mul4(mul4(t2, t2), half);
+            float4 out = mul4(set4(-0.5f), sub4(mul4(u, sub4(u, two)), one));
+            return select4(less4(t2, one), in, out);
+        }
+    case tweenfunc::Cubic_EaseIn:
+        return mul4(mul4(t, t), t);
+    case tweenfunc::Cubic_EaseOut:
+        {
+            float4 u = sub4(t, one);
+            return add4(mul4(mul4(u, u), u), one);
+        }
+    case tweenfunc::Cubic_EaseInOut:
+        {
+            float4 t2 = mul4(t, two);
+            float4 u = sub4(t2, two);
+            float4 in = mul4(mul4(mul4(half, t2), t2), t2);
+            float4 out = mul4(half, add4(mul4(mul4(u, u), u), two));
+            return select4(less4(t2, one), in, out);
+        }
+    case tweenfunc::Quart_EaseIn:
+        return mul4(mul4(mul4(t, t), t), t);
+    case tweenfunc::Quart_EaseOut:
+        {
+            float4 u = sub4(t, one);
+            return neg4(sub4(mul4(mul4(mul4(u, u), u), u), one));
+        }
+    case tweenfunc::Quart_EaseInOut:
+        {
+            float4 t2 = mul4(t, two);
+            float4 u = sub4(t2, two);
+            float4 in = mul4(mul4(mul4(mul4(half, t2), t2), t2), t2);
+            float4 out = mul4(set4(-0.5f), sub4(mul4(mul4(mul4(u, u), u), u), two));
+            return select4(less4(t2, one), in, out);
+        }
+    case tweenfunc::Quint_EaseIn:
+        return mul4(mul4(mul4(mul4(t, t), t), t), t);
+    case tweenfunc::Quint_EaseOut:
+        {
+            float4 u = sub4(t, one);
+            return add4(mul4(mul4(mul4(mul4(u, u), u), u), u), one);
+        }
+    case tweenfunc::Quint_EaseInOut:
+        {
+            float4 t2 = mul4(t, two);
+            float4 u = sub4(t2, two);
+            float4 in = mul4(mul4(mul4(mul4(mul4(half, t2), t2), t2), t2), t2);
+            float4 out = mul4(half, add4(mul4(mul4(mul4(mul4(u, u), u), u), u), two));
+            return select4(less4(t2, one), in, out);
+        }
+    default:
+        return t;
+    }
+}
+
+#endif // INCLUDE_SSE || INCLUDE_NEON
+
+//////////////////////////////////////////////////////////////////////////
+// TweenDesc
+
+TweenDesc::TweenDesc()
+: property(Property::POSITION)
+, easing(tweenfunc::Linear)
+, easingParam(0.3f)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TweenBatch
+
+TweenBatch::TweenBatch()
+: _actionCount(0)
+, _dt(0)
+{
+}
+
+TweenBatch::~TweenBatch()
+{
+    CCASSERT(_actionCount == 0, "The batched actions should be removed first!");
+}
+
+ssize_t TweenBatch::getActionCount() const
+{
+    return _actionCount;
+}
+
+int TweenBatch::findBucket(tweenfunc::TweenType easing)
+{
+    for (int i = 0; i < (int)_buckets.size(); ++i)
+    {
+        if (_buckets[i].easing == easing)
+        {
+            return i;
+        }
+    }
+
+    Bucket bucket;
+    bucket.easing = easing;
+    _buckets.push_back(std::move(bucket));
+    return (int)_buckets.size() - 1;
+}
+
+bool TweenBatch::addAction(Action *action)
+{
+    CCASSERT(action != nullptr, "action can't be nullptr!");
+    CCASSERT(! isBatched(action), "action already batched!");
+
+    auto interval = dynamic_cast<ActionInterval*>(action);
+    if (interval == nullptr || interval->getTarget() == nullptr)
+    {
+        return false;
+    }
+
+#if CC_ENABLE_SCRIPT_BINDING
+    // step() sends the updates of these actions to the script engine
+    if (interval->_scriptType == kScriptTypeJavascript)
+    {
+        return false;
+    }
+#endif
+
+    TweenDesc desc;
+    if (! interval->getTween(desc))
+    {
+        return false;
+    }
+
+    Tween tween;
+    tween.action = interval;
+    tween.target = interval->getTarget();
+    tween.property = desc.property;
+    tween.firstTick = interval->_firstTick;
+    tween.evaluated = false;
+    tween.start = desc.start;
+    tween.previous = desc.previous;
+
+    int bucketIndex = findBucket(desc.easing);
+    auto& bucket = _buckets[bucketIndex];
+    bucket.tweens.push_back(tween);
+    bucket.elapsed.push_back(interval->_elapsed);
+    bucket.nextElapsed.push_back(0);
+    bucket.divisors.push_back(MAX(interval->getDuration(), FLT_EPSILON));
+    bucket.easingParams.push_back(desc.easingParam);
+    bucket.times.push_back(0);
+    bucket.deltaX.push_back(desc.delta.x);
+    bucket.deltaY.push_back(desc.delta.y);
+    bucket.deltaZ.push_back(desc.delta.z);
+    bucket.offsetX.push_back(0);
+    bucket.offsetY.push_back(0);
+    bucket.offsetZ.push_back(0);
+
+    action->_tweenBucket = bucketIndex;
+    action->_tweenIndex = (ssize_t)bucket.tweens.size() - 1;
+    ++_actionCount;
+
+    return true;
+}
+
+void TweenBatch::syncAction(const Bucket& bucket, ssize_t index)
+{
+    const auto& tween = bucket.tweens[index];
+
+    TweenDesc desc;
+    desc.property = tween.property;
+    desc.easing = bucket.easing;
+    desc.easingParam = bucket.easingParams[index];
+    desc.start = tween.start;
+    desc.delta.set(bucket.deltaX[index], bucket.deltaY[index], bucket.deltaZ[index]);
+    desc.previous = tween.previous;
+
+    tween.action->_elapsed = bucket.elapsed[index];
+    tween.action->_firstTick = tween.firstTick;
+    tween.action->setTween(desc);
+}
+
+void TweenBatch::removeAction(Action *action)
+{
+    if (action == nullptr || ! isBatched(action))
+    {
+        return;
+    }
+
+    int bucketIndex = action->_tweenBucket;
+    ssize_t index = action->_tweenIndex;
+    syncAction(_buckets[bucketIndex], index);
+    removeTween(bucketIndex, index);
+
+    action->_tweenBucket = -1;
+    action->_tweenIndex = -1;
+    --_actionCount;
+}
+
+void TweenBatch::removeTween(int bucketIndex, ssize_t index)
+{
+    auto& bucket = _buckets[bucketIndex];
+    ssize_t lastIndex = (ssize_t)bucket.tweens.size() - 1;
+
+    if (index != lastIndex)
+    {
+        bucket.tweens[index] = bucket.tweens[lastIndex];
+        bucket.elapsed[index] = bucket.elapsed[lastIndex];
+        bucket.nextElapsed[index] = bucket.nextElapsed[lastIndex];
+        bucket.divisors[index] = bucket.divisors[lastIndex];
+        bucket.easingParams[index] = bucket.easingParams[lastIndex];
+        bucket.times[index] = bucket.times[lastIndex];
+        bucket.deltaX[index] = bucket.deltaX[lastIndex];
+        bucket.deltaY[index] = bucket.deltaY[lastIndex];
+        bucket.deltaZ[index] = bucket.deltaZ[lastIndex];
+        bucket.offsetX[index] = bucket.offsetX[lastIndex];
+        bucket.offsetY[index] = bucket.offsetY[lastIndex];
+        bucket.offsetZ[index] = bucket.offsetZ[lastIndex];
+        bucket.tweens[index].action->_tweenIndex = index;
+    }
+
+    bucket.tweens.pop_back();
+    bucket.elapsed.pop_back();
+    bucket.nextElapsed.pop_back();
+    bucket.divisors.pop_back();
+    bucket.easingParams.pop_back();
+    bucket.times.pop_back();
+    bucket.deltaX.pop_back();
+    bucket.deltaY.pop_back();
+    bucket.deltaZ.pop_back();
+    bucket.offsetX.pop_back();
+    bucket.offsetY.pop_back();
+    bucket.offsetZ.pop_back();
+}
+
+void TweenBatch::evaluate(Bucket& bucket, ssize_t begin, ssize_t end)
+{
+    const float* elapsed = bucket.elapsed.data();
+    const float* divisors = bucket.divisors.data();
+    float* nextElapsed = bucket.nextElapsed.data();
+    float* times = bucket.times.data();
+    const float* deltaX = bucket.deltaX.data();
+    const float* deltaY = bucket.deltaY.data();
+    const float* deltaZ = bucket.deltaZ.data();
+    float* offsetX = bucket.offsetX.data();
+    float* offsetY = bucket.offsetY.data();
+    float* offsetZ = bucket.offsetZ.data();
+
+    // the same steps as ActionInterval::step(), the elapsed time is only kept once the action is stepped
+    for (ssize_t i = begin; i < end; ++i)
+    {
+        auto& tween = bucket.tweens[i];
+        nextElapsed[i] = tween.firstTick ? 0 : elapsed[i] + _dt;
+        times[i] = MAX (0,                              // needed for rewind. elapsed could be negative
+                        MIN(1, nextElapsed[i] / divisors[i]));
+        tween.evaluated = true;
+    }
+
+    // eased times, in place
+    ssize_t i = begin;
+    if (bucket.easing != tweenfunc::Linear)
+    {
+#if defined (INCLUDE_SSE) || defined (INCLUDE_NEON)
+        if (isSimdSupported() && isVectorEasing(bucket.easing))
+        {
+            for (; i + 4 <= end; i += 4)
+            {
+                store4(times + i, easeVector(bucket.easing, load4(times + i)));
+            }
+        }
+#endif
+        const float* easingParams = bucket.easingParams.data();
+        for (; i < end; ++i)
+        {
+            times[i] = easeTime(bucket.easing, times[i], easingParams[i]);
+        }
+    }
+
+    // delta * time, the start values are added when the actions are stepped
+    i = begin;
+#if defined (INCLUDE_SSE) || defined (INCLUDE_NEON)
+    if (isSimdSupported())
+    {
+        for (; i + 4 <= end; i += 4)
+        {
+            float4 t = load4(times + i);
+            store4(offsetX + i, mul4(load4(deltaX + i), t));
+            store4(offsetY + i, mul4(load4(deltaY + i), t));
+            store4(offsetZ + i, mul4(load4(deltaZ + i), t));
+        }
+    }
+#endif
+    for (; i < end; ++i)
+    {
+        offsetX[i] = deltaX[i] * times[i];
+        offsetY[i] = deltaY[i] * times[i];
+        offsetZ[i] = deltaZ[i] * times[i];
+    }
+}
+
+void TweenBatch::update(float dt)
+{
+    _dt = dt;
+
+    for (auto& bucket : _buckets)
+    {
+        evaluate(bucket, 0, (ssize_t)bucket.tweens.size());
+    }
+}
+
+void TweenBatch::step(Action *action)
+{
+    CCASSERT(isBatched(action), "action isn't batched!");
+
+    auto& bucket = _buckets[action->_tweenBucket];
+    ssize_t i = action->_tweenIndex;
+    if (! bucket.tweens[i].evaluated)
+    {
+        // added after update()
+        evaluate(bucket, i, i + 1);
+    }
+
+    auto& tween = bucket.tweens[i];
+    tween.evaluated = false;
+    tween.firstTick = false;
+    bucket.elapsed[i] = bucket.nextElapsed[i];
+    tween.action->_firstTick = false;
+    tween.action->_elapsed = bucket.elapsed[i];
+
+    // the tween is copied, the setters of the target may add or remove actions
+    Node *target = tween.target;
+    Vec3 start = tween.start;
+    Vec3 offset(bucket.offsetX[i], bucket.offsetY[i], bucket.offsetZ[i]);
+
+    switch (tween.property)
+    {
+    case TweenDesc::Property::POSITION:
+        {
+#if CC_ENABLE_STACKABLE_ACTIONS
+            Vec3 currentPos = target->getPosition3D();
+            Vec3 diff = currentPos - tween.previous;
+            tween.start = start + diff;
+            Vec3 newPos = tween.start + offset;
+            tween.previous = newPos;
+            target->setPosition3D(newPos);
+#else
+            target->setPosition3D(start + offset);
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+        }
+        break;
+    case TweenDesc::Property::SCALE:
+        target->setScaleX(start.x + offset.x);
+        target->setScaleY(start.y + offset.y);
+        target->setScaleZ(start.z + offset.z);
+        break;
+    case TweenDesc::Property::ROTATION:
+#if CC_USE_PHYSICS
+        if (start.x == start.y && bucket.deltaX[i] == bucket.deltaY[i])
+        {
+            target->setRotation(start.x + offset.x);
+        }
+        else
+        {
+            target->setRotationSkewX(start.x + offset.x);
+            target->setRotationSkewY(start.y + offset.y);
+        }
+#else
+        target->setRotationSkewX(start.x + offset.x);
+        target->setRotationSkewY(start.y + offset.y);
+#endif // CC_USE_PHYSICS
+        break;
+    case TweenDesc::Property::ROTATION_3D:
+        {
+            Vec3 v;
+            v.x = start.x + offset.x;
+            v.y = start.y + offset.y;
+            v.z = start.z + offset.z;
+            target->setRotation3D(v);
+        }
+        break;
+    case TweenDesc::Property::OPACITY:
+        target->setOpacity((GLubyte)(start.x + offset.x));
+        break;
+    }
+}
+
+NS_CC_END
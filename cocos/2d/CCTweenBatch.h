@@ -0,0 +1,173 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __ACTION_CCTWEEN_BATCH_H__
+#define __ACTION_CCTWEEN_BATCH_H__
+
+#include <vector>
+
+#include "2d/CCAction.h"
+#include "2d/CCTweenFunction.h"
+#include "math/Vec3.h"
+
+NS_CC_BEGIN
+
+class Node;
+class ActionInterval;
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+
+/** @struct TweenDesc
+ * @brief Describes an interval action as a tween of one property of its target:
+ * value = start + delta * easing(time).
+ * @since v3.10
+ * @js NA
+ * @lua NA
+ */
+struct CC_DLL TweenDesc
+{
+    enum class Property
+    {
+        POSITION,       ///< setPosition3D(), stacked like MoveBy when CC_ENABLE_STACKABLE_ACTIONS is on
+        SCALE,          ///< setScaleX(), setScaleY() and setScaleZ()
+        ROTATION,       ///< setRotationSkewX() and setRotationSkewY(), like RotateBy
+        ROTATION_3D,    ///< setRotation3D()
+        OPACITY,        ///< setOpacity() of x
+    };
+
+    TweenDesc();
+
+    Property property;
+    /** The tweenfunc curve applied to the time, Linear for the plain actions. */
+    tweenfunc::TweenType easing;
+    /** The easing parameter, the period of the elastic curves. */
+    float easingParam;
+    Vec3 start;
+    Vec3 delta;
+    /** The last value set by the tween, for the stacked positions. */
+    Vec3 previous;
+};
+
+/** @class TweenBatch
+ * @brief Evaluates many interval actions at once.
+ * The batched actions are kept in arrays grouped by easing curve. At the start of a frame
+ * update() evaluates the eased times and the deltas of all of them in bulk, with SSE or NEON
+ * when they are available. step() then sets the result of one action on its target, in
+ * place of ActionInterval::step(), so the actions keep their order.
+ * Only the actions whose getTween() describes them are batched: MoveBy, MoveTo,
+ * ScaleTo, ScaleBy, RotateBy, FadeTo, FadeIn and FadeOut, optionally wrapped in
+ * one of the ActionEase curves of tweenfunc.
+ * It is used by ActionManager, see ActionManager::setTweenBatchEnabled().
+ * @since v3.10
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL TweenBatch
+{
+public:
+    TweenBatch();
+    ~TweenBatch();
+
+    /** Adds an action that was started with its target.
+     *
+     * @param action    A started action.
+     * @return False if the action can't be batched, it has to be stepped as usual then.
+     */
+    bool addAction(Action *action);
+
+    /** Removes a batched action. The state of the action is updated from the batch,
+     * so it can be stepped as usual afterwards.
+     */
+    void removeAction(Action *action);
+
+    /** Evaluates all the batched actions for a frame. Nothing is set on the targets,
+     * so the result of the actions that are not stepped afterwards is discarded.
+     *
+     * @param dt    In seconds.
+     */
+    void update(float dt);
+
+    /** Steps a batched action like ActionInterval::step(), with the result of update().
+     * The actions added since update() are evaluated on their own.
+     */
+    void step(Action *action);
+
+    /** Returns the number of batched actions. */
+    ssize_t getActionCount() const;
+
+    /** Returns whether the action is in a TweenBatch. */
+    static bool isBatched(const Action *action) { return action->_tweenIndex >= 0; }
+
+protected:
+    // the targets and the per action state
+    struct Tween
+    {
+        ActionInterval *action;
+        Node *target;
+        TweenDesc::Property property;
+        bool firstTick;
+        // whether the arrays hold the result of the current frame
+        bool evaluated;
+        Vec3 start;
+        Vec3 previous;
+    };
+
+    // the tweens using one easing curve, the floats are kept in separate arrays for SIMD
+    struct Bucket
+    {
+        tweenfunc::TweenType easing;
+        std::vector<Tween> tweens;
+        std::vector<float> elapsed;
+        std::vector<float> nextElapsed;
+        std::vector<float> divisors;
+        std::vector<float> easingParams;
+        std::vector<float> times;
+        std::vector<float> deltaX;
+        std::vector<float> deltaY;
+        std::vector<float> deltaZ;
+        std::vector<float> offsetX;
+        std::vector<float> offsetY;
+        std::vector<float> offsetZ;
+    };
+
+    int findBucket(tweenfunc::TweenType easing);
+    void removeTween(int bucketIndex, ssize_t index);
+    void syncAction(const Bucket& bucket, ssize_t index);
+    void evaluate(Bucket& bucket, ssize_t begin, ssize_t end);
+
+    std::vector<Bucket> _buckets;
+    ssize_t _actionCount;
+    // the delta time of the current frame
+    float _dt;
+};
+
+// end of actions group
+/// @}
+
+NS_CC_END
+
+#endif // __ACTION_CCTWEEN_BATCH_H__
@@ -32,6 +32,7 @@
 #include "base/CCDirector.h"
 #include "base/CCConfiguration.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
 #include "renderer/CCTechnique.h"
@@ -127,6 +128,7 @@ Mesh::Mesh()
 , _isTransparent(false)
 , _meshIndexData(nullptr)
 , _material(nullptr)
+, _instancedMaterial(nullptr)
 , _glProgramState(nullptr)
 , _blend(BlendFunc::ALPHA_NON_PREMULTIPLIED)
 , _visibleChanged(nullptr)
@@ -145,6 +147,7 @@ Mesh::~Mesh()
     CC_SAFE_RELEASE(_skin);
     CC_SAFE_RELEASE(_meshIndexData);
     CC_SAFE_RELEASE(_material);
+    CC_SAFE_RELEASE(_instancedMaterial);
     CC_SAFE_RELEASE(_glProgramState);
 }
 
@@ -407,6 +410,26 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
     _meshCommand.set3D(!_force2DQueue);
     _material->getStateBlock()->setBlend(_force2DQueue || isTransparent);
 
+    const Vec4* matrixPalette = _skin ? _skin->getMatrixPalette() : nullptr;
+    const ssize_t matrixPaletteSize = _skin ? _skin->getMatrixPaletteSize() : 0;
+
+    // opaque meshes may be drawn instanced, the color is then read from the instance buffer instead of u_color.
+    // Building the instanced material creates GL objects, so it is not done while recording on worker threads.
+    if (!isTransparent && renderer->isInstancingEnabled())
+    {
+        auto instancedMaterial = renderer->isRecordingInParallel() ? _instancedMaterial : getInstancedMaterial();
+        if (instancedMaterial && _skin)
+        {
+            // skinned meshes are only drawn together when their matrix palettes are the same
+            instancedMaterial->_currentTechnique->_passes.at(0)->getGLProgramState()->setUniformVec4v("u_matrixPalette", (GLsizei)matrixPaletteSize, matrixPalette);
+            _meshCommand.setInstancedMaterial(instancedMaterial, color, matrixPalette, matrixPaletteSize);
+        }
+        else
+        {
+            _meshCommand.setInstancedMaterial(instancedMaterial, color);
+        }
+    }
+
     // set default uniforms for Mesh
     // 'u_color' and others
     const auto scene = Director::getInstance()->getRunningScene();
@@ -417,7 +440,7 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
         programState->setUniformVec4("u_color", color);
 
         if (_skin)
-            programState->setUniformVec4v("u_matrixPalette", (GLsizei)_skin->getMatrixPaletteSize(), _skin->getMatrixPalette());
+            programState->setUniformVec4v("u_matrixPalette", (GLsizei)matrixPaletteSize, matrixPalette);
 
         if (scene && scene->getLights().size() > 0)
             setLightUniforms(pass, scene, color, lightMask);
@@ -433,6 +456,7 @@ void Mesh::setSkin(MeshSkin* skin)
         CC_SAFE_RETAIN(skin);
         CC_SAFE_RELEASE(_skin);
         _skin = skin;
+        CC_SAFE_RELEASE_NULL(_instancedMaterial);
         calculateAABB();
     }
 }
@@ -504,6 +528,9 @@ void Mesh::calculateAABB()
 
 void Mesh::bindMeshCommand()
 {
+    // rebuilt on demand with the new material, texture or vertex data
+    CC_SAFE_RELEASE_NULL(_instancedMaterial);
+
     if (_material && _meshIndexData)
     {
         auto pass = _material->_currentTechnique->_passes.at(0);
@@ -520,6 +547,36 @@ void Mesh::bindMeshCommand()
     }
 }
 
+Material* Mesh::getInstancedMaterial()
+{
+    // Only meshes drawn with the default unlit textured shaders can be instanced, their only
+    // per mesh states are then the model view matrix, the color and for skinned meshes the matrix palette
+    if (!_material || !_meshIndexData)
+        return nullptr;
+
+    if (!_instancedMaterial)
+    {
+        auto glProgramCache = GLProgramCache::getInstance();
+        auto& passes = _material->_currentTechnique->_passes;
+        const char* programName = _skin ? GLProgram::SHADER_3D_SKINPOSITION_TEXTURE : GLProgram::SHADER_3D_POSITION_TEXTURE;
+        if (passes.size() != 1
+            || passes.at(0)->getGLProgramState()->getGLProgram() != glProgramCache->getGLProgram(programName))
+            return nullptr;
+
+        const char* instancedProgramName = _skin ? GLProgram::SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED : GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED;
+        auto glProgramState = GLProgramState::create(glProgramCache->getGLProgram(instancedProgramName));
+        _instancedMaterial = Material::createWithGLStateProgram(glProgramState);
+        _instancedMaterial->retain();
+        // share the render state, so the changes made in draw() apply to both materials
+        _instancedMaterial->setStateBlock(_material->getStateBlock());
+
+        auto pass = _instancedMaterial->_currentTechnique->_passes.at(0);
+        pass->setVertexAttribBinding(VertexAttribBinding::create(_meshIndexData, glProgramState));
+        pass->setTexture(passes.at(0)->getTexture());
+    }
+    return _instancedMaterial;
+}
+
 void Mesh::setLightUniforms(Pass* pass, Scene* scene, const Vec4& color, unsigned int lightmask)
 {
     CCASSERT(pass, "Invalid Pass");
@@ -247,6 +247,8 @@ protected:
     void resetLightUniformValues();
     void setLightUniforms(Pass* pass, Scene* scene, const Vec4& color, unsigned int lightmask);
     void bindMeshCommand();
+    //returns the material used to draw this mesh instanced, or nullptr if it can't be instanced
+    Material* getInstancedMaterial();
 
     std::map<NTextureData::Usage, Texture2D*> _textures; //textures that submesh is using
     MeshSkin*           _skin;     //skin
@@ -261,6 +263,7 @@ protected:
     BlendFunc           _blend;
     bool                _blendDirty;
     Material*           _material;
+    Material*           _instancedMaterial;
     AABB                _aabb;
     std::function<void()> _visibleChanged;
     
@@ -0,0 +1,201 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "base/CCAsyncFileLoader.h"
+
+#include <memory>
+
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+static const int DEFAULT_THREAD_COUNT = 2;
+static const size_t DEFAULT_MAX_BYTES_IN_FLIGHT = 32 * 1024 * 1024;
+
+AsyncFileLoader* AsyncFileLoader::s_sharedLoader = nullptr;
+
+AsyncFileLoader* AsyncFileLoader::getInstance()
+{
+    if (s_sharedLoader == nullptr)
+    {
+        s_sharedLoader = new (std::nothrow) AsyncFileLoader();
+    }
+    return s_sharedLoader;
+}
+
+void AsyncFileLoader::destroyInstance()
+{
+    delete s_sharedLoader;
+    s_sharedLoader = nullptr;
+}
+
+AsyncFileLoader::AsyncFileLoader()
+: _threadCount(DEFAULT_THREAD_COUNT)
+, _bytesInFlight(0)
+, _maxBytesInFlight(DEFAULT_MAX_BYTES_IN_FLIGHT)
+, _stop(false)
+{
+}
+
+AsyncFileLoader::~AsyncFileLoader()
+{
+    stopThreads();
+}
+
+void AsyncFileLoader::setThreadCount(int count)
+{
+    if (count < 1)
+        count = 1;
+
+    if (count == _threadCount)
+        return;
+
+    // the files in the queue are read by the new threads
+    _threadCount = count;
+    if (!_threads.empty())
+    {
+        stopThreads();
+        startThreads();
+    }
+}
+
+void AsyncFileLoader::setMaxBytesInFlight(size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxBytesInFlight = bytes;
+    }
+    _condition.notify_all();
+}
+
+void AsyncFileLoader::startThreads()
+{
+    _stop = false;
+    _threads.reserve(_threadCount);
+    for (int i = 0; i < _threadCount; ++i)
+    {
+        _threads.push_back(std::thread(&AsyncFileLoader::threadLoop, this));
+    }
+}
+
+void AsyncFileLoader::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+void AsyncFileLoader::load(const std::string& fullPath, const Reader& reader, const Callback& callback)
+{
+    if (_threads.empty())
+    {
+        startThreads();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = _requests.find(fullPath);
+        if (iter != _requests.end())
+        {
+            // the file is already queued or being read
+            iter->second.callbacks.push_back(callback);
+            return;
+        }
+
+        auto& request = _requests[fullPath];
+        request.reader = reader;
+        request.callbacks.push_back(callback);
+        _queue.push_back(fullPath);
+    }
+    _condition.notify_one();
+}
+
+void AsyncFileLoader::releaseBytes(size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bytesInFlight = bytes < _bytesInFlight ? _bytesInFlight - bytes : 0;
+    }
+    _condition.notify_all();
+}
+
+void AsyncFileLoader::threadLoop()
+{
+    while (true)
+    {
+        std::string fullPath;
+        Reader reader;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] {
+                return _stop || (!_queue.empty() && (_bytesInFlight < _maxBytesInFlight || _bytesInFlight == 0));
+            });
+            if (_stop)
+                break;
+
+            fullPath = std::move(_queue.front());
+            _queue.pop_front();
+            // the request stays in the map, so that the files requested while it is read share the read
+            reader = _requests[fullPath].reader;
+        }
+
+        auto data = std::make_shared<Data>(reader());
+        size_t size = static_cast<size_t>(data->getSize());
+
+        auto callbacks = std::make_shared<std::vector<Callback>>();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _bytesInFlight += size;
+            auto iter = _requests.find(fullPath);
+            callbacks->swap(iter->second.callbacks);
+            _requests.erase(iter);
+        }
+
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([data, callbacks, size] {
+            for (size_t i = 0; i < callbacks->size(); ++i)
+            {
+                // the data is only copied for the files requested several times
+                if (i + 1 < callbacks->size())
+                    (*callbacks)[i](*data);
+                else
+                    (*callbacks)[i](std::move(*data));
+            }
+
+            if (s_sharedLoader)
+            {
+                s_sharedLoader->releaseBytes(size);
+            }
+        });
+    }
+}
+
+NS_CC_END
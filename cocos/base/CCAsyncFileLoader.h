@@ -0,0 +1,131 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCASYNC_FILE_LOADER_H_
+#define __CCASYNC_FILE_LOADER_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class AsyncFileLoader
+ * @brief Reads files on a pool of I/O threads, used by FileUtils::getDataFromFileAsync().
+ *
+ * Requests for a file which is already being loaded share the same read. The data read but not yet
+ * given to the callbacks is limited by a budget, so that queuing many large files doesn't load all of
+ * them in memory at once: the threads wait until the callbacks of the previous files have been called.
+ * @since v3.10
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL AsyncFileLoader
+{
+public:
+    typedef std::function<void(Data)> Callback;
+    /** Reads a file on an I/O thread, it must not use any state shared with the cocos thread. */
+    typedef std::function<Data()> Reader;
+
+    /** Returns the shared instance of the loader, its threads are started by the first load(). */
+    static AsyncFileLoader* getInstance();
+
+    /** Destroys the shared instance, joining its threads. The callbacks of the pending files are never called. */
+    static void destroyInstance();
+
+    /** Sets the number of I/O threads, 2 by default. */
+    void setThreadCount(int count);
+
+    /** Returns the number of I/O threads. */
+    int getThreadCount() const { return _threadCount; }
+
+    /** Sets how many bytes may be read and waiting for their callbacks, 32MB by default.
+     * A file is always read if nothing else is, however large it is.
+     */
+    void setMaxBytesInFlight(size_t bytes);
+
+    /** Returns how many bytes may be read and waiting for their callbacks. */
+    size_t getMaxBytesInFlight() const { return _maxBytesInFlight; }
+
+    /**
+     * Reads a file on an I/O thread, then calls the callback on the cocos thread.
+     * @note Must be called on the cocos thread.
+     * @param fullPath The full path of the file, the requests with the same path share the same read.
+     * @param reader Called on an I/O thread to read the file, FileUtils::getDataFromFileAsync() resolves
+     * the file on the cocos thread and gives a reader which doesn't use the FileUtils caches.
+     * @param callback Called with the data of the file, which is null if the file couldn't be read.
+     */
+    void load(const std::string& fullPath, const Reader& reader, const Callback& callback);
+
+CC_CONSTRUCTOR_ACCESS:
+    AsyncFileLoader();
+    ~AsyncFileLoader();
+
+protected:
+    void startThreads();
+    void stopThreads();
+    void threadLoop();
+    void releaseBytes(size_t bytes);
+
+    std::vector<std::thread> _threads;
+    int _threadCount;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+
+    struct Request
+    {
+        Reader reader;
+        std::vector<Callback> callbacks;
+    };
+
+    /** The files waiting for a thread, in the order they were requested. */
+    std::deque<std::string> _queue;
+    /** The files in the queue or being read. */
+    std::unordered_map<std::string, Request> _requests;
+
+    size_t _bytesInFlight;
+    size_t _maxBytesInFlight;
+    bool _stop;
+
+    static AsyncFileLoader* s_sharedLoader;
+};
+
+NS_CC_END
+// end of base group
+/** @} */
+
+#endif // __CCASYNC_FILE_LOADER_H_
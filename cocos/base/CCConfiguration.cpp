@@ -49,6 +49,10 @@ Configuration::Configuration()
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
+, _supportsMapBufferRange(false)
+, _supportsSyncObjects(false)
+, _supportsInstancedArrays(false)
+, _supportsProgramBinary(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -150,6 +154,33 @@ void Configuration::gatherGPUInfo()
     _supportsShareableVAO = checkForGLExtension("vertex_array_object");
 	_valueDict["gl.supports_vertex_array_object"] = Value(_supportsShareableVAO);
 
+    _supportsMapBufferRange = checkForGLExtension("map_buffer_range");
+    _valueDict["gl.supports_map_buffer_range"] = Value(_supportsMapBufferRange);
+
+    _supportsSyncObjects = checkForGLExtension("GL_ARB_sync") || checkForGLExtension("GL_APPLE_sync");
+    _valueDict["gl.supports_sync_objects"] = Value(_supportsSyncObjects);
+
+    _supportsInstancedArrays = checkForGLExtension("instanced_arrays");
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    // glew only resolves the core entry points if the context is recent enough
+    _supportsInstancedArrays = _supportsInstancedArrays && glDrawElementsInstanced && glVertexAttribDivisor;
+#endif
+    _valueDict["gl.supports_instanced_arrays"] = Value(_supportsInstancedArrays);
+
+#if CC_GLPROGRAM_USE_PROGRAM_BINARY
+    _supportsProgramBinary = checkForGLExtension("get_program_binary");
+    // glew and the android extension loader both resolve these as function pointers which may be null
+    _supportsProgramBinary = _supportsProgramBinary && glGetProgramBinary && glProgramBinary;
+    if (_supportsProgramBinary)
+    {
+        // the extension may be exposed without any binary format the driver can reload
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        _supportsProgramBinary = formats > 0;
+    }
+#endif
+    _valueDict["gl.supports_program_binary"] = Value(_supportsProgramBinary);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -259,6 +290,42 @@ bool Configuration::supportsShareableVAO() const
 #endif
 }
 
+bool Configuration::supportsMapBufferRange() const
+{
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+    return _supportsMapBufferRange;
+#else
+    return false;
+#endif
+}
+
+bool Configuration::supportsSyncObjects() const
+{
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+    return _supportsSyncObjects;
+#else
+    return false;
+#endif
+}
+
+bool Configuration::supportsInstancedArrays() const
+{
+#if CC_RENDERER_USE_INSTANCING
+    return _supportsInstancedArrays;
+#else
+    return false;
+#endif
+}
+
+bool Configuration::supportsProgramBinary() const
+{
+#if CC_GLPROGRAM_USE_PROGRAM_BINARY
+    return _supportsProgramBinary;
+#else
+    return false;
+#endif
+}
+
 int Configuration::getMaxSupportDirLightInShader() const
 {
     return _maxDirLightInShader;
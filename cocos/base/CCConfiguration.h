@@ -145,6 +145,34 @@ public:
      * @since v2.0.0
      */
 	bool supportsShareableVAO() const;
+
+    /** Whether or not glMapBufferRange is supported.
+     *
+     * @return Is true if supports glMapBufferRange.
+     * @since v3.10
+     */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not sync objects (glFenceSync/glClientWaitSync) are supported.
+     *
+     * @return Is true if supports sync objects.
+     * @since v3.10
+     */
+    bool supportsSyncObjects() const;
+
+    /** Whether or not instanced arrays (glVertexAttribDivisor/glDrawElementsInstanced) are supported.
+     *
+     * @return Is true if supports instanced arrays.
+     * @since v3.10
+     */
+    bool supportsInstancedArrays() const;
+
+    /** Whether or not program binaries (glGetProgramBinary/glProgramBinary) are supported.
+     *
+     * @return Is true if the driver can save and reload linked programs.
+     * @since v3.10
+     */
+    bool supportsProgramBinary() const;
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -232,6 +260,10 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsMapBufferRange;
+    bool            _supportsSyncObjects;
+    bool            _supportsInstancedArrays;
+    bool            _supportsProgramBinary;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
@@ -63,6 +63,7 @@
 #include "platform/CCPlatformConfig.h"
 #include "base/CCConfiguration.h"
 #include "2d/CCScene.h"
+#include "2d/CCSpriteFrameCache.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
 #include "base/base64.h"
@@ -349,6 +350,7 @@ Console::Console()
         { "projection", "Change or print the current projection. Args: [2d | 3d]", std::bind(&Console::commandProjection, this, std::placeholders::_1, std::placeholders::_2) },
         { "resolution", "Change or print the window resolution. Args: [width height resolution_policy | ]", std::bind(&Console::commandResolution, this, std::placeholders::_1, std::placeholders::_2) },
         { "scenegraph", "Print the scene graph", std::bind(&Console::commandSceneGraph, this, std::placeholders::_1, std::placeholders::_2) },
+        { "spriteframe", "Flush the unused frames or print the SpriteFrameCache info. Args: [flush | ] ", std::bind(&Console::commandSpriteFrames, this, std::placeholders::_1, std::placeholders::_2) },
         { "texture", "Flush or print the TextureCache info. Args: [flush | ] ", std::bind(&Console::commandTextures, this, std::placeholders::_1, std::placeholders::_2) },
         { "director", "director commands, type -h or [director help] to list supported directives", std::bind(&Console::commandDirector, this, std::placeholders::_1, std::placeholders::_2) },
         { "touch", "simulate touch event via console, type -h or [touch help] to list supported directives", std::bind(&Console::commandTouch, this, std::placeholders::_1, std::placeholders::_2) },
@@ -637,6 +639,31 @@ void Console::commandProjection(int fd, const std::string& args)
     }
 }
 
+void Console::commandSpriteFrames(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+
+    if( args.compare("flush")== 0)
+    {
+        sched->performFunctionInCocosThread( [](){
+            SpriteFrameCache::getInstance()->removeUnusedSpriteFrames();
+        }
+                                            );
+    }
+    else if(args.empty())
+    {
+        sched->performFunctionInCocosThread( [=](){
+            mydprintf(fd, "%s", SpriteFrameCache::getInstance()->getCachedSpriteFrameInfo().c_str());
+            sendPrompt(fd);
+        }
+                                            );
+    }
+    else
+    {
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'flush' or nothing", args.c_str());
+    }
+}
+
 void Console::commandTextures(int fd, const std::string& args)
 {
     Scheduler *sched = Director::getInstance()->getScheduler();
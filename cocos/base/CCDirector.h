@@ -565,6 +565,7 @@ protected:
     LabelAtlas *_FPSLabel;
     LabelAtlas *_drawnBatchesLabel;
     LabelAtlas *_drawnVerticesLabel;
+    LabelAtlas *_uploadedBytesLabel;
     
     /** Whether or not the Director is paused */
     bool _paused;
@@ -31,6 +31,16 @@ EventCustom::EventCustom(const std::string& eventName)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
 , _eventName(eventName)
+, _internedName(nullptr)
+, _eventID(-1)
+{
+}
+
+EventCustom::EventCustom(int eventID, const std::string& eventName)
+: Event(Type::CUSTOM)
+, _userData(nullptr)
+, _internedName(&eventName)
+, _eventID(eventID)
 {
 }
 
@@ -48,6 +48,16 @@ public:
      */
     EventCustom(const std::string& eventName);
     
+    /** Constructor of an event dispatched by ID, the name isn't copied.
+     *
+     * @param eventID The ID returned by EventDispatcher::registerCustomEventID().
+     * @param eventName The name of the event, it must outlive the event.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    EventCustom(int eventID, const std::string& eventName);
+    
     /** Sets user data.
      *
      * @param data The user data pointer, it's a void*.
@@ -64,10 +74,21 @@ public:
      *
      * @return The name of the event.
      */
-    inline const std::string& getEventName() const { return _eventName; };
+    inline const std::string& getEventName() const { return _internedName ? *_internedName : _eventName; };
+    
+    /** Gets the ID of an event dispatched by ID.
+     *
+     * @return The ID of the event, or -1 if it was created with a name.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    inline int getEventID() const { return _eventID; };
 protected:
     void* _userData;       ///< User data
     std::string _eventName;
+    const std::string* _internedName;   ///< The name of an event dispatched by ID, not owned
+    int _eventID;
 };
 
 NS_CC_END
@@ -23,6 +23,7 @@
  ****************************************************************************/
 #include "base/CCEventDispatcher.h"
 #include <algorithm>
+#include <cmath>
 
 #include "base/CCEventCustom.h"
 #include "base/CCEventListenerTouch.h"
@@ -38,6 +39,7 @@
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
 #include "2d/CCCamera.h"
+#include "math/CCAffineTransform.h"
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
 
@@ -66,29 +68,22 @@ private:
 
 NS_CC_BEGIN
 
-static EventListener::ListenerID __getListenerID(Event* event)
+static const EventListener::ListenerID& __getListenerID(Event* event)
 {
-    EventListener::ListenerID ret;
+    // returns a reference, so the name of a custom event isn't copied
+    static const EventListener::ListenerID invalid;
     switch (event->getType())
     {
         case Event::Type::ACCELERATION:
-            ret = EventListenerAcceleration::LISTENER_ID;
-            break;
+            return EventListenerAcceleration::LISTENER_ID;
         case Event::Type::CUSTOM:
-            {
-                auto customEvent = static_cast<EventCustom*>(event);
-                ret = customEvent->getEventName();
-            }
-            break;
+            return static_cast<EventCustom*>(event)->getEventName();
         case Event::Type::KEYBOARD:
-            ret = EventListenerKeyboard::LISTENER_ID;
-            break;
+            return EventListenerKeyboard::LISTENER_ID;
         case Event::Type::MOUSE:
-            ret = EventListenerMouse::LISTENER_ID;
-            break;
+            return EventListenerMouse::LISTENER_ID;
         case Event::Type::FOCUS:
-            ret = EventListenerFocus::LISTENER_ID;
-            break;
+            return EventListenerFocus::LISTENER_ID;
         case Event::Type::TOUCH:
             // Touch listener is very special, it contains two kinds of listeners, EventListenerTouchOneByOne and EventListenerTouchAllAtOnce.
             // return UNKNOWN instead.
@@ -96,15 +91,14 @@ static EventListener::ListenerID __getListenerID(Event* event)
             break;
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
         case Event::Type::GAME_CONTROLLER:
-            ret = EventListenerController::LISTENER_ID;
-            break;
+            return EventListenerController::LISTENER_ID;
 #endif
         default:
             CCASSERT(false, "Invalid type!");
             break;
     }
     
-    return ret;
+    return invalid;
 }
 
 EventDispatcher::EventListenerVector::EventListenerVector() :
@@ -202,6 +196,10 @@ EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
 , _nodePriorityIndex(0)
+, _touchBoundsDirty(false)
+, _touchBroadphaseStamp(0)
+, _touchBroadphaseEnabled(false)
+, _listenerMapVersion(0)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -417,10 +415,20 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
     
     listeners->push_back(listener);
+    
+    if (_touchBroadphaseEnabled && listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+    {
+        addTouchBounds(node, listener);
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
 {
+    if (_touchBroadphaseEnabled && listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+    {
+        removeTouchBounds(listener);
+    }
+    
     std::vector<EventListener*>* listeners = nullptr;
     auto found = _nodeListenersMap.find(node);
     if (found != _nodeListenersMap.end())
@@ -464,6 +472,7 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
         
         listeners = new (std::nothrow) EventListenerVector();
         _listenerMap.insert(std::make_pair(listenerID, listeners));
+        ++_listenerMapVersion;
     }
     else
     {
@@ -672,6 +681,7 @@ void EventDispatcher::removeEventListener(EventListener* listener)
             _priorityDirtyFlagMap.erase(listener->getListenerID());
             auto list = iter->second;
             iter = _listenerMap.erase(iter);
+            ++_listenerMapVersion;
             CC_SAFE_DELETE(list);
         }
         else
@@ -791,6 +801,11 @@ void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, c
 }
 
 void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent)
+{
+    dispatchTouchEventToListeners(listeners, onEvent, nullptr);
+}
+
+void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent, const Vec2* broadphaseLocation)
 {
     bool shouldStopPropagation = false;
     auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
@@ -847,12 +862,18 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
                 
                 Camera::_visitingCamera = camera;
                 auto cameraFlag = (unsigned short)camera->getCameraFlag();
+                // the bounded listeners whose node doesn't contain the touch would not claim it
+                bool useBroadphase = broadphaseLocation && _touchBroadphaseEnabled && queryTouchBroadphase(camera, *broadphaseLocation);
                 for (auto& l : sceneListeners)
                 {
                     if (nullptr == l->getAssociatedNode() || 0 == (l->getAssociatedNode()->getCameraMask() & cameraFlag))
                     {
                         continue;
                     }
+                    if (useBroadphase && !isTouchBroadphaseCandidate(l))
+                    {
+                        continue;
+                    }
                     if (onEvent(l))
                     {
                         shouldStopPropagation = true;
@@ -936,6 +957,74 @@ void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *op
     dispatchEvent(&ev);
 }
 
+int EventDispatcher::registerCustomEventID(const std::string &eventName)
+{
+    auto found = _customEventIDs.find(eventName);
+    if (found != _customEventIDs.end())
+        return found->second;
+    
+    int eventID = static_cast<int>(_customEvents.size());
+    auto inserted = _customEventIDs.insert(std::make_pair(eventName, eventID)).first;
+    
+    // the keys of the map don't move, so the entry keeps a pointer to the name
+    CustomEventEntry entry;
+    entry.name = &inserted->first;
+    entry.listeners = nullptr;
+    entry.dirtyFlag = nullptr;
+    entry.mapVersion = _listenerMapVersion - 1;
+    _customEvents.push_back(entry);
+    return eventID;
+}
+
+void EventDispatcher::updateCustomEventEntry(CustomEventEntry& entry)
+{
+    if (entry.mapVersion == _listenerMapVersion)
+        return;
+    
+    entry.listeners = getListeners(*entry.name);
+    auto dirtyIter = _priorityDirtyFlagMap.find(*entry.name);
+    entry.dirtyFlag = dirtyIter != _priorityDirtyFlagMap.end() ? &dirtyIter->second : nullptr;
+    entry.mapVersion = _listenerMapVersion;
+}
+
+void EventDispatcher::dispatchCustomEvent(int eventID, void *optionalUserData)
+{
+    CCASSERT(eventID >= 0 && eventID < static_cast<int>(_customEvents.size()), "Invalid custom event ID, see registerCustomEventID()");
+    
+    if (!_isEnabled)
+        return;
+    
+    updateDirtyFlagForSceneGraph();
+    
+    DispatchGuard guard(_inDispatch);
+    
+    // the callbacks may register other events, so nothing refers to the entry while dispatching
+    auto& entry = _customEvents[eventID];
+    updateCustomEventEntry(entry);
+    auto listeners = entry.listeners;
+    const auto& eventName = *entry.name;
+    if (listeners == nullptr)
+        return;
+    
+    if (entry.dirtyFlag && *entry.dirtyFlag != DirtyFlag::NONE)
+    {
+        sortEventListeners(eventName);
+    }
+    
+    EventCustom ev(eventID, eventName);
+    ev.setUserData(optionalUserData);
+    
+    auto onEvent = [&ev](EventListener* listener) -> bool{
+        ev.setCurrentTarget(listener->getAssociatedNode());
+        listener->_onEvent(&ev);
+        return ev.isStopped();
+    };
+    
+    dispatchEventToListeners(listeners, onEvent);
+    
+    updateListeners(listeners);
+}
+
 
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
@@ -960,6 +1049,7 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     //
     if (oneByOneListeners)
     {
+        bool isBegan = event->getEventCode() == EventTouch::EventCode::BEGAN;
         auto mutableTouchesIter = mutableTouches.begin();
         auto touchesIter = originalTouches.begin();
         
@@ -1055,7 +1145,8 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
             };
             
             //
-            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent);
+            Vec2 location = (*touchesIter)->getLocation();
+            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent, isBegan ? &location : nullptr);
             if (event->isStopped())
             {
                 return;
@@ -1131,86 +1222,93 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     updateListeners(event);
 }
 
-void EventDispatcher::updateListeners(Event* event)
+void EventDispatcher::cleanUnregisteredListeners(EventListenerVector* listeners)
 {
-    CCASSERT(_inDispatch > 0, "If program goes here, there should be event in dispatch.");
-
-    if (_inDispatch > 1)
+    if (listeners == nullptr)
         return;
-
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID)
+    
+    auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
+    auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
+    
+    if (sceneGraphPriorityListeners)
     {
-        auto listenersIter = _listenerMap.find(listenerID);
-        if (listenersIter == _listenerMap.end())
-            return;
-
-        auto listeners = listenersIter->second;
-        
-        auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
-        auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
-        
-        if (sceneGraphPriorityListeners)
+        for (auto iter = sceneGraphPriorityListeners->begin(); iter != sceneGraphPriorityListeners->end();)
         {
-            for (auto iter = sceneGraphPriorityListeners->begin(); iter != sceneGraphPriorityListeners->end();)
+            auto l = *iter;
+            if (!l->isRegistered())
             {
-                auto l = *iter;
-                if (!l->isRegistered())
-                {
-                    iter = sceneGraphPriorityListeners->erase(iter);
-                    // if item in toRemove list, remove it from the list
-                    auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
-                    if (matchIter != _toRemovedListeners.end())
-                        _toRemovedListeners.erase(matchIter);
-                    l->release();
-                }
-                else
-                {
-                    ++iter;
-                }
+                iter = sceneGraphPriorityListeners->erase(iter);
+                // if item in toRemove list, remove it from the list
+                auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
+                if (matchIter != _toRemovedListeners.end())
+                    _toRemovedListeners.erase(matchIter);
+                l->release();
             }
-        }
-        
-        if (fixedPriorityListeners)
-        {
-            for (auto iter = fixedPriorityListeners->begin(); iter != fixedPriorityListeners->end();)
+            else
             {
-                auto l = *iter;
-                if (!l->isRegistered())
-                {
-                    iter = fixedPriorityListeners->erase(iter);
-                    // if item in toRemove list, remove it from the list
-                    auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
-                    if (matchIter != _toRemovedListeners.end())
-                        _toRemovedListeners.erase(matchIter);
-                    l->release();
-                }
-                else
-                {
-                    ++iter;
-                }
+                ++iter;
             }
         }
-        
-        if (sceneGraphPriorityListeners && sceneGraphPriorityListeners->empty())
+    }
+    
+    if (fixedPriorityListeners)
+    {
+        for (auto iter = fixedPriorityListeners->begin(); iter != fixedPriorityListeners->end();)
         {
-            listeners->clearSceneGraphListeners();
+            auto l = *iter;
+            if (!l->isRegistered())
+            {
+                iter = fixedPriorityListeners->erase(iter);
+                // if item in toRemove list, remove it from the list
+                auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
+                if (matchIter != _toRemovedListeners.end())
+                    _toRemovedListeners.erase(matchIter);
+                l->release();
+            }
+            else
+            {
+                ++iter;
+            }
         }
+    }
+    
+    if (sceneGraphPriorityListeners && sceneGraphPriorityListeners->empty())
+    {
+        listeners->clearSceneGraphListeners();
+    }
 
-        if (fixedPriorityListeners && fixedPriorityListeners->empty())
-        {
-            listeners->clearFixedListeners();
-        }
-    };
+    if (fixedPriorityListeners && fixedPriorityListeners->empty())
+    {
+        listeners->clearFixedListeners();
+    }
+}
+
+void EventDispatcher::updateListeners(Event* event)
+{
+    CCASSERT(_inDispatch > 0, "If program goes here, there should be event in dispatch.");
+
+    if (_inDispatch > 1)
+        return;
 
     if (event->getType() == Event::Type::TOUCH)
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        cleanUnregisteredListeners(getListeners(EventListenerTouchOneByOne::LISTENER_ID));
+        updateListeners(getListeners(EventListenerTouchAllAtOnce::LISTENER_ID));
     }
     else
     {
-        onUpdateListeners(__getListenerID(event));
+        updateListeners(getListeners(__getListenerID(event)));
     }
+}
+
+void EventDispatcher::updateListeners(EventListenerVector* listeners)
+{
+    CCASSERT(_inDispatch > 0, "If program goes here, there should be event in dispatch.");
+
+    if (_inDispatch > 1)
+        return;
+
+    cleanUnregisteredListeners(listeners);
     
     CCASSERT(_inDispatch == 1, "_inDispatch should be 1 here.");
     
@@ -1221,6 +1319,7 @@ void EventDispatcher::updateListeners(Event* event)
             _priorityDirtyFlagMap.erase(iter->first);
             delete iter->second;
             iter = _listenerMap.erase(iter);
+            ++_listenerMapVersion;
         }
         else
         {
@@ -1418,12 +1517,14 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
         _priorityDirtyFlagMap.erase(listenerID);
+        ++_listenerMapVersion;
         
         if (!_inDispatch)
         {
             listeners->clear();
             delete listeners;
             _listenerMap.erase(listenerItemIter);
+            ++_listenerMapVersion;
         }
     }
     
@@ -1500,6 +1601,7 @@ void EventDispatcher::removeAllEventListeners()
     if (!_inDispatch && cleanMap)
     {
         _listenerMap.clear();
+        ++_listenerMapVersion;
     }
 }
 
@@ -1513,6 +1615,231 @@ bool EventDispatcher::isEnabled() const
     return _isEnabled;
 }
 
+// the size of the cells of the touch broadphase grid, in points
+static const float TOUCH_CELL_SIZE = 128.0f;
+// the nodes covering more cells are candidates of every touch
+static const int TOUCH_MAX_CELLS = 64;
+// the bounds are grown by this margin, in points, so the rounding errors of the hit tests are covered
+static const float TOUCH_BOUNDS_MARGIN = 1.0f;
+
+static inline int64_t __touchCellKey(int x, int y)
+{
+    return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(y);
+}
+
+void EventDispatcher::setTouchBroadphaseEnabled(bool enabled)
+{
+    if (enabled == _touchBroadphaseEnabled)
+        return;
+    
+    _touchBroadphaseEnabled = enabled;
+    if (enabled)
+    {
+        for (const auto& e : _nodeListenersMap)
+        {
+            for (const auto& listener : *e.second)
+            {
+                if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+                    addTouchBounds(e.first, listener);
+            }
+        }
+    }
+    else
+    {
+        for (const auto& e : _touchBounds)
+        {
+            e.second.node->_touchBoundsCount--;
+            e.second.node->_touchBoundsDirty = false;
+        }
+        _touchBounds.clear();
+        _touchGrid.clear();
+        _unboundedTouchListeners.clear();
+        _touchBoundsDirty = false;
+    }
+}
+
+void EventDispatcher::addTouchBounds(Node* node, EventListener* listener)
+{
+    TouchBounds touchBounds;
+    touchBounds.node = node;
+    // not in the grid until the bounds are updated
+    touchBounds.minX = touchBounds.minY = 0;
+    touchBounds.maxX = touchBounds.maxY = -1;
+    touchBounds.unbounded = false;
+    _touchBounds.insert(std::make_pair(listener, touchBounds));
+    
+    node->_touchBoundsCount++;
+    setTouchBoundsDirty(node);
+}
+
+void EventDispatcher::removeTouchBounds(EventListener* listener)
+{
+    auto found = _touchBounds.find(listener);
+    if (found == _touchBounds.end())
+        return;
+    
+    eraseTouchBounds(static_cast<EventListenerTouchOneByOne*>(listener), found->second);
+    found->second.node->_touchBoundsCount--;
+    _touchBounds.erase(found);
+}
+
+void EventDispatcher::insertTouchBounds(EventListenerTouchOneByOne* listener, TouchBounds& touchBounds)
+{
+    Node* node = touchBounds.node;
+    const Size& size = node->getContentSize();
+    // an empty rect is never hit
+    if (size.width <= 0 || size.height <= 0)
+        return;
+    
+    // the hit tests run in the plane of the node, only the nodes lying in the world plane z = 0 are culled
+    Mat4 transform = node->getNodeToWorldTransform();
+    if (transform.m[2] != 0 || transform.m[6] != 0 || transform.m[14] != 0)
+    {
+        touchBounds.unbounded = true;
+        _unboundedTouchListeners.push_back(listener);
+        return;
+    }
+    
+    Rect bounds = RectApplyTransform(Rect(0, 0, size.width, size.height), transform);
+    bounds.origin.x -= TOUCH_BOUNDS_MARGIN;
+    bounds.origin.y -= TOUCH_BOUNDS_MARGIN;
+    bounds.size.width += TOUCH_BOUNDS_MARGIN * 2;
+    bounds.size.height += TOUCH_BOUNDS_MARGIN * 2;
+    
+    float minX = std::floor(bounds.getMinX() / TOUCH_CELL_SIZE);
+    float minY = std::floor(bounds.getMinY() / TOUCH_CELL_SIZE);
+    float maxX = std::floor(bounds.getMaxX() / TOUCH_CELL_SIZE);
+    float maxY = std::floor(bounds.getMaxY() / TOUCH_CELL_SIZE);
+    // also rejects the nodes far away and the NaNs
+    if (!((maxX - minX + 1) * (maxY - minY + 1) <= TOUCH_MAX_CELLS && std::abs(minX) < 1e6f && std::abs(minY) < 1e6f))
+    {
+        touchBounds.unbounded = true;
+        _unboundedTouchListeners.push_back(listener);
+        return;
+    }
+    
+    touchBounds.bounds = bounds;
+    touchBounds.minX = static_cast<int>(minX);
+    touchBounds.minY = static_cast<int>(minY);
+    touchBounds.maxX = static_cast<int>(maxX);
+    touchBounds.maxY = static_cast<int>(maxY);
+    
+    TouchCellEntry entry = { listener, bounds };
+    for (int y = touchBounds.minY; y <= touchBounds.maxY; ++y)
+    {
+        for (int x = touchBounds.minX; x <= touchBounds.maxX; ++x)
+        {
+            _touchGrid[__touchCellKey(x, y)].push_back(entry);
+        }
+    }
+}
+
+void EventDispatcher::eraseTouchBounds(EventListenerTouchOneByOne* listener, TouchBounds& touchBounds)
+{
+    if (touchBounds.unbounded)
+    {
+        auto iter = std::find(_unboundedTouchListeners.begin(), _unboundedTouchListeners.end(), listener);
+        if (iter != _unboundedTouchListeners.end())
+            _unboundedTouchListeners.erase(iter);
+        touchBounds.unbounded = false;
+        return;
+    }
+    
+    for (int y = touchBounds.minY; y <= touchBounds.maxY; ++y)
+    {
+        for (int x = touchBounds.minX; x <= touchBounds.maxX; ++x)
+        {
+            auto cell = _touchGrid.find(__touchCellKey(x, y));
+            if (cell == _touchGrid.end())
+                continue;
+            
+            auto& entries = cell->second;
+            for (auto iter = entries.begin(); iter != entries.end(); ++iter)
+            {
+                if (iter->listener == listener)
+                {
+                    // the order in a cell doesn't matter
+                    *iter = entries.back();
+                    entries.pop_back();
+                    break;
+                }
+            }
+            if (entries.empty())
+                _touchGrid.erase(cell);
+        }
+    }
+    touchBounds.minX = touchBounds.minY = 0;
+    touchBounds.maxX = touchBounds.maxY = -1;
+}
+
+void EventDispatcher::updateTouchBounds()
+{
+    if (!_touchBoundsDirty.exchange(false))
+        return;
+    
+    for (auto& e : _touchBounds)
+    {
+        if (e.second.node->_touchBoundsDirty)
+        {
+            auto listener = static_cast<EventListenerTouchOneByOne*>(e.first);
+            eraseTouchBounds(listener, e.second);
+            insertTouchBounds(listener, e.second);
+        }
+    }
+    // a node may have several listeners, so the flags are cleared afterwards
+    for (auto& e : _touchBounds)
+    {
+        e.second.node->_touchBoundsDirty = false;
+    }
+}
+
+bool EventDispatcher::queryTouchBroadphase(const Camera* camera, const Vec2& location)
+{
+    // the touch ray meets the world plane z = 0 at the point the hit tests find in the culled nodes
+    Vec3 nearPoint = camera->unprojectGL(Vec3(location.x, location.y, -1));
+    Vec3 farPoint = camera->unprojectGL(Vec3(location.x, location.y, 1));
+    if (nearPoint.z == farPoint.z)
+        return false;
+    
+    updateTouchBounds();
+    
+    float t = nearPoint.z / (nearPoint.z - farPoint.z);
+    Vec2 point(nearPoint.x + (farPoint.x - nearPoint.x) * t, nearPoint.y + (farPoint.y - nearPoint.y) * t);
+    float x = std::floor(point.x / TOUCH_CELL_SIZE);
+    float y = std::floor(point.y / TOUCH_CELL_SIZE);
+    if (!(std::abs(x) < 1e6f && std::abs(y) < 1e6f))
+        return false;
+    
+    ++_touchBroadphaseStamp;
+    for (auto& listener : _unboundedTouchListeners)
+    {
+        listener->_broadphaseStamp = _touchBroadphaseStamp;
+    }
+    
+    auto cell = _touchGrid.find(__touchCellKey(static_cast<int>(x), static_cast<int>(y)));
+    if (cell != _touchGrid.end())
+    {
+        for (auto& entry : cell->second)
+        {
+            if (entry.bounds.containsPoint(point))
+                entry.listener->_broadphaseStamp = _touchBroadphaseStamp;
+        }
+    }
+    return true;
+}
+
+bool EventDispatcher::isTouchBroadphaseCandidate(EventListener* listener) const
+{
+    auto touchListener = static_cast<EventListenerTouchOneByOne*>(listener);
+    return !touchListener->_boundedByNode || touchListener->_broadphaseStamp == _touchBroadphaseStamp;
+}
+
+void EventDispatcher::setTouchBoundsDirty(Node* node)
+{
+    node->_touchBoundsDirty = true;
+    _touchBoundsDirty.store(true, std::memory_order_relaxed);
+}
+
 void EventDispatcher::setDirtyForNode(Node* node)
 {
     // Mark the node dirty only when there is an eventlistener associated with it. 
@@ -1535,6 +1862,7 @@ void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, Dirt
     if (iter == _priorityDirtyFlagMap.end())
     {
         _priorityDirtyFlagMap.insert(std::make_pair(listenerID, flag));
+        ++_listenerMapVersion;
     }
     else
     {
@@ -25,6 +25,7 @@
 #ifndef __CC_EVENT_DISPATCHER_H__
 #define __CC_EVENT_DISPATCHER_H__
 
+#include <atomic>
 #include <functional>
 #include <string>
 #include <unordered_map>
@@ -34,6 +35,7 @@
 #include "platform/CCPlatformMacros.h"
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
+#include "math/CCGeometry.h"
 #include "platform/CCStdC.h"
 
 /**
@@ -48,6 +50,8 @@ class EventTouch;
 class Node;
 class EventCustom;
 class EventListenerCustom;
+class EventListenerTouchOneByOne;
+class Camera;
 
 /** @class EventDispatcher
 * @brief This class manages event listener subscriptions
@@ -160,6 +164,27 @@ public:
      */
     bool isEnabled() const;
 
+    /** Enables a broadphase for the touches of the one by one listeners with scene graph priority.
+     * The world bounding boxes of the nodes of these listeners are kept in a uniform grid, which is
+     * updated incrementally when the nodes are visited with a dirty transform or content size.
+     * A touch then only begins at the bounded listeners whose node contains it, see
+     * EventListenerTouchOneByOne::setBoundedByNode(), and at the other listeners as usual.
+     * The listeners keep their priority order.
+     * @note Only the nodes that lie in the z = 0 plane of the world are culled, and a node moved
+     * by a touch callback is only found at its new place after it is visited.
+     *
+     * @param enabled True to enable the broadphase, it is disabled by default.
+     * @since v3.10
+     */
+    void setTouchBroadphaseEnabled(bool enabled);
+
+    /** Whether the broadphase for the one by one touch listeners is enabled.
+     *
+     * @return True if the broadphase is enabled.
+     * @since v3.10
+     */
+    bool isTouchBroadphaseEnabled() const { return _touchBroadphaseEnabled; }
+
     /////////////////////////////////////////////
     
     /** Dispatches the event.
@@ -177,6 +202,29 @@ public:
      */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Interns the name of a custom event, so the event can be dispatched by ID.
+     * The listeners are still added with the name, see EventListenerCustom::create().
+     *
+     * @param eventName The name of the event.
+     * @return The ID of the event. A name always gets the same ID, which stays valid until the dispatcher is destroyed.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    int registerCustomEventID(const std::string &eventName);
+
+    /** Dispatches a Custom Event by the ID returned by registerCustomEventID().
+     * The listeners are found in a table indexed by the ID, and nothing is allocated on the heap,
+     * unless the listeners have to be sorted again.
+     *
+     * @param eventID The ID of the event.
+     * @param optionalUserData The optional user data, it's a void*, the default value is nullptr.
+     * @since v3.10
+     * @js NA
+     * @lua NA
+     */
+    void dispatchCustomEvent(int eventID, void *optionalUserData = nullptr);
+
     /////////////////////////////////////////////
     
     /** Constructor of EventDispatcher.
@@ -263,6 +311,12 @@ protected:
      *  2) Adds all listener items that have been marked as 'added' when dispatching event.
      */
     void updateListeners(Event* event);
+    
+    /** Updates the listeners after dispatching an event to a listener list */
+    void updateListeners(EventListenerVector* listeners);
+    
+    /** Removes the listener items of a list that have been marked as 'removed' when dispatching event */
+    void cleanUnregisteredListeners(EventListenerVector* listeners);
 
     /** Touch event needs to be processed different with other events since it needs support ALL_AT_ONCE and ONE_BY_NONE mode. */
     void dispatchTouchEvent(EventTouch* event);
@@ -286,6 +340,54 @@ protected:
      */
     void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
     
+    /** Dispatches a one by one touch event, the touch broadphase is used when a location is passed */
+    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent, const Vec2* broadphaseLocation);
+    
+    /** The world bounds of the node of a one by one touch listener, for the touch broadphase */
+    struct TouchBounds
+    {
+        Node* node;
+        Rect bounds;
+        // the grid cells covered by the bounds
+        int minX, minY, maxX, maxY;
+        // whether the listener is a candidate of every touch
+        bool unbounded;
+    };
+    
+    /** A listener in a cell of the touch broadphase grid */
+    struct TouchCellEntry
+    {
+        EventListenerTouchOneByOne* listener;
+        Rect bounds;
+    };
+    
+    /** Adds a one by one touch listener to the touch broadphase */
+    void addTouchBounds(Node* node, EventListener* listener);
+    
+    /** Removes a one by one touch listener from the touch broadphase */
+    void removeTouchBounds(EventListener* listener);
+    
+    /** Inserts the listener in the grid with the current world bounds of its node */
+    void insertTouchBounds(EventListenerTouchOneByOne* listener, TouchBounds& touchBounds);
+    
+    /** Removes the listener from the grid */
+    void eraseTouchBounds(EventListenerTouchOneByOne* listener, TouchBounds& touchBounds);
+    
+    /** Updates the bounds of the nodes that were visited with a dirty transform */
+    void updateTouchBounds();
+    
+    /** Stamps the candidates of a touch seen by a camera.
+     *
+     * @return False if the touch can't be located in the world plane, every listener is a candidate then.
+     */
+    bool queryTouchBroadphase(const Camera* camera, const Vec2& location);
+    
+    /** Whether a listener of the scene graph was stamped by the last query */
+    bool isTouchBroadphaseCandidate(EventListener* listener) const;
+    
+    /** Called by Node::visit() when a node with touch bounds has moved, may be called by worker threads */
+    void setTouchBoundsDirty(Node* node);
+    
     /// Priority dirty flag
     enum class DirtyFlag
     {
@@ -298,6 +400,18 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
+    /** The listeners of a custom event registered by ID, looked up again when the maps changed */
+    struct CustomEventEntry
+    {
+        const EventListener::ListenerID* name;
+        EventListenerVector* listeners;
+        DirtyFlag* dirtyFlag;
+        unsigned int mapVersion;
+    };
+    
+    /** Looks up the listeners and the dirty flag of a custom event again if the maps changed */
+    void updateCustomEventEntry(CustomEventEntry& entry);
+    
     /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
     void visitTarget(Node* node, bool isRootNode);
 
@@ -337,6 +451,31 @@ protected:
     int _nodePriorityIndex;
     
     std::set<std::string> _internalCustomListenerIDs;
+    
+    /** key: Custom event name, value: ID of the event */
+    std::unordered_map<EventListener::ListenerID, int> _customEventIDs;
+    
+    /** The custom events registered by ID, indexed by ID */
+    std::vector<CustomEventEntry> _customEvents;
+    
+    /** Incremented when an entry is added to or removed from _listenerMap or _priorityDirtyFlagMap */
+    unsigned int _listenerMapVersion;
+    
+    /** The one by one touch listeners in the touch broadphase */
+    std::unordered_map<EventListener*, TouchBounds> _touchBounds;
+    
+    /** key: Grid cell, value: the listeners whose bounds overlap the cell */
+    std::unordered_map<int64_t, std::vector<TouchCellEntry>> _touchGrid;
+    
+    /** The listeners that are candidates of every touch */
+    std::vector<EventListenerTouchOneByOne*> _unboundedTouchListeners;
+    
+    /** Whether a node with touch bounds was visited with a dirty transform */
+    std::atomic<bool> _touchBoundsDirty;
+    
+    unsigned int _touchBroadphaseStamp;
+    
+    bool _touchBroadphaseEnabled;
 };
 
 
@@ -39,6 +39,8 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _boundedByNode(false)
+, _broadphaseStamp(0)
 {
 }
 
@@ -67,6 +69,16 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setBoundedByNode(bool bounded)
+{
+    _boundedByNode = bounded;
+}
+
+bool EventListenerTouchOneByOne::isBoundedByNode() const
+{
+    return _boundedByNode;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -108,6 +120,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_boundedByNode = _boundedByNode;
     }
     else
     {
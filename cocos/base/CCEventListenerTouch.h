@@ -67,6 +67,22 @@ public:
      * @return True if needs to swall touches.
      */
     bool isSwallowTouches();
+
+    /** Sets whether onTouchBegan only claims the touches inside the content rect of the node of the listener,
+     * like the touch listener of ui::Widget. The touch broadphase of EventDispatcher skips a bounded listener
+     * when a touch begins outside of its node.
+     *
+     * @param bounded True if the touches outside of the node are never claimed.
+     * @see EventDispatcher::setTouchBroadphaseEnabled()
+     * @since v3.10
+     */
+    void setBoundedByNode(bool bounded);
+    /** Whether onTouchBegan only claims the touches inside the content rect of the node.
+     *
+     * @return True if the touches outside of the node are never claimed.
+     * @since v3.10
+     */
+    bool isBoundedByNode() const;
     
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
@@ -90,6 +106,9 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _boundedByNode;
+    // the touch broadphase query that last found the listener
+    unsigned int _broadphaseStamp;
     
     friend class EventDispatcher;
 };
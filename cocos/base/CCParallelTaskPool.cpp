@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCParallelTaskPool.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+ParallelTaskPool* ParallelTaskPool::s_sharedPool = nullptr;
+
+ParallelTaskPool* ParallelTaskPool::getInstance()
+{
+    if (s_sharedPool == nullptr)
+    {
+        s_sharedPool = new (std::nothrow) ParallelTaskPool();
+    }
+    return s_sharedPool;
+}
+
+void ParallelTaskPool::destroyInstance()
+{
+    delete s_sharedPool;
+    s_sharedPool = nullptr;
+}
+
+ParallelTaskPool::ParallelTaskPool()
+: _task(nullptr)
+, _taskCount(0)
+, _nextTask(0)
+, _unfinishedTasks(0)
+, _running(false)
+, _stop(false)
+{
+    int hardwareThreads = (int)std::thread::hardware_concurrency();
+    startWorkers(hardwareThreads > 1 ? hardwareThreads - 1 : 0);
+}
+
+ParallelTaskPool::~ParallelTaskPool()
+{
+    stopWorkers();
+}
+
+void ParallelTaskPool::setWorkerCount(int count)
+{
+    CCASSERT(!_running, "Can't resize the pool while it is running tasks");
+    if (count < 0)
+        count = 0;
+
+    if (count == (int)_workers.size())
+        return;
+
+    stopWorkers();
+    startWorkers(count);
+}
+
+void ParallelTaskPool::startWorkers(int count)
+{
+    _stop = false;
+    _workers.reserve(count);
+    _workerIds.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        _workers.push_back(std::thread(&ParallelTaskPool::threadLoop, this));
+        _workerIds.push_back(_workers.back().get_id());
+    }
+}
+
+void ParallelTaskPool::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _taskCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+    _workers.clear();
+    _workerIds.clear();
+}
+
+int ParallelTaskPool::getCurrentThreadIndex() const
+{
+    auto threadId = std::this_thread::get_id();
+    for (size_t i = 0; i < _workerIds.size(); ++i)
+    {
+        if (_workerIds[i] == threadId)
+            return (int)i + 1;
+    }
+    return 0;
+}
+
+void ParallelTaskPool::run(int count, const Task& task)
+{
+    if (count <= 0)
+        return;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_running || _workers.empty() || count == 1)
+    {
+        lock.unlock();
+        for (int i = 0; i < count; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    _running = true;
+    _task = &task;
+    _taskCount = count;
+    _nextTask = 0;
+    _unfinishedTasks = count;
+    _taskCondition.notify_all();
+
+    // the calling thread takes its share of the work as well
+    while (_nextTask < _taskCount)
+    {
+        int index = _nextTask++;
+        lock.unlock();
+        task(index);
+        lock.lock();
+        --_unfinishedTasks;
+    }
+
+    _finishCondition.wait(lock, [this]{ return _unfinishedTasks == 0; });
+
+    _task = nullptr;
+    _taskCount = 0;
+    _nextTask = 0;
+    _running = false;
+}
+
+void ParallelTaskPool::threadLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;)
+    {
+        _taskCondition.wait(lock, [this]{ return _stop || _nextTask < _taskCount; });
+        if (_stop)
+            return;
+
+        int index = _nextTask++;
+        const Task* task = _task;
+        lock.unlock();
+        (*task)(index);
+        lock.lock();
+
+        if (--_unfinishedTasks == 0)
+            _finishCondition.notify_one();
+    }
+}
+
+NS_CC_END
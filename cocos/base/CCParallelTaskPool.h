@@ -0,0 +1,116 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCPARALLEL_TASK_POOL_H_
+#define __CCPARALLEL_TASK_POOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class ParallelTaskPool
+ * @brief A fork-join pool used to split a frame's work across worker threads.
+ *
+ * Unlike `AsyncTaskPool`, `run()` blocks until every task has finished and
+ * the calling thread executes tasks too, so it is meant for short jobs that
+ * must complete within the current frame (e.g. visiting large scene graphs).
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ParallelTaskPool
+{
+public:
+    typedef std::function<void(int)> Task;
+
+    /** Returns the shared instance of the pool. */
+    static ParallelTaskPool* getInstance();
+
+    /** Destroys the shared instance, joining its worker threads. */
+    static void destroyInstance();
+
+    /** Returns the number of worker threads, not counting the thread calling `run()`. */
+    int getWorkerCount() const { return (int)_workers.size(); }
+
+    /**
+     * Sets the number of worker threads. 0 makes `run()` execute every task on the calling thread.
+     * By default the pool has `std::thread::hardware_concurrency() - 1` workers.
+     * @note Must not be called while `run()` is executing.
+     */
+    void setWorkerCount(int count);
+
+    /**
+     * Executes `task(0)` ... `task(count - 1)` and returns once all of them have finished.
+     * Tasks may run in any order and on any thread. If the pool is already running tasks
+     * (e.g. `run()` is called from inside a task), the tasks are executed serially on the calling thread.
+     */
+    void run(int count, const Task& task);
+
+    /**
+     * Returns the index of the calling thread inside the pool: 1 ... getWorkerCount() for
+     * worker threads and 0 for any other thread.
+     */
+    int getCurrentThreadIndex() const;
+
+CC_CONSTRUCTOR_ACCESS:
+    ParallelTaskPool();
+    ~ParallelTaskPool();
+
+protected:
+    void startWorkers(int count);
+    void stopWorkers();
+    void threadLoop();
+
+    std::vector<std::thread> _workers;
+    std::vector<std::thread::id> _workerIds;
+
+    std::mutex _mutex;
+    std::condition_variable _taskCondition;
+    std::condition_variable _finishCondition;
+
+    const Task* _task;
+    int _taskCount;
+    int _nextTask;
+    int _unfinishedTasks;
+    bool _running;
+    bool _stop;
+
+    static ParallelTaskPool* s_sharedPool;
+};
+
+NS_CC_END
+// end group
+/// @}
+
+#endif //__CCPARALLEL_TASK_POOL_H_
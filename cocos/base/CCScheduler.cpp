@@ -65,9 +65,15 @@ typedef struct _hashSelectorEntry
     Timer               *currentTimer;
     bool                currentTimerSalvaged;
     bool                paused;
+    double              pausedTime;     // timer queue time when the target was paused
     UT_hash_handle      hh;
 } tHashTimerEntry;
 
+// _queueIndex of a timer that isn't in the timer queue
+static const int TIMER_NOT_QUEUED = -1;
+// _queueIndex of a timer taken out of the timer queue to be updated in the current frame
+static const int TIMER_DUE = -2;
+
 // implementation Timer
 
 Timer::Timer()
@@ -79,6 +85,9 @@ Timer::Timer()
 , _repeat(0)
 , _delay(0.0f)
 , _interval(0.0f)
+, _lastUpdateTime(0.0)
+, _dueTime(0.0)
+, _queueIndex(TIMER_NOT_QUEUED)
 {
 }
 
@@ -144,6 +153,17 @@ void Timer::update(float dt)
     }
 }
 
+float Timer::getTimeToNextTrigger() const
+{
+    if (_elapsed == -1)
+    {
+        return 0;
+    }
+
+    float timeToNextTrigger = (_useDelay ? _delay : _interval) - _elapsed;
+    return timeToNextTrigger > 0 ? timeToNextTrigger : 0;
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector()
@@ -253,6 +273,8 @@ Scheduler::Scheduler(void)
 , _currentTarget(nullptr)
 , _currentTargetSalvaged(false)
 , _updateHashLocked(false)
+, _timerQueueTime(0.0)
+, _timerQueueEnabled(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
@@ -295,6 +317,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        element->pausedTime = _timerQueueTime;
     }
     else
     {
@@ -315,6 +338,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                requeueTimer(timer);
                 return;
             }        
         }
@@ -324,6 +348,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
+    queueTimer(element, timer);
     timer->release();
 }
 
@@ -355,6 +380,7 @@ void Scheduler::unschedule(const std::string &key, void *target)
                     element->currentTimerSalvaged = true;
                 }
 
+                removeTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -651,6 +677,10 @@ void Scheduler::unscheduleAllForTarget(void *target)
             element->currentTimer->retain();
             element->currentTimerSalvaged = true;
         }
+        for (int i = 0; i < element->timers->num; ++i)
+        {
+            removeTimer((Timer*)element->timers->arr[i]);
+        }
         ccArrayRemoveAllObjects(element->timers);
 
         if (_currentTarget == element)
@@ -699,7 +729,7 @@ void Scheduler::resumeTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = false;
+        setTimersPaused(element, false);
     }
 
     // update selector
@@ -721,7 +751,7 @@ void Scheduler::pauseTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = true;
+        setTimersPaused(element, true);
     }
 
     // update selector
@@ -770,7 +800,7 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        setTimersPaused(element, true);
         idsWithSelectors.insert(element->target);
     }
 
@@ -825,6 +855,243 @@ void Scheduler::performFunctionInCocosThread(const std::function<void ()> &funct
     _performMutex.unlock();
 }
 
+// timer queue
+
+void Scheduler::setTimerQueueEnabled(bool enabled)
+{
+    CCASSERT(!_updateHashLocked, "The timer queue can't be changed in a scheduled function");
+
+    if (enabled == _timerQueueEnabled)
+    {
+        return;
+    }
+
+    if (!enabled)
+    {
+        // the time since their last update is given back to the timers, they are updated every frame again
+        for (auto timer : _timerQueue)
+        {
+            if (timer->_elapsed != -1)
+            {
+                timer->_elapsed += (float)(_timerQueueTime - timer->_lastUpdateTime);
+            }
+            timer->_queueIndex = TIMER_NOT_QUEUED;
+        }
+        _timerQueue.clear();
+    }
+
+    for (tHashTimerEntry *element = _hashForTimers; element != nullptr; element = (tHashTimerEntry *)element->hh.next)
+    {
+        if (!enabled && element->paused)
+        {
+            for (int i = 0; i < element->timers->num; ++i)
+            {
+                auto timer = (Timer*)element->timers->arr[i];
+                if (timer->_elapsed != -1)
+                {
+                    timer->_elapsed += (float)(element->pausedTime - timer->_lastUpdateTime);
+                }
+            }
+        }
+        element->pausedTime = _timerQueueTime;
+    }
+
+    _timerQueueEnabled = enabled;
+
+    if (enabled)
+    {
+        for (tHashTimerEntry *element = _hashForTimers; element != nullptr; element = (tHashTimerEntry *)element->hh.next)
+        {
+            for (int i = 0; i < element->timers->num; ++i)
+            {
+                queueTimer(element, (Timer*)element->timers->arr[i]);
+            }
+        }
+    }
+}
+
+void Scheduler::setTimersPaused(tHashTimerEntry *element, bool paused)
+{
+    if (element->paused == paused)
+    {
+        return;
+    }
+
+    element->paused = paused;
+
+    if (!_timerQueueEnabled)
+    {
+        return;
+    }
+
+    if (paused)
+    {
+        element->pausedTime = _timerQueueTime;
+        for (int i = 0; i < element->timers->num; ++i)
+        {
+            removeTimer((Timer*)element->timers->arr[i]);
+        }
+    }
+    else
+    {
+        // the time spent paused doesn't count
+        double pausedDuration = _timerQueueTime - element->pausedTime;
+        for (int i = 0; i < element->timers->num; ++i)
+        {
+            auto timer = (Timer*)element->timers->arr[i];
+            timer->_lastUpdateTime += pausedDuration;
+            pushTimer(timer);
+        }
+    }
+}
+
+void Scheduler::queueTimer(tHashTimerEntry *element, Timer *timer)
+{
+    if (!_timerQueueEnabled)
+    {
+        return;
+    }
+
+    // a paused timer is pushed when its target is resumed
+    if (element->paused)
+    {
+        timer->_lastUpdateTime = element->pausedTime;
+    }
+    else
+    {
+        timer->_lastUpdateTime = _timerQueueTime;
+        pushTimer(timer);
+    }
+}
+
+void Scheduler::requeueTimer(Timer *timer)
+{
+    // a due timer is pushed again after its update
+    if (timer->_queueIndex >= 0)
+    {
+        removeTimer(timer);
+        pushTimer(timer);
+    }
+}
+
+void Scheduler::pushTimer(Timer *timer)
+{
+    timer->_dueTime = timer->_lastUpdateTime + timer->getTimeToNextTrigger();
+    timer->_queueIndex = (int)_timerQueue.size();
+    _timerQueue.push_back(timer);
+    siftTimerUp(timer->_queueIndex);
+}
+
+void Scheduler::removeTimer(Timer *timer)
+{
+    int index = timer->_queueIndex;
+    timer->_queueIndex = TIMER_NOT_QUEUED;
+
+    // a due timer is only marked, it will be skipped by updateTimerQueue()
+    if (index < 0)
+    {
+        return;
+    }
+
+    Timer* last = _timerQueue.back();
+    _timerQueue.pop_back();
+    if (last != timer)
+    {
+        _timerQueue[index] = last;
+        last->_queueIndex = index;
+        siftTimerUp(index);
+        siftTimerDown(last->_queueIndex);
+    }
+}
+
+void Scheduler::siftTimerUp(int index)
+{
+    Timer* timer = _timerQueue[index];
+    while (index > 0)
+    {
+        int parentIndex = (index - 1) / 2;
+        Timer* parent = _timerQueue[parentIndex];
+        if (parent->_dueTime <= timer->_dueTime)
+        {
+            break;
+        }
+
+        _timerQueue[index] = parent;
+        parent->_queueIndex = index;
+        index = parentIndex;
+    }
+
+    _timerQueue[index] = timer;
+    timer->_queueIndex = index;
+}
+
+void Scheduler::siftTimerDown(int index)
+{
+    Timer* timer = _timerQueue[index];
+    int count = (int)_timerQueue.size();
+    while (true)
+    {
+        int childIndex = index * 2 + 1;
+        if (childIndex >= count)
+        {
+            break;
+        }
+        if (childIndex + 1 < count && _timerQueue[childIndex + 1]->_dueTime < _timerQueue[childIndex]->_dueTime)
+        {
+            ++childIndex;
+        }
+
+        Timer* child = _timerQueue[childIndex];
+        if (timer->_dueTime <= child->_dueTime)
+        {
+            break;
+        }
+
+        _timerQueue[index] = child;
+        child->_queueIndex = index;
+        index = childIndex;
+    }
+
+    _timerQueue[index] = timer;
+    timer->_queueIndex = index;
+}
+
+void Scheduler::updateTimerQueue()
+{
+    // The due timers are taken out of the queue first, so the timers scheduled or
+    // pushed again by the callbacks are only updated on the next frame.
+    while (!_timerQueue.empty() && _timerQueue.front()->_dueTime <= _timerQueueTime)
+    {
+        Timer* timer = _timerQueue.front();
+        removeTimer(timer);
+        timer->_queueIndex = TIMER_DUE;
+
+        // the callbacks may unschedule the timer, keep it alive until its step is done
+        timer->retain();
+        _dueTimers.push_back(timer);
+    }
+
+    for (auto timer : _dueTimers)
+    {
+        // skip the timers unscheduled or paused by a previous callback
+        if (timer->_queueIndex == TIMER_DUE)
+        {
+            // the step is accounted for before the callback runs, so a timer paused or
+            // resumed by its own callback is measured from this update
+            float dt = (float)(_timerQueueTime - timer->_lastUpdateTime);
+            timer->_lastUpdateTime = _timerQueueTime;
+            timer->update(dt);
+
+            if (timer->_queueIndex == TIMER_DUE)
+            {
+                pushTimer(timer);
+            }
+        }
+        timer->release();
+    }
+    _dueTimers.clear();
+}
+
 // main loop
 void Scheduler::update(float dt)
 {
@@ -869,42 +1136,51 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
-    {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+    _timerQueueTime += dt;
 
-        if (! _currentTarget->paused)
+    if (_timerQueueEnabled)
+    {
+        updateTimerQueue();
+    }
+    else
+    {
+        // Iterate over all the custom selectors
+        for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+            _currentTarget = elt;
+            _currentTargetSalvaged = false;
+
+            if (! _currentTarget->paused)
             {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
+                // The 'timers' array may change while inside this loop
+                for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+                {
+                    elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
+                    elt->currentTimerSalvaged = false;
 
-                elt->currentTimer->update(dt);
+                    elt->currentTimer->update(dt);
 
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+                    if (elt->currentTimerSalvaged)
+                    {
+                        // The currentTimer told the remove itself. To prevent the timer from
+                        // accidentally deallocating itself before finishing its step, we retained
+                        // it. Now that step is done, it's safe to release it.
+                        elt->currentTimer->release();
+                    }
 
-                elt->currentTimer = nullptr;
+                    elt->currentTimer = nullptr;
+                }
             }
-        }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+            // elt, at this moment, is still valid
+            // so it is safe to ask this here (issue #490)
+            elt = (tHashTimerEntry *)elt->hh.next;
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
+            // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
+            if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+            {
+                removeHashElement(_currentTarget);
+            }
         }
     }
 
@@ -996,6 +1272,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
         
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        element->pausedTime = _timerQueueTime;
     }
     else
     {
@@ -1016,6 +1293,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                requeueTimer(timer);
                 return;
             }
         }
@@ -1025,6 +1303,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
+    queueTimer(element, timer);
     timer->release();
 }
 
@@ -1096,6 +1375,7 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
                     element->currentTimerSalvaged = true;
                 }
                 
+                removeTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
                 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -64,6 +64,10 @@ public:
     void update(float dt);
     
 protected:
+    friend class Scheduler;
+
+    /** time left before the timer triggers, 0 if it triggers on its next update */
+    float getTimeToNextTrigger() const;
     
     Scheduler* _scheduler; // weak ref
     float _elapsed;
@@ -73,6 +77,11 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
+
+    // used by the Scheduler when the timer queue is enabled
+    double _lastUpdateTime;
+    double _dueTime;
+    int _queueIndex;
 };
 
 
@@ -212,6 +221,21 @@ public:
      */
     void update(float dt);
 
+    /** Enables or disables the timer queue.
+     By default every timer scheduled with `schedule()` is visited once per frame.
+     When the timer queue is enabled the timers are kept in a min-heap sorted by the time they trigger next,
+     so a frame only visits the timers that are due. Use it when many timers are scheduled with long intervals.
+     Timers that are due on the same frame are triggered by due time instead of by target.
+     It can't be changed from a scheduled function.
+     @since v3.10
+     */
+    void setTimerQueueEnabled(bool enabled);
+    /** Whether or not the timer queue is enabled.
+     @see Scheduler::setTimerQueueEnabled()
+     @since v3.10
+     */
+    bool isTimerQueueEnabled() const { return _timerQueueEnabled; }
+
     /////////////////////////////////////
     
     // schedule
@@ -507,6 +531,17 @@ protected:
     void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
 
+    // timer queue specific
+
+    void setTimersPaused(struct _hashSelectorEntry *element, bool paused);
+    void queueTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void requeueTimer(Timer *timer);
+    void pushTimer(Timer *timer);
+    void removeTimer(Timer *timer);
+    void siftTimerUp(int index);
+    void siftTimerDown(int index);
+    void updateTimerQueue();
+
 
     float _timeScale;
 
@@ -524,6 +559,12 @@ protected:
     bool _currentTargetSalvaged;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
+
+    // Used by the timer queue, a min-heap of timers sorted by due time
+    std::vector<Timer*> _timerQueue;
+    std::vector<Timer*> _dueTimers;
+    double _timerQueueTime;
+    bool _timerQueueEnabled;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
@@ -28,6 +28,11 @@ THE SOFTWARE.
 #include "tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+#include <chrono>
+#include <unordered_map>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
@@ -36,105 +41,356 @@ THE SOFTWARE.
 
 #define XML_FILE_NAME "UserDefault.xml"
 
+#define BINARY_FILE_NAME "UserDefault.bin"
+
 using namespace std;
 
 NS_CC_BEGIN
 
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * The values are kept in memory, as the strings the xml file used to store. The changes are appended
+ * to a binary log, in batches, and the log is rewritten with only the current values when it grows
+ * too much. Old xml files are read once, when the log doesn't exist yet.
  */
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+namespace {
+
+const char LOG_MAGIC[4] = { 'C', 'C', 'U', 'D' };
+const uint32_t LOG_VERSION = 1;
+const unsigned char LOG_SET = 1;
+const unsigned char LOG_DELETE = 2;
+
+// the changes are appended when the oldest one is this old, or when there are this many bytes of them
+const std::chrono::seconds WRITE_BACK_DELAY(2);
+const size_t WRITE_BACK_MAX_PENDING = 64 * 1024;
+const char* WRITE_BACK_SCHEDULE_KEY = "UserDefaultWriteBack";
+// the log is compacted when it is this large and twice as large as the values it holds
+const size_t COMPACT_MIN_SIZE = 64 * 1024;
+
+class UserDefaultStore
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+public:
+    UserDefaultStore()
+    : _loaded(false)
+    , _fileSize(0)
+    , _valuesSize(0)
+    {
+    }
 
-    // check the key value
-    if (! pKey)
+    const std::string* getValue(const char* key)
     {
-        return nullptr;
+        load();
+        auto it = _values.find(key);
+        return it != _values.end() ? &it->second : nullptr;
     }
 
-    do 
+    void setValue(const char* key, const char* value)
     {
-         tinyxml2::XMLDocument* xmlDoc = new tinyxml2::XMLDocument();
-        *doc = xmlDoc;
+        load();
+        auto it = _values.find(key);
+        if (it != _values.end())
+        {
+            if (it->second == value)
+                return;
+            _valuesSize -= recordSize(it->first, it->second);
+            it->second = value;
+        }
+        else
+        {
+            it = _values.emplace(key, value).first;
+        }
+        _valuesSize += recordSize(it->first, it->second);
+        appendRecord(LOG_SET, it->first, &it->second);
+    }
 
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
+    void deleteValue(const char* key)
+    {
+        load();
+        auto it = _values.find(key);
+        if (it == _values.end())
+            return;
+        _valuesSize -= recordSize(it->first, it->second);
+        appendRecord(LOG_DELETE, it->first, nullptr);
+        _values.erase(it);
+    }
 
-        if (xmlBuffer.empty())
+    // appends the pending changes, and compacts the log if it grew too much
+    void writeBack()
+    {
+        if (!_loaded)
+            return;
+
+        if (_fileSize + _pending.size() >= COMPACT_MIN_SIZE && _fileSize + _pending.size() >= 2 * (sizeof(LOG_MAGIC) + sizeof(LOG_VERSION) + _valuesSize))
         {
-            CCLOG("can not read xml file");
-            break;
+            compact();
         }
-        xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
+        else if (!_pending.empty())
+        {
+            FILE* fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_filePath).c_str(), "ab");
+            if (fp)
+            {
+                size_t written = fwrite(_pending.data(), 1, _pending.size(), fp);
+                fclose(fp);
+                if (written != _pending.size())
+                {
+                    // rewrite everything rather than leave a partial record in the middle of the log
+                    compact();
+                    return;
+                }
+                _fileSize += written;
+                _pending.clear();
+            }
+            else
+            {
+                CCLOG("UserDefault: can not write %s", _filePath.c_str());
+            }
+        }
+    }
 
-        // get root node
-        *rootNode = xmlDoc->RootElement();
-        if (nullptr == *rootNode)
+    // writes the pending changes and forgets the values, they are read again by the next call
+    void reset()
+    {
+        writeBack();
+        _values.clear();
+        _pending.clear();
+        _loaded = false;
+        _fileSize = 0;
+        _valuesSize = 0;
+    }
+
+private:
+    static size_t recordSize(const std::string& key, const std::string& value)
+    {
+        return 1 + sizeof(uint32_t) + key.size() + sizeof(uint32_t) + value.size();
+    }
+
+    static void writeString(std::string& out, const std::string& string)
+    {
+        uint32_t length = static_cast<uint32_t>(string.size());
+        out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.append(string);
+    }
+
+    static bool readString(const unsigned char* bytes, size_t size, size_t& offset, std::string& string)
+    {
+        uint32_t length = 0;
+        if (size - offset < sizeof(length))
+            return false;
+        memcpy(&length, bytes + offset, sizeof(length));
+        offset += sizeof(length);
+        if (size - offset < length)
+            return false;
+        string.assign(reinterpret_cast<const char*>(bytes + offset), length);
+        offset += length;
+        return true;
+    }
+
+    void appendRecord(unsigned char op, const std::string& key, const std::string* value)
+    {
+        if (_pending.empty())
         {
-            CCLOG("read root node error");
-            break;
+            _pendingSince = std::chrono::steady_clock::now();
+            scheduleWriteBack();
+        }
+        _pending.push_back(static_cast<char>(op));
+        writeString(_pending, key);
+        if (value)
+        {
+            writeString(_pending, *value);
+        }
+
+        if (_pending.size() >= WRITE_BACK_MAX_PENDING || std::chrono::steady_clock::now() - _pendingSince >= WRITE_BACK_DELAY)
+        {
+            writeBack();
+        }
+    }
+
+    // writes the changes back even if nothing else is set, a flush() before it makes it do nothing
+    void scheduleWriteBack()
+    {
+        auto scheduler = Director::getInstance()->getScheduler();
+        if (scheduler->isScheduled(WRITE_BACK_SCHEDULE_KEY, this))
+            return;
+
+        float delay = std::chrono::duration_cast<std::chrono::duration<float>>(WRITE_BACK_DELAY).count();
+        scheduler->schedule([this](float) {
+            writeBack();
+        }, this, delay, 0, 0.0f, false, WRITE_BACK_SCHEDULE_KEY);
+    }
+
+    void load()
+    {
+        if (_loaded)
+            return;
+        _loaded = true;
+
+        auto fileUtils = FileUtils::getInstance();
+        _filePath = fileUtils->getWritablePath() + BINARY_FILE_NAME;
+        std::string tempPath = _filePath + ".tmp";
+        if (!fileUtils->isFileExist(_filePath) && fileUtils->isFileExist(tempPath))
+        {
+            // the last compaction stopped between removing the log and renaming the new one
+            fileUtils->renameFile(tempPath, _filePath);
         }
-        // find the node
-        curNode = (*rootNode)->FirstChildElement();
-        while (nullptr != curNode)
+
+        bool valid = false;
+        bool truncated = false;
+        if (fileUtils->isFileExist(_filePath))
         {
-            const char* nodeName = curNode->Value();
-            if (!strcmp(nodeName, pKey))
+            Data data = fileUtils->getDataFromFile(_filePath);
+            const unsigned char* bytes = data.getBytes();
+            size_t size = static_cast<size_t>(data.getSize());
+            uint32_t version = 0;
+            if (size >= sizeof(LOG_MAGIC) + sizeof(version))
             {
-                break;
+                memcpy(&version, bytes + sizeof(LOG_MAGIC), sizeof(version));
+                valid = memcmp(bytes, LOG_MAGIC, sizeof(LOG_MAGIC)) == 0 && version == LOG_VERSION;
             }
 
-            curNode = curNode->NextSiblingElement();
+            size_t offset = sizeof(LOG_MAGIC) + sizeof(version);
+            std::string key, value;
+            while (valid && offset < size)
+            {
+                // a record cut by a crash ends the log, it is dropped by the compaction below
+                unsigned char op = bytes[offset++];
+                if ((op != LOG_SET && op != LOG_DELETE)
+                    || !readString(bytes, size, offset, key)
+                    || (op == LOG_SET && !readString(bytes, size, offset, value)))
+                {
+                    truncated = true;
+                    break;
+                }
+                if (op == LOG_SET)
+                {
+                    _values[key] = value;
+                }
+                else
+                {
+                    _values.erase(key);
+                }
+            }
+            _fileSize = size;
+
+            if (!valid)
+            {
+                CCLOG("UserDefault: %s is invalid", _filePath.c_str());
+            }
         }
-    } while (0);
 
-    return curNode;
-}
+        if (!valid)
+        {
+            loadXMLFile();
+        }
+        for (const auto& item : _values)
+        {
+            _valuesSize += recordSize(item.first, item.second);
+        }
+        if (!valid || truncated)
+        {
+            compact();
+        }
+    }
 
-static void setValueForKey(const char* pKey, const char* pValue)
-{
-     tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    // check the params
-    if (! pKey || ! pValue)
+    void loadXMLFile()
     {
-        return;
+        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getXMLFilePath());
+        if (xmlBuffer.empty())
+            return;
+
+        tinyxml2::XMLDocument xmlDoc;
+        xmlDoc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
+        auto rootNode = xmlDoc.RootElement();
+        if (nullptr == rootNode)
+        {
+            CCLOG("read root node error");
+            return;
+        }
+
+        for (auto node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+        {
+            auto content = node->FirstChild();
+            _values[node->Value()] = content && content->Value() ? content->Value() : "";
+        }
+        CCLOG("UserDefault: %d values imported from %s", static_cast<int>(_values.size()), UserDefault::getXMLFilePath().c_str());
     }
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode, &doc);
-    // if node exist, change the content
-    if (node)
+
+    // rewrites the log with only the current values, through a temporary file so it is never left half written
+    void compact()
     {
-        if (node->FirstChild())
+        std::string log(LOG_MAGIC, sizeof(LOG_MAGIC));
+        log.append(reinterpret_cast<const char*>(&LOG_VERSION), sizeof(LOG_VERSION));
+        log.reserve(log.size() + _valuesSize);
+        for (const auto& item : _values)
         {
-            node->FirstChild()->SetValue(pValue);
+            log.push_back(static_cast<char>(LOG_SET));
+            writeString(log, item.first);
+            writeString(log, item.second);
         }
-        else
+
+        auto fileUtils = FileUtils::getInstance();
+        std::string tempPath = _filePath + ".tmp";
+        FILE* fp = fopen(fileUtils->getSuitableFOpen(tempPath).c_str(), "wb");
+        if (!fp)
+        {
+            CCLOG("UserDefault: can not write %s", tempPath.c_str());
+            return;
+        }
+        size_t written = fwrite(log.data(), 1, log.size(), fp);
+        fclose(fp);
+
+        if (written != log.size())
         {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
+            CCLOG("UserDefault: can not write %s", tempPath.c_str());
+            fileUtils->removeFile(tempPath);
+            return;
         }
+        if (fileUtils->isFileExist(_filePath))
+        {
+            fileUtils->removeFile(_filePath);
+        }
+        if (!fileUtils->renameFile(tempPath, _filePath))
+        {
+            CCLOG("UserDefault: can not write %s", _filePath.c_str());
+            return;
+        }
+
+        _fileSize = log.size();
+        _pending.clear();
     }
-    else
+
+    bool _loaded;
+    std::string _filePath;
+    std::unordered_map<std::string, std::string> _values;
+    // changes not in the file yet
+    std::string _pending;
+    std::chrono::steady_clock::time_point _pendingSince;
+    size_t _fileSize;
+    // size of the log holding only the current values
+    size_t _valuesSize;
+};
+
+UserDefaultStore s_store;
+
+}
+
+static const char* getValueForKey(const char* pKey)
+{
+    if (! pKey)
     {
-        if (rootNode)
-        {
-            tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-            rootNode->LinkEndChild(tmpNode);
-            tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-            tmpNode->LinkEndChild(content);
-        }    
+        return nullptr;
     }
+    auto value = s_store.getValue(pKey);
+    return value ? value->c_str() : nullptr;
+}
 
-    // save file and free doc
-    if (doc)
+static void setValueForKey(const char* pKey, const char* pValue)
+{
+    // check the params
+    if (! pKey || ! pValue)
     {
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        return;
     }
+    s_store.setValue(pKey, pValue);
 }
 
 /**
@@ -147,6 +403,7 @@ bool UserDefault::_isFilePathInitialized = false;
 
 UserDefault::~UserDefault()
 {
+    s_store.reset();
 }
 
 UserDefault::UserDefault()
@@ -160,16 +417,7 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const char* value = getValueForKey(pKey);
 
     bool ret = defaultValue;
 
@@ -178,8 +426,6 @@ bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
         ret = (! strcmp(value, "true"));
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -190,16 +436,7 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const char* value = getValueForKey(pKey);
 
     int ret = defaultValue;
 
@@ -208,12 +445,6 @@ int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
         ret = atoi(value);
     }
 
-    if(doc)
-    {
-        delete doc;
-    }
-
-
     return ret;
 }
 
@@ -236,16 +467,7 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const char* value = getValueForKey(pKey);
 
     double ret = defaultValue;
 
@@ -254,8 +476,6 @@ double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
         ret = utils::atof(value);
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -266,16 +486,7 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const char* value = getValueForKey(pKey);
 
     string ret = defaultValue;
 
@@ -284,8 +495,6 @@ string UserDefault::getStringForKey(const char* pKey, const std::string & defaul
         ret = string(value);
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -296,16 +505,7 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        encodedData = (const char*)(node->FirstChild()->Value());
-    }
+    const char* encodedData = getValueForKey(pKey);
     
     Data ret = defaultValue;
     
@@ -319,9 +519,7 @@ Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
         }
     }
     
-    if (doc) delete doc;
-    
-    return ret;    
+    return ret;
 }
 
 
@@ -410,13 +608,6 @@ UserDefault* UserDefault::getInstance()
     {
         initXMLFilePath();
 
-        // only create xml file one time
-        // the file exists after the program exit
-        if ((!isXMLFileExist()) && (!createXMLFile()))
-        {
-            return nullptr;
-        }
-
         _userDefault = new (std::nothrow) UserDefault();
     }
 
@@ -501,14 +692,11 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    s_store.writeBack();
 }
 
 void UserDefault::deleteValueForKey(const char* key)
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-
     // check the params
     if (!key)
     {
@@ -516,22 +704,7 @@ void UserDefault::deleteValueForKey(const char* key)
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(key, &rootNode, &doc);
-
-    // if node not exist, don't need to delete
-    if (!node)
-    {
-        return;
-    }
-
-    // save file and free doc
-    if (doc)
-    {
-        doc->DeleteNode(node);
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
-    }
+    s_store.deleteValue(key);
 
     flush();
 }
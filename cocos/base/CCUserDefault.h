@@ -241,6 +241,10 @@ public:
      */
     CC_DEPRECATED_ATTRIBUTE static void purgeSharedUserDefault();
     /** All supported platforms other iOS & Android use xml file to save values. This function is return the file path of the xml path.
+     * Since v3.10, the platforms that used it keep the values in memory and write them to UserDefault.bin in the
+     * writable path, when flush() is called, when the application enters the background or about two seconds
+     * after they are set (the delay is counted by the Scheduler, it doesn't elapse while the Director is paused).
+     * The xml file is only read once, to import its values.
      * @js NA
      */
     static const std::string& getXMLFilePath();
@@ -0,0 +1,374 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "base/CCZipArchive.h"
+
+#include <algorithm>
+#include <mutex>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+static const uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+static const uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+static const uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+static const size_t LOCAL_HEADER_SIZE = 30;
+static const size_t CENTRAL_HEADER_SIZE = 46;
+static const size_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+static const size_t MAX_COMMENT_SIZE = 0xffff;
+
+static const uint16_t METHOD_STORED = 0;
+static const uint16_t METHOD_DEFLATED = 8;
+static const uint16_t FLAG_ENCRYPTED = 1;
+
+// identifies the version of a mounted file, or of a file which failed to mount; a file which can't be stat'ed
+// (missing, or inside the Android apk) has the stamp {-1, -1}
+struct FileStamp
+{
+    long long size;
+    long long modificationTime;
+
+    bool operator==(const FileStamp& other) const
+    {
+        return size == other.size && modificationTime == other.modificationTime;
+    }
+};
+
+struct MountedArchive
+{
+    ZipArchive* archive;
+    FileStamp stamp;
+};
+
+static std::mutex s_archivesMutex;
+static std::unordered_map<std::string, MountedArchive> s_archives;
+static std::unordered_map<std::string, FileStamp> s_failedMounts;
+// archives whose file changed after they were mounted, their pointers stay valid until they are unmounted
+static std::vector<ZipArchive*> s_replacedArchives;
+
+static FileStamp getFileStamp(const std::string& fullPath)
+{
+    struct stat st;
+    if (stat(fullPath.c_str(), &st) != 0)
+        return FileStamp{ -1, -1 };
+    return FileStamp{ static_cast<long long>(st.st_size), static_cast<long long>(st.st_mtime) };
+}
+
+// zip files are little endian
+static uint16_t readUInt16(const unsigned char* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t readUInt32(const unsigned char* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+        | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+ZipArchive* ZipArchive::getArchive(const std::string& fullPath)
+{
+    std::lock_guard<std::mutex> lock(s_archivesMutex);
+
+    // the file may be downloaded again or rewritten while it is mounted, the directory read when it was
+    // mounted would then be wrong, and a truncated mapping would crash when it is read
+    FileStamp stamp = getFileStamp(fullPath);
+    auto it = s_archives.find(fullPath);
+    if (it != s_archives.end())
+    {
+        if (it->second.stamp == stamp)
+            return it->second.archive;
+        s_replacedArchives.push_back(it->second.archive);
+        s_archives.erase(it);
+    }
+
+    // a file which failed to mount is only tried again once it changed, e.g. when it was downloaded
+    auto failed = s_failedMounts.find(fullPath);
+    if (failed != s_failedMounts.end() && failed->second == stamp)
+        return nullptr;
+
+    auto archive = new (std::nothrow) ZipArchive();
+    if (archive && archive->initWithFile(fullPath))
+    {
+        s_archives[fullPath] = MountedArchive{ archive, stamp };
+        s_failedMounts.erase(fullPath);
+        return archive;
+    }
+    delete archive;
+    s_failedMounts[fullPath] = stamp;
+    return nullptr;
+}
+
+void ZipArchive::unmount(const std::string& fullPath)
+{
+    std::lock_guard<std::mutex> lock(s_archivesMutex);
+
+    auto it = s_archives.find(fullPath);
+    if (it != s_archives.end())
+    {
+        delete it->second.archive;
+        s_archives.erase(it);
+    }
+    s_failedMounts.erase(fullPath);
+
+    auto replaced = std::remove_if(s_replacedArchives.begin(), s_replacedArchives.end(), [&fullPath](ZipArchive* archive) {
+        if (archive->getPath() != fullPath)
+            return false;
+        delete archive;
+        return true;
+    });
+    s_replacedArchives.erase(replaced, s_replacedArchives.end());
+}
+
+void ZipArchive::unmountAll()
+{
+    std::lock_guard<std::mutex> lock(s_archivesMutex);
+
+    for (auto& item : s_archives)
+    {
+        delete item.second.archive;
+    }
+    s_archives.clear();
+    s_failedMounts.clear();
+
+    for (auto archive : s_replacedArchives)
+    {
+        delete archive;
+    }
+    s_replacedArchives.clear();
+}
+
+ZipArchive::ZipArchive()
+{
+}
+
+ZipArchive::~ZipArchive()
+{
+}
+
+bool ZipArchive::initWithFile(const std::string& fullPath)
+{
+    if (!_file.open(fullPath))
+        return false;
+    _path = fullPath;
+
+    const unsigned char* bytes = _file.getBytes();
+    size_t size = static_cast<size_t>(_file.getSize());
+    if (size < END_OF_CENTRAL_DIRECTORY_SIZE)
+        return false;
+
+    // the end of central directory record is followed by a comment of up to 64KB
+    const unsigned char* end = nullptr;
+    size_t lowest = size - END_OF_CENTRAL_DIRECTORY_SIZE > MAX_COMMENT_SIZE ? size - END_OF_CENTRAL_DIRECTORY_SIZE - MAX_COMMENT_SIZE : 0;
+    for (size_t offset = size - END_OF_CENTRAL_DIRECTORY_SIZE + 1; offset-- > lowest;)
+    {
+        if (readUInt32(bytes + offset) == END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+        {
+            end = bytes + offset;
+            break;
+        }
+    }
+    if (!end)
+    {
+        CCLOG("cocos2d: ZipArchive: %s isn't a zip file", fullPath.c_str());
+        return false;
+    }
+
+    uint16_t entryCount = readUInt16(end + 10);
+    uint32_t directorySize = readUInt32(end + 12);
+    uint32_t directoryOffset = readUInt32(end + 16);
+    if (entryCount == 0xffff || directoryOffset == 0xffffffff)
+    {
+        CCLOG("cocos2d: ZipArchive: %s is a zip64 file, which isn't supported", fullPath.c_str());
+        return false;
+    }
+    if (static_cast<size_t>(directoryOffset) + directorySize > size)
+    {
+        CCLOG("cocos2d: ZipArchive: %s is invalid", fullPath.c_str());
+        return false;
+    }
+
+    _entries.reserve(entryCount);
+    const unsigned char* header = bytes + directoryOffset;
+    const unsigned char* directoryEnd = header + directorySize;
+    for (uint16_t i = 0; i < entryCount; ++i)
+    {
+        if (directoryEnd - header < static_cast<ptrdiff_t>(CENTRAL_HEADER_SIZE)
+            || readUInt32(header) != CENTRAL_HEADER_SIGNATURE)
+        {
+            CCLOG("cocos2d: ZipArchive: %s is invalid", fullPath.c_str());
+            return false;
+        }
+        uint16_t nameLength = readUInt16(header + 28);
+        size_t headerSize = CENTRAL_HEADER_SIZE + nameLength + readUInt16(header + 30) + readUInt16(header + 32);
+        if (directoryEnd - header < static_cast<ptrdiff_t>(headerSize))
+        {
+            CCLOG("cocos2d: ZipArchive: %s is invalid", fullPath.c_str());
+            return false;
+        }
+
+        Entry entry;
+        entry.flags = readUInt16(header + 8);
+        entry.compressionMethod = readUInt16(header + 10);
+        entry.compressedSize = readUInt32(header + 20);
+        entry.uncompressedSize = readUInt32(header + 24);
+        entry.localHeaderOffset = readUInt32(header + 42);
+        if (entry.compressedSize == 0xffffffff || entry.uncompressedSize == 0xffffffff || entry.localHeaderOffset == 0xffffffff)
+        {
+            CCLOG("cocos2d: ZipArchive: %s is a zip64 file, which isn't supported", fullPath.c_str());
+            return false;
+        }
+        _entries.emplace(std::string(reinterpret_cast<const char*>(header + CENTRAL_HEADER_SIZE), nameLength), entry);
+
+        header += headerSize;
+    }
+
+    return true;
+}
+
+const unsigned char* ZipArchive::getEntryBytes(const Entry& entry) const
+{
+    // the local header may have a different extra field than the central directory
+    const unsigned char* bytes = _file.getBytes();
+    size_t size = static_cast<size_t>(_file.getSize());
+    size_t offset = entry.localHeaderOffset;
+    if (size < LOCAL_HEADER_SIZE || size - LOCAL_HEADER_SIZE < offset || readUInt32(bytes + offset) != LOCAL_HEADER_SIGNATURE)
+        return nullptr;
+
+    offset += LOCAL_HEADER_SIZE + readUInt16(bytes + offset + 26) + readUInt16(bytes + offset + 28);
+    if (offset > size || size - offset < entry.compressedSize)
+        return nullptr;
+
+    return bytes + offset;
+}
+
+bool ZipArchive::fileExists(const std::string& fileName) const
+{
+    return _entries.find(fileName) != _entries.end();
+}
+
+ssize_t ZipArchive::getFileSize(const std::string& fileName) const
+{
+    auto it = _entries.find(fileName);
+    return it != _entries.end() ? static_cast<ssize_t>(it->second.uncompressedSize) : -1;
+}
+
+std::vector<std::string> ZipArchive::getFileNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(_entries.size());
+    for (const auto& item : _entries)
+    {
+        if (!item.first.empty() && item.first.back() != '/')
+            names.push_back(item.first);
+    }
+    return names;
+}
+
+unsigned char* ZipArchive::getFileData(const std::string& fileName, ssize_t* size) const
+{
+    if (size)
+        *size = 0;
+
+    auto it = _entries.find(fileName);
+    if (it == _entries.end())
+        return nullptr;
+
+    const Entry& entry = it->second;
+    if (entry.flags & FLAG_ENCRYPTED)
+    {
+        CCLOG("cocos2d: ZipArchive: %s in %s is encrypted", fileName.c_str(), _path.c_str());
+        return nullptr;
+    }
+    if (entry.compressionMethod != METHOD_STORED && entry.compressionMethod != METHOD_DEFLATED)
+    {
+        CCLOG("cocos2d: ZipArchive: %s in %s uses the unsupported compression method %d", fileName.c_str(), _path.c_str(), entry.compressionMethod);
+        return nullptr;
+    }
+    const unsigned char* source = getEntryBytes(entry);
+    if (!source)
+    {
+        CCLOG("cocos2d: ZipArchive: %s in %s is invalid", fileName.c_str(), _path.c_str());
+        return nullptr;
+    }
+
+    // at least one byte, so that an empty file isn't taken for an error
+    unsigned char* buffer = (unsigned char*)malloc(entry.uncompressedSize > 0 ? entry.uncompressedSize : 1);
+    if (!buffer)
+        return nullptr;
+
+    if (entry.compressionMethod == METHOD_STORED)
+    {
+        memcpy(buffer, source, entry.uncompressedSize);
+    }
+    else
+    {
+        // raw deflate data, each call has its own stream so threads can inflate at the same time
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        int ret = inflateInit2(&stream, -MAX_WBITS);
+        if (ret == Z_OK)
+        {
+            stream.next_in = const_cast<Bytef*>(source);
+            stream.avail_in = entry.compressedSize;
+            stream.next_out = buffer;
+            stream.avail_out = entry.uncompressedSize;
+            ret = inflate(&stream, Z_FINISH);
+            inflateEnd(&stream);
+        }
+        if (ret != Z_STREAM_END || stream.total_out != entry.uncompressedSize)
+        {
+            CCLOG("cocos2d: ZipArchive: can't inflate %s in %s", fileName.c_str(), _path.c_str());
+            free(buffer);
+            return nullptr;
+        }
+    }
+
+    if (size)
+        *size = entry.uncompressedSize;
+    return buffer;
+}
+
+const unsigned char* ZipArchive::getStoredFileBytes(const std::string& fileName, ssize_t* size) const
+{
+    if (size)
+        *size = 0;
+
+    auto it = _entries.find(fileName);
+    if (it == _entries.end())
+        return nullptr;
+
+    const Entry& entry = it->second;
+    if (entry.compressionMethod != METHOD_STORED || (entry.flags & FLAG_ENCRYPTED))
+        return nullptr;
+
+    const unsigned char* bytes = getEntryBytes(entry);
+    if (bytes && size)
+        *size = entry.uncompressedSize;
+    return bytes;
+}
+
+NS_CC_END
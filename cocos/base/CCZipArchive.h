@@ -0,0 +1,131 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCZIP_ARCHIVE_H_
+#define __CCZIP_ARCHIVE_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+#include "platform/CCMappedFile.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class ZipArchive
+ * @brief A zip file mounted once for the whole process, whose entries are found through a hash index.
+ *
+ * The archive is memory mapped when possible and its central directory read once, so looking up an entry
+ * doesn't scan the directory like `unzLocateFile()`. Reads don't share any state, several threads can
+ * read from the same archive at the same time. Stored (uncompressed) entries can be used in place,
+ * without copying them, with `getStoredFileBytes()`.
+ *
+ * Zip64 archives and encrypted entries aren't supported, `getArchive()` returns nullptr for the former.
+ * @since v3.10
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ZipArchive
+{
+public:
+    /** Returns the archive of this file, mounting it the first time. Thread safe.
+     *
+     * The file is stat'ed on each call: when its size or modification time changed since it was mounted, e.g. it
+     * was downloaded again, it is mounted again. The archive returned before stays valid, with its old entries,
+     * until unmount() is called. A file which fails to mount isn't read again until its size or modification
+     * time changes, or unmount() is called with its path.
+     * @return nullptr if the file can't be read or isn't a supported zip file.
+     */
+    static ZipArchive* getArchive(const std::string& fullPath);
+
+    /** Unmounts an archive. Its pointers, and the bytes returned by getStoredFileBytes(), become invalid,
+     * so no other thread may be using it. This includes the archives mounted before the file changed.
+     * If the file failed to mount, the next getArchive() tries again.
+     */
+    static void unmount(const std::string& fullPath);
+
+    /** Unmounts all the archives, see unmount(). */
+    static void unmountAll();
+
+    /** Returns true if the archive has an entry with this name. */
+    bool fileExists(const std::string& fileName) const;
+
+    /** Returns the uncompressed size of an entry, or -1 if there is no such entry. */
+    ssize_t getFileSize(const std::string& fileName) const;
+
+    /** Returns the names of the files of the archive, without the directories. */
+    std::vector<std::string> getFileNames() const;
+
+    /** Returns the number of entries of the archive. */
+    ssize_t getFileCount() const { return static_cast<ssize_t>(_entries.size()); }
+
+    /** Returns a copy of the uncompressed entry, to release with free(), like FileUtils::getFileDataFromZip().
+     * @return nullptr if the entry doesn't exist or can't be read.
+     */
+    unsigned char* getFileData(const std::string& fileName, ssize_t* size) const;
+
+    /** Returns the bytes of a stored entry inside the archive, valid until the archive is unmounted.
+     * @return nullptr if the entry doesn't exist or is compressed.
+     */
+    const unsigned char* getStoredFileBytes(const std::string& fileName, ssize_t* size) const;
+
+    /** Returns true if the archive is memory mapped rather than loaded in memory. */
+    bool isMapped() const { return _file.isMapped(); }
+
+    const std::string& getPath() const { return _path; }
+
+    ~ZipArchive();
+
+private:
+    struct Entry
+    {
+        uint32_t localHeaderOffset;
+        uint32_t compressedSize;
+        uint32_t uncompressedSize;
+        uint16_t compressionMethod;
+        uint16_t flags;
+    };
+
+    ZipArchive();
+    bool initWithFile(const std::string& fullPath);
+    const unsigned char* getEntryBytes(const Entry& entry) const;
+
+    std::string _path;
+    MappedFile _file;
+    std::unordered_map<std::string, Entry> _entries;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(ZipArchive);
+};
+
+NS_CC_END
+// end of base group
+/** @} */
+
+#endif // __CCZIP_ARCHIVE_H_
@@ -171,6 +171,49 @@ THE SOFTWARE.
     #endif
 #endif
 
+/** @def CC_RENDERER_USE_MAP_BUFFER_RANGE
+ * If enabled, the Renderer writes batched quads and triangles straight into a ring of vertex buffer segments
+ * mapped with glMapBufferRange, instead of orphaning the vertex buffer and copying the vertices on every flush.
+ * It is only used when the GL context supports map buffer range and sync objects, otherwise the old path is used.
+ * To disable it set it to 0. Enabled by default on platforms whose GL headers expose these functions.
+ */
+#ifndef CC_RENDERER_USE_MAP_BUFFER_RANGE
+    #if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        #define CC_RENDERER_USE_MAP_BUFFER_RANGE 1
+    #else
+        #define CC_RENDERER_USE_MAP_BUFFER_RANGE 0
+    #endif
+#endif
+
+/** @def CC_RENDERER_USE_INSTANCING
+ * If enabled, consecutive opaque meshes that share their vertex data, texture and default unlit 3D shader are drawn
+ * with a single instanced draw call, their model view matrices and colors being read from an instance buffer.
+ * Skinned meshes are only drawn together when they share the same pose, see Renderer::setInstancingEnabled().
+ * It is only used when the GL context supports instanced arrays, otherwise every mesh is drawn on its own.
+ * To disable it set it to 0. Enabled by default on platforms whose GL headers expose these functions.
+ */
+#ifndef CC_RENDERER_USE_INSTANCING
+    #if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        #define CC_RENDERER_USE_INSTANCING 1
+    #else
+        #define CC_RENDERER_USE_INSTANCING 0
+    #endif
+#endif
+
+/** @def CC_GLPROGRAM_USE_PROGRAM_BINARY
+ * If enabled, GLProgram can store linked program binaries in the writable path and load them on the next run
+ * instead of compiling the shaders again. See GLProgram::setBinaryCacheEnabled(), the cache itself is disabled by default.
+ * It is only used when the GL context supports program binaries.
+ * To disable it set it to 0. Enabled by default on platforms whose GL headers expose these functions.
+ */
+#ifndef CC_GLPROGRAM_USE_PROGRAM_BINARY
+    #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        #define CC_GLPROGRAM_USE_PROGRAM_BINARY 1
+    #else
+        #define CC_GLPROGRAM_USE_PROGRAM_BINARY 0
+    #endif
+#endif
+
 
 /** @def CC_USE_LA88_LABELS
  * If enabled, it will use LA88 (Luminance Alpha 16-bit textures) for LabelTTF objects.
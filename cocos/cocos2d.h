@@ -39,6 +39,9 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCParallelTaskPool.h"
+#include "base/CCZipArchive.h"
+#include "base/CCAsyncFileLoader.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
@@ -106,6 +109,7 @@ THE SOFTWARE.
 #include "2d/CCActionTiledGrid.h"
 #include "2d/CCActionTween.h"
 #include "2d/CCTweenFunction.h"
+#include "2d/CCTweenBatch.h"
 
 // 2d nodes
 #include "2d/CCAtlasNode.h"
@@ -192,6 +196,7 @@ THE SOFTWARE.
 #include "platform/CCDevice.h"
 #include "platform/CCFileUtils.h"
 #include "platform/CCImage.h"
+#include "platform/CCMappedFile.h"
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCSAXParser.h"
@@ -260,6 +265,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCSpriteSheetBinary.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
@@ -25,6 +25,8 @@ THE SOFTWARE.
 
 #include "CCFileUtils.h"
 
+#include <algorithm>
+#include <climits>
 #include <stack>
 
 #include "base/CCData.h"
@@ -32,6 +34,8 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "platform/CCSAXParser.h"
 #include "base/ccUtils.h"
+#include "base/CCZipArchive.h"
+#include "base/CCAsyncFileLoader.h"
 
 #include "tinyxml2.h"
 #ifdef MINIZIP_FROM_SYSTEM
@@ -555,6 +559,8 @@ void FileUtils::setDelegate(FileUtils *delegate)
 
 FileUtils::FileUtils()
     : _writablePath("")
+    , _pathIndexEnabled(false)
+    , _pathIndexDirty(true)
 {
 }
 
@@ -605,6 +611,9 @@ bool FileUtils::init()
 void FileUtils::purgeCachedEntries()
 {
     _fullPathCache.clear();
+    _indexedPathFiles.clear();
+    _mountedArchives.clear();
+    _pathIndexDirty = true;
 }
 
 static Data getData(const std::string& filename, bool forString)
@@ -669,7 +678,9 @@ static Data getData(const std::string& filename, bool forString)
 
 std::string FileUtils::getStringFromFile(const std::string& filename)
 {
-    Data data = getData(filename, true);
+    Data data;
+    if (!getDataFromMountedArchive(filename, true, &data))
+        data = getData(filename, true);
     if (data.isNull())
         return "";
 
@@ -679,9 +690,63 @@ std::string FileUtils::getStringFromFile(const std::string& filename)
 
 Data FileUtils::getDataFromFile(const std::string& filename)
 {
+    Data data;
+    if (getDataFromMountedArchive(filename, false, &data))
+        return data;
     return getData(filename, false);
 }
 
+Data FileUtils::getDataFromFullPath(const std::string& fullPath)
+{
+    return getData(fullPath, false);
+}
+
+void FileUtils::getDataFromFileAsync(const std::string& filename, const std::function<void(Data)>& callback)
+{
+    // the file is resolved here, the path index and the mounted archives may be rebuilt
+    // by the cocos thread at any time so the I/O threads must not use them
+    std::string fullPath = fullPathForFilename(filename);
+
+    std::string fileName;
+    ZipArchive* archive = fullPath.empty() ? nullptr : getMountedArchive(fullPath, &fileName);
+
+    AsyncFileLoader::Reader reader;
+    if (archive)
+    {
+        // mounted archives are never unmounted by FileUtils, the pointer stays valid
+        reader = [archive, fileName]() {
+            Data data;
+            ssize_t size = 0;
+            unsigned char* buffer = archive->getFileData(fileName, &size);
+            if (buffer && size > 0)
+                data.fastSet(buffer, size);
+            else
+                free(buffer);
+            return data;
+        };
+    }
+    else if (!fullPath.empty())
+    {
+        reader = [this, fullPath]() { return getDataFromFullPath(fullPath); };
+    }
+    else
+    {
+        reader = []() { return Data(); };
+    }
+
+    AsyncFileLoader::getInstance()->load(fullPath, reader, callback);
+}
+
+void FileUtils::getStringFromFileAsync(const std::string& filename, const std::function<void(std::string)>& callback)
+{
+    getDataFromFileAsync(filename, [callback](Data data) {
+        if (data.isNull())
+            callback("");
+        else
+            callback(std::string((const char*)data.getBytes(), data.getSize()));
+    });
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
@@ -722,6 +787,14 @@ unsigned char* FileUtils::getFileDataFromZip(const std::string& zipFilePath, con
     {
         CC_BREAK_IF(zipFilePath.empty());
 
+        // archives are mounted once and indexed, minizip is only used for the ones ZipArchive can't read
+        auto archive = ZipArchive::getArchive(zipFilePath);
+        if (archive)
+        {
+            buffer = archive->getFileData(filename, size);
+            break;
+        }
+
         file = unzOpen(zipFilePath.c_str());
         CC_BREAK_IF(!file);
 
@@ -821,11 +894,39 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
 
     std::string fullpath;
 
-    for (const auto& searchIt : _searchPathArray)
+    if (_pathIndexEnabled || !_overlayPathArray.empty())
+    {
+        fullpath = getPathFromIndex(newFilename);
+        if (!fullpath.empty())
+        {
+            _fullPathCache.insert(std::make_pair(filename, fullpath));
+            return fullpath;
+        }
+
+        // the index only knows the files listed when it was built, and the names relative to a path,
+        // the directories of the overlays are searched as usual if the file isn't in it
+        for (const auto& overlayPath : _overlayPathArray)
+        {
+            if (_mountedArchives.find(overlayPath) != _mountedArchives.end())
+                continue;
+
+            for (const auto& resolutionIt : _searchResolutionsOrderArray)
+            {
+                fullpath = this->getPathForFilename(newFilename, resolutionIt, overlayPath);
+                if (!fullpath.empty())
+                {
+                    _fullPathCache.insert(std::make_pair(filename, fullpath));
+                    return fullpath;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < _searchPathArray.size(); ++i)
     {
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
         {
-            fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
+            fullpath = this->getPathForFilename(newFilename, resolutionIt, _searchPathArray[i]);
 
             if (!fullpath.empty())
             {
@@ -854,6 +955,7 @@ void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& search
 {
     bool existDefault = false;
     _fullPathCache.clear();
+    _pathIndexDirty = true;
     _searchResolutionsOrderArray.clear();
     for(const auto& iter : searchResolutionsOrder)
     {
@@ -888,6 +990,7 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
     } else {
         _searchResolutionsOrderArray.push_back(resOrder);
     }
+    _pathIndexDirty = true;
 }
 
 const std::vector<std::string>& FileUtils::getSearchResolutionsOrder() const
@@ -915,21 +1018,11 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
     bool existDefaultRootPath = false;
 
     _fullPathCache.clear();
+    _pathIndexDirty = true;
     _searchPathArray.clear();
     for (const auto& iter : searchPaths)
     {
-        std::string prefix;
-        std::string path;
-
-        if (!isAbsolutePath(iter))
-        { // Not an absolute path
-            prefix = _defaultResRootPath;
-        }
-        path = prefix + (iter);
-        if (!path.empty() && path[path.length()-1] != '/')
-        {
-            path += "/";
-        }
+        std::string path = getMountPath(iter);
         if (!existDefaultRootPath && path == _defaultResRootPath)
         {
             existDefaultRootPath = true;
@@ -945,23 +1038,328 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 }
 
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
+{
+    std::string path = getMountPath(searchpath);
+    if (front) {
+        _searchPathArray.insert(_searchPathArray.begin(), path);
+    } else {
+        _searchPathArray.push_back(path);
+    }
+    _pathIndexDirty = true;
+}
+
+std::string FileUtils::getMountPath(const std::string& path) const
 {
     std::string prefix;
-    if (!isAbsolutePath(searchpath))
+    if (!isAbsolutePath(path))
         prefix = _defaultResRootPath;
 
-    std::string path = prefix + searchpath;
-    if (!path.empty() && path[path.length()-1] != '/')
+    std::string ret = prefix + path;
+    if (!ret.empty() && ret[ret.length()-1] != '/')
     {
-        path += "/";
+        ret += "/";
     }
-    if (front) {
-        _searchPathArray.insert(_searchPathArray.begin(), path);
-    } else {
-        _searchPathArray.push_back(path);
+    return ret;
+}
+
+void FileUtils::setPathIndexEnabled(bool enabled)
+{
+    if (_pathIndexEnabled != enabled)
+    {
+        _pathIndexEnabled = enabled;
+        _pathIndexDirty = true;
+        _fullPathCache.clear();
+    }
+}
+
+// one path per line, as printed by `find . -type f`
+static void parsePathIndexManifest(const std::string& content, std::vector<std::string>* files)
+{
+    size_t start = 0;
+    while (start < content.size())
+    {
+        size_t end = content.find('\n', start);
+        if (end == std::string::npos)
+            end = content.size();
+
+        size_t last = end;
+        while (last > start && (content[last - 1] == '\r' || content[last - 1] == ' '))
+            --last;
+        if (last - start >= 2 && content[start] == '.' && content[start + 1] == '/')
+            start += 2;
+        if (last > start)
+            files->push_back(content.substr(start, last - start));
+
+        start = end + 1;
     }
 }
 
+bool FileUtils::loadPathIndexManifest(const std::string& path, const std::string& manifestFile)
+{
+    // the full path is kept, the manifest may be read again while the index is being built
+    std::string fullPath = fullPathForFilename(manifestFile);
+    std::string content = fullPath.empty() ? "" : getStringFromFile(fullPath);
+    if (content.empty())
+    {
+        CCLOG("cocos2d: FileUtils: can't load the path index manifest %s", manifestFile.c_str());
+        return false;
+    }
+
+    std::string mountPath = getMountPath(path);
+    std::vector<std::string> files;
+    parsePathIndexManifest(content, &files);
+    _indexedPathFiles[mountPath] = std::move(files);
+    _pathIndexManifests[mountPath] = fullPath;
+    _pathIndexDirty = true;
+    _fullPathCache.clear();
+    return true;
+}
+
+void FileUtils::addOverlayPath(const std::string& path)
+{
+    std::string mountPath = getMountPath(path);
+    removeOverlayPath(mountPath);
+    _overlayPathArray.insert(_overlayPathArray.begin(), mountPath);
+}
+
+void FileUtils::removeOverlayPath(const std::string& path)
+{
+    std::string mountPath = getMountPath(path);
+    auto iter = std::find(_overlayPathArray.begin(), _overlayPathArray.end(), mountPath);
+    if (iter != _overlayPathArray.end())
+    {
+        _overlayPathArray.erase(iter);
+    }
+
+    // it is listed again when added back, to see the patched files
+    if (_pathIndexManifests.find(mountPath) == _pathIndexManifests.end())
+    {
+        _indexedPathFiles.erase(mountPath);
+    }
+    _mountedArchives.erase(mountPath);
+    _pathIndexDirty = true;
+    _fullPathCache.clear();
+}
+
+const std::vector<std::string>* FileUtils::getIndexedPathFiles(const std::string& path) const
+{
+    auto iter = _indexedPathFiles.find(path);
+    if (iter != _indexedPathFiles.end())
+    {
+        return &iter->second;
+    }
+
+    std::vector<std::string> files;
+    auto manifestIter = _pathIndexManifests.find(path);
+    if (manifestIter != _pathIndexManifests.end())
+    {
+        std::string content = const_cast<FileUtils*>(this)->getStringFromFile(manifestIter->second);
+        if (content.empty())
+            return nullptr;
+        parsePathIndexManifest(content, &files);
+    }
+    else
+    {
+        std::string archivePath = path.substr(0, path.length() - 1);
+        std::string extension = getFileExtension(archivePath);
+        if (extension == ".zip" || extension == ".obb")
+        {
+            auto archive = ZipArchive::getArchive(archivePath);
+            if (!archive)
+                return nullptr;
+            files = archive->getFileNames();
+            _mountedArchives[path] = archive;
+        }
+        else if (!listFilesRecursively(path, &files))
+        {
+            return nullptr;
+        }
+    }
+
+    auto& ret = _indexedPathFiles[path];
+    ret = std::move(files);
+    return &ret;
+}
+
+void FileUtils::buildPathIndex() const
+{
+    _pathIndexDirty = false;
+    _pathIndex.clear();
+    _unindexedPaths.clear();
+
+    std::vector<const std::string*> paths;
+    for (const auto& path : _overlayPathArray)
+        paths.push_back(&path);
+    for (size_t i = 0; _pathIndexEnabled && i < _searchPathArray.size(); ++i)
+        paths.push_back(&_searchPathArray[i]);
+
+    // the lower the priority, the earlier fullPathForFilename() would find the file
+    const int resolutionCount = static_cast<int>(_searchResolutionsOrderArray.size());
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        const std::string& path = *paths[i];
+        const int priority = static_cast<int>(i) * resolutionCount;
+
+        auto files = getIndexedPathFiles(path);
+        if (!files)
+        {
+            _unindexedPaths.push_back({ path, priority });
+            continue;
+        }
+
+        for (const auto& file : *files)
+        {
+            size_t nameStart = file.find_last_of('/');
+            nameStart = nameStart == std::string::npos ? 0 : nameStart + 1;
+
+            for (int r = 0; r < resolutionCount; ++r)
+            {
+                // the file is found as "directory/name" if it is "directory/resolution/name"
+                const std::string& resolution = _searchResolutionsOrderArray[r];
+                if (nameStart < resolution.length())
+                    continue;
+                size_t directoryEnd = nameStart - resolution.length();
+                if (file.compare(directoryEnd, resolution.length(), resolution) != 0
+                    || (directoryEnd > 0 && file[directoryEnd - 1] != '/'))
+                    continue;
+
+                std::string name = resolution.empty() ? file : file.substr(0, directoryEnd) + file.substr(nameStart);
+                auto iter = _pathIndex.find(name);
+                if (iter == _pathIndex.end())
+                {
+                    _pathIndex.emplace(std::move(name), IndexedPath{ path + file, priority + r });
+                }
+                else if (iter->second.priority > priority + r)
+                {
+                    iter->second.fullPath = path + file;
+                    iter->second.priority = priority + r;
+                }
+            }
+        }
+    }
+}
+
+// the index keys are the names relative to their path, e.g. "./dir/../file.png" is found as "file.png"
+static std::string normalizeIndexedName(const std::string& filename)
+{
+    if (filename.find("./") == std::string::npos && filename.find("//") == std::string::npos)
+    {
+        return filename;
+    }
+
+    std::vector<std::string> components;
+    size_t start = 0;
+    while (start <= filename.length())
+    {
+        size_t end = filename.find('/', start);
+        if (end == std::string::npos)
+            end = filename.length();
+
+        std::string component = filename.substr(start, end - start);
+        if (component == "..")
+        {
+            if (!components.empty() && components.back() != "..")
+                components.pop_back();
+            else
+                components.push_back(component);
+        }
+        else if (!component.empty() && component != ".")
+        {
+            components.push_back(component);
+        }
+        start = end + 1;
+    }
+
+    std::string ret;
+    for (const auto& component : components)
+    {
+        if (!ret.empty())
+            ret += '/';
+        ret += component;
+    }
+    return ret;
+}
+
+std::string FileUtils::getPathFromIndex(const std::string& filename) const
+{
+    if (_pathIndexDirty)
+    {
+        buildPathIndex();
+    }
+
+    auto iter = _pathIndex.find(normalizeIndexedName(filename));
+    int indexedPriority = iter != _pathIndex.end() ? iter->second.priority : INT_MAX;
+
+    // the paths which can't be indexed are searched as usual, if they come before the indexed file
+    const int resolutionCount = static_cast<int>(_searchResolutionsOrderArray.size());
+    for (const auto& unindexed : _unindexedPaths)
+    {
+        for (int r = 0; r < resolutionCount && unindexed.priority + r < indexedPriority; ++r)
+        {
+            std::string fullpath = getPathForFilename(filename, _searchResolutionsOrderArray[r], unindexed.path);
+            if (!fullpath.empty())
+                return fullpath;
+        }
+    }
+
+    return iter != _pathIndex.end() ? iter->second.fullPath : "";
+}
+
+ZipArchive* FileUtils::getMountedArchive(const std::string& fullPath, std::string* fileName) const
+{
+    // the archives are mounted when the index is built
+    if (_pathIndexDirty && (_pathIndexEnabled || !_overlayPathArray.empty()))
+    {
+        buildPathIndex();
+    }
+
+    for (const auto& item : _mountedArchives)
+    {
+        const std::string& path = item.first;
+        if (fullPath.length() > path.length() && fullPath.compare(0, path.length(), path) == 0)
+        {
+            *fileName = fullPath.substr(path.length());
+            return item.second;
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::getDataFromMountedArchive(const std::string& filename, bool forString, Data* data) const
+{
+    if (filename.empty())
+        return false;
+
+    std::string fileName;
+    std::string fullPath = fullPathForFilename(filename);
+    auto archive = _mountedArchives.empty() ? nullptr : getMountedArchive(fullPath, &fileName);
+    if (!archive)
+        return false;
+
+    ssize_t size = 0;
+    unsigned char* buffer = archive->getFileData(fileName, &size);
+    if (buffer && forString)
+    {
+        unsigned char* stringBuffer = (unsigned char*)realloc(buffer, size + 1);
+        if (stringBuffer)
+            stringBuffer[size] = '\0';
+        else
+            free(buffer);
+        buffer = stringBuffer;
+    }
+
+    if (!buffer || size == 0)
+    {
+        CCLOG("Get data from file %s failed", filename.c_str());
+        free(buffer);
+    }
+    else
+    {
+        data->fastSet(buffer, size);
+    }
+    return true;
+}
+
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
 {
     _fullPathCache.clear();
@@ -1008,7 +1406,9 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
-        return isFileExistInternal(filename);
+        std::string fileName;
+        auto archive = getMountedArchive(filename, &fileName);
+        return archive ? archive->fileExists(fileName) : isFileExistInternal(filename);
     }
     else
     {
@@ -1108,6 +1508,11 @@ long FileUtils::getFileSize(const std::string &filepath)
     return 0;
 }
 
+bool FileUtils::listFilesRecursively(const std::string& dirPath, std::vector<std::string>* files) const
+{
+    return false;
+}
+
 #else
 // default implements for unix like os
 #include <sys/types.h>
@@ -1124,6 +1529,46 @@ bool FileUtils::isDirectoryExistInternal(const std::string& dirPath) const
     return false;
 }
 
+bool FileUtils::listFilesRecursively(const std::string& dirPath, std::vector<std::string>* files) const
+{
+    // directories relative to dirPath, ending with '/'
+    std::vector<std::string> directories(1, "");
+    while (!directories.empty())
+    {
+        std::string directory = directories.back();
+        directories.pop_back();
+
+        DIR* dir = opendir((dirPath + directory).c_str());
+        if (!dir)
+        {
+            if (directory.empty())
+                return false;
+            continue;
+        }
+
+        while (struct dirent* entry = readdir(dir))
+        {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+                continue;
+
+            std::string path = directory + entry->d_name;
+            bool isDirectory = entry->d_type == DT_DIR;
+            if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+            {
+                struct stat st;
+                isDirectory = stat((dirPath + path).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+            }
+
+            if (isDirectory)
+                directories.push_back(path + '/');
+            else
+                files->push_back(path);
+        }
+        closedir(dir);
+    }
+    return true;
+}
+
 bool FileUtils::createDirectory(const std::string& path)
 {
     CCASSERT(!path.empty(), "Invalid path");
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <functional>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
@@ -36,6 +37,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class ZipArchive;
+
 /**
  * @addtogroup platform
  * @{
@@ -99,6 +102,28 @@ public:
      */
     virtual Data getDataFromFile(const std::string& filename);
 
+    /**
+     *  Reads a file on an I/O thread, see AsyncFileLoader, then calls the callback on the cocos thread.
+     *  Several requests for the same file share the same read.
+     *
+     *  @note Must be called on the cocos thread.
+     *  @param filename The file name.
+     *  @param callback Called with the data of the file, which is null if the file can't be read.
+     *  @since v3.10
+     *  @js NA
+     *  @lua NA
+     */
+    void getDataFromFileAsync(const std::string& filename, const std::function<void(Data)>& callback);
+
+    /**
+     *  Same as getDataFromFileAsync(), with the content of the file as a string,
+     *  which is empty if the file can't be read.
+     *  @since v3.10
+     *  @js NA
+     *  @lua NA
+     */
+    void getStringFromFileAsync(const std::string& filename, const std::function<void(std::string)>& callback);
+
     /**
      *  Gets resource file data
      *
@@ -292,6 +317,83 @@ public:
      */
     virtual const std::vector<std::string>& getSearchPaths() const;
 
+    /**
+     *  Enables or disables the path index. Disabled by default.
+     *
+     *  When enabled, the files of every search path are listed once, and fullPathForFilename() finds a file with
+     *  a single lookup in an index built from these lists, instead of checking every search path and resolution
+     *  directory on the file system. "." and ".." components are resolved before the lookup, a name which isn't
+     *  in the index (e.g. "../file.png", or a file added after the lists were made) is searched on the file system
+     *  as usual, so only missing files cost the full search.
+     *
+     *  The lists are kept until purgeCachedEntries() is called: a file added to a search path is found, but if a
+     *  file with the same name was already listed in a search path of lower priority, that one is returned until
+     *  purgeCachedEntries() is called, e.g. after downloading an update.
+     *
+     *  A search path can also be a zip file (e.g. "/sdcard/main.obb"), whose files are read with ZipArchive.
+     *  Search paths which can't be listed, like the ones inside the APK on Android, need a manifest,
+     *  see loadPathIndexManifest(), otherwise they are checked on the file system as usual.
+     *
+     *  @since v3.10
+     *  @js NA
+     *  @lua NA
+     */
+    void setPathIndexEnabled(bool enabled);
+
+    /**
+     *  Returns true if the path index is enabled.
+     *  @see setPathIndexEnabled()
+     *  @since v3.10
+     *  @js NA
+     *  @lua NA
+     */
+    bool isPathIndexEnabled() const { return _pathIndexEnabled; }
+
+    /**
+     *  Gives the files of a search path or an overlay path with a manifest generated when building the game,
+     *  instead of listing them when the path is indexed.
+     *
+     *  The manifest is a text file with a path relative to the search path per line, e.g. the output of
+     *  `find . -type f` run in the directory.
+     *
+     *  @param path The search path or overlay path, as passed to setSearchPaths() or addOverlayPath().
+     *  @param manifestFile The manifest file.
+     *  @return true if the manifest was read.
+     *  @since v3.10
+     *  @js NA
+     *  @lua NA
+     */
+    bool loadPathIndexManifest(const std::string& path, const std::string& manifestFile);
+
+    /**
+     *  Mounts a directory or a zip file over the search paths, e.g. to hot patch resources. Its files hide the
+     *  ones with the same name in the search paths and in the overlays added before it.
+     *
+     *  Overlay paths are always indexed, whether the path index is enabled or not.
+     *
+     *  @param path The directory or zip file, relative paths are in the default resource root path.
+     *  @since v3.10
+     *  @js NA
+     *  @lua NA
+     */
+    void addOverlayPath(const std::string& path);
+
+    /**
+     *  Unmounts an overlay path added with addOverlayPath().
+     *  @since v3.10
+     *  @js NA
+     *  @lua NA
+     */
+    void removeOverlayPath(const std::string& path);
+
+    /**
+     *  Gets the overlay paths, the first one has the highest priority.
+     *  @since v3.10
+     *  @js NA
+     *  @lua NA
+     */
+    const std::vector<std::string>& getOverlayPaths() const { return _overlayPathArray; }
+
     /**
      *  Gets the writable path.
      *  @return  The path that can be write/read a file in
@@ -538,6 +640,51 @@ protected:
      */
     virtual std::string getFullPathForDirectoryAndFilename(const std::string& directory, const std::string& filename) const;
 
+    /**
+     *  Lists the files of a directory and of its subdirectories, to build the path index.
+     *
+     *  @param dirPath The directory (with absolute path) to list, ending with '/'.
+     *  @param files The paths of the files, relative to the directory, are appended to it.
+     *  @return false if the directory can't be listed.
+     *  @since v3.10
+     */
+    virtual bool listFilesRecursively(const std::string& dirPath, std::vector<std::string>* files) const;
+
+    /**
+     *  Reads a file from the file system, without looking into the mounted archives.
+     *  It is called by the I/O threads of getDataFromFileAsync(), so it must not use the caches of FileUtils.
+     *  A subclass which overrides getDataFromFile() to read files differently should override it as well.
+     *
+     *  @param fullPath The full path of the file.
+     *  @since v3.10
+     */
+    virtual Data getDataFromFullPath(const std::string& fullPath);
+
+    /**
+     *  Reads a file if its full path is inside a zip file used as a search path or an overlay path.
+     *
+     *  @param filename The file name.
+     *  @param forString Whether a '\0' must be appended to the data.
+     *  @param data The data of the file.
+     *  @return false if the file isn't in a mounted zip file, it must then be read from the file system.
+     *  @since v3.10
+     */
+    bool getDataFromMountedArchive(const std::string& filename, bool forString, Data* data) const;
+
+    /** Returns the full path of a search path or an overlay path, ending with '/'. */
+    std::string getMountPath(const std::string& path) const;
+
+    /** Returns the mounted zip file which contains this full path, and the name of the file inside it. */
+    ZipArchive* getMountedArchive(const std::string& fullPath, std::string* fileName) const;
+
+    /** Returns the files of an indexed path, listing them the first time, or nullptr if it can't be indexed. */
+    const std::vector<std::string>* getIndexedPathFiles(const std::string& path) const;
+
+    /** Finds a file with the path index, returns an empty string if it isn't found. */
+    std::string getPathFromIndex(const std::string& filename) const;
+
+    void buildPathIndex() const;
+
     /** Dictionary used to lookup filenames based on a key.
      *  It is used internally by the following methods:
      *
@@ -574,6 +721,37 @@ protected:
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCache;
 
+    /**
+     *  The overlay paths, searched before the search paths.
+     *  The lower index of the element in this vector, the higher priority for this overlay path.
+     */
+    std::vector<std::string> _overlayPathArray;
+
+    /** A file of the path index, with the search path and resolution directory where it was found. */
+    struct IndexedPath
+    {
+        std::string fullPath;
+        int priority;
+    };
+
+    /** A search path which can't be indexed, it is searched on the file system. */
+    struct UnindexedPath
+    {
+        std::string path;
+        int priority;
+    };
+
+    bool _pathIndexEnabled;
+    mutable bool _pathIndexDirty;
+    mutable std::unordered_map<std::string, IndexedPath> _pathIndex;
+    mutable std::vector<UnindexedPath> _unindexedPaths;
+    /** The files of each indexed path, listed once. */
+    mutable std::unordered_map<std::string, std::vector<std::string>> _indexedPathFiles;
+    /** The manifests given with loadPathIndexManifest(). */
+    std::unordered_map<std::string, std::string> _pathIndexManifests;
+    /** The zip files used as search paths or overlay paths, with the '/' which starts their file names. */
+    mutable std::unordered_map<std::string, ZipArchive*> _mountedArchives;
+
     /**
      * Writable path.
      */
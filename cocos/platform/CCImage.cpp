@@ -83,6 +83,7 @@ extern "C"
 #include "CCStdC.h"
 #include "CCFileUtils.h"
 #include "base/CCConfiguration.h"
+#include "renderer/ccPixelConversion.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
@@ -2453,12 +2454,7 @@ void Image::premultipliedAlpha()
 {
     CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
-    {
-        unsigned char* p = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    PixelConversion::premultiplyAlpha(_data, (ssize_t)_width * _height);
     
     _hasPremultipliedAlpha = true;
 }
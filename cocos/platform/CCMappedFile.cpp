@@ -0,0 +1,190 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/CCMappedFile.h"
+#include "platform/CCFileUtils.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+#define CC_MAPPED_FILE_POSIX 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <windows.h>
+#include "base/ccUTF8.h"
+#endif
+
+NS_CC_BEGIN
+
+MappedFile::MappedFile()
+: _bytes(nullptr)
+, _size(0)
+, _mapped(false)
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+, _fileHandle(nullptr)
+, _mappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& fullPath)
+{
+    close();
+
+    if (fullPath.empty())
+        return false;
+
+    // On Android relative full paths point into the apk, which can't be mapped
+    if (FileUtils::getInstance()->isAbsolutePath(fullPath) && map(fullPath))
+        return true;
+
+    _data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (_data.isNull())
+        return false;
+
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+    return true;
+}
+
+#if defined(CC_MAPPED_FILE_POSIX)
+
+bool MappedFile::map(const std::string& fullPath)
+{
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+    if (address == MAP_FAILED)
+        return false;
+
+    _bytes = static_cast<const unsigned char*>(address);
+    _size = (ssize_t)st.st_size;
+    _mapped = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_mapped)
+    {
+        munmap(const_cast<unsigned char*>(_bytes), (size_t)_size);
+        _mapped = false;
+    }
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+}
+
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+
+bool MappedFile::map(const std::string& fullPath)
+{
+    std::u16string widePath;
+    if (!StringUtils::UTF8ToUTF16(fullPath, widePath))
+        return false;
+
+    HANDLE file = ::CreateFileW((LPCWSTR)widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    void* address = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (address == nullptr)
+    {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        return false;
+    }
+
+    _fileHandle = file;
+    _mappingHandle = mapping;
+    _bytes = static_cast<const unsigned char*>(address);
+    _size = (ssize_t)fileSize.QuadPart;
+    _mapped = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_mapped)
+    {
+        ::UnmapViewOfFile(_bytes);
+        ::CloseHandle((HANDLE)_mappingHandle);
+        ::CloseHandle((HANDLE)_fileHandle);
+        _mappingHandle = nullptr;
+        _fileHandle = nullptr;
+        _mapped = false;
+    }
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+}
+
+#else
+
+bool MappedFile::map(const std::string& /*fullPath*/)
+{
+    return false;
+}
+
+void MappedFile::close()
+{
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+}
+
+#endif
+
+NS_CC_END
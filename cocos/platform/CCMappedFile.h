@@ -0,0 +1,97 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_PLATFORM_MAPPED_FILE_H__
+#define __CC_PLATFORM_MAPPED_FILE_H__
+/// @cond DO_NOT_SHOW
+
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @class MappedFile
+ * @brief A read-only view of a whole file.
+ *
+ * The file is memory-mapped where the platform allows it, so its pages are only read when they are touched.
+ * Files that can't be mapped, like the assets inside an Android apk or files on WinRT, are read into memory
+ * with FileUtils::getDataFromFile() instead. The bytes stay valid until close() is called or the object is destroyed.
+ * @since v3.10
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /** Maps or reads the file at a full path.
+     *
+     * @param fullPath The full path of the file, as returned by FileUtils::fullPathForFilename().
+     * @return True if the file could be opened and is not empty.
+     */
+    bool open(const std::string& fullPath);
+
+    /** Unmaps the file, or releases the bytes read by open(). */
+    void close();
+
+    /** The content of the file, nullptr if no file is open. */
+    const unsigned char* getBytes() const { return _bytes; }
+
+    /** The size of the file in bytes. */
+    ssize_t getSize() const { return _size; }
+
+    /** Whether the bytes are memory-mapped rather than read into memory. */
+    bool isMapped() const { return _mapped; }
+
+private:
+    bool map(const std::string& fullPath);
+
+    const unsigned char* _bytes;
+    ssize_t _size;
+    bool _mapped;
+    Data _data;
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    void* _fileHandle;
+    void* _mappingHandle;
+#endif
+
+    CC_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+/// @endcond
+#endif // __CC_PLATFORM_MAPPED_FILE_H__
@@ -364,7 +364,9 @@ Data FileUtilsAndroid::getData(const std::string& filename, bool forString)
 
 std::string FileUtilsAndroid::getStringFromFile(const std::string& filename)
 {
-    Data data = getData(filename, true);
+    Data data;
+    if (!getDataFromMountedArchive(filename, true, &data))
+        data = getData(filename, true);
     if (data.isNull())
         return "";
 
@@ -374,9 +376,17 @@ std::string FileUtilsAndroid::getStringFromFile(const std::string& filename)
 
 Data FileUtilsAndroid::getDataFromFile(const std::string& filename)
 {
+    Data data;
+    if (getDataFromMountedArchive(filename, false, &data))
+        return data;
     return getData(filename, false);
 }
 
+Data FileUtilsAndroid::getDataFromFullPath(const std::string& fullPath)
+{
+    return getData(fullPath, false);
+}
+
 unsigned char* FileUtilsAndroid::getFileData(const std::string& filename, const char* mode, ssize_t * size)
 {
     unsigned char * data = 0;
@@ -83,6 +83,7 @@ public:
 private:
     virtual bool isFileExistInternal(const std::string& strFilePath) const override;
     virtual bool isDirectoryExistInternal(const std::string& dirPath) const override;
+    virtual Data getDataFromFullPath(const std::string& fullPath) override;
     Data getData(const std::string& filename, bool forString);
 
     static AAssetManager* assetmanager;
@@ -65,6 +65,14 @@ extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT;
 #define glBindVertexArrayOES glBindVertexArrayOESEXT
 #define glDeleteVertexArraysOES glDeleteVertexArraysOESEXT
 
+extern PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT;
+extern PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT;
+
+#define glGetProgramBinary              glGetProgramBinaryOESEXT
+#define glProgramBinary                 glProgramBinaryOESEXT
+#define GL_PROGRAM_BINARY_LENGTH        GL_PROGRAM_BINARY_LENGTH_OES
+#define GL_NUM_PROGRAM_BINARY_FORMATS   GL_NUM_PROGRAM_BINARY_FORMATS_OES
+
 
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 
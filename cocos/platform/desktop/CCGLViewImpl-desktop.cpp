@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "base/CCEventKeyboard.h"
 #include "base/CCEventMouse.h"
 #include "base/CCIMEDispatcher.h"
+#include "base/CCUserDefault.h"
 #include "base/ccUtils.h"
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
@@ -789,6 +790,8 @@ void GLViewImpl::onGLFWWindowIconifyCallback(GLFWwindow* window, int iconified)
 {
     if (iconified == GL_TRUE)
     {
+        // the application may be closed from the background without being told
+        UserDefault::getInstance()->flush();
         Application::getInstance()->applicationDidEnterBackground();
     }
     else
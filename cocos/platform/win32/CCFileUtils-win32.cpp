@@ -187,6 +187,40 @@ bool FileUtilsWin32::isDirectoryExistInternal(const std::string& dirPath) const
     return false;
 }
 
+bool FileUtilsWin32::listFilesRecursively(const std::string& dirPath, std::vector<std::string>* files) const
+{
+    // directories relative to dirPath, ending with '/'
+    std::vector<std::string> directories(1, "");
+    while (!directories.empty())
+    {
+        std::string directory = directories.back();
+        directories.pop_back();
+
+        WIN32_FIND_DATAW data;
+        HANDLE handle = FindFirstFileW(StringUtf8ToWideChar(dirPath + directory + "*").c_str(), &data);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            if (directory.empty())
+                return false;
+            continue;
+        }
+
+        do
+        {
+            if (wcscmp(data.cFileName, L".") == 0 || wcscmp(data.cFileName, L"..") == 0)
+                continue;
+
+            std::string path = directory + StringWideCharToUtf8(data.cFileName);
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                directories.push_back(path + '/');
+            else
+                files->push_back(path);
+        } while (FindNextFileW(handle, &data));
+        FindClose(handle);
+    }
+    return true;
+}
+
 std::string FileUtilsWin32::getSuitableFOpen(const std::string& filenameUtf8) const
 {
     return UTF8StringToMultiByte(filenameUtf8);
@@ -352,7 +386,9 @@ static Data getData(const std::string& filename, bool forString)
 
 std::string FileUtilsWin32::getStringFromFile(const std::string& filename)
 {
-    Data data = getData(filename, true);
+    Data data;
+    if (!getDataFromMountedArchive(filename, true, &data))
+        data = getData(filename, true);
     if (data.isNull())
     {
         return "";
@@ -364,9 +400,17 @@ std::string FileUtilsWin32::getStringFromFile(const std::string& filename)
 
 Data FileUtilsWin32::getDataFromFile(const std::string& filename)
 {
+    Data data;
+    if (getDataFromMountedArchive(filename, false, &data))
+        return data;
     return getData(filename, false);
 }
 
+Data FileUtilsWin32::getDataFromFullPath(const std::string& fullPath)
+{
+    return getData(fullPath, false);
+}
+
 unsigned char* FileUtilsWin32::getFileData(const std::string& filename, const char* mode, ssize_t* size)
 {
     unsigned char * pBuffer = nullptr;
@@ -83,6 +83,14 @@ protected:
     */
     virtual bool isDirectoryExistInternal(const std::string& dirPath) const override;
 
+    /**
+    *  Lists the files of a directory and of its subdirectories, to build the path index.
+    *  @param dirPath The directory (with absolute path) to list, ending with '/'.
+    *  @param files The paths of the files, relative to the directory, are appended to it.
+    *  @return false if the directory can't be listed.
+    */
+    virtual bool listFilesRecursively(const std::string& dirPath, std::vector<std::string>* files) const override;
+
     /**
     *  Removes a file.
     *
@@ -129,6 +137,8 @@ protected:
      */
     virtual Data getDataFromFile(const std::string& filename) override;
 
+    virtual Data getDataFromFullPath(const std::string& fullPath) override;
+
     /**
      *  Gets full path for filename, resolution directory and search path.
      *
@@ -76,6 +76,8 @@ void Cocos2dRenderer::Resume()
 void Cocos2dRenderer::Pause()
 {
     if (Director::getInstance()->getOpenGLView()) {
+        // a suspended application may be terminated without being told
+        UserDefault::getInstance()->flush();
         Application::getInstance()->applicationDidEnterBackground();
         cocos2d::EventCustom backgroundEvent(EVENT_COME_TO_BACKGROUND);
         cocos2d::Director::getInstance()->getEventDispatcher()->dispatchEvent(&backgroundEvent);
@@ -33,11 +33,13 @@ THE SOFTWARE.
 #endif
 
 #include "base/CCDirector.h"
+#include "base/CCConfiguration.h"
 #include "base/uthash.h"
 #include "renderer/ccGLStateCache.h"
 #include "platform/CCFileUtils.h"
 
 #include "deprecated/CCString.h"
+#include "xxhash.h"
 
 // helper functions
 
@@ -81,7 +83,9 @@ const char* GLProgram::SHADER_NAME_LABEL_OUTLINE = "ShaderLabelOutline";
 
 const char* GLProgram::SHADER_3D_POSITION = "Shader3DPosition";
 const char* GLProgram::SHADER_3D_POSITION_TEXTURE = "Shader3DPositionTexture";
+const char* GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED = "Shader3DPositionTextureInstanced";
 const char* GLProgram::SHADER_3D_SKINPOSITION_TEXTURE = "Shader3DSkinPositionTexture";
+const char* GLProgram::SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED = "Shader3DSkinPositionTextureInstanced";
 const char* GLProgram::SHADER_3D_POSITION_NORMAL = "Shader3DPositionNormal";
 const char* GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE = "Shader3DPositionNormalTexture";
 const char* GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE = "Shader3DSkinPositionNormalTexture";
@@ -142,6 +146,64 @@ static const char * COCOS2D_SHADER_UNIFORMS =
 
 static const std::string EMPTY_DEFINE;
 
+// program binary cache, see GLProgram::setBinaryCacheEnabled()
+static const char* PROGRAM_BINARY_FOLDER = "glprogram/";
+static const uint32_t PROGRAM_BINARY_MAGIC = 0x42504343; // "CCPB"
+// bump it when the way shaders are assembled changes, so stale binaries are not loaded
+static const uint32_t PROGRAM_BINARY_VERSION = 1;
+
+struct ProgramBinaryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t length;
+    uint32_t checksum;
+};
+
+static bool s_binaryCacheEnabled = false;
+
+static std::string getProgramBinaryPath(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray, const std::string& convertedDefines)
+{
+    // a driver update may change the binary format, so the driver is part of the key
+    auto conf = Configuration::getInstance();
+    std::string key = conf->getValue("gl.vendor").asString();
+    key += conf->getValue("gl.renderer").asString();
+    key += conf->getValue("gl.version").asString();
+    key += COCOS2D_SHADER_UNIFORMS;
+    key += convertedDefines;
+    key += '\0';
+    if (vShaderByteArray)
+        key += vShaderByteArray;
+    key += '\0';
+    if (fShaderByteArray)
+        key += fShaderByteArray;
+
+    // two seeds give a 64 bit name, so that different programs practically never share a file
+    unsigned int h0 = XXH32(key.data(), (int)key.size(), PROGRAM_BINARY_VERSION);
+    unsigned int h1 = XXH32(key.data(), (int)key.size(), 0x9E3779B1);
+    return FileUtils::getInstance()->getWritablePath() + PROGRAM_BINARY_FOLDER + StringUtils::format("%08x%08x.bin", h0, h1);
+}
+
+void GLProgram::setBinaryCacheEnabled(bool enabled)
+{
+    s_binaryCacheEnabled = enabled;
+}
+
+bool GLProgram::isBinaryCacheEnabled()
+{
+    return s_binaryCacheEnabled;
+}
+
+bool GLProgram::removeBinaryCache()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string dirPath = fileUtils->getWritablePath() + PROGRAM_BINARY_FOLDER;
+    if (!fileUtils->isDirectoryExist(dirPath))
+        return true;
+    return fileUtils->removeDirectory(dirPath);
+}
+
 GLProgram* GLProgram::createWithByteArrays(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray)
 {
     return createWithByteArrays(vShaderByteArray, fShaderByteArray, EMPTY_DEFINE);
@@ -185,6 +247,7 @@ GLProgram::GLProgram()
 : _program(0)
 , _vertShader(0)
 , _fragShader(0)
+, _loadedFromBinary(false)
 , _flags()
 {
     _director = Director::getInstance();
@@ -236,6 +299,18 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     replaceDefines(compileTimeDefines, replacedDefines);
 
     _vertShader = _fragShader = 0;
+    _loadedFromBinary = false;
+    _binaryCachePath.clear();
+    _hashForUniforms.clear();
+
+    if (s_binaryCacheEnabled && Configuration::getInstance()->supportsProgramBinary())
+    {
+        _binaryCachePath = getProgramBinaryPath(vShaderByteArray, fShaderByteArray, replacedDefines);
+        if (loadProgramBinary())
+        {
+            return true;
+        }
+    }
 
     if (vShaderByteArray)
     {
@@ -267,13 +342,99 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
         glAttachShader(_program, _fragShader);
     }
 
-    _hashForUniforms.clear();
-
     CHECK_GL_ERROR_DEBUG();
 
     return true;
 }
 
+bool GLProgram::loadProgramBinary()
+{
+#if CC_GLPROGRAM_USE_PROGRAM_BINARY
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(_binaryCachePath))
+        return false;
+
+    Data data = fileUtils->getDataFromFile(_binaryCachePath);
+    ProgramBinaryHeader header;
+    if (data.getSize() < (ssize_t)sizeof(header))
+        return false;
+
+    memcpy(&header, data.getBytes(), sizeof(header));
+    const unsigned char* binary = data.getBytes() + sizeof(header);
+    if (header.magic != PROGRAM_BINARY_MAGIC || header.version != PROGRAM_BINARY_VERSION
+        || header.length != (uint32_t)(data.getSize() - sizeof(header))
+        || header.checksum != XXH32(binary, (int)header.length, 0))
+    {
+        CCLOG("cocos2d: program binary %s is invalid", _binaryCachePath.c_str());
+        return false;
+    }
+
+    glProgramBinary(_program, (GLenum)header.format, binary, (GLsizei)header.length);
+
+    // the driver rejects binaries of another version, the shaders are compiled then and the binary is saved again
+    GLint status = GL_FALSE;
+    glGetProgramiv(_program, GL_LINK_STATUS, &status);
+    // clear the error raised by a rejected format, it is not a failure of the program
+    glGetError();
+    if (status != GL_TRUE)
+    {
+        CCLOG("cocos2d: program binary %s was rejected by the driver", _binaryCachePath.c_str());
+        return false;
+    }
+
+    _loadedFromBinary = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GLProgram::saveProgramBinary()
+{
+#if CC_GLPROGRAM_USE_PROGRAM_BINARY
+    GLint status = GL_FALSE;
+    glGetProgramiv(_program, GL_LINK_STATUS, &status);
+    GLint length = 0;
+    glGetProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (status != GL_TRUE || length <= 0)
+        return;
+
+    ssize_t size = sizeof(ProgramBinaryHeader) + length;
+    unsigned char* buffer = (unsigned char*)malloc(size);
+    if (!buffer)
+        return;
+
+    ProgramBinaryHeader header;
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(_program, length, &written, &format, buffer + sizeof(header));
+    if (written <= 0)
+    {
+        free(buffer);
+        return;
+    }
+
+    header.magic = PROGRAM_BINARY_MAGIC;
+    header.version = PROGRAM_BINARY_VERSION;
+    header.format = (uint32_t)format;
+    header.length = (uint32_t)written;
+    header.checksum = XXH32(buffer + sizeof(header), written, 0);
+    memcpy(buffer, &header, sizeof(header));
+
+    Data data;
+    data.fastSet(buffer, sizeof(header) + written);
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string dirPath = fileUtils->getWritablePath() + PROGRAM_BINARY_FOLDER;
+    if (!fileUtils->isDirectoryExist(dirPath))
+        fileUtils->createDirectory(dirPath);
+    if (!fileUtils->writeDataToFile(data, _binaryCachePath))
+    {
+        CCLOG("cocos2d: failed to save program binary %s", _binaryCachePath.c_str());
+    }
+#endif
+}
+
 bool GLProgram::initWithFilenames(const std::string& vShaderFilename, const std::string& fShaderFilename)
 {
     return initWithFilenames(vShaderFilename, fShaderFilename, EMPTY_DEFINE);
@@ -551,13 +712,34 @@ bool GLProgram::link()
 
     GLint status = GL_TRUE;
 
+    // the binary is already linked, with the attribute locations bound when it was saved
+    if (_loadedFromBinary)
+    {
+        parseVertexAttribs();
+        parseUniforms();
+        return true;
+    }
+
     bindPredefinedVertexAttribs();
 
+#if CC_GLPROGRAM_USE_PROGRAM_BINARY && (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    // desktop drivers may not keep the binary around unless asked before linking
+    if (!_binaryCachePath.empty() && glProgramParameteri)
+    {
+        glProgramParameteri(_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+
     glLinkProgram(_program);
 
     parseVertexAttribs();
     parseUniforms();
 
+    if (!_binaryCachePath.empty())
+    {
+        saveProgramBinary();
+    }
+
     if (_vertShader)
     {
         glDeleteShader(_vertShader);
@@ -931,6 +1113,8 @@ void GLProgram::reset()
     // it is already deallocated by android
     //GL::deleteProgram(_program);
     _program = 0;
+    _loadedFromBinary = false;
+    _binaryCachePath.clear();
 
     for (auto e: _hashForUniforms)
     {
@@ -197,11 +197,22 @@ public:
     /**Built in shader used for 3D, support Position and Texture vertex attribute, with color specified by a uniform.*/
     static const char* SHADER_3D_POSITION_TEXTURE;
     /**
+    Built in shader used for instanced 3D drawing, support Position and Texture vertex attribute,
+    with the model view matrix and color read from the per instance a_instanceMatrix and a_instanceColor attributes.
+    */
+    static const char* SHADER_3D_POSITION_TEXTURE_INSTANCED;
+    /**
     Built in shader used for 3D, support Position (Skeletal animation by hardware skin) and Texture vertex attribute,
     with color specified by a uniform.
     */
     static const char* SHADER_3D_SKINPOSITION_TEXTURE;
     /**
+    Built in shader used for instanced 3D drawing, support Position (Skeletal animation by hardware skin) and Texture vertex attribute,
+    with the model view matrix and color read from the per instance a_instanceMatrix and a_instanceColor attributes.
+    The matrix palette is a uniform, so all the instances drawn together share it.
+    */
+    static const char* SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED;
+    /**
     Built in shader used for 3D, support Position and Normal vertex attribute, used in lighting. with color specified by a uniform.
     */
     static const char* SHADER_3D_POSITION_NORMAL;
@@ -476,6 +487,27 @@ public:
     when opengl context lost, so don't call it.
     */
     void reset();
+
+    /** Enables or disables the program binary cache.
+    When enabled, linked programs are saved in the "glprogram" folder of the writable path, keyed by a hash of
+    the driver, the sources and the compile time defines, and later initializations of the same program load
+    the binary instead of compiling the shaders. The attribute locations are the ones bound when the binary was linked.
+    It does nothing if Configuration::supportsProgramBinary() is false. Disabled by default.
+    @since v3.10
+    */
+    static void setBinaryCacheEnabled(bool enabled);
+    /** Whether or not the program binary cache is enabled.
+    @since v3.10
+    */
+    static bool isBinaryCacheEnabled();
+    /** Removes every program binary saved in the writable path.
+    @since v3.10
+    */
+    static bool removeBinaryCache();
+    /** Whether or not the program was loaded from the binary cache instead of being compiled.
+    @since v3.10
+    */
+    inline bool isLoadedFromBinary() const { return _loadedFromBinary; }
     /*Get the built in openGL handle of the program.*/
     inline const GLuint getProgram() const { return _program; }
 
@@ -507,6 +539,10 @@ protected:
     /**Compile the shader sources.*/
     bool compileShader(GLuint * shader, GLenum type, const GLchar* source, const std::string& convertedDefines);
     bool compileShader(GLuint * shader, GLenum type, const GLchar* source);
+    /**Load the program from the binary cache, returns false if there is no valid binary for it.*/
+    bool loadProgramBinary();
+    /**Save the linked program in the binary cache.*/
+    void saveProgramBinary();
 
     /**OpenGL handle for program.*/
     GLuint            _program;
@@ -518,6 +554,10 @@ protected:
     GLint             _builtInUniforms[UNIFORM_MAX];
     /**Indicate whether it has a offline shader compiler or not.*/
     bool              _hasShaderCompiler;
+    /**Whether the program was loaded from the binary cache.*/
+    bool              _loadedFromBinary;
+    /**Binary cache file of the program, empty if the cache is not used.*/
+    std::string       _binaryCachePath;
 
     struct flag_struct {
         unsigned int usesTime:1;
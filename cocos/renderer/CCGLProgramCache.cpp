@@ -57,7 +57,9 @@ enum {
     kShaderType_LabelOutline,
     kShaderType_3DPosition,
     kShaderType_3DPositionTex,
+    kShaderType_3DPositionTexInstanced,
     kShaderType_3DSkinPositionTex,
+    kShaderType_3DSkinPositionTexInstanced,
     kShaderType_3DPositionNormal,
     kShaderType_3DPositionNormalTex,
     kShaderType_3DSkinPositionNormalTex,
@@ -71,6 +73,46 @@ enum {
     kShaderType_MAX,
 };
 
+static const struct {
+    const char* key;
+    int type;
+    bool relativeToLights;
+} s_defaultPrograms[] =
+{
+    {GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, kShaderType_PositionTextureColor, false},
+    {GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, kShaderType_PositionTextureColor_noMVP, false},
+    {GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST, kShaderType_PositionTextureColorAlphaTest, false},
+    {GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV, kShaderType_PositionTextureColorAlphaTestNoMV, false},
+    {GLProgram::SHADER_NAME_POSITION_COLOR, kShaderType_PositionColor, false},
+    {GLProgram::SHADER_NAME_POSITION_COLOR_TEXASPOINTSIZE, kShaderType_PositionColorTextureAsPointsize, false},
+    {GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP, kShaderType_PositionColor_noMVP, false},
+    {GLProgram::SHADER_NAME_POSITION_TEXTURE, kShaderType_PositionTexture, false},
+    {GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR, kShaderType_PositionTexture_uColor, false},
+    {GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR, kShaderType_PositionTextureA8Color, false},
+    {GLProgram::SHADER_NAME_POSITION_U_COLOR, kShaderType_Position_uColor, false},
+    {GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, kShaderType_PositionLengthTexureColor, false},
+    {GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, kShaderType_LabelDistanceFieldNormal, false},
+    {GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW, kShaderType_LabelDistanceFieldGlow, false},
+    {GLProgram::SHADER_NAME_POSITION_GRAYSCALE, kShaderType_UIGrayScale, false},
+    {GLProgram::SHADER_NAME_LABEL_NORMAL, kShaderType_LabelNormal, false},
+    {GLProgram::SHADER_NAME_LABEL_OUTLINE, kShaderType_LabelOutline, false},
+    {GLProgram::SHADER_3D_POSITION, kShaderType_3DPosition, false},
+    {GLProgram::SHADER_3D_POSITION_TEXTURE, kShaderType_3DPositionTex, false},
+    {GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED, kShaderType_3DPositionTexInstanced, false},
+    {GLProgram::SHADER_3D_SKINPOSITION_TEXTURE, kShaderType_3DSkinPositionTex, false},
+    {GLProgram::SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED, kShaderType_3DSkinPositionTexInstanced, false},
+    {GLProgram::SHADER_3D_POSITION_NORMAL, kShaderType_3DPositionNormal, true},
+    {GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE, kShaderType_3DPositionNormalTex, true},
+    {GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE, kShaderType_3DSkinPositionNormalTex, true},
+    {GLProgram::SHADER_3D_POSITION_BUMPEDNORMAL_TEXTURE, kShaderType_3DPositionBumpedNormalTex, true},
+    {GLProgram::SHADER_3D_SKINPOSITION_BUMPEDNORMAL_TEXTURE, kShaderType_3DSkinPositionBumpedNormalTex, true},
+    {GLProgram::SHADER_3D_PARTICLE_COLOR, kShaderType_3DParticleColor, false},
+    {GLProgram::SHADER_3D_PARTICLE_TEXTURE, kShaderType_3DParticleTex, false},
+    {GLProgram::SHADER_3D_SKYBOX, kShaderType_3DSkyBox, false},
+    {GLProgram::SHADER_3D_TERRAIN, kShaderType_3DTerrain, false},
+    {GLProgram::SHADER_CAMERA_CLEAR, kShaderType_CameraClear, false},
+};
+
 static GLProgramCache *_sharedGLProgramCache = 0;
 
 GLProgramCache* GLProgramCache::getInstance()
@@ -119,8 +161,7 @@ GLProgramCache::~GLProgramCache()
 
 bool GLProgramCache::init()
 {
-    loadDefaultGLPrograms();
-    
+    // the default programs are compiled on first use, see getGLProgram()
     auto listener = EventListenerCustom::create(Configuration::CONFIG_FILE_LOADED, [this](EventCustom* event){
         reloadDefaultGLProgramsRelativeToLights();
     });
@@ -132,318 +173,45 @@ bool GLProgramCache::init()
 
 void GLProgramCache::loadDefaultGLPrograms()
 {
-    // Position Texture Color shader
-    GLProgram *p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, p ) );
-
-    // Position Texture Color without MVP shader
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, p ) );
-
-    // Position Texture Color alpha test
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST, p) );
-
-    // Position Texture Color alpha test
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV, p) );
-    //
-    // Position, Color shader
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR, p) );
-
-    // Position, Color, PointSize shader
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColorTextureAsPointsize);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR_TEXASPOINTSIZE, p) );
-
-    //
-    // Position, Color shader no MVP
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP, p) );
-
-    //
-    // Position Texture shader
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE, p) );
-
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR, p) );
-
-    //
-    // Position Texture A8 Color shader
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR, p) );
-
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_U_COLOR, p) );
-
-    //
-    // Position, Length(TexCoords, Color (used by Draw Node basically )
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_UIGrayScale);
-    _programs.insert(std::make_pair(GLProgram::SHADER_NAME_POSITION_GRAYSCALE, p));
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_NORMAL, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_OUTLINE, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPosition);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionTex);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_TEXTURE, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE, p));
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_NORMAL, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormalTex);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionNormalTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE, p));
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionBumpedNormalTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_POSITION_BUMPEDNORMAL_TEXTURE, p));
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionBumpedNormalTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_BUMPEDNORMAL_TEXTURE, p));
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DParticleColor);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_PARTICLE_COLOR, p));
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DParticleTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_PARTICLE_TEXTURE, p));
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DSkyBox);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKYBOX, p));
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DTerrain);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_TERRAIN, p));
-    
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_CameraClear);
-    _programs.insert(std::make_pair(GLProgram::SHADER_CAMERA_CLEAR, p));
+    for (const auto& info : s_defaultPrograms)
+    {
+        if (_programs.find(info.key) == _programs.end())
+        {
+            GLProgram *p = new (std::nothrow) GLProgram();
+            loadDefaultGLProgram(p, info.type);
+            _programs.insert( std::make_pair(info.key, p) );
+        }
+    }
 }
 
 void GLProgramCache::reloadDefaultGLPrograms()
 {
-    // reset all programs and reload them
-
-    // Position Texture Color shader
-    GLProgram *p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-
-    // Position Texture Color without MVP shader
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    //
-    // Position, Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-
-    // Position, Color, PointSize shader
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR_TEXASPOINTSIZE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionColorTextureAsPointsize);
-
-    //
-    // Position, Color shader no MVP
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP);
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-
-    //
-    // Position Texture shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-
-    //
-    // Position Texture A8 Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-
-    //
-    // Position, Length(TexCoords, Color (used by Draw Node basically )
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPosition);
-
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionTex);
-
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
-
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
-
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormalTex);
-
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionNormalTex);
-
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_BUMPEDNORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionBumpedNormalTex);
-
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_BUMPEDNORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionBumpedNormalTex);
-
-    p = getGLProgram(GLProgram::SHADER_3D_PARTICLE_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DParticleTex);
-
-    p = getGLProgram(GLProgram::SHADER_3D_PARTICLE_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DParticleColor);
-
-    p = getGLProgram(GLProgram::SHADER_3D_SKYBOX);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkyBox);
-
-    p = getGLProgram(GLProgram::SHADER_3D_TERRAIN);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DTerrain);
-    
-    p = getGLProgram(GLProgram::SHADER_CAMERA_CLEAR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_CameraClear);
+    // reset the programs created so far and reload them, the others are still created on first use
+    for (const auto& info : s_defaultPrograms)
+    {
+        auto it = _programs.find(info.key);
+        if (it != _programs.end())
+        {
+            it->second->reset();
+            loadDefaultGLProgram(it->second, info.type);
+        }
+    }
 }
 
 void GLProgramCache::reloadDefaultGLProgramsRelativeToLights()
 {
-    GLProgram *p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormalTex);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionNormalTex);
-
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_BUMPEDNORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionBumpedNormalTex);
+    for (const auto& info : s_defaultPrograms)
+    {
+        if (!info.relativeToLights)
+            continue;
 
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_BUMPEDNORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionBumpedNormalTex);
+        auto it = _programs.find(info.key);
+        if (it != _programs.end())
+        {
+            it->second->reset();
+            loadDefaultGLProgram(it->second, info.type);
+        }
+    }
 }
 
 void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
@@ -508,9 +276,15 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_3DPositionTex:
             p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_ColorTex_frag);
             break;
+        case kShaderType_3DPositionTexInstanced:
+            p->initWithByteArrays(cc3D_PositionTexInstanced_vert, cc3D_ColorTexInstanced_frag);
+            break;
         case kShaderType_3DSkinPositionTex:
             p->initWithByteArrays(cc3D_SkinPositionTex_vert, cc3D_ColorTex_frag);
             break;
+        case kShaderType_3DSkinPositionTexInstanced:
+            p->initWithByteArrays(cc3D_SkinPositionTexInstanced_vert, cc3D_ColorTexInstanced_frag);
+            break;
         case kShaderType_3DPositionNormal:
             {
                 std::string def = getShaderMacrosForLight();
@@ -576,13 +350,26 @@ GLProgram* GLProgramCache::getGLProgram(const std::string &key)
     auto it = _programs.find(key);
     if( it != _programs.end() )
         return it->second;
+
+    // default programs are compiled the first time they are asked for
+    for (const auto& info : s_defaultPrograms)
+    {
+        if (key == info.key)
+        {
+            GLProgram *p = new (std::nothrow) GLProgram();
+            loadDefaultGLProgram(p, info.type);
+            _programs.insert( std::make_pair(key, p) );
+            return p;
+        }
+    }
     return nullptr;
 }
 
 void GLProgramCache::addGLProgram(GLProgram* program, const std::string &key)
 {
-    // release old one
-    auto prev = getGLProgram(key);
+    // release old one, without creating a default program only to replace it
+    auto it = _programs.find(key);
+    auto prev = it != _programs.end() ? it->second : nullptr;
     if( prev == program )
         return;
 
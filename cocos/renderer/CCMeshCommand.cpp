@@ -55,6 +55,10 @@ MeshCommand::MeshCommand()
 , _materialID(0)
 , _vao(0)
 , _material(nullptr)
+, _instancedMaterial(nullptr)
+, _instanceKey(0)
+, _instanceMatrixPalette(nullptr)
+, _instanceMatrixPaletteSize(0)
 , _stateBlock(nullptr)
 {
     _type = RenderCommand::Type::MESH_COMMAND;
@@ -82,6 +86,7 @@ void MeshCommand::init(float globalZOrder,
 
     _globalOrder = globalZOrder;
     _material = material;
+    _instancedMaterial = nullptr;
     
     _vertexBuffer = vertexBuffer;
     _indexBuffer = indexBuffer;
@@ -113,6 +118,7 @@ void MeshCommand::init(float globalZOrder,
     
     _globalOrder = globalZOrder;
     _textureID = textureID;
+    _instancedMaterial = nullptr;
 
     // weak ref
     _glProgramState = glProgramState;
@@ -187,6 +193,96 @@ uint32_t MeshCommand::getMaterialID() const
     return _materialID;
 }
 
+void MeshCommand::setInstancedMaterial(Material* instancedMaterial, const Vec4& color, const Vec4* matrixPalette, ssize_t matrixPaletteSize)
+{
+    _instancedMaterial = instancedMaterial;
+    _instanceColor = color;
+    _instanceMatrixPalette = matrixPalette;
+    _instanceMatrixPaletteSize = matrixPalette ? matrixPaletteSize : 0;
+    if (!_instancedMaterial)
+        return;
+
+    auto pass = _instancedMaterial->_currentTechnique->_passes.at(0);
+    auto texture = pass->getTexture();
+    auto stateBlock = _instancedMaterial->getStateBlock();
+
+    uint32_t keyArray[8];
+    keyArray[0] = texture ? texture->getName() : 0;
+    keyArray[1] = _vertexBuffer;
+    keyArray[2] = _indexBuffer;
+    keyArray[3] = (uint32_t)_indexCount;
+    keyArray[4] = _primitive;
+    keyArray[5] = _indexFormat;
+    keyArray[6] = stateBlock->getHash();
+    // skinned meshes sharing one animation state have the same palette, group them together
+    keyArray[7] = _instanceMatrixPalette ? XXH32((const void*)_instanceMatrixPalette, sizeof(Vec4) * _instanceMatrixPaletteSize, 0) : 0;
+    _instanceKey = XXH32((const void*)keyArray, sizeof(keyArray), 0);
+}
+
+bool MeshCommand::canDrawInstancedWith(const MeshCommand* command) const
+{
+    if (_instanceKey != command->_instanceKey || _instanceMatrixPaletteSize != command->_instanceMatrixPaletteSize)
+        return false;
+
+    // a hash collision between two palettes would draw a mesh with the pose of another one
+    return _instanceMatrixPalette == command->_instanceMatrixPalette
+        || memcmp(_instanceMatrixPalette, command->_instanceMatrixPalette, sizeof(Vec4) * _instanceMatrixPaletteSize) == 0;
+}
+
+MeshCommand::InstanceData MeshCommand::getInstanceData() const
+{
+    InstanceData data;
+    data.modelView = _mv;
+    data.color = _instanceColor;
+    return data;
+}
+
+void MeshCommand::drawInstanced(GLuint instanceBuffer, ssize_t instanceCount)
+{
+    CCASSERT(_instancedMaterial, "Instanced material must be set");
+
+#if CC_RENDERER_USE_INSTANCING
+    for(const auto& pass: _instancedMaterial->_currentTechnique->_passes)
+    {
+        // the model view matrices come from the instance buffer
+        pass->bind(Mat4::IDENTITY);
+
+        auto glProgram = pass->getGLProgramState()->getGLProgram();
+        GLint matrixLocation = glProgram->getAttribLocation("a_instanceMatrix");
+        GLint colorLocation = glProgram->getAttribLocation("a_instanceColor");
+
+        // a mat4 attribute takes 4 consecutive locations, one per column
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        for (GLint column = 0; column < 4; ++column)
+        {
+            glEnableVertexAttribArray(matrixLocation + column);
+            glVertexAttribPointer(matrixLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (GLvoid*)(offsetof(InstanceData, modelView) + sizeof(Vec4) * column));
+            glVertexAttribDivisor(matrixLocation + column, 1);
+        }
+        glEnableVertexAttribArray(colorLocation);
+        glVertexAttribPointer(colorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (GLvoid*)offsetof(InstanceData, color));
+        glVertexAttribDivisor(colorLocation, 1);
+
+        glDrawElementsInstanced(_primitive, (GLsizei)_indexCount, _indexFormat, 0, (GLsizei)instanceCount);
+        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount * instanceCount);
+
+        for (GLint column = 0; column < 4; ++column)
+        {
+            glVertexAttribDivisor(matrixLocation + column, 0);
+            glDisableVertexAttribArray(matrixLocation + column);
+        }
+        glVertexAttribDivisor(colorLocation, 0);
+        glDisableVertexAttribArray(colorLocation);
+
+        pass->unbind();
+    }
+
+    // the locations used by the instance attributes may be tracked by the GL state cache,
+    // disable everything so the cache matches the GL state again
+    GL::enableVertexAttribs(0);
+#endif
+}
+
 void MeshCommand::preBatchDraw()
 {
     // Do nothing if using material since each pass needs to bind its own VAO
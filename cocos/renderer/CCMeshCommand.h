@@ -42,6 +42,12 @@ class Material;
 class CC_DLL MeshCommand : public RenderCommand
 {
 public:
+    /** Per instance data read by GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED and SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED */
+    struct InstanceData
+    {
+        Mat4 modelView;
+        Vec4 color;
+    };
 
     MeshCommand();
     virtual ~MeshCommand();
@@ -66,6 +72,24 @@ public:
     
     uint32_t getMaterialID() const;
     
+    /**
+     * Lets the Renderer draw this command in a single instanced draw call together with the consecutive commands
+     * that have the same instance key, using `instancedMaterial` and reading the model view matrix and `color`
+     * from the instance buffer. Pass nullptr to draw it on its own. Must be called after init().
+     * Skinned meshes pass their `matrixPalette`, which must stay valid until the command is drawn: as it is a uniform
+     * of the instanced material, only the commands whose palettes are identical are drawn together.
+     */
+    void setInstancedMaterial(Material* instancedMaterial, const Vec4& color, const Vec4* matrixPalette = nullptr, ssize_t matrixPaletteSize = 0);
+    Material* getInstancedMaterial() const { return _instancedMaterial; }
+    /** Commands with the same instance key share their vertex data, texture, render state and most likely their matrix palette */
+    uint32_t getInstanceKey() const { return _instanceKey; }
+    /** Whether this command can be drawn in the same instanced draw call as `command`, checks the key and compares the matrix palettes */
+    bool canDrawInstancedWith(const MeshCommand* command) const;
+    /** Returns the model view matrix and color of this command as an instance */
+    InstanceData getInstanceData() const;
+    /** Draws `instanceCount` instances of this command with its instanced material, reading their InstanceData from `instanceBuffer` */
+    void drawInstanced(GLuint instanceBuffer, ssize_t instanceCount);
+
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     void listenRendererRecreated(EventCustom* event);
 #endif
@@ -105,6 +129,13 @@ protected:
     // weak ref
     Material* _material;
 
+    // instanced drawing, weak ref
+    Material* _instancedMaterial;
+    Vec4 _instanceColor;
+    uint32_t _instanceKey;
+    const Vec4* _instanceMatrixPalette;
+    ssize_t _instanceMatrixPaletteSize;
+
     // Mode B: StateBlock
     // weak ref
     GLProgramState* _glProgramState;
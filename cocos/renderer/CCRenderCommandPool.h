@@ -26,74 +26,157 @@
 #define __CC_RENDERCOMMANDPOOL_H__
 /// @cond DO_NOT_SHOW
 
-#include <list>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
+#include "base/ccMacros.h"
+#include "base/CCParallelTaskPool.h"
 
 NS_CC_BEGIN
 
+/**
+ A pool of render commands allocated in contiguous chunks.
+
+ Commands returned by generateCommand() are owned by the caller until they are given back with pushBackCommand().
+ The free commands are linked through the chunks, so neither call allocates once the pool is warm.
+ Commands returned by generateTransientCommand() are bump allocated and are all reclaimed at once
+ by reclaimTransientCommands(), which the Renderer does when it cleans its queues.
+
+ Every thread of ParallelTaskPool gets its own free list and transient arena, so once setThreadCount() has been
+ called the pool can be used from those threads without any locking. Commands are reused without being
+ constructed again, callers have to init them.
+ */
 template <class T>
 class RenderCommandPool
 {
 public:
     RenderCommandPool()
+    : _threadPools(1)
     {
     }
     ~RenderCommandPool()
     {
-//        if( 0 != _usedPool.size())
-//        {
-//            CCLOG("All RenderCommand should not be used when Pool is released!");
-//        }
-        _freePool.clear();
-        for (typename std::list<T*>::iterator iter = _allocatedPoolBlocks.begin(); iter != _allocatedPoolBlocks.end(); ++iter)
+        for (auto& threadPool : _threadPools)
         {
-            delete[] *iter;
-            *iter = nullptr;
+            for (auto chunk : threadPool.chunks)
+            {
+                delete[] chunk;
+            }
+        }
+        _threadPools.clear();
+    }
+
+    /**
+     Makes the pool usable from the threads 0 ... count - 1 of ParallelTaskPool, see ParallelTaskPool::getCurrentThreadIndex().
+     Must not be called while other threads are using the pool.
+     */
+    void setThreadCount(int count)
+    {
+        if (count > (int)_threadPools.size())
+        {
+            _threadPools.resize(count);
         }
-        _allocatedPoolBlocks.clear();
     }
 
     T* generateCommand()
     {
-        T* result = nullptr;
-        if(_freePool.empty())
+        auto& threadPool = getThreadPool();
+        if (threadPool.freeList == nullptr)
         {
-            AllocateCommands();
+            Slot* commands = allocateCommands(threadPool);
+            for (int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
+            {
+                commands[index].nextFree = index + 1 < COMMANDS_ALLOCATE_BLOCK_SIZE ? &commands[index + 1] : nullptr;
+            }
+            threadPool.freeList = commands;
         }
-        result = _freePool.front();
-        _freePool.pop_front();
-        //_usedPool.insert(result);
+
+        Slot* result = threadPool.freeList;
+        threadPool.freeList = result->nextFree;
         return result;
     }
     
     void pushBackCommand(T* ptr)
     {
-//        if(_usedPool.find(ptr) == _usedPool.end())
-//        {
-//            CCLOG("push Back Wrong command!");
-//            return;
-//        }
-        
-        _freePool.push_back(ptr);
-        //_usedPool.erase(ptr);
-        
+        auto& threadPool = getThreadPool();
+        Slot* slot = static_cast<Slot*>(ptr);
+        slot->nextFree = threadPool.freeList;
+        threadPool.freeList = slot;
     }
+
+    /** Returns a command that stays valid until the next call to reclaimTransientCommands(). */
+    T* generateTransientCommand()
+    {
+        auto& threadPool = getThreadPool();
+        if (threadPool.transientUsed == COMMANDS_ALLOCATE_BLOCK_SIZE)
+        {
+            ++threadPool.transientChunk;
+            threadPool.transientUsed = 0;
+        }
+        if (threadPool.transientChunk == threadPool.transientChunks.size())
+        {
+            threadPool.transientChunks.push_back(allocateCommands(threadPool));
+        }
+        return &threadPool.transientChunks[threadPool.transientChunk][threadPool.transientUsed++];
+    }
+
+    /** Makes every command returned by generateTransientCommand() available again. Must not be called while other threads are using the pool. */
+    void reclaimTransientCommands()
+    {
+        for (auto& threadPool : _threadPools)
+        {
+            threadPool.transientChunk = 0;
+            threadPool.transientUsed = 0;
+        }
+    }
+
 private:
-    void AllocateCommands()
+    static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
+
+    struct Slot : public T
+    {
+        Slot* nextFree;
+    };
+
+    struct ThreadPool
+    {
+        ThreadPool()
+        : freeList(nullptr)
+        , transientChunk(0)
+        , transientUsed(0)
+        {
+        }
+
+        Slot* freeList;
+        std::vector<Slot*> chunks;
+        std::vector<Slot*> transientChunks;
+        size_t transientChunk;
+        int transientUsed;
+        // keeps the pools of different threads on different cache lines
+        char padding[64];
+    };
+
+    ThreadPool& getThreadPool()
     {
-        static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
-        T* commands = new (std::nothrow) T[COMMANDS_ALLOCATE_BLOCK_SIZE];
-        _allocatedPoolBlocks.push_back(commands);
-        for(int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
+        // the pool is only shared with other threads once setThreadCount() has been called
+        if (_threadPools.size() == 1)
         {
-            _freePool.push_back(commands+index);
+            return _threadPools[0];
         }
+
+        int index = ParallelTaskPool::getInstance()->getCurrentThreadIndex();
+        CCASSERT(index < (int)_threadPools.size(), "setThreadCount() must be called before using the pool from this thread");
+        return _threadPools[index];
+    }
+
+    Slot* allocateCommands(ThreadPool& threadPool)
+    {
+        Slot* commands = new (std::nothrow) Slot[COMMANDS_ALLOCATE_BLOCK_SIZE];
+        threadPool.chunks.push_back(commands);
+        return commands;
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
-    //std::set<T*> _usedPool;
+    std::vector<ThreadPool> _threadPools;
 };
 
 NS_CC_END
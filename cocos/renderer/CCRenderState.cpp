@@ -31,6 +31,7 @@
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCPass.h"
 #include "renderer/ccGLStateCache.h"
+#include "xxhash.h"
 
 
 NS_CC_BEGIN
@@ -715,8 +716,31 @@ bool RenderState::StateBlock::isDirty() const
 
 uint32_t RenderState::StateBlock::getHash() const
 {
-    // XXX
-    return 0x12345678;
+    // bind() only applies the states that were explicitly set, so the others are left out of the hash
+    uint32_t stateArray[10] = {0};
+    stateArray[0] = (uint32_t)_bits;
+    if (_bits & RS_BLEND)
+        stateArray[1] = _blendEnabled;
+    if (_bits & RS_BLEND_FUNC)
+    {
+        stateArray[2] = (uint32_t)_blendSrc;
+        stateArray[3] = (uint32_t)_blendDst;
+    }
+    if (_bits & RS_CULL_FACE)
+        stateArray[4] = _cullFaceEnabled;
+    if (_bits & RS_CULL_FACE_SIDE)
+        stateArray[5] = (uint32_t)_cullFaceSide;
+    if (_bits & RS_FRONT_FACE)
+        stateArray[6] = (uint32_t)_frontFace;
+    if (_bits & RS_DEPTH_TEST)
+        stateArray[7] = _depthTestEnabled;
+    if (_bits & RS_DEPTH_WRITE)
+        stateArray[8] = _depthWriteEnabled;
+    if (_bits & RS_DEPTH_FUNC)
+        stateArray[9] = (uint32_t)_depthFunction;
+
+    _hash = XXH32((const void*)stateArray, sizeof(stateArray), 0);
+    return _hash;
 }
 
 void RenderState::StateBlock::invalidate(long stateBits)
@@ -42,24 +42,29 @@
 
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
+#include "base/CCParallelTaskPool.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
+#include "2d/CCFontAtlasCache.h"
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// maps a float to an unsigned int that compares in the same order
+static inline uint32_t sortableFloatBits(float value)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    // adding 0 turns -0.0f into 0.0f, so both get the same bits
+    value += 0.0f;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
-{
-    return  a->getDepth() > b->getDepth();
-}
+// queues smaller than this are sorted with std::sort, the histograms aren't worth it
+static const size_t RADIX_SORT_MIN_SIZE = 256;
 
 // queue
 RenderQueue::RenderQueue()
@@ -112,9 +117,107 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    sortSubQueue(QUEUE_GROUP::TRANSPARENT_3D, true);
+    sortSubQueue(QUEUE_GROUP::GLOBALZ_NEG, false);
+    sortSubQueue(QUEUE_GROUP::GLOBALZ_POS, false);
+    groupInstancedMeshes();
+}
+
+void RenderQueue::groupInstancedMeshes()
+{
+    // Opaque 3D objects are drawn with depth test and depth write, so the order of the
+    // meshes inside a run of instanced meshes doesn't change the result
+    auto isInstanced = [](RenderCommand* command) {
+        return command->getType() == RenderCommand::Type::MESH_COMMAND
+            && static_cast<MeshCommand*>(command)->getInstancedMaterial() != nullptr;
+    };
+    auto byInstanceKey = [](RenderCommand* a, RenderCommand* b) {
+        return static_cast<MeshCommand*>(a)->getInstanceKey() < static_cast<MeshCommand*>(b)->getInstanceKey();
+    };
+
+    auto& commands = _commands[QUEUE_GROUP::OPAQUE_3D];
+    auto begin = std::find_if(commands.begin(), commands.end(), isInstanced);
+    while (begin != commands.end())
+    {
+        auto end = std::find_if_not(begin, commands.end(), isInstanced);
+        if (end - begin > 2)
+            std::stable_sort(begin, end, byInstanceKey);
+        begin = std::find_if(end, commands.end(), isInstanced);
+    }
+}
+
+void RenderQueue::sortSubQueue(QUEUE_GROUP group, bool byDepth)
+{
+    auto& commands = _commands[group];
+    size_t count = commands.size();
+    if (count < 2)
+        return;
+
+    // The key is the sortable globalZ (or inverted depth) in the high 32 bits
+    // and the arrival index in the low 32 bits, so all keys are unique and
+    // sorting them gives a stable order.
+    _sortKeys.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t order = byDepth ? ~sortableFloatBits(commands[i]->getDepth()) : sortableFloatBits(commands[i]->getGlobalOrder());
+        _sortKeys[i] = ((uint64_t)order << 32) | (uint64_t)i;
+    }
+
+    if (count < RADIX_SORT_MIN_SIZE)
+    {
+        std::sort(_sortKeys.begin(), _sortKeys.end());
+    }
+    else
+    {
+        // LSD radix sort over the 4 high bytes, the low 32 bits are already in order
+        size_t histograms[4][256];
+        memset(histograms, 0, sizeof(histograms));
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t order = (uint32_t)(_sortKeys[i] >> 32);
+            ++histograms[0][order & 0xff];
+            ++histograms[1][(order >> 8) & 0xff];
+            ++histograms[2][(order >> 16) & 0xff];
+            ++histograms[3][order >> 24];
+        }
+
+        _sortKeysBuffer.resize(count);
+        uint64_t* src = _sortKeys.data();
+        uint64_t* dst = _sortKeysBuffer.data();
+        for (int pass = 0; pass < 4; ++pass)
+        {
+            size_t* histogram = histograms[pass];
+            unsigned int shift = 32 + pass * 8;
+
+            // skip the pass if every key has the same byte, quite common for globalZ
+            if (histogram[(src[0] >> shift) & 0xff] == count)
+                continue;
+
+            size_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket)
+            {
+                size_t bucketSize = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketSize;
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                dst[histogram[(src[i] >> shift) & 0xff]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+
+        if (src != _sortKeys.data())
+        {
+            _sortKeys.swap(_sortKeysBuffer);
+        }
+    }
+
+    _sortCommandsBuffer.assign(commands.begin(), commands.end());
+    for (size_t i = 0; i < count; ++i)
+    {
+        commands[i] = _sortCommandsBuffer[(uint32_t)_sortKeys[i]];
+    }
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -152,6 +255,14 @@ void RenderQueue::realloc(size_t reserveSize)
     }
 }
 
+void RenderQueue::append(const RenderQueue& queue)
+{
+    for(int i = 0; i < QUEUE_COUNT; ++i)
+    {
+        _commands[i].insert(_commands[i].end(), queue._commands[i].begin(), queue._commands[i].end());
+    }
+}
+
 void RenderQueue::saveRenderState()
 {
     _isDepthEnabled = glIsEnabled(GL_DEPTH_TEST) != GL_FALSE;
@@ -197,6 +308,24 @@ void RenderQueue::restoreRenderState()
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
 
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+// how long glClientWaitSync blocks before polling again, in nanoseconds
+static const GLuint64 STREAM_FENCE_TIMEOUT = 1000000;
+#endif
+
+// points the position, color and tex coord attributes to the V3F_C4B_T2F vertices starting at `offset` in the bound buffer
+static void setBatchVertexAttribPointers(size_t offset)
+{
+    // vertices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+
+    // colors
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+}
+
 //
 // constructors, destructor, init
 //
@@ -206,9 +335,17 @@ Renderer::Renderer()
 ,_filledVertex(0)
 ,_filledIndex(0)
 ,_numberQuads(0)
+,_useStreamBuffers(false)
+,_instancingEnabled(true)
+,_supportsInstancing(false)
+,_instanceVBO(0)
 ,_glViewAssigned(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
+,_uploadedBytes(0)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_isRecordingInParallel(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -221,6 +358,9 @@ Renderer::Renderer()
     _renderGroups.push_back(defaultRenderQueue);
     _batchedCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
 
+    resetStreamBuffer(_triangleStream, 0, _verts);
+    resetStreamBuffer(_quadStream, 0, _quadVerts);
+
     // default clear color
     _clearColor = Color4F::BLACK;
 }
@@ -229,9 +369,14 @@ Renderer::~Renderer()
 {
     _renderGroups.clear();
     _groupCommandManager->release();
+
+    releaseStreamBuffer(_triangleStream);
+    releaseStreamBuffer(_quadStream);
     
     glDeleteBuffers(2, _buffersVBO);
     glDeleteBuffers(2, _quadbuffersVBO);
+    if (_instanceVBO)
+        glDeleteBuffers(1, &_instanceVBO);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -274,7 +419,13 @@ void Renderer::initGLView()
 
 void Renderer::setupBuffer()
 {
-    if(Configuration::getInstance()->supportsShareableVAO())
+    auto conf = Configuration::getInstance();
+    _useStreamBuffers = conf->supportsMapBufferRange() && conf->supportsSyncObjects();
+    _supportsInstancing = conf->supportsInstancedArrays();
+    //created on demand, the old one is gone if the GL context was recreated
+    _instanceVBO = 0;
+
+    if(conf->supportsShareableVAO())
     {
         setupVBOAndVAO();
     }
@@ -282,6 +433,10 @@ void Renderer::setupBuffer()
     {
         setupVBO();
     }
+
+    // the previous fences, if any, belonged to a context that is gone
+    resetStreamBuffer(_triangleStream, _buffersVBO[0], _verts);
+    resetStreamBuffer(_quadStream, _quadbuffersVBO[0], _quadVerts);
 }
 
 void Renderer::setupVBOAndVAO()
@@ -292,8 +447,11 @@ void Renderer::setupVBOAndVAO()
 
     glGenBuffers(2, &_buffersVBO[0]);
 
+    // when streaming, the vertex buffers hold a ring of STREAM_BUFFER_SEGMENTS batches
+    const int vertexBufferSize = VBO_SIZE * (_useStreamBuffers ? STREAM_BUFFER_SEGMENTS : 1);
+
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * vertexBufferSize, _useStreamBuffers ? nullptr : _verts, GL_DYNAMIC_DRAW);
 
     // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -322,7 +480,7 @@ void Renderer::setupVBOAndVAO()
     glGenBuffers(2, &_quadbuffersVBO[0]);
     
     glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE, _quadVerts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * vertexBufferSize, _useStreamBuffers ? nullptr : _quadVerts, GL_DYNAMIC_DRAW);
     
     // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -359,11 +517,13 @@ void Renderer::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
     GL::bindVAO(0);
 
+    const int vertexBufferSize = VBO_SIZE * (_useStreamBuffers ? STREAM_BUFFER_SEGMENTS : 1);
+
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * vertexBufferSize, _useStreamBuffers ? nullptr : _verts, GL_DYNAMIC_DRAW);
     
     glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE, _quadVerts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * vertexBufferSize, _useStreamBuffers ? nullptr : _quadVerts, GL_DYNAMIC_DRAW);
     
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -378,8 +538,125 @@ void Renderer::mapBuffers()
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Renderer::resetStreamBuffer(StreamBuffer& stream, GLuint vbo, V3F_C4B_T2F* clientVerts)
+{
+    stream.vbo = vbo;
+    stream.clientVerts = clientVerts;
+    stream.verts = clientVerts;
+    stream.capacity = VBO_SIZE;
+    stream.segment = 0;
+    stream.offset = 0;
+    stream.mapped = false;
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+    for (int i = 0; i < STREAM_BUFFER_SEGMENTS; ++i)
+    {
+        stream.fences[i] = nullptr;
+    }
+#endif
+}
+
+void Renderer::releaseStreamBuffer(StreamBuffer& stream)
+{
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+    for (int i = 0; i < STREAM_BUFFER_SEGMENTS; ++i)
+    {
+        if (stream.fences[i])
+        {
+            glDeleteSync(stream.fences[i]);
+            stream.fences[i] = nullptr;
+        }
+    }
+#endif
+}
+
+void Renderer::beginStreamBatch(StreamBuffer& stream, int vertexCount)
+{
+    if (!_useStreamBuffers)
+        return;
+
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+    if (stream.mapped)
+    {
+        // the previous batch only had empty commands, keep using its range if possible
+        if (vertexCount <= stream.capacity)
+            return;
+
+        glBindBuffer(GL_ARRAY_BUFFER, stream.vbo);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        stream.mapped = false;
+    }
+
+    // a batch never crosses the end of a segment, so move to the next one if it doesn't fit
+    if (stream.offset + vertexCount > (stream.segment + 1) * VBO_SIZE)
+    {
+        stream.fences[stream.segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        stream.segment = (stream.segment + 1) % STREAM_BUFFER_SEGMENTS;
+        stream.offset = stream.segment * VBO_SIZE;
+
+        // wait for the GPU to finish drawing the batches written the last time this segment was used
+        GLsync& fence = stream.fences[stream.segment];
+        if (fence)
+        {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_FENCE_TIMEOUT) == GL_TIMEOUT_EXPIRED)
+            {
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    stream.capacity = (stream.segment + 1) * VBO_SIZE - stream.offset;
+
+    // nothing the GPU may still read is in this range, so no need to synchronize
+    glBindBuffer(GL_ARRAY_BUFFER, stream.vbo);
+    void* buf = glMapBufferRange(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F) * stream.offset, sizeof(V3F_C4B_T2F) * stream.capacity,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    stream.mapped = (buf != nullptr);
+    stream.verts = stream.mapped ? (V3F_C4B_T2F*)buf : stream.clientVerts;
+#endif
+}
+
+int Renderer::endStreamBatch(StreamBuffer& stream, int vertexCount)
+{
+    GLsizeiptr size = sizeof(V3F_C4B_T2F) * vertexCount;
+
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+    if (stream.mapped)
+    {
+        glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    else
+#endif
+    {
+        // mapping failed, upload the client side copy into the same range
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F) * stream.offset, size, stream.clientVerts);
+    }
+    _uploadedBytes += size;
+
+    int batchOffset = stream.offset;
+    stream.offset += vertexCount;
+    stream.capacity = VBO_SIZE;
+    stream.verts = stream.clientVerts;
+    stream.mapped = false;
+    return batchOffset;
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
+    if (_isRecordingInParallel)
+    {
+        auto recordingQueue = _threadRecordingQueues[ParallelTaskPool::getInstance()->getCurrentThreadIndex()];
+        if (recordingQueue)
+        {
+            CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
+            recordingQueue->push_back(command);
+            return;
+        }
+    }
+
     int renderQueue =_commandGroupStack.top();
     addCommand(command, renderQueue);
 }
@@ -387,6 +664,7 @@ void Renderer::addCommand(RenderCommand* command)
 void Renderer::addCommand(RenderCommand* command, int renderQueue)
 {
     CCASSERT(!_isRendering, "Cannot add command while rendering");
+    CCASSERT(!_isRecordingInParallel, "Cannot add command to a render queue while recording in parallel");
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
@@ -396,22 +674,77 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    CCASSERT(!_isRecordingInParallel, "Cannot change render queue while recording in parallel");
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    CCASSERT(!_isRecordingInParallel, "Cannot change render queue while recording in parallel");
     _commandGroupStack.pop();
 }
 
 int Renderer::createRenderQueue()
 {
+    CCASSERT(!_isRecordingInParallel, "Cannot create render queue while recording in parallel");
     RenderQueue newRenderQueue;
     _renderGroups.push_back(newRenderQueue);
     return (int)_renderGroups.size() - 1;
 }
 
+void Renderer::beginParallelRecording(int count)
+{
+    CCASSERT(!_isRendering, "Cannot record commands while rendering");
+    CCASSERT(!_isRecordingInParallel, "Parallel recording can't be nested");
+
+    if (_recordingQueues.size() < (size_t)count)
+    {
+        _recordingQueues.resize(count);
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        _recordingQueues[i].clear();
+    }
+
+    int threadCount = ParallelTaskPool::getInstance()->getWorkerCount() + 1;
+    _threadRecordingQueues.assign(threadCount, nullptr);
+    _transientCustomCommandPool.setThreadCount(threadCount);
+    _isRecordingInParallel = true;
+}
+
+void Renderer::setRecordingQueue(int index)
+{
+    CCASSERT(_isRecordingInParallel, "beginParallelRecording() must be called first");
+    CCASSERT(index < (int)_recordingQueues.size(), "Invalid recording queue");
+
+    int threadIndex = ParallelTaskPool::getInstance()->getCurrentThreadIndex();
+    _threadRecordingQueues[threadIndex] = index >= 0 ? &_recordingQueues[index] : nullptr;
+}
+
+void Renderer::endParallelRecording()
+{
+    CCASSERT(_isRecordingInParallel, "beginParallelRecording() must be called first");
+    _isRecordingInParallel = false;
+
+    auto& renderQueue = _renderGroups[_commandGroupStack.top()];
+    for (auto& recordingQueue : _recordingQueues)
+    {
+        renderQueue.append(recordingQueue);
+        recordingQueue.clear();
+    }
+}
+
+CustomCommand* Renderer::generateTransientCustomCommand()
+{
+    CCASSERT(!_isRendering, "Cannot generate commands while rendering");
+
+    auto command = _transientCustomCommandPool.generateTransientCommand();
+    // the command may have been used by another node in a previous frame
+    *command = CustomCommand();
+    return command;
+}
+
 void Renderer::processRenderCommand(RenderCommand* command)
 {
     auto commandType = command->getType();
@@ -425,7 +758,7 @@ void Renderer::processRenderCommand(RenderCommand* command)
         auto cmd = static_cast<TrianglesCommand*>(command);
         
         //Draw batched Triangles if necessary
-        if(cmd->isSkipBatching() || _filledVertex + cmd->getVertexCount() > VBO_SIZE || _filledIndex + cmd->getIndexCount() > INDEX_VBO_SIZE)
+        if(cmd->isSkipBatching() || _filledVertex + cmd->getVertexCount() > _triangleStream.capacity || _filledIndex + cmd->getIndexCount() > INDEX_VBO_SIZE)
         {
             CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
             CCASSERT(cmd->getIndexCount()>= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
@@ -454,7 +787,7 @@ void Renderer::processRenderCommand(RenderCommand* command)
         auto cmd = static_cast<QuadCommand*>(command);
         
         //Draw batched quads if necessary
-        if(cmd->isSkipBatching()|| (_numberQuads + cmd->getQuadCount()) * 4 > VBO_SIZE )
+        if(cmd->isSkipBatching()|| (_numberQuads + cmd->getQuadCount()) * 4 > _quadStream.capacity )
         {
             CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() * 4 < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
             //Draw batched quads if VBO is full
@@ -476,7 +809,13 @@ void Renderer::processRenderCommand(RenderCommand* command)
         flush2D();
         auto cmd = static_cast<MeshCommand*>(command);
         
-        if (cmd->isSkipBatching() || _lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
+        if (cmd->getInstancedMaterial())
+        {
+            if (_instancedMeshCommands.empty() || !_instancedMeshCommands[0]->canDrawInstancedWith(cmd))
+                flush3D();
+            _instancedMeshCommands.push_back(cmd);
+        }
+        else if (cmd->isSkipBatching() || _lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
         {
             flush3D();
             
@@ -704,6 +1043,10 @@ void Renderer::render()
     
     if (_glViewAssigned)
     {
+        // the glyphs added by the labels visited before this pass must be on their textures
+        FontAtlasCache::uploadDirtyAtlases();
+
+
         //Process render commands
         //1. Sort render commands based on ID
         for (auto &renderqueue : _renderGroups)
@@ -729,6 +1072,8 @@ void Renderer::clean()
         _renderGroups[j].clear();
     }
 
+    _transientCustomCommandPool.reclaimTransientCommands();
+
     // Clear batch commands
     _batchedCommands.clear();
     _batchQuadCommands.clear();
@@ -737,6 +1082,7 @@ void Renderer::clean()
     _numberQuads = 0;
     _lastMaterialID = 0;
     _lastBatchedMeshCommand = nullptr;
+    _instancedMeshCommands.clear();
 }
 
 void Renderer::clear()
@@ -776,14 +1122,22 @@ void Renderer::setDepthTest(bool enable)
 
 void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 {
-    memcpy(_verts + _filledVertex, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
+    if (_filledVertex == 0)
+    {
+        beginStreamBatch(_triangleStream, (int)cmd->getVertexCount());
+    }
+
+    // the vertices are transformed while they are copied so the destination, which may be
+    // write-combined memory mapped from the GPU, is never read back
+    const V3F_C4B_T2F* vertices = cmd->getVertices();
+    V3F_C4B_T2F* verts = _triangleStream.verts + _filledVertex;
     const Mat4& modelView = cmd->getModelView();
     
     for(ssize_t i=0; i< cmd->getVertexCount(); ++i)
     {
-        V3F_C4B_T2F *q = &_verts[i + _filledVertex];
-        Vec3 *vec1 = (Vec3*)&q->vertices;
-        modelView.transformPoint(vec1);
+        verts[i].colors = vertices[i].colors;
+        verts[i].texCoords = vertices[i].texCoords;
+        modelView.transformPoint(vertices[i].vertices, &verts[i].vertices);
     }
     
     const unsigned short* indices = cmd->getIndices();
@@ -799,12 +1153,19 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 
 void Renderer::fillQuads(const QuadCommand *cmd)
 {
+    if (_numberQuads == 0)
+    {
+        beginStreamBatch(_quadStream, (int)cmd->getQuadCount() * 4);
+    }
+
     const Mat4& modelView = cmd->getModelView();
     const V3F_C4B_T2F* quads =  (V3F_C4B_T2F*)cmd->getQuads();
+    V3F_C4B_T2F* verts = _quadStream.verts + _numberQuads * 4;
     for(ssize_t i=0; i< cmd->getQuadCount() * 4; ++i)
     {
-        _quadVerts[i + _numberQuads * 4] = quads[i];
-        modelView.transformPoint(quads[i].vertices,&(_quadVerts[i + _numberQuads * 4].vertices));
+        verts[i].colors = quads[i].colors;
+        verts[i].texCoords = quads[i].texCoords;
+        modelView.transformPoint(quads[i].vertices,&(verts[i].vertices));
     }
     
     _numberQuads += cmd->getQuadCount();
@@ -823,7 +1184,27 @@ void Renderer::drawBatchedTriangles()
         return;
     }
 
-    if (Configuration::getInstance()->supportsShareableVAO())
+    if (_useStreamBuffers)
+    {
+        if (Configuration::getInstance()->supportsShareableVAO())
+        {
+            GL::bindVAO(_buffersVAO);
+        }
+        else
+        {
+            GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        int offset = endStreamBatch(_triangleStream, _filledVertex);
+        // indices are relative to the start of the batch
+        setBatchVertexAttribPointers(sizeof(_verts[0]) * offset);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
+    }
+    else if (Configuration::getInstance()->supportsShareableVAO())
     {
         //Bind VAO
         GL::bindVAO(_buffersVAO);
@@ -841,6 +1222,7 @@ void Renderer::drawBatchedTriangles()
         void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
         memcpy(buf, _verts, sizeof(_verts[0])* _filledVertex);
         glUnmapBuffer(GL_ARRAY_BUFFER);
+        _uploadedBytes += sizeof(_verts[0]) * _filledVertex;
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         
@@ -853,6 +1235,7 @@ void Renderer::drawBatchedTriangles()
         glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
         glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex , _verts, GL_DYNAMIC_DRAW);
+        _uploadedBytes += sizeof(_verts[0]) * _filledVertex;
 
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
@@ -869,6 +1252,8 @@ void Renderer::drawBatchedTriangles()
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
     }
 
+    _uploadedBytes += sizeof(_indices[0]) * _filledIndex;
+
     //Start drawing verties in batch
     for(const auto& cmd : _batchedCommands)
     {
@@ -931,7 +1316,26 @@ void Renderer::drawBatchedQuads()
         return;
     }
     
-    if (Configuration::getInstance()->supportsShareableVAO())
+    if (_useStreamBuffers)
+    {
+        if (Configuration::getInstance()->supportsShareableVAO())
+        {
+            GL::bindVAO(_quadVAO);
+        }
+        else
+        {
+            GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
+        int offset = endStreamBatch(_quadStream, (int)_numberQuads * 4);
+        // the quad indices are static and relative to the start of the batch
+        setBatchVertexAttribPointers(sizeof(_quadVerts[0]) * offset);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+    }
+    else if (Configuration::getInstance()->supportsShareableVAO())
     {
         //Bind VAO
         GL::bindVAO(_quadVAO);
@@ -949,6 +1353,7 @@ void Renderer::drawBatchedQuads()
         void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
         memcpy(buf, _quadVerts, sizeof(_quadVerts[0])* _numberQuads * 4);
         glUnmapBuffer(GL_ARRAY_BUFFER);
+        _uploadedBytes += sizeof(_quadVerts[0]) * _numberQuads * 4;
         
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         
@@ -960,6 +1365,7 @@ void Renderer::drawBatchedQuads()
         glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
         
         glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * _numberQuads * 4 , _quadVerts, GL_DYNAMIC_DRAW);
+        _uploadedBytes += sizeof(_quadVerts[0]) * _numberQuads * 4;
         
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
         
@@ -1046,6 +1452,8 @@ void Renderer::flush2D()
 
 void Renderer::flush3D()
 {
+    drawInstancedMeshes();
+
     if (_lastBatchedMeshCommand)
     {
         _lastBatchedMeshCommand->postBatchDraw();
@@ -1053,6 +1461,40 @@ void Renderer::flush3D()
     }
 }
 
+void Renderer::drawInstancedMeshes()
+{
+    if (_instancedMeshCommands.empty())
+        return;
+
+    auto instanceCount = _instancedMeshCommands.size();
+    if (instanceCount == 1)
+    {
+        // nothing to share the draw call with, draw it with its own material
+        _instancedMeshCommands[0]->execute();
+    }
+    else
+    {
+        _instanceData.resize(instanceCount);
+        for (size_t i = 0; i < instanceCount; ++i)
+        {
+            _instanceData[i] = _instancedMeshCommands[i]->getInstanceData();
+        }
+
+        if (_instanceVBO == 0)
+            glGenBuffers(1, &_instanceVBO);
+
+        const auto instanceBytes = sizeof(_instanceData[0]) * instanceCount;
+        glBindBuffer(GL_ARRAY_BUFFER, _instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instanceBytes, _instanceData.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        _uploadedBytes += instanceBytes;
+
+        _instancedMeshCommands[0]->drawInstanced(_instanceVBO, instanceCount);
+    }
+
+    _instancedMeshCommands.clear();
+}
+
 void Renderer::flushQuads()
 {
     if(_numberQuads > 0)
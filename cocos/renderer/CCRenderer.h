@@ -30,7 +30,11 @@
 #include <stack>
 
 #include "platform/CCPlatformMacros.h"
+#include "base/ccConfig.h"
 #include "renderer/CCRenderCommand.h"
+#include "renderer/CCCustomCommand.h"
+#include "renderer/CCMeshCommand.h"
+#include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCGLProgram.h"
 #include "platform/CCGL.h"
 
@@ -44,7 +48,6 @@ NS_CC_BEGIN
 class EventListenerCustom;
 class QuadCommand;
 class TrianglesCommand;
-class MeshCommand;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
@@ -78,7 +81,7 @@ public:
     void push_back(RenderCommand* command);
     /**Return the number of render commands.*/
     ssize_t size() const;
-    /**Sort the render commands.*/
+    /**Sort the render commands. Commands with the same globalZ (or depth for transparent 3D objects) keep their arrival order.*/
     void sort();
     /**Treat sorted commands as an array, access them one by one.*/
     RenderCommand* operator[](ssize_t index) const;
@@ -86,6 +89,8 @@ public:
     void clear();
     /**Realloc command queues and reserve with given size. Note: this clears any existing commands.*/
     void realloc(size_t reserveSize);
+    /**Append the commands of another queue, keeping their order, after the commands of this queue.*/
+    void append(const RenderQueue& queue);
     /**Get a sub group of the render queue.*/
     inline std::vector<RenderCommand*>& getSubQueue(QUEUE_GROUP group) { return _commands[group]; }
     /**Get the number of render commands contained in a subqueue.*/
@@ -97,8 +102,18 @@ public:
     void restoreRenderState();
     
 protected:
+    /**Radix sort a sub queue by globalZ, or by decreasing depth if `byDepth` is true. The sort is stable.*/
+    void sortSubQueue(QUEUE_GROUP group, bool byDepth);
+    /**Stable sort each run of instanced meshes of the opaque 3D queue by instance key, so meshes that can be drawn together are adjacent.*/
+    void groupInstancedMeshes();
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+
+    /**Scratch buffers of the sort, kept between frames to avoid allocations.*/
+    std::vector<uint64_t> _sortKeys;
+    std::vector<uint64_t> _sortKeysBuffer;
+    std::vector<RenderCommand*> _sortCommandsBuffer;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -132,6 +147,8 @@ public:
     static const int BATCH_QUADCOMMAND_RESEVER_SIZE = 64;
     /**Reserved for material id, which means that the command could not be batched.*/
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+    /**The number of VBO_SIZE segments in a streaming vertex buffer, see CC_RENDERER_USE_MAP_BUFFER_RANGE.*/
+    static const int STREAM_BUFFER_SEGMENTS = 3;
     /**Constructor.*/
     Renderer();
     /**Destructor.*/
@@ -155,6 +172,28 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /**
+     Prepares `count` recording queues used while `Node::visit` runs on the threads of `ParallelTaskPool`.
+     Render groups can't be pushed or popped until `endParallelRecording()` is called.
+     */
+    void beginParallelRecording(int count);
+
+    /** Commands added from the calling thread will be recorded into the recording queue `index`. Pass -1 to stop recording. */
+    void setRecordingQueue(int index);
+
+    /** Appends the recording queues to the current render queue, in index order, so draw order is the same as a serial visit */
+    void endParallelRecording();
+
+    /** Whether commands are being recorded from worker threads */
+    bool isRecordingInParallel() const { return _isRecordingInParallel; }
+
+    /**
+     Returns a `CustomCommand` owned by the renderer which is valid until the queued commands have been rendered.
+     Nodes that add commands every frame (or several times per frame) can use it instead of a member command.
+     It can be called from the threads of `ParallelTaskPool` while recording in parallel.
+     */
+    CustomCommand* generateTransientCustomCommand();
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
@@ -174,8 +213,10 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) QuadCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of bytes of batched vertices and indices uploaded to the GPU in the last frame */
+    ssize_t getUploadedBytes() const { return _uploadedBytes; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _uploadedBytes = 0; }
 
     /**
      * Enable/Disable depth test
@@ -183,6 +224,21 @@ public:
      * For 2D object depth test is disabled by default
      */
     void setDepthTest(bool enable);
+
+    /**
+     * Enable/Disable drawing consecutive compatible meshes with one instanced draw call, see CC_RENDERER_USE_INSTANCING.
+     * It is enabled by default, and ignored if the GL context doesn't support instanced arrays.
+     *
+     * Only opaque meshes drawn with the default unlit shaders (GLProgram::SHADER_3D_POSITION_TEXTURE or
+     * SHADER_3D_SKINPOSITION_TEXTURE) are instanced, when they share their vertex data, texture and render state;
+     * the opaque 3D queue is sorted so that such meshes are consecutive. Skinned meshes are drawn together only if
+     * their matrix palettes are identical, e.g. a crowd of sprites running the same Animate3D in sync.
+     * Transparent meshes, meshes lit by a light of the scene and meshes using a custom material keep one draw call
+     * each, and so does a run of a single mesh.
+     */
+    void setInstancingEnabled(bool enable) { _instancingEnabled = enable; }
+    /** Whether meshes are drawn with instanced draw calls when possible */
+    bool isInstancingEnabled() const { return _instancingEnabled && _supportsInstancing; }
     
     //This will not be used outside.
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
@@ -192,13 +248,43 @@ public:
 
 protected:
 
+    /* A vertex buffer made of STREAM_BUFFER_SEGMENTS segments of VBO_SIZE vertices. Each batch is written
+       through glMapBufferRange into the free part of the current segment, without synchronization, and a
+       fence is inserted when the ring moves to the next segment so it is only reused once the GPU is done with it.
+     */
+    struct StreamBuffer
+    {
+        GLuint vbo;
+        //client side array used when streaming is not available or mapping failed
+        V3F_C4B_T2F* clientVerts;
+        //where the current batch is written, either the mapped range or clientVerts
+        V3F_C4B_T2F* verts;
+        //max number of vertices of the current batch
+        int capacity;
+        int segment;
+        //offset in vertices of the current batch in the buffer
+        int offset;
+        bool mapped;
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+        GLsync fences[STREAM_BUFFER_SEGMENTS];
+#endif
+    };
+
     //Setup VBO or VAO based on OpenGL extensions
     void setupBuffer();
     void setupVBOAndVAO();
     void setupVBO();
     void mapBuffers();
+    void resetStreamBuffer(StreamBuffer& stream, GLuint vbo, V3F_C4B_T2F* clientVerts);
+    void releaseStreamBuffer(StreamBuffer& stream);
+    //Prepares the stream for a new batch whose first command has `vertexCount` vertices
+    void beginStreamBatch(StreamBuffer& stream, int vertexCount);
+    //Makes the `vertexCount` vertices written since beginStreamBatch() available to the GPU and returns the offset of the batch in vertices, the buffer must be bound
+    int endStreamBatch(StreamBuffer& stream, int vertexCount);
     void drawBatchedTriangles();
     void drawBatchedQuads();
+    //Draws the meshes accumulated in _instancedMeshCommands with one instanced draw call
+    void drawInstancedMeshes();
 
     //Draw the previews queued quads and flush previous context
     void flush();
@@ -244,18 +330,39 @@ protected:
     GLuint _quadVAO;
     GLuint _quadbuffersVBO[2]; //0: vertex  1: indices
     int _numberQuads;
+
+    //stream the vertices of QuadCommands and TrianglesCommands with glMapBufferRange
+    bool _useStreamBuffers;
+    StreamBuffer _triangleStream;
+    StreamBuffer _quadStream;
+
+    //for instanced MeshCommands, consecutive commands with the same instance key
+    bool _instancingEnabled;
+    bool _supportsInstancing;
+    std::vector<MeshCommand*> _instancedMeshCommands;
+    std::vector<MeshCommand::InstanceData> _instanceData;
+    GLuint _instanceVBO;
     
     bool _glViewAssigned;
 
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _uploadedBytes;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     bool _isDepthTestFor2D;
     
     GroupCommandManager* _groupCommandManager;
+
+    // parallel visit
+    std::vector<RenderQueue> _recordingQueues;
+    std::vector<RenderQueue*> _threadRecordingQueues; //indexed by ParallelTaskPool thread index
+    bool _isRecordingInParallel;
+
+    //commands returned by generateTransientCustomCommand(), reclaimed by clean()
+    RenderCommandPool<CustomCommand> _transientCustomCommandPool;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
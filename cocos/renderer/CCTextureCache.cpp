@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <chrono>
+#include <algorithm>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -56,7 +58,9 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
+: _asyncWorkerCount(std::max(1, std::min(4, (int)std::thread::hardware_concurrency() / 2)))
+, _asyncUploadBytesPerFrame(0)
+, _asyncUploadMillisecondsPerFrame(0)
 , _needQuit(false)
 , _asyncRefCount(0)
 , _dirty(false)
@@ -70,7 +74,8 @@ TextureCache::~TextureCache()
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    if (!_loadingThreads.empty())
+        stopLoadingThreads();
 }
 
 void TextureCache::destroyInstance()
@@ -94,22 +99,24 @@ std::string TextureCache::getDescription() const
 struct TextureCache::AsyncStruct
 {
 public:
-    AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f), loadSuccess(false) {}
+    AsyncStruct(const std::string& fn, int p) : filename(fn), priority(p), loadSuccess(false), cancelled(false) {}
     
     std::string filename;
-    std::function<void(Texture2D*)> callback;
+    std::vector<std::function<void(Texture2D*)>> callbacks;
+    int priority;
     Image image;
     bool loadSuccess;
+    bool cancelled;
 };
 
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
+ - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads)
  - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
  
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
+ - _requestQueue: locked by _requestMutex, sorted by priority
  - _responseQueue: locked by _responseMutex
  
  the object's life time:
@@ -117,18 +124,24 @@ public:
  - image data: new in Load thread, delete in GL thread(by Image instance)
  
  Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - all AsyncStruct referenced in _asyncStructQueue, for unbind and cancel functions use.
+ - several load threads decode images at the same time, so the responses don't come in request order.
  
  How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
  - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
+ - If the image request is pending already, the callback is added to the pending request, the image is only loaded once.
+ - If the image was cancelled while being decoded, a new request loads it again.
  
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a problem.
+ - Convert image to texture faster than load image from disk, but many big images can make a frame too long,
+   setAsyncUploadBudget() spreads them over several frames.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
+{
+    addImageAsync(path, callback, 0);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -150,12 +163,33 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
+    // merge with a pending request of the same image
+    for (auto pending : _asyncStructQueue)
+    {
+        if (pending->filename == fullpath && !pending->cancelled)
+        {
+            if (callback)
+                pending->callbacks.push_back(callback);
+
+            if (priority > pending->priority)
+            {
+                std::lock_guard<std::mutex> lock(_requestMutex);
+                pending->priority = priority;
+                auto request = std::find(_requestQueue.begin(), _requestQueue.end(), pending);
+                if (request != _requestQueue.end())
+                {
+                    _requestQueue.erase(request);
+                    pushRequest(pending);
+                }
+            }
+            return;
+        }
+    }
+
     // lazy init
-    if (_loadingThread == nullptr)
+    if (_loadingThreads.empty())
     {
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
-        _needQuit = false;
+        startLoadingThreads();
     }
 
     if (0 == _asyncRefCount)
@@ -166,17 +200,28 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     ++_asyncRefCount;
 
     // generate async struct
-    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, callback);
+    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, priority);
+    if (callback)
+        data->callbacks.push_back(callback);
     
     // add async struct into queue
     _asyncStructQueue.push_back(data);
     _requestMutex.lock();
-    _requestQueue.push_back(data);
+    pushRequest(data);
     _requestMutex.unlock();
 
     _sleepCondition.notify_one();
 }
 
+void TextureCache::pushRequest(AsyncStruct* data)
+{
+    // the queue is sorted by decreasing priority, a request goes after the ones with the same priority
+    auto position = std::upper_bound(_requestQueue.begin(), _requestQueue.end(), data, [](const AsyncStruct* a, const AsyncStruct* b) {
+        return a->priority > b->priority;
+    });
+    _requestQueue.insert(position, data);
+}
+
 void TextureCache::unbindImageAsync(const std::string& filename)
 {
     if (_asyncStructQueue.empty())
@@ -188,7 +233,7 @@ void TextureCache::unbindImageAsync(const std::string& filename)
     {
         if ((*it)->filename == fullpath)
         {
-            (*it)->callback = nullptr;
+            (*it)->callbacks.clear();
         }
     }
 }
@@ -202,33 +247,111 @@ void TextureCache::unbindAllImageAsync()
     }
     for (auto it = _asyncStructQueue.begin(); it != _asyncStructQueue.end(); ++it)
     {
-        (*it)->callback = nullptr;
+        (*it)->callbacks.clear();
     }
 }
 
+void TextureCache::cancelImageAsync(const std::string& filename)
+{
+    if (_asyncStructQueue.empty())
+    {
+        return;
+    }
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+
+    std::lock_guard<std::mutex> lock(_requestMutex);
+    for (auto it = _asyncStructQueue.begin(); it != _asyncStructQueue.end(); )
+    {
+        auto data = *it;
+        if (data->filename != fullpath)
+        {
+            ++it;
+            continue;
+        }
+
+        auto request = std::find(_requestQueue.begin(), _requestQueue.end(), data);
+        if (request != _requestQueue.end())
+        {
+            // not decoded yet, drop it now
+            _requestQueue.erase(request);
+            it = _asyncStructQueue.erase(it);
+            delete data;
+            --_asyncRefCount;
+        }
+        else
+        {
+            // being decoded, addImageAsyncCallBack() drops it once it is done
+            data->cancelled = true;
+            data->callbacks.clear();
+            ++it;
+        }
+    }
+
+    if (0 == _asyncRefCount)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+    }
+}
+
+void TextureCache::setAsyncWorkerCount(int count)
+{
+    CCASSERT(count > 0, "At least one thread is needed to load images");
+    if (count == _asyncWorkerCount)
+        return;
+
+    _asyncWorkerCount = count;
+    if (!_loadingThreads.empty())
+    {
+        stopLoadingThreads();
+        startLoadingThreads();
+    }
+}
+
+void TextureCache::setAsyncUploadBudget(ssize_t bytesPerFrame, float millisecondsPerFrame)
+{
+    _asyncUploadBytesPerFrame = bytesPerFrame;
+    _asyncUploadMillisecondsPerFrame = millisecondsPerFrame;
+}
+
+void TextureCache::startLoadingThreads()
+{
+    _needQuit = false;
+    for (int i = 0; i < _asyncWorkerCount; ++i)
+    {
+        _loadingThreads.push_back(std::thread(&TextureCache::loadImage, this));
+    }
+}
+
+void TextureCache::stopLoadingThreads()
+{
+    // the requests left in the queue are loaded by the next threads
+    _requestMutex.lock();
+    _needQuit = true;
+    _requestMutex.unlock();
+    _sleepCondition.notify_all();
+
+    for (auto& thread : _loadingThreads)
+    {
+        thread.join();
+    }
+    _loadingThreads.clear();
+}
+
 void TextureCache::loadImage()
 {
     AsyncStruct *asyncStruct = nullptr;
-    std::mutex signalMutex;
-    std::unique_lock<std::mutex> signal(signalMutex);
-    while (!_needQuit)
+    while (true)
     {
         // pop an AsyncStruct from request queue
-        _requestMutex.lock();
-        if(_requestQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }else
         {
+            std::unique_lock<std::mutex> lock(_requestMutex);
+            _sleepCondition.wait(lock, [this]{ return _needQuit || !_requestQueue.empty(); });
+            if (_needQuit)
+                break;
+
             asyncStruct = _requestQueue.front();
             _requestQueue.pop_front();
         }
-        _requestMutex.unlock();
-        
-        if (nullptr == asyncStruct) {
-            _sleepCondition.wait(signal);
-            continue;
-        }
         
         // load image
         asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
@@ -244,8 +367,22 @@ void TextureCache::addImageAsyncCallBack(float dt)
 {
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
+    auto startTime = std::chrono::steady_clock::now();
+    ssize_t uploadedBytes = 0;
+    bool uploaded = false;
     while (true)
     {
+        // keep the remaining responses for the next frames once the budget is spent
+        if (uploaded)
+        {
+            if (_asyncUploadBytesPerFrame > 0 && uploadedBytes >= _asyncUploadBytesPerFrame)
+                break;
+
+            if (_asyncUploadMillisecondsPerFrame > 0 &&
+                std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= _asyncUploadMillisecondsPerFrame)
+                break;
+        }
+
         // pop an AsyncStruct from response queue
         _responseMutex.lock();
         if(_responseQueue.empty())
@@ -255,16 +392,21 @@ void TextureCache::addImageAsyncCallBack(float dt)
         {
             asyncStruct = _responseQueue.front();
             _responseQueue.pop_front();
-            
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
         }
         _responseMutex.unlock();
         
         if (nullptr == asyncStruct) {
             break;
         }
+
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+
+        if (asyncStruct->cancelled)
+        {
+            delete asyncStruct;
+            --_asyncRefCount;
+            continue;
+        }
         
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
@@ -293,16 +435,19 @@ void TextureCache::addImageAsyncCallBack(float dt)
                 texture->retain();
                 
                 texture->autorelease();
+
+                uploadedBytes += image->getDataLen();
+                uploaded = true;
             } else {
                 texture = nullptr;
                 CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
             }
         }
         
-        // call callback function
-        if (asyncStruct->callback)
+        // call callback functions
+        for (const auto& callback : asyncStruct->callbacks)
         {
-            (asyncStruct->callback)(texture);
+            callback(texture);
         }
 
         // release the asyncStruct
@@ -560,10 +705,8 @@ const std::string TextureCache::getTextureFilePath( cocos2d::Texture2D *texture
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    // notify sub threads to quit
+    stopLoadingThreads();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
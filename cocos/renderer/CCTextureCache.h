@@ -121,6 +121,45 @@ public:
      @since v0.8
     */
     virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback);
+
+    /** Same as addImageAsync(const std::string&, const std::function<void(Texture2D*)>&), with a priority.
+    * Pending images with a higher priority are loaded first, images with the same priority are loaded in request order.
+    * Requesting an image that is already being loaded doesn't load it twice, the request is merged with the pending one
+    * and its priority raised if needed.
+     @param filepath A null terminated string.
+     @param callback A callback function would be invoked after the image is loaded.
+     @param priority The priority of the request, 0 for addImageAsync() without a priority.
+     @since v3.10
+    */
+    virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback, int priority);
+
+    /** Cancels the asynchronous loading of an image.
+     * The pending requests of the file are dropped, their callbacks aren't called and no texture is created for them.
+     * @param filename It's the related/absolute path of the file image.
+     * @since v3.10
+     */
+    virtual void cancelImageAsync(const std::string &filename);
+
+    /** Sets the number of threads decoding the images loaded by addImageAsync().
+     * By default it is half the number of hardware threads, between 1 and 4.
+     * @param count The number of threads, at least 1.
+     * @since v3.10
+     */
+    void setAsyncWorkerCount(int count);
+
+    /** Returns the number of threads decoding the images loaded by addImageAsync().
+     * @since v3.10
+     */
+    int getAsyncWorkerCount() const { return _asyncWorkerCount; }
+
+    /** Limits the textures created each frame from the images loaded by addImageAsync(), so loading
+     * many images doesn't stall a frame. The images over budget are turned into textures in the next frames.
+     * At least one texture is created per frame. Both limits are 0, no limit, by default.
+     * @param bytesPerFrame Size of the decoded images turned into textures in a frame, 0 for no limit.
+     * @param millisecondsPerFrame Time spent creating textures in a frame, 0 for no limit.
+     * @since v3.10
+     */
+    void setAsyncUploadBudget(ssize_t bytesPerFrame, float millisecondsPerFrame);
     
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
@@ -221,12 +260,20 @@ public:
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
+    void startLoadingThreads();
+    void stopLoadingThreads();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
 public:
 protected:
     struct AsyncStruct;
+
+    /// inserts a request in _requestQueue by priority, _requestMutex must be locked
+    void pushRequest(AsyncStruct* data);
     
-    std::thread* _loadingThread;
+    std::vector<std::thread> _loadingThreads;
+    int _asyncWorkerCount;
+    ssize_t _asyncUploadBytesPerFrame;
+    float _asyncUploadMillisecondsPerFrame;
 
     std::deque<AsyncStruct*> _asyncStructQueue;
     std::deque<AsyncStruct*> _requestQueue;
@@ -0,0 +1,663 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/ccPixelConversion.h"
+#include "math/MathUtil.h"
+
+//#define INCLUDE_SSE       : SSE2 and SSSE3 code included, SSSE3 is detected at runtime
+//#define INCLUDE_NEON      : NEON code included, NEON is detected at runtime on Android armv7
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INCLUDE_SSE
+    #include <emmintrin.h>
+    #include <tmmintrin.h>
+    #if defined (_MSC_VER)
+        #include <intrin.h>
+        #define TARGET_SSSE3
+    #else
+        #include <cpuid.h>
+        #define TARGET_SSSE3 __attribute__((target("ssse3")))
+    #endif
+#endif
+
+#if defined (__ARM_NEON__) || defined (__ARM_NEON) || defined (__aarch64__)
+    #define INCLUDE_NEON
+    #include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace PixelConversion
+{
+
+// Every kernel converts `count` pixels and returns the number of pixels it converted.
+// The SIMD kernels stop before the last incomplete block, the scalar kernels convert the rest.
+typedef ssize_t (*Kernel)(const unsigned char* data, ssize_t count, unsigned char* outData);
+
+//////////////////////////////////////////////////////////////////////////
+// scalar reference
+
+namespace scalar
+{
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
+static ssize_t convertRGBA8888ToRGB888(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < count; ++i, data += 4)
+    {
+        *outData++ = data[0];         //R
+        *outData++ = data[1];         //G
+        *outData++ = data[2];         //B
+    }
+    return count;
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
+static ssize_t convertRGBA8888ToRGB565(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < count; ++i, data += 4)
+    {
+        *out16++ = (data[0] & 0x00F8) << 8    //R
+            | (data[1] & 0x00FC) << 3         //G
+            | (data[2] & 0x00F8) >> 3;        //B
+    }
+    return count;
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
+static ssize_t convertRGBA8888ToA8(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < count; ++i, data += 4)
+    {
+        *outData++ = data[3];         //A
+    }
+    return count;
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
+static ssize_t convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < count; ++i, data += 4)
+    {
+        *out16++ = (data[0] & 0x00F0) << 8    //R
+            | (data[1] & 0x00F0) << 4         //G
+            | (data[2] & 0xF0)                //B
+            | (data[3] & 0xF0) >> 4;          //A
+    }
+    return count;
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGBBBBBA
+static ssize_t convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < count; ++i, data += 4)
+    {
+        *out16++ = (data[0] & 0x00F8) << 8    //R
+            | (data[1] & 0x00F8) << 3         //G
+            | (data[2] & 0x00F8) >> 2         //B
+            | (data[3] & 0x0080) >> 7;        //A
+    }
+    return count;
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+static ssize_t convertRGB888ToRGBA8888(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < count; ++i, data += 3)
+    {
+        *outData++ = data[0];         //R
+        *outData++ = data[1];         //G
+        *outData++ = data[2];         //B
+        *outData++ = 0xFF;            //A
+    }
+    return count;
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
+static ssize_t convertRGB888ToRGB565(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < count; ++i, data += 3)
+    {
+        *out16++ = (data[0] & 0x00F8) << 8    //R
+            | (data[1] & 0x00FC) << 3         //G
+            | (data[2] & 0x00F8) >> 3;        //B
+    }
+    return count;
+}
+
+// C = C * (A + 1) / 256, like CC_RGB_PREMULTIPLY_ALPHA
+static ssize_t premultiplyAlpha(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < count; ++i, data += 4, outData += 4)
+    {
+        unsigned int alpha = data[3] + 1;
+        outData[0] = (unsigned char)((data[0] * alpha) >> 8);
+        outData[1] = (unsigned char)((data[1] * alpha) >> 8);
+        outData[2] = (unsigned char)((data[2] * alpha) >> 8);
+        outData[3] = data[3];
+    }
+    return count;
+}
+
+} // namespace scalar
+
+#ifdef INCLUDE_SSE
+//////////////////////////////////////////////////////////////////////////
+// SSE2 and SSSE3, pixels are loaded as little endian 32 bit lanes: 0xAABBGGRR
+
+namespace sse
+{
+
+// packs the low 16 bits of the 32 bit lanes of a and b, _mm_packs_epi32 alone would saturate them
+static inline __m128i packLow16(__m128i a, __m128i b)
+{
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+static inline __m128i toRGB565(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x000000F8)), 8);
+    __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x0000FC00)), 5);
+    __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x00F80000)), 19);
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+static inline __m128i toRGBA4444(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x000000F0)), 8);
+    __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x0000F000)), 4);
+    __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x00F00000)), 16);
+    __m128i a = _mm_srli_epi32(p, 28);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+static inline __m128i toRGB5A1(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x000000F8)), 8);
+    __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x0000F800)), 5);
+    __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x00F80000)), 18);
+    __m128i a = _mm_srli_epi32(p, 31);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+static ssize_t convertRGBA8888ToRGB565(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packLow16(toRGB565(p0), toRGB565(p1)));
+    }
+    return i;
+}
+
+static ssize_t convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packLow16(toRGBA4444(p0), toRGBA4444(p1)));
+    }
+    return i;
+}
+
+static ssize_t convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packLow16(toRGB5A1(p0), toRGB5A1(p1)));
+    }
+    return i;
+}
+
+static ssize_t convertRGBA8888ToA8(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i* in = (const __m128i*)(data + i * 4);
+        __m128i a0 = _mm_srli_epi32(_mm_loadu_si128(in), 24);
+        __m128i a1 = _mm_srli_epi32(_mm_loadu_si128(in + 1), 24);
+        __m128i a2 = _mm_srli_epi32(_mm_loadu_si128(in + 2), 24);
+        __m128i a3 = _mm_srli_epi32(_mm_loadu_si128(in + 3), 24);
+        __m128i a = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+        _mm_storeu_si128((__m128i*)(outData + i), a);
+    }
+    return i;
+}
+
+static ssize_t premultiplyAlpha(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    ssize_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(data + i * 4));
+
+        // two pixels per register, one channel per 16 bit lane
+        __m128i lo = _mm_unpacklo_epi8(p, zero);
+        __m128i hi = _mm_unpackhi_epi8(p, zero);
+        __m128i alphaLo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+        __m128i alphaHi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+        __m128i premultipliedLo = _mm_srli_epi16(_mm_mullo_epi16(lo, alphaLo), 8);
+        __m128i premultipliedHi = _mm_srli_epi16(_mm_mullo_epi16(hi, alphaHi), 8);
+
+        // the alpha channel is kept as is
+        lo = _mm_or_si128(_mm_andnot_si128(alphaMask, premultipliedLo), _mm_and_si128(alphaMask, lo));
+        hi = _mm_or_si128(_mm_andnot_si128(alphaMask, premultipliedHi), _mm_and_si128(alphaMask, hi));
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+// 16 RGB888 pixels, in 3 registers, to 4 registers of 32 bit lanes with a zero alpha
+TARGET_SSSE3 static inline void expandRGB888(const unsigned char* data, __m128i* p)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    __m128i in0 = _mm_loadu_si128((const __m128i*)data);
+    __m128i in1 = _mm_loadu_si128((const __m128i*)(data + 16));
+    __m128i in2 = _mm_loadu_si128((const __m128i*)(data + 32));
+    p[0] = _mm_shuffle_epi8(in0, shuffle);
+    p[1] = _mm_shuffle_epi8(_mm_alignr_epi8(in1, in0, 12), shuffle);
+    p[2] = _mm_shuffle_epi8(_mm_alignr_epi8(in2, in1, 8), shuffle);
+    p[3] = _mm_shuffle_epi8(_mm_srli_si128(in2, 4), shuffle);
+}
+
+TARGET_SSSE3 static ssize_t convertRGBA8888ToRGB888(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i* in = (const __m128i*)(data + i * 4);
+        __m128i s0 = _mm_shuffle_epi8(_mm_loadu_si128(in), shuffle);
+        __m128i s1 = _mm_shuffle_epi8(_mm_loadu_si128(in + 1), shuffle);
+        __m128i s2 = _mm_shuffle_epi8(_mm_loadu_si128(in + 2), shuffle);
+        __m128i s3 = _mm_shuffle_epi8(_mm_loadu_si128(in + 3), shuffle);
+
+        // 4 x 12 bytes -> 3 x 16 bytes
+        __m128i* out = (__m128i*)(outData + i * 3);
+        _mm_storeu_si128(out, _mm_or_si128(s0, _mm_slli_si128(s1, 12)));
+        _mm_storeu_si128(out + 1, _mm_or_si128(_mm_srli_si128(s1, 4), _mm_slli_si128(s2, 8)));
+        _mm_storeu_si128(out + 2, _mm_or_si128(_mm_srli_si128(s2, 8), _mm_slli_si128(s3, 4)));
+    }
+    return i;
+}
+
+TARGET_SSSE3 static ssize_t convertRGB888ToRGBA8888(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i p[4];
+        expandRGB888(data + i * 3, p);
+
+        __m128i* out = (__m128i*)(outData + i * 4);
+        _mm_storeu_si128(out, _mm_or_si128(p[0], alpha));
+        _mm_storeu_si128(out + 1, _mm_or_si128(p[1], alpha));
+        _mm_storeu_si128(out + 2, _mm_or_si128(p[2], alpha));
+        _mm_storeu_si128(out + 3, _mm_or_si128(p[3], alpha));
+    }
+    return i;
+}
+
+TARGET_SSSE3 static ssize_t convertRGB888ToRGB565(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i p[4];
+        expandRGB888(data + i * 3, p);
+
+        __m128i* out = (__m128i*)(outData + i * 2);
+        _mm_storeu_si128(out, packLow16(toRGB565(p[0]), toRGB565(p[1])));
+        _mm_storeu_si128(out + 1, packLow16(toRGB565(p[2]), toRGB565(p[3])));
+    }
+    return i;
+}
+
+static bool isSSSE3Supported()
+{
+#if defined (_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSSE3) != 0;
+#endif
+}
+
+} // namespace sse
+
+#define SSE2_KERNEL(__name__) sse::__name__
+#define SSSE3_KERNEL(__name__) sse::__name__
+#else
+#define SSE2_KERNEL(__name__) nullptr
+#define SSSE3_KERNEL(__name__) nullptr
+#endif // INCLUDE_SSE
+
+#ifdef INCLUDE_NEON
+//////////////////////////////////////////////////////////////////////////
+// NEON, vld3/vld4 split the channels in one register each
+
+namespace neon
+{
+
+// RRRRRGGG GGGBBBBB, stored low byte first
+static inline uint8x16x2_t toRGB565(uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+    uint8x16x2_t out;
+    out.val[0] = vorrq_u8(vandq_u8(vshlq_n_u8(g, 3), vdupq_n_u8(0xE0)), vshrq_n_u8(b, 3));
+    out.val[1] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF8)), vshrq_n_u8(g, 5));
+    return out;
+}
+
+static ssize_t convertRGBA8888ToRGB888(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x3_t out;
+        out.val[0] = p.val[0];
+        out.val[1] = p.val[1];
+        out.val[2] = p.val[2];
+        vst3q_u8(outData + i * 3, out);
+    }
+    return i;
+}
+
+static ssize_t convertRGBA8888ToRGB565(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        vst2q_u8(outData + i * 2, toRGB565(p.val[0], p.val[1], p.val[2]));
+    }
+    return i;
+}
+
+static ssize_t convertRGBA8888ToA8(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        vst1q_u8(outData + i, p.val[3]);
+    }
+    return i;
+}
+
+static ssize_t convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    const uint8x16_t mask = vdupq_n_u8(0xF0);
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vandq_u8(p.val[2], mask), vshrq_n_u8(p.val[3], 4));
+        out.val[1] = vorrq_u8(vandq_u8(p.val[0], mask), vshrq_n_u8(p.val[1], 4));
+        vst2q_u8(outData + i * 2, out);
+    }
+    return i;
+}
+
+static ssize_t convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vorrq_u8(vandq_u8(vshlq_n_u8(p.val[1], 3), vdupq_n_u8(0xC0)),
+                                       vandq_u8(vshrq_n_u8(p.val[2], 2), vdupq_n_u8(0x3E))),
+                              vshrq_n_u8(p.val[3], 7));
+        out.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(p.val[1], 5));
+        vst2q_u8(outData + i * 2, out);
+    }
+    return i;
+}
+
+static ssize_t convertRGB888ToRGBA8888(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x3_t p = vld3q_u8(data + i * 3);
+        uint8x16x4_t out;
+        out.val[0] = p.val[0];
+        out.val[1] = p.val[1];
+        out.val[2] = p.val[2];
+        out.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(outData + i * 4, out);
+    }
+    return i;
+}
+
+static ssize_t convertRGB888ToRGB565(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x3_t p = vld3q_u8(data + i * 3);
+        vst2q_u8(outData + i * 2, toRGB565(p.val[0], p.val[1], p.val[2]));
+    }
+    return i;
+}
+
+// C * (A + 1) >> 8 computed as (C * A + C) >> 8
+static inline uint8x16_t premultiply(uint8x16_t c, uint8x16_t a)
+{
+    uint16x8_t lo = vaddw_u8(vmull_u8(vget_low_u8(c), vget_low_u8(a)), vget_low_u8(c));
+    uint16x8_t hi = vaddw_u8(vmull_u8(vget_high_u8(c), vget_high_u8(a)), vget_high_u8(c));
+    return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+}
+
+static ssize_t premultiplyAlpha(const unsigned char* data, ssize_t count, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        p.val[0] = premultiply(p.val[0], p.val[3]);
+        p.val[1] = premultiply(p.val[1], p.val[3]);
+        p.val[2] = premultiply(p.val[2], p.val[3]);
+        vst4q_u8(outData + i * 4, p);
+    }
+    return i;
+}
+
+} // namespace neon
+
+#define NEON_KERNEL(__name__) neon::__name__
+#else
+#define NEON_KERNEL(__name__) nullptr
+#endif // INCLUDE_NEON
+
+//////////////////////////////////////////////////////////////////////////
+// dispatch
+
+static InstructionSet& currentInstructionSet()
+{
+    static InstructionSet instructionSet = getBestInstructionSet();
+    return instructionSet;
+}
+
+static bool isInstructionSetSupported(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case InstructionSet::SCALAR:
+        return true;
+#ifdef INCLUDE_SSE
+    case InstructionSet::SSE2:
+        return true;
+    case InstructionSet::SSSE3:
+        {
+            static bool supported = sse::isSSSE3Supported();
+            return supported;
+        }
+#endif
+#ifdef INCLUDE_NEON
+    case InstructionSet::NEON:
+        return MathUtil::isNeon32Enabled() || MathUtil::isNeon64Enabled();
+#endif
+    default:
+        return false;
+    }
+}
+
+InstructionSet getBestInstructionSet()
+{
+    if (isInstructionSetSupported(InstructionSet::NEON))
+        return InstructionSet::NEON;
+    if (isInstructionSetSupported(InstructionSet::SSSE3))
+        return InstructionSet::SSSE3;
+    if (isInstructionSetSupported(InstructionSet::SSE2))
+        return InstructionSet::SSE2;
+    return InstructionSet::SCALAR;
+}
+
+InstructionSet getInstructionSet()
+{
+    return currentInstructionSet();
+}
+
+bool setInstructionSet(InstructionSet instructionSet)
+{
+    if (!isInstructionSetSupported(instructionSet))
+        return false;
+
+    currentInstructionSet() = instructionSet;
+    return true;
+}
+
+const char* getInstructionSetName(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case InstructionSet::SSE2:
+        return "SSE2";
+    case InstructionSet::SSSE3:
+        return "SSSE3";
+    case InstructionSet::NEON:
+        return "NEON";
+    default:
+        return "scalar";
+    }
+}
+
+// runs the best kernel available for the current instruction set, then the scalar one on the remaining pixels
+static void convert(const unsigned char* data, ssize_t count, unsigned char* outData, int inBytes, int outBytes,
+                    Kernel scalarKernel, Kernel sse2Kernel, Kernel ssse3Kernel, Kernel neonKernel)
+{
+    Kernel kernel = nullptr;
+    switch (currentInstructionSet())
+    {
+    case InstructionSet::SSSE3:
+        kernel = ssse3Kernel ? ssse3Kernel : sse2Kernel;
+        break;
+    case InstructionSet::SSE2:
+        kernel = sse2Kernel;
+        break;
+    case InstructionSet::NEON:
+        kernel = neonKernel;
+        break;
+    default:
+        break;
+    }
+
+    ssize_t converted = kernel ? kernel(data, count, outData) : 0;
+    scalarKernel(data + converted * inBytes, count - converted, outData + converted * outBytes);
+}
+
+void convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convert(data, dataLen / 4, outData, 4, 3, scalar::convertRGBA8888ToRGB888,
+            nullptr, SSSE3_KERNEL(convertRGBA8888ToRGB888), NEON_KERNEL(convertRGBA8888ToRGB888));
+}
+
+void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convert(data, dataLen / 4, outData, 4, 2, scalar::convertRGBA8888ToRGB565,
+            SSE2_KERNEL(convertRGBA8888ToRGB565), nullptr, NEON_KERNEL(convertRGBA8888ToRGB565));
+}
+
+void convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convert(data, dataLen / 4, outData, 4, 1, scalar::convertRGBA8888ToA8,
+            SSE2_KERNEL(convertRGBA8888ToA8), nullptr, NEON_KERNEL(convertRGBA8888ToA8));
+}
+
+void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convert(data, dataLen / 4, outData, 4, 2, scalar::convertRGBA8888ToRGBA4444,
+            SSE2_KERNEL(convertRGBA8888ToRGBA4444), nullptr, NEON_KERNEL(convertRGBA8888ToRGBA4444));
+}
+
+void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convert(data, dataLen / 4, outData, 4, 2, scalar::convertRGBA8888ToRGB5A1,
+            SSE2_KERNEL(convertRGBA8888ToRGB5A1), nullptr, NEON_KERNEL(convertRGBA8888ToRGB5A1));
+}
+
+void convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convert(data, dataLen / 3, outData, 3, 4, scalar::convertRGB888ToRGBA8888,
+            nullptr, SSSE3_KERNEL(convertRGB888ToRGBA8888), NEON_KERNEL(convertRGB888ToRGBA8888));
+}
+
+void convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convert(data, dataLen / 3, outData, 3, 2, scalar::convertRGB888ToRGB565,
+            nullptr, SSSE3_KERNEL(convertRGB888ToRGB565), NEON_KERNEL(convertRGB888ToRGB565));
+}
+
+void premultiplyAlpha(unsigned char* data, ssize_t pixelCount)
+{
+    convert(data, pixelCount, data, 4, 4, scalar::premultiplyAlpha,
+            SSE2_KERNEL(premultiplyAlpha), nullptr, NEON_KERNEL(premultiplyAlpha));
+}
+
+} // namespace PixelConversion
+
+NS_CC_END
@@ -0,0 +1,91 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_PIXEL_CONVERSION_H__
+#define __CC_PIXEL_CONVERSION_H__
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * Pixel format conversions used when loading textures.
+ * Each conversion has a scalar version and SIMD versions (SSE2, SSSE3 or NEON), the best one supported
+ * by the CPU is picked at runtime. All versions give exactly the same result, the scalar one is the reference.
+ *
+ * `dataLen` is the size of the source data in bytes, `outData` must be big enough for the converted pixels.
+ */
+namespace PixelConversion
+{
+    /** Instruction sets the conversions can use. */
+    enum class InstructionSet
+    {
+        SCALAR,
+        SSE2,
+        SSSE3,
+        NEON
+    };
+
+    /** Returns the best instruction set supported by the CPU and the build. */
+    InstructionSet CC_DLL getBestInstructionSet();
+
+    /** Returns the instruction set used by the conversions, the best one unless setInstructionSet() changed it. */
+    InstructionSet CC_DLL getInstructionSet();
+
+    /**
+     * Forces the instruction set used by the conversions, e.g. SCALAR to validate or benchmark the other ones.
+     * An instruction set that isn't supported is ignored, and false is returned.
+     */
+    bool CC_DLL setInstructionSet(InstructionSet instructionSet);
+
+    /** Returns the name of an instruction set, for logs. */
+    const char* CC_DLL getInstructionSetName(InstructionSet instructionSet);
+
+    // RGBA8888 to XXX
+    void CC_DLL convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+    void CC_DLL convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+    void CC_DLL convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+    void CC_DLL convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+    void CC_DLL convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+
+    // RGB888 to XXX
+    void CC_DLL convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+    void CC_DLL convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+
+    /** Premultiplies the color of RGBA8888 pixels by their alpha in place, like CC_RGB_PREMULTIPLY_ALPHA. */
+    void CC_DLL premultiplyAlpha(unsigned char* data, ssize_t pixelCount);
+}
+
+NS_CC_END
+
+// end group
+/// @}
+
+#endif // __CC_PIXEL_CONVERSION_H__
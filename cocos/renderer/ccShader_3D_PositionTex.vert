@@ -14,6 +14,27 @@ void main(void)
 }
 );
 
+const char* cc3D_PositionTexInstanced_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+// per instance attributes
+attribute mat4 a_instanceMatrix;
+attribute vec4 a_instanceColor;
+
+varying vec2 TextureCoordOut;
+varying vec4 ColorOut;
+
+void main(void)
+{
+    gl_Position = CC_PMatrix * a_instanceMatrix * a_position;
+    TextureCoordOut = a_texCoord;
+    TextureCoordOut.y = 1.0 - TextureCoordOut.y;
+    ColorOut = a_instanceColor;
+}
+);
+
 const char* cc3D_SkinPositionTex_vert = STRINGIFY(
 attribute vec3 a_position;
 
@@ -85,4 +106,82 @@ void main()
     TextureCoordOut.y = 1.0 - TextureCoordOut.y;
 }
 
-);
\ No newline at end of file
+);
+const char* cc3D_SkinPositionTexInstanced_vert = STRINGIFY(
+attribute vec3 a_position;
+
+attribute vec4 a_blendWeight;
+attribute vec4 a_blendIndex;
+
+attribute vec2 a_texCoord;
+
+// per instance attributes
+attribute mat4 a_instanceMatrix;
+attribute vec4 a_instanceColor;
+
+const int SKINNING_JOINT_COUNT = 60;
+// Uniforms, the matrix palette is shared by all the instances
+uniform vec4 u_matrixPalette[SKINNING_JOINT_COUNT * 3];
+
+// Varyings
+varying vec2 TextureCoordOut;
+varying vec4 ColorOut;
+
+vec4 getPosition()
+{
+    float blendWeight = a_blendWeight[0];
+
+    int matrixIndex = int (a_blendIndex[0]) * 3;
+    vec4 matrixPalette1 = u_matrixPalette[matrixIndex] * blendWeight;
+    vec4 matrixPalette2 = u_matrixPalette[matrixIndex + 1] * blendWeight;
+    vec4 matrixPalette3 = u_matrixPalette[matrixIndex + 2] * blendWeight;
+    
+    
+    blendWeight = a_blendWeight[1];
+    if (blendWeight > 0.0)
+    {
+        matrixIndex = int(a_blendIndex[1]) * 3;
+        matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
+        matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
+        matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+        
+        blendWeight = a_blendWeight[2];
+        if (blendWeight > 0.0)
+        {
+            matrixIndex = int(a_blendIndex[2]) * 3;
+            matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
+            matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
+            matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+            
+            blendWeight = a_blendWeight[3];
+            if (blendWeight > 0.0)
+            {
+                matrixIndex = int(a_blendIndex[3]) * 3;
+                matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
+                matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
+                matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+            }
+        }
+    }
+
+    vec4 _skinnedPosition;
+    vec4 postion = vec4(a_position, 1.0);
+    _skinnedPosition.x = dot(postion, matrixPalette1);
+    _skinnedPosition.y = dot(postion, matrixPalette2);
+    _skinnedPosition.z = dot(postion, matrixPalette3);
+    _skinnedPosition.w = postion.w;
+    
+    return _skinnedPosition;
+}
+
+void main()
+{
+    vec4 position = getPosition();
+    gl_Position = CC_PMatrix * a_instanceMatrix * position;
+    
+    TextureCoordOut = a_texCoord;
+    TextureCoordOut.y = 1.0 - TextureCoordOut.y;
+    ColorOut = a_instanceColor;
+}
+
+);
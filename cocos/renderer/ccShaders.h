@@ -78,6 +78,9 @@ extern CC_DLL const GLchar * ccLabel_vert;
 extern CC_DLL const GLchar * cc3D_PositionTex_vert;
 extern CC_DLL const GLchar * cc3D_SkinPositionTex_vert;
 extern CC_DLL const GLchar * cc3D_ColorTex_frag;
+extern CC_DLL const GLchar * cc3D_PositionTexInstanced_vert;
+extern CC_DLL const GLchar * cc3D_ColorTexInstanced_frag;
+extern CC_DLL const GLchar * cc3D_SkinPositionTexInstanced_vert;
 extern CC_DLL const GLchar * cc3D_Color_frag;
 extern CC_DLL const GLchar * cc3D_PositionNormalTex_vert;
 extern CC_DLL const GLchar * cc3D_SkinPositionNormalTex_vert;
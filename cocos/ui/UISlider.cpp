@@ -464,6 +464,12 @@ bool Slider::hitTest(const cocos2d::Vec2 &pt, const Camera *camera, Vec3 *p) con
     return isScreenPointInRect(pt, camera, w2l, rect, nullptr) || isScreenPointInRect(pt, camera, barW2l, sliderBarRect, nullptr);
 }
 
+bool Slider::isHitAreaInContentRect() const
+{
+    // the slid ball may stick out of the bar
+    return false;
+}
+
 bool Slider::onTouchBegan(Touch *touch, Event *unusedEvent)
 {
     bool pass = Widget::onTouchBegan(touch, unusedEvent);
@@ -282,6 +282,7 @@ protected:
     virtual void onPressStateChangedToPressed() override;
     virtual void onPressStateChangedToDisabled() override;
     virtual void onSizeChanged() override;
+    virtual bool isHitAreaInContentRect() const override;
 
     void setupBarTexture();
     void loadBarTexture(SpriteFrame* spriteframe);
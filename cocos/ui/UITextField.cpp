@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "ui/UIHelper.h"
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
+#include "base/CCEventListenerTouch.h"
 
 NS_CC_BEGIN
 
@@ -379,6 +380,15 @@ void TextField::setTouchSize(const Size &size)
 void TextField::setTouchAreaEnabled(bool enable)
 {
     _useTouchArea = enable;
+    if (_touchListener)
+    {
+        _touchListener->setBoundedByNode(isHitAreaInContentRect());
+    }
+}
+
+bool TextField::isHitAreaInContentRect() const
+{
+    return !_useTouchArea;
 }
     
 bool TextField::hitTest(const Vec2 &pt, const Camera* camera, Vec3 *p) const
@@ -633,6 +633,7 @@ protected:
     void insertTextEvent();
     void deleteBackwardEvent();
     virtual void onSizeChanged() override;
+    virtual bool isHitAreaInContentRect() const override;
   
     void textfieldRendererScaleChangedWithSize();
     
@@ -584,6 +584,7 @@ void Widget::setTouchEnabled(bool enable)
         _touchListener = EventListenerTouchOneByOne::create();
         CC_SAFE_RETAIN(_touchListener);
         _touchListener->setSwallowTouches(true);
+        _touchListener->setBoundedByNode(isHitAreaInContentRect());
         _touchListener->onTouchBegan = CC_CALLBACK_2(Widget::onTouchBegan, this);
         _touchListener->onTouchMoved = CC_CALLBACK_2(Widget::onTouchMoved, this);
         _touchListener->onTouchEnded = CC_CALLBACK_2(Widget::onTouchEnded, this);
@@ -958,6 +959,11 @@ bool Widget::hitTest(const Vec2 &pt, const Camera* camera, Vec3 *p) const
     return isScreenPointInRect(pt, camera, getWorldToNodeTransform(), rect, p);
 }
 
+bool Widget::isHitAreaInContentRect() const
+{
+    return true;
+}
+
 bool Widget::isClippingParentContainsPoint(const Vec2 &pt)
 {
     _affectByClipping = false;
@@ -894,6 +894,14 @@ protected:
      *@since v3.4
      */
     GLProgramState* getGrayGLProgramState()const;
+    
+    /**
+     * Whether hitTest only succeeds inside the content rect of the widget.
+     * The touch listener of the widget is bounded by the widget then, see EventListenerTouchOneByOne::setBoundedByNode().
+     *@return True if the touches outside of the content rect never hit the widget.
+     *@since v3.10
+     */
+    virtual bool isHitAreaInContentRect() const;
      
     
     //call back function called when size changed.
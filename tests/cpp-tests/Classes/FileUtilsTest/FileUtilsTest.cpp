@@ -1,4 +1,5 @@
 #include "FileUtilsTest.h"
+#include <zlib.h>
 
 USING_NS_CC;
 
@@ -17,6 +18,8 @@ FileUtilsTests::FileUtilsTests()
     ADD_TEST_CASE(TestWriteValueMap);
     ADD_TEST_CASE(TestWriteValueVector);
     ADD_TEST_CASE(TestUnicodePath);
+    ADD_TEST_CASE(TestZipFileData);
+    ADD_TEST_CASE(TestPathIndex);
 }
 
 // TestResolutionDirectories
@@ -956,3 +959,410 @@ std::string TestUnicodePath::subtitle() const
 {
     return "";
 }
+
+// TestZipFileData
+
+namespace
+{
+    void appendShort(std::string& out, unsigned int value)
+    {
+        out.push_back((char)(value & 0xff));
+        out.push_back((char)((value >> 8) & 0xff));
+    }
+
+    void appendLong(std::string& out, unsigned long value)
+    {
+        appendShort(out, (unsigned int)(value & 0xffff));
+        appendShort(out, (unsigned int)((value >> 16) & 0xffff));
+    }
+
+    // Raw deflate stream, as stored in zip entries with method 8.
+    std::string deflateRaw(const std::string& input)
+    {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return "";
+
+        std::string output(deflateBound(&stream, (uLong)input.size()), '\0');
+        stream.next_in = (Bytef*)input.data();
+        stream.avail_in = (uInt)input.size();
+        stream.next_out = (Bytef*)&output[0];
+        stream.avail_out = (uInt)output.size();
+        int err = deflate(&stream, Z_FINISH);
+        output.resize(stream.total_out);
+        deflateEnd(&stream);
+        return err == Z_STREAM_END ? output : "";
+    }
+
+    // A file of the test zip files and directories, deflated only matters in a zip file.
+    struct TestFile
+    {
+        std::string name;
+        std::string content;
+        bool deflated;
+    };
+
+    // Builds a minimal zip archive in memory, without data descriptors or extra fields.
+    std::string buildZip(const std::vector<TestFile>& entries)
+    {
+        std::string zip;
+        std::string central;
+
+        for (const auto& entry : entries)
+        {
+            std::string payload = entry.deflated ? deflateRaw(entry.content) : entry.content;
+            uLong crc = crc32(0L, (const Bytef*)entry.content.data(), (uInt)entry.content.size());
+            unsigned int method = entry.deflated ? 8 : 0;
+            size_t offset = zip.size();
+
+            appendLong(zip, 0x04034b50);
+            appendShort(zip, 20);
+            appendShort(zip, 0);
+            appendShort(zip, method);
+            appendShort(zip, 0);
+            appendShort(zip, 0x21);
+            appendLong(zip, crc);
+            appendLong(zip, payload.size());
+            appendLong(zip, entry.content.size());
+            appendShort(zip, (unsigned int)entry.name.size());
+            appendShort(zip, 0);
+            zip += entry.name;
+            zip += payload;
+
+            appendLong(central, 0x02014b50);
+            appendShort(central, 20);
+            appendShort(central, 20);
+            appendShort(central, 0);
+            appendShort(central, method);
+            appendShort(central, 0);
+            appendShort(central, 0x21);
+            appendLong(central, crc);
+            appendLong(central, payload.size());
+            appendLong(central, entry.content.size());
+            appendShort(central, (unsigned int)entry.name.size());
+            appendShort(central, 0);
+            appendShort(central, 0);
+            appendShort(central, 0);
+            appendShort(central, 0);
+            appendLong(central, 0);
+            appendLong(central, offset);
+            central += entry.name;
+        }
+
+        size_t centralOffset = zip.size();
+        zip += central;
+        appendLong(zip, 0x06054b50);
+        appendShort(zip, 0);
+        appendShort(zip, 0);
+        appendShort(zip, (unsigned int)entries.size());
+        appendShort(zip, (unsigned int)entries.size());
+        appendLong(zip, central.size());
+        appendLong(zip, centralOffset);
+        appendShort(zip, 0);
+        return zip;
+    }
+
+    // Writes the files in a directory, creating their subdirectories.
+    bool writeFiles(const std::string& dirPath, const std::vector<TestFile>& entries)
+    {
+        auto util = FileUtils::getInstance();
+        for (const auto& entry : entries)
+        {
+            std::string fullPath = dirPath + entry.name;
+            if (!util->createDirectory(fullPath.substr(0, fullPath.rfind('/') + 1))
+                || !util->writeStringToFile(entry.content, fullPath))
+                return false;
+        }
+        return true;
+    }
+}
+
+void TestZipFileData::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto s = Director::getInstance()->getWinSize();
+    auto util = FileUtils::getInstance();
+
+    std::string stored = "Hello Cocos2d-x, stored without compression.";
+    std::string deflated;
+    for (int i = 0; i < 64; ++i)
+        deflated += StringUtils::format("line %d of a deflated entry\n", i);
+
+    std::vector<TestFile> entries;
+    entries.push_back({"stored.txt", stored, false});
+    entries.push_back({"dir/deflated.txt", deflated, true});
+    std::string zip = buildZip(entries);
+
+    _zipPath = util->getWritablePath() + "test_zip_file_data.zip";
+    Data zipData;
+    zipData.copy((unsigned char*)zip.data(), zip.size());
+    bool written = util->writeDataToFile(zipData, _zipPath);
+    CCASSERT(written, "failed to write the test zip");
+
+    auto readEntry = [&](const TestFile& entry) -> std::string
+    {
+        ssize_t size = 0;
+        unsigned char* buffer = util->getFileDataFromZip(_zipPath, entry.name, &size);
+        bool match = buffer && size == (ssize_t)entry.content.size()
+            && memcmp(buffer, entry.content.data(), size) == 0;
+        free(buffer);
+        CCASSERT(match, "zip entry content mismatch");
+        log("%s (%s): %s", entry.name.c_str(), entry.deflated ? "deflated" : "stored", match ? "ok" : "mismatch");
+        return StringUtils::format("%s: %s", entry.name.c_str(), match ? "ok" : "mismatch");
+    };
+
+    auto label = Label::createWithSystemFont(readEntry(entries[0]), "", 20);
+    label->setPosition(s.width/2, s.height/3*2);
+    this->addChild(label);
+
+    label = Label::createWithSystemFont(readEntry(entries[1]), "", 20);
+    label->setPosition(s.width/2, s.height/3);
+    this->addChild(label);
+
+    ssize_t missingSize = 0;
+    unsigned char* missing = util->getFileDataFromZip(_zipPath, "missing.txt", &missingSize);
+    CCASSERT(missing == nullptr && missingSize == 0, "missing zip entry should not be found");
+    free(missing);
+}
+
+void TestZipFileData::onExit()
+{
+    auto util = FileUtils::getInstance();
+    ZipArchive::unmount(_zipPath);
+    util->removeFile(_zipPath);
+    FileUtilsDemo::onExit();
+}
+
+std::string TestZipFileData::title() const
+{
+    return "FileUtils: read zip entries";
+}
+
+std::string TestZipFileData::subtitle() const
+{
+    return "Stored and deflated entries via getFileDataFromZip()";
+}
+
+// TestPathIndex
+
+void TestPathIndex::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto s = Director::getInstance()->getWinSize();
+    auto util = FileUtils::getInstance();
+
+    _defaultSearchPathArray = util->getSearchPaths();
+    _defaultResolutionsOrderArray = util->getSearchResolutionsOrder();
+    _defaultPathIndexEnabled = util->isPathIndexEnabled();
+    _rootPath = util->getWritablePath() + "test_path_index/";
+    util->removeDirectory(_rootPath);
+    util->createDirectory(_rootPath);
+
+    // every lookup is done with the path index disabled and enabled, the results must be the same
+    const char* names[] = { "resolution directories", "zip search path", "manifest", "overlay" };
+    bool results[] = { testResolutionDirectories(), testZipSearchPath(), testManifest(), testOverlay() };
+
+    for (int i = 0; i < 4; ++i)
+    {
+        log("TestPathIndex: %s %s", names[i], results[i] ? "ok" : "mismatch");
+        auto label = Label::createWithSystemFont(StringUtils::format("%s: %s", names[i], results[i] ? "ok" : "mismatch"), "", 20);
+        label->setPosition(s.width/2, s.height * (4 - i) / 5);
+        label->setColor(results[i] ? Color3B::GREEN : Color3B::RED);
+        this->addChild(label);
+    }
+}
+
+void TestPathIndex::onExit()
+{
+    auto util = FileUtils::getInstance();
+    util->removeOverlayPath(_rootPath + "overlay");
+    util->setSearchPaths(_defaultSearchPathArray);
+    util->setSearchResolutionsOrder(_defaultResolutionsOrderArray);
+    util->setPathIndexEnabled(_defaultPathIndexEnabled);
+    util->purgeCachedEntries();
+    ZipArchive::unmount(_rootPath + "files.zip");
+    util->removeDirectory(_rootPath);
+    FileUtilsDemo::onExit();
+}
+
+std::vector<std::string> TestPathIndex::lookup(const std::vector<std::string>& filenames, bool indexed)
+{
+    auto util = FileUtils::getInstance();
+    util->setPathIndexEnabled(indexed);
+    util->purgeCachedEntries();
+
+    std::vector<std::string> fullPaths;
+    for (const auto& filename : filenames)
+    {
+        fullPaths.push_back(util->fullPathForFilename(filename));
+        log("%s %s -> %s", indexed ? "indexed" : "not indexed", filename.c_str(), fullPaths.back().c_str());
+    }
+    return fullPaths;
+}
+
+bool TestPathIndex::testResolutionDirectories()
+{
+    auto util = FileUtils::getInstance();
+
+    std::vector<std::string> searchPaths = _defaultSearchPathArray;
+    searchPaths.insert(searchPaths.begin(), "Misc");
+    util->setSearchPaths(searchPaths);
+
+    std::vector<std::string> resolutionsOrder = _defaultResolutionsOrderArray;
+    const char* resolutions[] = { "resources-ipadhd", "resources-ipad", "resources-widehd", "resources-wide", "resources-hd", "resources-iphone" };
+    resolutionsOrder.insert(resolutionsOrder.begin(), std::begin(resolutions), std::end(resolutions));
+    util->setSearchResolutionsOrder(resolutionsOrder);
+
+    std::vector<std::string> filenames;
+    for (int i = 1; i < 7; ++i)
+        filenames.push_back(StringUtils::format("test%d.txt", i));
+    filenames.push_back("Images/grossini.png");
+    filenames.push_back("missing.txt");
+
+    auto fullPaths = lookup(filenames, false);
+    bool ok = fullPaths == lookup(filenames, true);
+
+    util->setSearchPaths(_defaultSearchPathArray);
+    util->setSearchResolutionsOrder(_defaultResolutionsOrderArray);
+    return ok;
+}
+
+bool TestPathIndex::testZipSearchPath()
+{
+    auto util = FileUtils::getInstance();
+
+    // zip files are only searched by the path index, the same files extracted in a directory are searched without it
+    std::vector<TestFile> entries;
+    entries.push_back({"a.txt", "a in the root", false});
+    entries.push_back({"sub/b.txt", "b in a subdirectory", true});
+    entries.push_back({"sub/c.txt", "c without resolution", false});
+    entries.push_back({"sub/res-hd/c.txt", "c in the resolution directory", true});
+
+    std::string dirPath = _rootPath + "files/";
+    std::string zipPath = _rootPath + "files.zip";
+    std::string zip = buildZip(entries);
+    Data zipData;
+    zipData.copy((unsigned char*)zip.data(), zip.size());
+    if (!writeFiles(dirPath, entries) || !util->writeDataToFile(zipData, zipPath))
+        return false;
+
+    std::vector<std::string> resolutionsOrder = _defaultResolutionsOrderArray;
+    resolutionsOrder.insert(resolutionsOrder.begin(), "res-hd");
+    util->setSearchResolutionsOrder(resolutionsOrder);
+
+    std::vector<std::string> filenames = { "a.txt", "sub/b.txt", "sub/c.txt", "missing.txt" };
+
+    std::vector<std::string> searchPaths = _defaultSearchPathArray;
+    searchPaths.insert(searchPaths.begin(), dirPath);
+    util->setSearchPaths(searchPaths);
+    auto dirPaths = lookup(filenames, false);
+    std::vector<std::string> dirContents;
+    for (const auto& fullPath : dirPaths)
+        dirContents.push_back(fullPath.empty() ? "" : util->getStringFromFile(fullPath));
+
+    searchPaths[0] = zipPath;
+    util->setSearchPaths(searchPaths);
+    auto zipPaths = lookup(filenames, true);
+    std::vector<std::string> zipContents;
+    for (const auto& fullPath : zipPaths)
+        zipContents.push_back(fullPath.empty() ? "" : util->getStringFromFile(fullPath));
+
+    bool ok = dirContents == zipContents;
+    for (size_t i = 0; ok && i < filenames.size(); ++i)
+    {
+        // the files have the same path relative to the directory and to the zip file
+        std::string dirName = dirPaths[i].empty() ? "" : dirPaths[i].substr(dirPath.length());
+        std::string zipName = zipPaths[i].empty() ? "" : zipPaths[i].substr(zipPath.length() + 1);
+        ok = dirName == zipName;
+    }
+
+    util->setSearchPaths(_defaultSearchPathArray);
+    util->setSearchResolutionsOrder(_defaultResolutionsOrderArray);
+    return ok && !zipContents[2].empty() && zipContents[2] == entries[3].content;
+}
+
+bool TestPathIndex::testManifest()
+{
+    auto util = FileUtils::getInstance();
+
+    std::vector<TestFile> entries;
+    entries.push_back({"listed.txt", "listed in the manifest", false});
+    entries.push_back({"sub/listed.txt", "listed in the manifest", false});
+    entries.push_back({"unlisted.txt", "added after the manifest was made", false});
+
+    std::string dirPath = _rootPath + "manifest/";
+    std::string manifestPath = _rootPath + "manifest.txt";
+    if (!writeFiles(dirPath, entries)
+        || !util->writeStringToFile("./listed.txt\n./sub/listed.txt\n", manifestPath))
+        return false;
+
+    std::vector<std::string> searchPaths = _defaultSearchPathArray;
+    searchPaths.insert(searchPaths.begin(), dirPath);
+    util->setSearchPaths(searchPaths);
+
+    // a file missing from the manifest is still found on the file system
+    std::vector<std::string> filenames = { "listed.txt", "sub/listed.txt", "unlisted.txt", "missing.txt" };
+    auto fullPaths = lookup(filenames, false);
+    bool loaded = util->loadPathIndexManifest(dirPath, manifestPath);
+    bool ok = loaded && fullPaths == lookup(filenames, true);
+
+    util->setSearchPaths(_defaultSearchPathArray);
+    return ok;
+}
+
+bool TestPathIndex::testOverlay()
+{
+    auto util = FileUtils::getInstance();
+
+    std::string basePath = _rootPath + "base/";
+    std::string overlayPath = _rootPath + "overlay/";
+    std::vector<TestFile> baseFiles;
+    baseFiles.push_back({"patched.txt", "base", false});
+    baseFiles.push_back({"kept.txt", "base", false});
+    std::vector<TestFile> overlayFiles;
+    overlayFiles.push_back({"patched.txt", "overlay", false});
+    if (!writeFiles(basePath, baseFiles) || !writeFiles(overlayPath, overlayFiles))
+        return false;
+
+    std::vector<std::string> searchPaths = _defaultSearchPathArray;
+    searchPaths.insert(searchPaths.begin(), basePath);
+    util->setSearchPaths(searchPaths);
+
+    std::vector<std::string> filenames = { "patched.txt", "kept.txt", "added.txt" };
+    bool ok = true;
+    for (int indexed = 0; indexed < 2 && ok; ++indexed)
+    {
+        util->addOverlayPath(overlayPath);
+        auto overlaid = lookup(filenames, indexed != 0);
+
+        util->removeOverlayPath(overlayPath);
+        auto removed = lookup(filenames, indexed != 0);
+
+        // a file added while the overlay is removed is found once it is added back
+        util->writeStringToFile("overlay", overlayPath + "added.txt");
+        util->addOverlayPath(overlayPath);
+        auto readded = lookup(filenames, indexed != 0);
+
+        util->removeOverlayPath(overlayPath);
+        util->removeFile(overlayPath + "added.txt");
+
+        ok = overlaid[0] == overlayPath + "patched.txt" && overlaid[1] == basePath + "kept.txt" && overlaid[2].empty()
+            && removed[0] == basePath + "patched.txt" && removed[1] == basePath + "kept.txt" && removed[2].empty()
+            && readded[0] == overlayPath + "patched.txt" && readded[1] == basePath + "kept.txt"
+            && readded[2] == overlayPath + "added.txt";
+    }
+
+    util->setSearchPaths(_defaultSearchPathArray);
+    return ok;
+}
+
+std::string TestPathIndex::title() const
+{
+    return "FileUtils: path index";
+}
+
+std::string TestPathIndex::subtitle() const
+{
+    return "Lookups with the path index enabled and disabled should match";
+}
@@ -146,6 +146,41 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class TestZipFileData : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestZipFileData);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::string _zipPath;
+};
+
+class TestPathIndex : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestPathIndex);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::vector<std::string> lookup(const std::vector<std::string>& filenames, bool indexed);
+    bool testResolutionDirectories();
+    bool testZipSearchPath();
+    bool testManifest();
+    bool testOverlay();
+
+    std::string _rootPath;
+    std::vector<std::string> _defaultSearchPathArray;
+    std::vector<std::string> _defaultResolutionsOrderArray;
+    bool _defaultPathIndexEnabled;
+};
+
 class TestUnicodePath : public FileUtilsDemo
 {
 public:
@@ -2,6 +2,8 @@
 #include "../testResource.h"
 #include "renderer/CCRenderer.h"
 #include "2d/CCFontAtlasCache.h"
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontFreeType.h"
 
 USING_NS_CC;
 using namespace ui;
@@ -97,6 +99,7 @@ NewLabelTests::NewLabelTests()
     ADD_TEST_CASE(LabelToggleTypeTest);
     ADD_TEST_CASE(LabelSystemFontTest);
     ADD_TEST_CASE(LabelCharMapFontTest);
+    ADD_TEST_CASE(LabelPersistentAtlasTest);
 };
 
 LabelFNTColorAndOpacity::LabelFNTColorAndOpacity()
@@ -2750,3 +2753,161 @@ std::string LabelCharMapFontTest::subtitle() const
 {
     return "";
 }
+
+// LabelPersistentAtlasTest
+
+namespace
+{
+    // ASCII fills more than a page at this size, the Latin-1 letters are added after the atlas is read back
+    const float kPersistentFontSize = 71;
+
+    std::u16string persistentLetters(char16_t first, char16_t last)
+    {
+        std::u16string letters;
+        for (char16_t letter = first; letter <= last; ++letter)
+            letters.push_back(letter);
+        return letters;
+    }
+
+    // The letter definitions, page count and kerning of the atlas, to compare two atlases.
+    std::string describeAtlas(FontAtlas* atlas, const std::u16string& text)
+    {
+        std::stringstream ss;
+        ss.precision(9);
+        ss << "pages:" << atlas->getTextures().size();
+        for (auto letter : text)
+        {
+            FontLetterDefinition definition;
+            bool valid = atlas->getLetterDefinitionForChar(letter, definition);
+            ss << '|' << static_cast<int>(letter) << ':' << valid;
+            if (valid)
+            {
+                ss << ',' << definition.U << ',' << definition.V << ',' << definition.width << ',' << definition.height
+                    << ',' << definition.offsetX << ',' << definition.offsetY << ',' << definition.textureID
+                    << ',' << definition.xAdvance;
+            }
+        }
+
+        int count = 0;
+        int* kerning = atlas->getFont()->getHorizontalKerningForTextUTF16(text, count);
+        ss << "|kerning";
+        for (int i = 0; kerning && i < count; ++i)
+            ss << ',' << kerning[i];
+        delete [] kerning;
+        return ss.str();
+    }
+}
+
+LabelPersistentAtlasTest::LabelPersistentAtlasTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    bool wasEnabled = FontAtlasCache::isPersistentCacheEnabled();
+    auto util = FileUtils::getInstance();
+    util->removeDirectory(FontAtlasCache::getPersistentCachePath());
+
+    bool roundTrip = testRoundTrip();
+    bool invalidFiles = testInvalidFiles();
+
+    FontAtlasCache::setPersistentCacheEnabled(wasEnabled);
+    util->removeDirectory(FontAtlasCache::getPersistentCachePath());
+
+    CCASSERT(roundTrip, "the persisted atlas should be read back as it was written");
+    CCASSERT(invalidFiles, "truncated or outdated atlas files should be ignored");
+
+    auto label = Label::createWithSystemFont(StringUtils::format("round trip: %s", roundTrip ? "ok" : "mismatch"), "", 20);
+    label->setPosition(s.width/2, s.height/2 + 20);
+    label->setColor(roundTrip ? Color3B::GREEN : Color3B::RED);
+    addChild(label);
+
+    label = Label::createWithSystemFont(StringUtils::format("invalid files: %s", invalidFiles ? "ignored" : "read"), "", 20);
+    label->setPosition(s.width/2, s.height/2 - 20);
+    label->setColor(invalidFiles ? Color3B::GREEN : Color3B::RED);
+    addChild(label);
+}
+
+bool LabelPersistentAtlasTest::testRoundTrip()
+{
+    TTFConfig config("fonts/arial.ttf", kPersistentFontSize);
+    std::u16string saved = persistentLetters(0x20, 0x7e);
+    std::u16string added = persistentLetters(0xa1, 0xff);
+    std::u16string all = saved + added;
+
+    // the atlas as it is built without the persistent cache
+    FontAtlasCache::setPersistentCacheEnabled(false);
+    auto atlas = FontAtlasCache::getFontAtlasTTF(&config);
+    if (!atlas)
+        return false;
+    atlas->prepareLetterDefinitions(saved);
+    std::string expectedSaved = describeAtlas(atlas, saved);
+    atlas->prepareLetterDefinitions(added);
+    std::string expectedAll = describeAtlas(atlas, all);
+    FontAtlasCache::releaseFontAtlas(atlas);
+
+    // written when the atlas is released
+    FontAtlasCache::setPersistentCacheEnabled(true);
+    atlas = FontAtlasCache::getFontAtlasTTF(&config);
+    atlas->prepareLetterDefinitions(saved);
+    FontAtlasCache::releaseFontAtlas(atlas);
+
+    // read back, the letters added afterwards must be packed where they would have been without it
+    atlas = FontAtlasCache::getFontAtlasTTF(&config);
+    std::string loadedSaved = describeAtlas(atlas, saved);
+    atlas->prepareLetterDefinitions(added);
+    std::string loadedAll = describeAtlas(atlas, all);
+    FontAtlasCache::releaseFontAtlas(atlas);
+
+    log("LabelPersistentAtlasTest: saved letters %s, all letters %s",
+        loadedSaved == expectedSaved ? "match" : "differ", loadedAll == expectedAll ? "match" : "differ");
+    return loadedSaved == expectedSaved && loadedAll == expectedAll;
+}
+
+bool LabelPersistentAtlasTest::testInvalidFiles()
+{
+    auto util = FileUtils::getInstance();
+    std::string fullPath = FontAtlasCache::getPersistentCachePath() + "invalid.ccfa";
+    std::u16string letters = persistentLetters(0x20, 0x7e);
+
+    // the atlas is read when it is created, a new font is needed for every attempt
+    auto createAtlas = [&](const std::string& key) -> FontAtlas* {
+        auto font = FontFreeType::create("fonts/arial.ttf", kPersistentFontSize, GlyphCollection::DYNAMIC, nullptr);
+        if (!font)
+            return nullptr;
+        font->setPersistentAtlasFile(fullPath, key);
+        return font->createFontAtlas();
+    };
+    auto isEmpty = [&](FontAtlas* atlas) {
+        FontLetterDefinition definition;
+        bool empty = atlas && !atlas->getLetterDefinitionForChar(u'A', definition) && atlas->getTextures().size() == 1;
+        CC_SAFE_RELEASE(atlas);
+        return empty;
+    };
+
+    auto atlas = createAtlas("key");
+    if (!atlas)
+        return false;
+    atlas->prepareLetterDefinitions(letters);
+    bool saved = atlas->savePersistentFile();
+    atlas->release();
+
+    bool wrongKey = isEmpty(createAtlas("other key"));
+
+    Data data = util->getDataFromFile(fullPath);
+    Data truncated;
+    truncated.copy(data.getBytes(), data.getSize() / 2);
+    util->writeDataToFile(truncated, fullPath);
+    bool truncatedFile = isEmpty(createAtlas("key"));
+
+    log("LabelPersistentAtlasTest: saved %d, wrong key ignored %d, truncated file ignored %d", saved, wrongKey, truncatedFile);
+    return saved && !data.isNull() && wrongKey && truncatedFile;
+}
+
+std::string LabelPersistentAtlasTest::title() const
+{
+    return "Persistent font atlas";
+}
+
+std::string LabelPersistentAtlasTest::subtitle() const
+{
+    return "An atlas read back from its file should match the one that was saved";
+}
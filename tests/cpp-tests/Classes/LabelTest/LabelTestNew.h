@@ -614,6 +614,21 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class LabelPersistentAtlasTest : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelPersistentAtlasTest);
+
+    LabelPersistentAtlasTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    bool testRoundTrip();
+    bool testInvalidFiles();
+};
+
 class LabelIssue13202Test : public AtlasDemoNew
 {
 public:
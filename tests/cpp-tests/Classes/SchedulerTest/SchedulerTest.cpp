@@ -29,6 +29,7 @@ SchedulerTests::SchedulerTests()
     ADD_TEST_CASE(ScheduleCallbackTest);
     ADD_TEST_CASE(ScheduleUpdatePriority);
     ADD_TEST_CASE(SchedulerIssue10232);
+    ADD_TEST_CASE(SchedulerTimerQueuePause);
 };
 
 //------------------------------------------------------------------
@@ -1148,3 +1149,75 @@ std::string SchedulerIssue10232::subtitle() const
 {
     return "Should not crash";
 }
+
+// SchedulerTimerQueuePause
+
+void SchedulerTimerQueuePause::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    float first = 0, second = 0;
+    float queuedFirst = 0, queuedSecond = 0;
+    runPausedTimer(false, &first, &second);
+    runPausedTimer(true, &queuedFirst, &queuedSecond);
+
+    bool ok = first == queuedFirst && second == queuedSecond;
+    CCASSERT(ok, "The timer queue should trigger a timer paused by its callback like the per frame update");
+    log("SchedulerTimerQueuePause: per frame %f %f, timer queue %f %f", first, second, queuedFirst, queuedSecond);
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithSystemFont(StringUtils::format("per frame: %.3f, %.3f", first, second), "", 20);
+    label->setPosition(s.width/2, s.height/2 + 20);
+    addChild(label);
+
+    label = Label::createWithSystemFont(StringUtils::format("timer queue: %.3f, %.3f", queuedFirst, queuedSecond), "", 20);
+    label->setPosition(s.width/2, s.height/2 - 20);
+    label->setColor(ok ? Color3B::GREEN : Color3B::RED);
+    addChild(label);
+}
+
+void SchedulerTimerQueuePause::runPausedTimer(bool timerQueueEnabled, float* firstTrigger, float* secondTrigger)
+{
+    // the scheduler is stepped by hand, so both runs see exactly the same frames
+    auto scheduler = new (std::nothrow) Scheduler();
+    scheduler->setTimerQueueEnabled(timerQueueEnabled);
+
+    const float frame = 0.125f;
+    float now = 0;
+    int triggers = 0;
+    scheduler->schedule([&](float dt) {
+        if (triggers++ == 0)
+        {
+            *firstTrigger = now;
+            // pause its own target, the paused time must not count towards the next trigger
+            scheduler->pauseTarget(this);
+        }
+        else if (triggers == 2)
+        {
+            *secondTrigger = now;
+        }
+    }, this, 1.0f, false, "timer");
+
+    for (int i = 0; i < 40; ++i)
+    {
+        now += frame;
+        if (i == 11)
+        {
+            scheduler->resumeTarget(this);
+        }
+        scheduler->update(frame);
+    }
+
+    scheduler->unscheduleAllForTarget(this);
+    scheduler->release();
+}
+
+std::string SchedulerTimerQueuePause::title() const
+{
+    return "Timer queue: pause from callback";
+}
+
+std::string SchedulerTimerQueuePause::subtitle() const
+{
+    return "Both lines should show the same trigger times";
+}
@@ -326,4 +326,18 @@ public:
     void update(float dt) override;
 };
 
+class SchedulerTimerQueuePause : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerTimerQueuePause);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onEnter() override;
+
+private:
+    void runPausedTimer(bool timerQueueEnabled, float* firstTrigger, float* secondTrigger);
+};
+
 #endif
@@ -49,6 +49,7 @@ Sprite3DTests::Sprite3DTests()
     ADD_TEST_CASE(Sprite3DLightMapTest);
     ADD_TEST_CASE(Sprite3DWithSkinTest);
     ADD_TEST_CASE(Sprite3DWithSkinOutlineTest);
+    ADD_TEST_CASE(Sprite3DInstancingTest);
     ADD_TEST_CASE(Animate3DTest);
     ADD_TEST_CASE(AttachmentTest);
     ADD_TEST_CASE(Sprite3DReskinTest);
@@ -2586,6 +2587,142 @@ std::string Sprite3DNormalMappingTest::subtitle() const
     return "";
 }
 
+static const int INSTANCING_CROWD_ROWS = 5;
+static const int INSTANCING_CROWD_COLUMNS = 8;
+
+Sprite3DInstancingTest::Sprite3DInstancingTest()
+: _afterDrawListener(nullptr)
+, _menuItem(nullptr)
+, _resultLabel(nullptr)
+, _measureState(MeasureState::WAITING)
+, _batchesWithoutInstancing(0)
+, _instancingEnabled(true)
+{
+    auto s = Director::getInstance()->getWinSize();
+    float stepX = s.width / 2 / INSTANCING_CROWD_COLUMNS;
+    float stepY = s.height * 0.6f / INSTANCING_CROWD_ROWS;
+
+    // a crowd of static meshes on the left, every one of them uses the same vertex data, texture and shader
+    for (int row = 0; row < INSTANCING_CROWD_ROWS; ++row)
+    {
+        for (int column = 0; column < INSTANCING_CROWD_COLUMNS; ++column)
+        {
+            auto ship = Sprite3D::create("Sprite3DTest/boss1.obj");
+            ship->setTexture("Sprite3DTest/boss.png");
+            ship->setScale(1.5f);
+            ship->setPosition(stepX * (column + 0.5f), s.height * 0.2f + stepY * (row + 0.5f));
+            addChild(ship);
+        }
+    }
+
+    // a crowd of skinned meshes on the right, their animations start in the same frame and
+    // run at the same speed so they share one pose
+    std::string fileName = "Sprite3DTest/orc.c3b";
+    auto animation = Animation3D::create(fileName);
+    for (int row = 0; row < INSTANCING_CROWD_ROWS; ++row)
+    {
+        for (int column = 0; column < INSTANCING_CROWD_COLUMNS; ++column)
+        {
+            auto orc = Sprite3D::create(fileName);
+            orc->setScale(1.5f);
+            orc->setRotation3D(Vec3(0, 180, 0));
+            orc->setPosition(s.width / 2 + stepX * (column + 0.5f), s.height * 0.2f + stepY * row);
+            addChild(orc);
+            if (animation)
+                orc->runAction(RepeatForever::create(Animate3D::create(animation)));
+        }
+    }
+
+    MenuItemFont::setFontName("fonts/arial.ttf");
+    MenuItemFont::setFontSize(15);
+    _menuItem = MenuItemFont::create("", CC_CALLBACK_1(Sprite3DInstancingTest::switchInstancingCallback, this));
+    _menuItem->setColor(Color3B(0, 200, 20));
+    auto menu = Menu::create(_menuItem, nullptr);
+    menu->setPosition(Vec2::ZERO);
+    _menuItem->setPosition(VisibleRect::left().x + 70, VisibleRect::top().y - 70);
+    addChild(menu, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 12);
+    _resultLabel->setPosition(VisibleRect::center().x, VisibleRect::bottom().y + 30);
+    addChild(_resultLabel, 1);
+}
+
+Sprite3DInstancingTest::~Sprite3DInstancingTest()
+{
+}
+
+std::string Sprite3DInstancingTest::title() const
+{
+    return "Instanced Sprite3D";
+}
+
+std::string Sprite3DInstancingTest::subtitle() const
+{
+    return "Crowds of static and skinned meshes";
+}
+
+void Sprite3DInstancingTest::onEnter()
+{
+    Sprite3DTestDemo::onEnter();
+
+    auto renderer = Director::getInstance()->getRenderer();
+    _instancingEnabled = renderer->isInstancingEnabled();
+    _menuItem->setString(_instancingEnabled ? "Instancing: On" : "Instancing: Off");
+
+    _afterDrawListener = _eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, CC_CALLBACK_1(Sprite3DInstancingTest::onAfterDraw, this));
+
+    // let the scene settle before counting the draw calls
+    scheduleOnce([this](float) {
+        _measureState = MeasureState::WITHOUT_INSTANCING;
+        Director::getInstance()->getRenderer()->setInstancingEnabled(false);
+    }, 0.5f, "measure_instancing");
+}
+
+void Sprite3DInstancingTest::onExit()
+{
+    _eventDispatcher->removeEventListener(_afterDrawListener);
+    _afterDrawListener = nullptr;
+    Director::getInstance()->getRenderer()->setInstancingEnabled(_instancingEnabled);
+
+    Sprite3DTestDemo::onExit();
+}
+
+void Sprite3DInstancingTest::switchInstancingCallback(Ref* sender)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setInstancingEnabled(!renderer->isInstancingEnabled());
+    _menuItem->setString(renderer->isInstancingEnabled() ? "Instancing: On" : "Instancing: Off");
+}
+
+void Sprite3DInstancingTest::onAfterDraw(EventCustom* event)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    if (_measureState == MeasureState::WITHOUT_INSTANCING)
+    {
+        _batchesWithoutInstancing = renderer->getDrawnBatches();
+        _measureState = MeasureState::WITH_INSTANCING;
+        renderer->setInstancingEnabled(true);
+    }
+    else if (_measureState == MeasureState::WITH_INSTANCING)
+    {
+        ssize_t batchesWithInstancing = renderer->getDrawnBatches();
+        _measureState = MeasureState::DONE;
+
+        auto result = StringUtils::format("GL calls: %d without instancing, %d with instancing",
+                                          (int)_batchesWithoutInstancing, (int)batchesWithInstancing);
+        CCLOG("Sprite3DInstancingTest: %s", result.c_str());
+        _resultLabel->setString(result);
+
+        // the meshes of each crowd collapse into one draw call per mesh of the model,
+        // unless the GL context doesn't support instanced arrays
+        const ssize_t crowdSize = INSTANCING_CROWD_ROWS * INSTANCING_CROWD_COLUMNS;
+        CCASSERT(!renderer->isInstancingEnabled() || _batchesWithoutInstancing - batchesWithInstancing >= 2 * (crowdSize - 1),
+                 "the crowds should be drawn with instanced draw calls");
+
+        renderer->setInstancingEnabled(_instancingEnabled);
+    }
+}
+
 Sprite3DPropertyTest::Sprite3DPropertyTest()
 {
     auto s = Director::getInstance()->getWinSize();
@@ -595,6 +595,38 @@ public:
     virtual ~Sprite3DNormalMappingTest();
 };
 
+class Sprite3DInstancingTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DInstancingTest);
+    Sprite3DInstancingTest();
+    virtual ~Sprite3DInstancingTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    void switchInstancingCallback(cocos2d::Ref* sender);
+    void onAfterDraw(cocos2d::EventCustom* event);
+
+protected:
+    // draw calls are counted for one frame without instancing, then for one frame with it
+    enum class MeasureState
+    {
+        WAITING,
+        WITHOUT_INSTANCING,
+        WITH_INSTANCING,
+        DONE,
+    };
+
+    cocos2d::EventListenerCustom* _afterDrawListener;
+    cocos2d::MenuItemFont* _menuItem;
+    cocos2d::Label* _resultLabel;
+    MeasureState _measureState;
+    ssize_t _batchesWithoutInstancing;
+    bool _instancingEnabled; // renderer setting when the test was entered, restored on exit
+};
+
 class Sprite3DPropertyTest : public Sprite3DTestDemo
 {
 public:
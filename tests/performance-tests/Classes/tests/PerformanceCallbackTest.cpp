@@ -40,6 +40,8 @@ PerformceCallbackTests::PerformceCallbackTests()
     ADD_TEST_CASE(SimulateNewSchedulerCallbackPerfTest);
     ADD_TEST_CASE(InvokeMemberFunctionPerfTest);
     ADD_TEST_CASE(InvokeStdFunctionPerfTest);
+    ADD_TEST_CASE(SchedulerTimerDensityPerfTest);
+    ADD_TEST_CASE(SchedulerTimerQueuePerfTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -183,3 +185,58 @@ void InvokeStdFunctionPerfTest::onUpdate(float dt)
     }
     CC_PROFILER_STOP(_profileName.c_str());
 }
+
+// SchedulerTimerDensityPerfTest
+
+SchedulerTimerDensityPerfTest::SchedulerTimerDensityPerfTest()
+: _timerScheduler(nullptr)
+{
+}
+
+void SchedulerTimerDensityPerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = isTimerQueueEnabled() ? "SchedulerTimerQueue" : "SchedulerTimerDensity";
+
+    // A scheduler of its own, so only the test timers are measured.
+    // Most of them trigger every few seconds, like UI and gameplay timers.
+    _timerScheduler = new (std::nothrow) Scheduler();
+    _timerScheduler->setTimerQueueEnabled(isTimerQueueEnabled());
+    _timerTargets.resize(TIMER_COUNT);
+    for (int i = 0; i < TIMER_COUNT; ++i)
+    {
+        _timerScheduler->schedule([this](float dt){
+            ++_placeHolder;
+        }, &_timerTargets[i], 1.0f + (i % 40) * 0.1f, false, "timer");
+    }
+}
+
+void SchedulerTimerDensityPerfTest::onExit()
+{
+    CC_SAFE_RELEASE_NULL(_timerScheduler);
+    PerformanceCallbackScene::onExit();
+}
+
+std::string SchedulerTimerDensityPerfTest::title() const
+{
+    return "Scheduler timers perf test";
+}
+
+std::string SchedulerTimerDensityPerfTest::subtitle() const
+{
+    return StringUtils::format("%d timers, 1 to 5 seconds interval. See console", TIMER_COUNT);
+}
+
+void SchedulerTimerDensityPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    _timerScheduler->update(dt);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+// SchedulerTimerQueuePerfTest
+
+std::string SchedulerTimerQueuePerfTest::title() const
+{
+    return "Scheduler timer queue perf test";
+}
@@ -90,4 +90,40 @@ private:
     std::function<void(float)> _callback;
 };
 
+// SchedulerTimerDensityPerfTest
+class SchedulerTimerDensityPerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(SchedulerTimerDensityPerfTest);
+
+    SchedulerTimerDensityPerfTest();
+
+    // overrides
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+protected:
+    virtual bool isTimerQueueEnabled() const { return false; }
+
+    static const int TIMER_COUNT = 20000;
+
+    cocos2d::Scheduler* _timerScheduler;
+    std::vector<int> _timerTargets;
+};
+
+// SchedulerTimerQueuePerfTest
+class SchedulerTimerQueuePerfTest : public SchedulerTimerDensityPerfTest
+{
+public:
+    CREATE_FUNC(SchedulerTimerQueuePerfTest);
+
+    virtual std::string title() const override;
+
+protected:
+    virtual bool isTimerQueueEnabled() const override { return true; }
+};
+
 #endif /* __PERFORMANCE_CALLBACK_TEST_H__ */
@@ -254,6 +254,8 @@ void PerformanceEventDispatcherScene::reset()
     
     _nodes.clear();
     
+    Director::getInstance()->getEventDispatcher()->setTouchBroadphaseEnabled(false);
+    
     // Removes all fixed listeners
     for (auto& listener : _fixedPriorityListeners)
     {
@@ -362,6 +364,64 @@ const char*  PerformanceEventDispatcherScene::testName()
 
 void TouchEventDispatchingPerfTest::generateTestFunctions()
 {
+    // listeners on nodes spread over the screen, which only claim the touches inside of their node like ui::Widget
+    auto boundedTest = [=](bool broadphase) -> std::function<void()> {
+        return [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            Size size = Director::getInstance()->getWinSize();
+            if (quantityOfNodes != _lastRenderedCount)
+            {
+                auto listener = EventListenerTouchOneByOne::create();
+                listener->onTouchBegan = [](Touch* touch, Event* event){
+                    auto target = event->getCurrentTarget();
+                    Vec2 location = target->convertToNodeSpace(touch->getLocation());
+                    Rect rect(Vec2::ZERO, target->getContentSize());
+                    return rect.containsPoint(location);
+                };
+                
+                listener->onTouchMoved = [](Touch* touch, Event* event){};
+                listener->onTouchEnded = [](Touch* touch, Event* event){};
+                listener->setBoundedByNode(true);
+                
+                // Create new touchable nodes
+                for (int i = 0; i < this->quantityOfNodes; ++i)
+                {
+                    auto node = Node::create();
+                    node->setTag(1000 + i);
+                    node->setContentSize(Size(40, 40));
+                    node->setPosition(Vec2(rand() % (int)size.width, rand() % (int)size.height));
+                    this->addChild(node);
+                    this->_nodes.push_back(node);
+                    dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+                }
+                
+                _lastRenderedCount = quantityOfNodes;
+            }
+            dispatcher->setTouchBroadphaseEnabled(broadphase);
+            
+            EventTouch touchEvent;
+            touchEvent.setEventCode(EventTouch::EventCode::BEGAN);
+            std::vector<Touch*> touches;
+            
+            for (int i = 0; i < 4; ++i)
+            {
+                Touch* touch = new (std::nothrow) Touch();
+                touch->autorelease();
+                touch->setTouchInfo(i, rand() % (int)size.width, rand() % (int)size.height);
+                touches.push_back(touch);
+            }
+            touchEvent.setTouches(touches);
+            
+            CC_PROFILER_START(this->profilerName());
+            dispatcher->dispatchEvent(&touchEvent);
+            CC_PROFILER_STOP(this->profilerName());
+            
+            // the claimed touches end at once
+            touchEvent.setEventCode(EventTouch::EventCode::ENDED);
+            dispatcher->dispatchEvent(&touchEvent);
+        };
+    };
+    
     TestFunction testFunctions[] = {
         { "OneByOne-scenegraph",    [=](){
             auto dispatcher = Director::getInstance()->getEventDispatcher();
@@ -640,6 +700,10 @@ void TouchEventDispatchingPerfTest::generateTestFunctions()
             dispatcher->dispatchEvent(&touchEvent);
             CC_PROFILER_STOP(this->profilerName());
         } } ,
+        
+        { "OneByOne-bounded",    boundedTest(false) } ,
+        
+        { "OneByOne-broadphase",    boundedTest(true) } ,
     };
     
     for (const auto& func : testFunctions)
@@ -764,6 +828,26 @@ void CustomEventDispatchingPerfTest::onExit()
     PerformanceEventDispatcherScene::onExit();
 }
 
+void CustomEventDispatchingPerfTest::addManyEventListeners()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _eventNames.clear();
+    _eventIDs.clear();
+    
+    // one listener for each event, like gameplay code firing many different events
+    for (int i = 0; i < this->quantityOfNodes; ++i)
+    {
+        _eventNames.push_back(StringUtils::format("custom_many_events_%d", i));
+        _eventIDs.push_back(dispatcher->registerCustomEventID(_eventNames.back()));
+        
+        auto l = EventListenerCustom::create(_eventNames.back(), [](EventCustom* event){});
+        this->_fixedPriorityListeners.push_back(l);
+        dispatcher->addEventListenerWithFixedPriority(l, 1);
+    }
+    
+    _lastRenderedCount = quantityOfNodes;
+}
+
 void CustomEventDispatchingPerfTest::generateTestFunctions()
 {
     TestFunction testFunctions[] = {
@@ -814,6 +898,34 @@ void CustomEventDispatchingPerfTest::generateTestFunctions()
             dispatcher->dispatchEvent(&event);
             CC_PROFILER_STOP(this->profilerName());
         } } ,
+        { "custom-many-by-name",    [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            if (quantityOfNodes != _lastRenderedCount)
+            {
+                addManyEventListeners();
+            }
+            
+            CC_PROFILER_START(this->profilerName());
+            for (const auto& name : _eventNames)
+            {
+                dispatcher->dispatchCustomEvent(name);
+            }
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
+        { "custom-many-by-id",    [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            if (quantityOfNodes != _lastRenderedCount)
+            {
+                addManyEventListeners();
+            }
+            
+            CC_PROFILER_START(this->profilerName());
+            for (int eventID : _eventIDs)
+            {
+                dispatcher->dispatchCustomEvent(eventID);
+            }
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
     };
     
     for (const auto& func : testFunctions)
@@ -99,7 +99,11 @@ public:
     virtual std::string subtitle() const override;
     
 private:
+    void addManyEventListeners();
+    
     std::vector<cocos2d::EventListener*> _customListeners;
+    std::vector<std::string> _eventNames;
+    std::vector<int> _eventIDs;
 };
 
 #endif /* defined(__PERFORMANCE_EVENTDISPATCHER_TEST_H__) */
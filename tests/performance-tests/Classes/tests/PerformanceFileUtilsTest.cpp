@@ -0,0 +1,159 @@
+#include "PerformanceFileUtilsTest.h"
+#include "Profile.h"
+#include "base/CCAsyncFileLoader.h"
+
+USING_NS_CC;
+
+PerformceFileUtilsTests::PerformceFileUtilsTests()
+{
+    ADD_TEST_CASE(FileUtilsAsyncLoadingPerformceTest);
+}
+
+static float calculateDeltaTime(struct timeval *lastUpdate)
+{
+    struct timeval now;
+
+    gettimeofday(&now, nullptr);
+
+    float dt = (now.tv_sec - lastUpdate->tv_sec) + (now.tv_usec - lastUpdate->tv_usec) / 1000000.0f;
+
+    return dt;
+}
+
+////////////////////////////////////////////////////////
+//
+// FileUtilsAsyncLoadingPerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kSmallFileCount = 1000;
+static const int kSmallFileSize = 2048;
+static const int kAsyncThreadCounts[] = { 1, 2, 4, 8 };
+
+FileUtilsAsyncLoadingPerformceTest::FileUtilsAsyncLoadingPerformceTest()
+: _runIndex(0)
+, _loadedCount(0)
+, _loadedBytes(0)
+, _defaultThreadCount(0)
+{
+}
+
+void FileUtilsAsyncLoadingPerformceTest::prepareFiles()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string directory = fileUtils->getWritablePath() + "async_files/";
+    fileUtils->createDirectory(directory);
+
+    std::string content(kSmallFileSize, 'x');
+    _files.clear();
+    for (int i = 0; i < kSmallFileCount; ++i)
+    {
+        auto path = StringUtils::format("%sfile_%04d.txt", directory.c_str(), i);
+        if (!fileUtils->isFileExist(path))
+        {
+            fileUtils->writeStringToFile(content, path);
+        }
+        _files.push_back(path);
+    }
+}
+
+void FileUtilsAsyncLoadingPerformceTest::runSync()
+{
+    auto fileUtils = FileUtils::getInstance();
+    ssize_t bytes = 0;
+
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    for (const auto& file : _files)
+    {
+        bytes += fileUtils->getDataFromFile(file).getSize();
+    }
+    auto dt = calculateDeltaTime(&now);
+
+    log("%d files, synchronous  ms:%f  (%d bytes)", kSmallFileCount, dt * 1000, (int)bytes);
+    if (isAutoTesting())
+        Profile::getInstance()->addTestResult(genStrVector("sync", nullptr),
+                                              genStrVector(genStr("%fms", dt * 1000).c_str(), nullptr));
+}
+
+void FileUtilsAsyncLoadingPerformceTest::startRun()
+{
+    AsyncFileLoader::getInstance()->setThreadCount(kAsyncThreadCounts[_runIndex]);
+
+    _loadedCount = 0;
+    _loadedBytes = 0;
+    // the callbacks can't be cancelled, the test is kept until they have all been called
+    retain();
+    gettimeofday(&_startTime, nullptr);
+    for (const auto& file : _files)
+    {
+        FileUtils::getInstance()->getDataFromFileAsync(file, [this](Data data) {
+            _loadedBytes += data.getSize();
+            if (++_loadedCount == (int)_files.size())
+                finishRun();
+        });
+    }
+}
+
+void FileUtilsAsyncLoadingPerformceTest::finishRun()
+{
+    // includes the frames waited for the callbacks, like a game loading during a loading screen would
+    auto dt = calculateDeltaTime(&_startTime);
+    int threads = kAsyncThreadCounts[_runIndex];
+    log("%d files, %d thread(s)  ms:%f  (%d bytes)", kSmallFileCount, threads, dt * 1000, (int)_loadedBytes);
+    if (isAutoTesting())
+        Profile::getInstance()->addTestResult(genStrVector(genStr("%d", threads).c_str(), nullptr),
+                                              genStrVector(genStr("%fms", dt * 1000).c_str(), nullptr));
+
+    // the next run starts on the next frame, out of the callback
+    if (++_runIndex < (int)(sizeof(kAsyncThreadCounts) / sizeof(kAsyncThreadCounts[0])) && isRunning())
+    {
+        scheduleOnce([this](float dt) { startRun(); }, 0, "startRun");
+    }
+    else if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+    release();
+}
+
+void FileUtilsAsyncLoadingPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("FileUtilsAsyncLoadingTest",
+                                              genStrVector("Threads", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    _defaultThreadCount = AsyncFileLoader::getInstance()->getThreadCount();
+    prepareFiles();
+
+    // reads the files once, so that every run reads them from the file system cache
+    for (const auto& file : _files)
+    {
+        FileUtils::getInstance()->getDataFromFile(file);
+    }
+
+    runSync();
+    _runIndex = 0;
+    startRun();
+}
+
+void FileUtilsAsyncLoadingPerformceTest::onExit()
+{
+    AsyncFileLoader::getInstance()->setThreadCount(_defaultThreadCount);
+
+    TestCase::onExit();
+}
+
+std::string FileUtilsAsyncLoadingPerformceTest::title() const
+{
+    return "FileUtils Async Loading Performance Test";
+}
+
+std::string FileUtilsAsyncLoadingPerformceTest::subtitle() const
+{
+    return StringUtils::format("Loads %d small files synchronously, then with 1, 2, 4 and 8 threads. See console", kSmallFileCount);
+}
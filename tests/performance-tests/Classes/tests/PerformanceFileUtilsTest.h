@@ -0,0 +1,34 @@
+#ifndef __PERFORMANCE_FILEUTILS_TEST_H__
+#define __PERFORMANCE_FILEUTILS_TEST_H__
+
+#include "BaseTest.h"
+
+DEFINE_TEST_SUITE(PerformceFileUtilsTests);
+
+class FileUtilsAsyncLoadingPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(FileUtilsAsyncLoadingPerformceTest);
+
+    FileUtilsAsyncLoadingPerformceTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+protected:
+    void prepareFiles();
+    void runSync();
+    void startRun();
+    void finishRun();
+
+    std::vector<std::string> _files;
+    int _runIndex;
+    int _loadedCount;
+    ssize_t _loadedBytes;
+    int _defaultThreadCount;
+    struct timeval _startTime;
+};
+
+#endif //__PERFORMANCE_FILEUTILS_TEST_H__
@@ -0,0 +1,127 @@
+#include "PerformanceGLProgramTest.h"
+#include "Profile.h"
+#include "renderer/ccShaders.h"
+
+USING_NS_CC;
+
+PerformceGLProgramTests::PerformceGLProgramTests()
+{
+    ADD_TEST_CASE(GLProgramBinaryCachePerformceTest);
+}
+
+static float calculateDeltaTime(struct timeval *lastUpdate)
+{
+    struct timeval now;
+
+    gettimeofday(&now, nullptr);
+
+    float dt = (now.tv_sec - lastUpdate->tv_sec) + (now.tv_usec - lastUpdate->tv_usec) / 1000000.0f;
+
+    return dt;
+}
+
+////////////////////////////////////////////////////////
+//
+// GLProgramBinaryCachePerformceTest
+//
+////////////////////////////////////////////////////////
+// the programs a typical first scene needs: sprites, labels, draw nodes and a few 3D models
+static const struct {
+    const GLchar** vert;
+    const GLchar** frag;
+} kFirstFramePrograms[] =
+{
+    {&ccPositionTextureColor_vert, &ccPositionTextureColor_frag},
+    {&ccPositionTextureColor_noMVP_vert, &ccPositionTextureColor_noMVP_frag},
+    {&ccPositionTextureColor_vert, &ccPositionTextureColorAlphaTest_frag},
+    {&ccPositionColor_vert, &ccPositionColor_frag},
+    {&ccPositionTexture_vert, &ccPositionTexture_frag},
+    {&ccPositionTextureA8Color_vert, &ccPositionTextureA8Color_frag},
+    {&ccPosition_uColor_vert, &ccPosition_uColor_frag},
+    {&ccPositionColorLengthTexture_vert, &ccPositionColorLengthTexture_frag},
+    {&ccPositionTextureColor_noMVP_vert, &ccPositionTexture_GrayScale_frag},
+    {&ccLabel_vert, &ccLabelNormal_frag},
+    {&ccLabel_vert, &ccLabelOutline_frag},
+    {&ccLabel_vert, &ccLabelDistanceFieldNormal_frag},
+    {&ccLabel_vert, &ccLabelDistanceFieldGlow_frag},
+    {&cc3D_PositionTex_vert, &cc3D_Color_frag},
+    {&cc3D_PositionTex_vert, &cc3D_ColorTex_frag},
+    {&cc3D_SkinPositionTex_vert, &cc3D_ColorTex_frag},
+    {&cc3D_Particle_vert, &cc3D_Particle_tex_frag},
+    {&cc3D_Skybox_vert, &cc3D_Skybox_frag},
+    {&cc3D_Terrain_vert, &cc3D_Terrain_frag},
+};
+
+void GLProgramBinaryCachePerformceTest::runPrograms(const char* name, const std::string& defines)
+{
+    const int count = sizeof(kFirstFramePrograms) / sizeof(kFirstFramePrograms[0]);
+    int fromBinary = 0;
+
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    for (int i = 0; i < count; ++i)
+    {
+        auto program = GLProgram::createWithByteArrays(*kFirstFramePrograms[i].vert, *kFirstFramePrograms[i].frag, defines);
+        if (program && program->isLoadedFromBinary())
+            ++fromBinary;
+    }
+    // some drivers only compile when the work is flushed
+    glFinish();
+    auto dt = calculateDeltaTime(&now);
+
+    log("%s: %d programs ms:%f  (%d from binaries)", name, count, dt * 1000, fromBinary);
+    if (isAutoTesting())
+        Profile::getInstance()->addTestResult(genStrVector(name, nullptr),
+                                              genStrVector(genStr("%fms", dt * 1000).c_str(), genStr("%d", fromBinary).c_str(), nullptr));
+}
+
+void GLProgramBinaryCachePerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("GLProgramBinaryCacheTest",
+                                              genStrVector("Cache", nullptr),
+                                              genStrVector("Time", "FromBinary", nullptr));
+    }
+
+    if (!Configuration::getInstance()->supportsProgramBinary())
+    {
+        log("program binaries are not supported by this driver, the cache is never used");
+    }
+
+    // defines unique to this launch, so that the shader caches some drivers keep on their own don't hide the compile time
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    std::string coldDefines = StringUtils::format("CC_PERF_COLD %ld", (long)now.tv_usec);
+    std::string cachedDefines = StringUtils::format("CC_PERF_CACHED %ld", (long)now.tv_usec);
+
+    bool enabled = GLProgram::isBinaryCacheEnabled();
+
+    GLProgram::setBinaryCacheEnabled(false);
+    runPrograms("without cache", coldDefines);
+
+    // the first launch with the cache compiles and saves the binaries, the next ones load them
+    GLProgram::setBinaryCacheEnabled(true);
+    GLProgram::removeBinaryCache();
+    runPrograms("cache, first launch", cachedDefines);
+    runPrograms("cache, next launches", cachedDefines);
+
+    GLProgram::removeBinaryCache();
+    GLProgram::setBinaryCacheEnabled(enabled);
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+std::string GLProgramBinaryCachePerformceTest::title() const
+{
+    return "GLProgram Binary Cache Performance Test";
+}
+
+std::string GLProgramBinaryCachePerformceTest::subtitle() const
+{
+    return "Creates the programs of a first frame without and with the binary cache. See console";
+}
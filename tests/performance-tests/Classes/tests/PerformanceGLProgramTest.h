@@ -0,0 +1,21 @@
+#ifndef __PERFORMANCE_GLPROGRAM_TEST_H__
+#define __PERFORMANCE_GLPROGRAM_TEST_H__
+
+#include "BaseTest.h"
+
+DEFINE_TEST_SUITE(PerformceGLProgramTests);
+
+class GLProgramBinaryCachePerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(GLProgramBinaryCachePerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+
+protected:
+    void runPrograms(const char* name, const std::string& defines);
+};
+
+#endif //__PERFORMANCE_GLPROGRAM_TEST_H__
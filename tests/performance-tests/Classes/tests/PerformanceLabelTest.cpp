@@ -1,6 +1,9 @@
 #include "PerformanceLabelTest.h"
 #include "Profile.h"
 
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontAtlasCache.h"
+
 USING_NS_CC;
 
 #define DELAY_TIME              1
@@ -38,6 +41,22 @@ static int _autoTestNodeCounts[] = {
 Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\
 Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua."
 
+// all the CJK ideographs of fonts/HKYuanMini.ttf
+#define CJKSentencesExample "一丁七万丈三上下丌不与专且世丙东丝丢两严丨个丫中丰串临丸为主举乃久么之乍乎乐乒乓" \
+"乖乘乙乜九乞也习书买乱了争事二于亏云互亓五亘些亡亢交亦产亨亩享京亭亮亲亳人亿什今" \
+"介从他代令以们仰件价任仿伍伏众优伙会伛伞伟传伢伤估伲伴似但位低住体何作你佣使例侍" \
+"供依便促保俞俟俩修俺倍倒倘候倚值假偌做偶儿兀允元充兆先光克免兑入全八公六兮兰共关" \
+"其内再冒冗写决况净准减凑几凡凭凶凸凹出击切划列则刚创初删判利别到前剩剪副力劝办功" \
+"加动助劾勿匀包匆匈匍北匹区医匿十千半华单南占卡卫印危即却卵卷卸厂历厉压厌厘原厶去" \
+"县叁参又叉及友双发取受变叙口古句另叨叩只叫召叭叮可台叱史右叵号司叹吃各吆同名后吏" \
+"吐向吖吗否吧吩含听呀告员呢周呵呼命咋和啊国天太夫夭央失头她好如子字学孩宁它对寺小" \
+"少支收改攻放政故文斋斌斗斜斤斥断新方无既日旦旧旨早时旷明昏易昔星映春是晋晌晏晒曰" \
+"月有木正歧歪歹死残段毁毅毋每比毕毛民气水火爰爱玉王白百的皆目看示礼社米美萌虽要见" \
+"视言计订认讥讦讨让记讲设证词该说诵读课谁贝负首黄黑"
+
+#define CJK_FONT_FILE           "fonts/HKYuanMini.ttf"
+#define CJK_RASTERIZATION_LOOPS 5
+
 PerformceLabelTests::PerformceLabelTests()
 {
     _curTestCase = kCaseLabelTTFUpdate;
@@ -46,6 +65,7 @@ PerformceLabelTests::PerformceLabelTests()
     addTestCase("Label Performance Test", [](){ return LabelMainScene::create(); });
     addTestCase("LabelBMFont large text Performance", [](){ return LabelMainScene::create(); });
     addTestCase("Label large text Performance", [](){ return LabelMainScene::create(); });
+    addTestCase("Label CJK glyph rasterization", [](){ return LabelCJKRasterizationPerformceTest::create(); });
 }
 
 ////////////////////////////////////////////////////////
@@ -383,3 +403,92 @@ void LabelMainScene::priorTestCallback(cocos2d::Ref* sender)
     }
     TestCase::priorTestCallback(sender);
 }
+
+////////////////////////////////////////////////////////
+//
+// LabelCJKRasterizationPerformceTest
+//
+////////////////////////////////////////////////////////
+static float calculateDeltaTime(struct timeval *lastUpdate)
+{
+    struct timeval now;
+
+    gettimeofday(&now, nullptr);
+
+    float dt = (now.tv_sec - lastUpdate->tv_sec) + (now.tv_usec - lastUpdate->tv_usec) / 1000000.0f;
+
+    return dt;
+}
+
+void LabelCJKRasterizationPerformceTest::performTests()
+{
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("LabelCJKRasterizationTest",
+                                              genStrVector("Mode", "FontSize", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    std::u16string utf16Text;
+    StringUtils::UTF8ToUTF16(CJKSentencesExample, utf16Text);
+
+    bool parallel = FontAtlas::isParallelRasterizationEnabled();
+    const char* modes[] = { "serial", "parallel", "serial SDF", "parallel SDF" };
+
+    log("--- %d glyphs ---", (int)utf16Text.length());
+    for (int loop = 0; loop < CJK_RASTERIZATION_LOOPS; ++loop)
+    {
+        for (int mode = 0; mode < 4; ++mode)
+        {
+            FontAtlas::setParallelRasterizationEnabled(mode % 2 == 1);
+
+            // a new size each loop, so that no atlas already has the glyphs
+            TTFConfig ttfConfig(CJK_FONT_FILE, 24 + loop * 8, GlyphCollection::DYNAMIC, nullptr, mode >= 2);
+            auto atlas = FontAtlasCache::getFontAtlasTTF(&ttfConfig);
+            if (atlas == nullptr)
+                continue;
+
+            struct timeval now;
+            gettimeofday(&now, nullptr);
+            atlas->prepareLetterDefinitions(utf16Text);
+            atlas->uploadDirtyTextures();
+            auto dt = calculateDeltaTime(&now);
+
+            log("%s size %d  ms:%f  pages:%d", modes[mode], (int)ttfConfig.fontSize, dt * 1000, (int)atlas->getTextures().size());
+            if (isAutoTesting())
+                Profile::getInstance()->addTestResult(genStrVector(modes[mode], genStr("%d", (int)ttfConfig.fontSize).c_str(), nullptr),
+                                                      genStrVector(genStr("%fms", dt * 1000).c_str(), nullptr));
+
+            FontAtlasCache::releaseFontAtlas(atlas);
+        }
+    }
+    FontAtlas::setParallelRasterizationEnabled(parallel);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+void LabelCJKRasterizationPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    performTests();
+
+    // shows the glyphs to check that both paths render the same
+    auto size = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(CJKSentencesExample, CJK_FONT_FILE, 20, Size(size.width * 0.9f, 0));
+    label->setPosition(Vec2(size.width / 2, size.height / 2));
+    addChild(label);
+}
+
+std::string LabelCJKRasterizationPerformceTest::title() const
+{
+    return "Label CJK Glyph Rasterization Test";
+}
+
+std::string LabelCJKRasterizationPerformceTest::subtitle() const
+{
+    return "Adds the glyphs of a large CJK text to new atlases, serially and in parallel, with and without distance field. See console";
+}
@@ -44,4 +44,16 @@ private:
     float maxFrameRate;
 };
 
+class LabelCJKRasterizationPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(LabelCJKRasterizationPerformceTest);
+
+    virtual void performTests();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
 #endif
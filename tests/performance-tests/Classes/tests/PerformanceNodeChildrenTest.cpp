@@ -45,6 +45,12 @@ PerformceNodeChildrenTests::PerformceNodeChildrenTests()
 //    ADD_TEST_CASE(ReorderSpriteSheet);
 //    ADD_TEST_CASE(SortAllChildrenSpriteSheet);
     ADD_TEST_CASE(VisitSceneGraph);
+    ADD_TEST_CASE(ParallelVisitSceneGraph);
+    ADD_TEST_CASE(TransformCacheVisitSceneGraph);
+    ADD_TEST_CASE(ReorderFewChildren);
+    ADD_TEST_CASE(CulledSubtreesVisitSceneGraph);
+    ADD_TEST_CASE(ActionManagerUpdate);
+    ADD_TEST_CASE(TweenBatchActionManagerUpdate);
 }
 
 enum {
@@ -980,3 +986,594 @@ const char*  VisitSceneGraph::testName()
 {
     return "visit()";
 }
+
+////////////////////////////////////////////////////////
+//
+// ParallelVisitSceneGraph
+//
+////////////////////////////////////////////////////////
+static int parallelVisitThreadCounts[] = {
+    1, 2, 4, 8
+};
+
+ParallelVisitSceneGraph::ParallelVisitSceneGraph()
+: _container(nullptr)
+, _defaultWorkerCount(ParallelTaskPool::getInstance()->getWorkerCount())
+{
+    _testName[0] = '\0';
+}
+
+ParallelVisitSceneGraph::~ParallelVisitSceneGraph()
+{
+    ParallelTaskPool::getInstance()->setWorkerCount(_defaultWorkerCount);
+}
+
+void ParallelVisitSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    _container->setParallelVisitEnabled(true);
+    addChild(_container);
+
+    // start with the biggest thread count the pool uses by default
+    int selectedIndex = 0;
+    int threadCountsSize = sizeof(parallelVisitThreadCounts)/sizeof(int);
+    for (int i = 0; i < threadCountsSize; ++i)
+    {
+        if (parallelVisitThreadCounts[i] <= _defaultWorkerCount + 1)
+            selectedIndex = i;
+    }
+    setThreadCount(parallelVisitThreadCounts[selectedIndex]);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    int oldFontSize = MenuItemFont::getFontSize();
+    MenuItemFont::setFontSize(24);
+
+    Vector<MenuItem*> toggleItems;
+    for (int i = 0; i < threadCountsSize; ++i)
+    {
+        toggleItems.pushBack(MenuItemFont::create(StringUtils::format("%d threads", parallelVisitThreadCounts[i])));
+    }
+
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender){
+        auto toggle = static_cast<MenuItemToggle*>(sender);
+        setThreadCount(parallelVisitThreadCounts[toggle->getSelectedIndex()]);
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, toggleItems);
+    toggle->setSelectedIndex(selectedIndex);
+
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-55));
+    addChild(menu, 1);
+
+    MenuItemFont::setFontSize(oldFontSize);
+
+    scheduleUpdate();
+}
+
+void ParallelVisitSceneGraph::setThreadCount(int threads)
+{
+    ParallelTaskPool::getInstance()->setWorkerCount(threads - 1);
+    snprintf(_testName, sizeof(_testName)-1, "parallel visit(), %d threads", threads);
+}
+
+void ParallelVisitSceneGraph::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto sprite = Sprite::create("Images/spritesheet1.png", Rect(0, 0, 32, 32));
+            _container->addChild(sprite);
+            sprite->setPosition(Vec2( CCRANDOM_0_1()*s.width, CCRANDOM_0_1()*s.height));
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _container->removeChild(_container->getChildren().back(), true);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void ParallelVisitSceneGraph::update(float dt)
+{
+    CC_PROFILER_START( this->profilerName() );
+    this->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    // Call `Renderer::clean` to prevent crash if current scene is destroyed.
+    // The render commands associated with current scene should be cleaned.
+    Director::getInstance()->getRenderer()->clean();
+}
+
+std::string ParallelVisitSceneGraph::title() const
+{
+    return "Performance of visiting the scene graph in parallel";
+}
+
+std::string ParallelVisitSceneGraph::subtitle() const
+{
+    return "records sprites commands on worker threads. See console";
+}
+
+const char*  ParallelVisitSceneGraph::testName()
+{
+    return _testName;
+}
+
+////////////////////////////////////////////////////////
+//
+// TransformCacheVisitSceneGraph
+//
+////////////////////////////////////////////////////////
+TransformCacheVisitSceneGraph::TransformCacheVisitSceneGraph()
+: _container(nullptr)
+{
+}
+
+void TransformCacheVisitSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    _container->setTransformCacheEnabled(true);
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    int oldFontSize = MenuItemFont::getFontSize();
+    MenuItemFont::setFontSize(24);
+
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender){
+        auto toggle = static_cast<MenuItemToggle*>(sender);
+        _container->setTransformCacheEnabled(toggle->getSelectedIndex() == 0);
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("transform cache on"), MenuItemFont::create("transform cache off"), nullptr);
+
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-55));
+    addChild(menu, 1);
+
+    MenuItemFont::setFontSize(oldFontSize);
+
+    scheduleUpdate();
+}
+
+void TransformCacheVisitSceneGraph::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto node = Node::create();
+            _container->addChild(node);
+            node->setPosition(Vec2( CCRANDOM_0_1()*s.width, CCRANDOM_0_1()*s.height));
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _container->removeChild(_container->getChildren().back(), true);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void TransformCacheVisitSceneGraph::update(float dt)
+{
+    CC_PROFILER_START( this->profilerName() );
+    this->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    // Call `Renderer::clean` to prevent crash if current scene is destroyed.
+    // The render commands associated with current scene should be cleaned.
+    Director::getInstance()->getRenderer()->clean();
+}
+
+std::string TransformCacheVisitSceneGraph::title() const
+{
+    return "Performance of visiting static children";
+}
+
+std::string TransformCacheVisitSceneGraph::subtitle() const
+{
+    return "visit() with the transform cache on or off. See console";
+}
+
+const char*  TransformCacheVisitSceneGraph::testName()
+{
+    return _container && _container->isTransformCacheEnabled() ? "visit(), transform cache" : "visit(), no transform cache";
+}
+
+////////////////////////////////////////////////////////
+//
+// ReorderFewChildren
+//
+////////////////////////////////////////////////////////
+ReorderFewChildren::ReorderFewChildren()
+: _container(nullptr)
+{
+}
+
+void ReorderFewChildren::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    scheduleUpdate();
+}
+
+void ReorderFewChildren::updateQuantityOfNodes()
+{
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            _container->addChild(Node::create(), CCRANDOM_MINUS1_1() * 50);
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _container->removeChild(_container->getChildren().back(), true);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+    _container->sortAllChildren();
+}
+
+void ReorderFewChildren::update(float dt)
+{
+    const auto& children = _container->getChildren();
+    if (children.empty())
+        return;
+
+    // 1 percent of the children get a new z order every frame, like depth sorted units walking around
+    _zOrders.clear();
+    for (ssize_t i = 0; i < std::max(children.size() / 100, (ssize_t)1); i++)
+    {
+        auto child = children.at(rand() % children.size());
+        _zOrders.push_back(std::make_pair(child, child->getLocalZOrder() + (rand() % 2 ? 1 : -1)));
+    }
+
+    CC_PROFILER_START( this->profilerName() );
+    _container->reorderChildren(_zOrders);
+    _container->sortAllChildren();
+    CC_PROFILER_STOP( this->profilerName() );
+}
+
+std::string ReorderFewChildren::title() const
+{
+    return "Node::sortAllChildren()";
+}
+
+std::string ReorderFewChildren::subtitle() const
+{
+    return "1% of the children reordered every frame. See console";
+}
+
+const char*  ReorderFewChildren::testName()
+{
+    return "Node::sortAllChildren(), 1% reordered";
+}
+
+////////////////////////////////////////////////////////
+//
+// CulledSubtreesVisitSceneGraph
+//
+////////////////////////////////////////////////////////
+static const int kSpritesPerChunk = 100;
+static const int kChunksPerRow = 10;
+
+// Culling only happens for the default camera, so the world is timed while the scene renders it
+class VisitTimerNode : public Node
+{
+public:
+    static VisitTimerNode* create(NodeChildrenMainScene* scene)
+    {
+        auto node = new (std::nothrow) VisitTimerNode();
+        if (node && node->init())
+        {
+            node->_scene = scene;
+            node->autorelease();
+            return node;
+        }
+        CC_SAFE_DELETE(node);
+        return nullptr;
+    }
+
+    virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override
+    {
+        CC_PROFILER_START( _scene->profilerName() );
+        Node::visit(renderer, parentTransform, parentFlags);
+        CC_PROFILER_STOP( _scene->profilerName() );
+    }
+
+protected:
+    NodeChildrenMainScene* _scene;
+};
+
+CulledSubtreesVisitSceneGraph::CulledSubtreesVisitSceneGraph()
+: _world(nullptr)
+, _cullingEnabled(true)
+{
+}
+
+void CulledSubtreesVisitSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _world = VisitTimerNode::create(this);
+    addChild(_world);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    int oldFontSize = MenuItemFont::getFontSize();
+    MenuItemFont::setFontSize(24);
+
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender){
+        auto toggle = static_cast<MenuItemToggle*>(sender);
+        setCullingEnabled(toggle->getSelectedIndex() == 0);
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("subtree culling on"), MenuItemFont::create("subtree culling off"), nullptr);
+
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-55));
+    addChild(menu, 1);
+
+    MenuItemFont::setFontSize(oldFontSize);
+
+    scheduleUpdate();
+}
+
+void CulledSubtreesVisitSceneGraph::setCullingEnabled(bool enabled)
+{
+    _cullingEnabled = enabled;
+    for (const auto& chunk : _world->getChildren())
+    {
+        chunk->setSubtreeCullingEnabled(enabled);
+    }
+}
+
+void CulledSubtreesVisitSceneGraph::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // the sprites are split in screen sized chunks, laid out in rows of kChunksPerRow screens
+    _world->removeAllChildren();
+    int chunkCount = (quantityOfNodes + kSpritesPerChunk - 1) / kSpritesPerChunk;
+    for (int i = 0; i < chunkCount; i++)
+    {
+        auto chunk = Node::create();
+        chunk->setContentSize(s);
+        chunk->setPosition(Vec2((i % kChunksPerRow) * s.width, (i / kChunksPerRow) * s.height));
+        chunk->setSubtreeCullingEnabled(_cullingEnabled);
+        _world->addChild(chunk);
+
+        for (int j = 0; j < kSpritesPerChunk && i * kSpritesPerChunk + j < quantityOfNodes; j++)
+        {
+            auto sprite = Sprite::create("Images/spritesheet1.png", Rect(0, 0, 32, 32));
+            sprite->setPosition(Vec2(CCRANDOM_0_1()*s.width, CCRANDOM_0_1()*s.height));
+            chunk->addChild(sprite);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void CulledSubtreesVisitSceneGraph::update(float dt)
+{
+    // scroll through the first row of chunks, so the world moves every frame
+    auto s = Director::getInstance()->getWinSize();
+    float x = _world->getPositionX() - 4;
+    if (x < -s.width * (kChunksPerRow - 1))
+        x = 0;
+    _world->setPositionX(x);
+}
+
+std::string CulledSubtreesVisitSceneGraph::title() const
+{
+    return "Performance of visiting a scrolling world";
+}
+
+std::string CulledSubtreesVisitSceneGraph::subtitle() const
+{
+    return "visit() with off-screen chunks culled or not. See console";
+}
+
+const char*  CulledSubtreesVisitSceneGraph::testName()
+{
+    return _cullingEnabled ? "visit(), subtree culling" : "visit(), no subtree culling";
+}
+
+////////////////////////////////////////////////////////
+//
+// ActionManagerUpdate
+//
+////////////////////////////////////////////////////////
+ActionManagerUpdate::ActionManagerUpdate()
+: _container(nullptr)
+, _actionManager(nullptr)
+{
+}
+
+ActionManagerUpdate::~ActionManagerUpdate()
+{
+    CC_SAFE_RELEASE(_actionManager);
+}
+
+void ActionManagerUpdate::initWithQuantityOfNodes(unsigned int nodes)
+{
+    // an ActionManager of its own, so only the actions of the test are measured
+    _actionManager = new (std::nothrow) ActionManager();
+
+    _container = Node::create();
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    scheduleUpdate();
+}
+
+void ActionManagerUpdate::runActions(Node* node)
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto move = Sequence::create(MoveTo::create(1.0f, Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height)),
+                                 MoveTo::create(1.0f, Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height)),
+                                 nullptr);
+    auto fade = Sequence::create(FadeTo::create(0.5f, 64), FadeTo::create(0.5f, 255), nullptr);
+    _actionManager->addAction(RepeatForever::create(move), node, false);
+    _actionManager->addAction(RepeatForever::create(fade), node, false);
+}
+
+void ActionManagerUpdate::updateQuantityOfNodes()
+{
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto node = Node::create();
+            _container->addChild(node);
+            runActions(node);
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            auto node = _container->getChildren().back();
+            _actionManager->removeAllActionsFromTarget(node);
+            _container->removeChild(node, true);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void ActionManagerUpdate::update(float dt)
+{
+    const auto& children = _container->getChildren();
+    if (children.empty())
+        return;
+
+    // 1 percent of the nodes get a short action every frame, so some actions complete every frame
+    for (ssize_t i = 0; i < std::max(children.size() / 100, (ssize_t)1); i++)
+    {
+        auto node = children.at(rand() % children.size());
+        _actionManager->addAction(DelayTime::create(CCRANDOM_0_1() * 0.5f), node, false);
+    }
+
+    CC_PROFILER_START( this->profilerName() );
+    _actionManager->update(dt);
+    CC_PROFILER_STOP( this->profilerName() );
+}
+
+std::string ActionManagerUpdate::title() const
+{
+    return "ActionManager::update()";
+}
+
+std::string ActionManagerUpdate::subtitle() const
+{
+    return "2 repeated sequences per node. See console";
+}
+
+const char*  ActionManagerUpdate::testName()
+{
+    return "ActionManager::update()";
+}
+
+////////////////////////////////////////////////////////
+//
+// TweenBatchActionManagerUpdate
+//
+////////////////////////////////////////////////////////
+void TweenBatchActionManagerUpdate::initWithQuantityOfNodes(unsigned int nodes)
+{
+    ActionManagerUpdate::initWithQuantityOfNodes(nodes);
+    _actionManager->setTweenBatchEnabled(true);
+
+    auto s = Director::getInstance()->getWinSize();
+    int oldFontSize = MenuItemFont::getFontSize();
+    MenuItemFont::setFontSize(24);
+
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender){
+        auto toggle = static_cast<MenuItemToggle*>(sender);
+        _actionManager->setTweenBatchEnabled(toggle->getSelectedIndex() == 0);
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("tween batch on"), MenuItemFont::create("tween batch off"), nullptr);
+
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-55));
+    addChild(menu, 1);
+
+    MenuItemFont::setFontSize(oldFontSize);
+}
+
+void TweenBatchActionManagerUpdate::runActions(Node* node)
+{
+    auto s = Director::getInstance()->getWinSize();
+    float duration = 1.0f + CCRANDOM_0_1() * 2.0f;
+    _actionManager->addAction(EaseSineInOut::create(MoveTo::create(duration, Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height))), node, false);
+    _actionManager->addAction(EaseCubicActionInOut::create(ScaleTo::create(duration, 0.5f + CCRANDOM_0_1())), node, false);
+    _actionManager->addAction(RotateBy::create(duration, 360 * CCRANDOM_MINUS1_1()), node, false);
+    _actionManager->addAction(FadeTo::create(duration, 64 + rand() % 192), node, false);
+}
+
+void TweenBatchActionManagerUpdate::update(float dt)
+{
+    // the nodes whose tweens are done get new ones
+    for (const auto& node : _container->getChildren())
+    {
+        if (_actionManager->getNumberOfRunningActionsInTarget(node) == 0)
+        {
+            runActions(node);
+        }
+    }
+
+    ActionManagerUpdate::update(dt);
+}
+
+std::string TweenBatchActionManagerUpdate::title() const
+{
+    return "ActionManager::update() with tweens";
+}
+
+std::string TweenBatchActionManagerUpdate::subtitle() const
+{
+    return "4 eased tweens per node. See console";
+}
+
+const char*  TweenBatchActionManagerUpdate::testName()
+{
+    return _actionManager && ! _actionManager->isTweenBatchEnabled() ? "ActionManager::update(), tween batch off" : "ActionManager::update(), tween batch on";
+}
@@ -218,4 +218,128 @@ public:
     virtual const char* testName() override;
 };
 
+class ParallelVisitSceneGraph : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(ParallelVisitSceneGraph);
+
+    ParallelVisitSceneGraph();
+    virtual ~ParallelVisitSceneGraph();
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    void setThreadCount(int threads);
+
+    cocos2d::Node* _container;
+    int _defaultWorkerCount;
+    char _testName[64];
+};
+
+class TransformCacheVisitSceneGraph : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(TransformCacheVisitSceneGraph);
+
+    TransformCacheVisitSceneGraph();
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    cocos2d::Node* _container;
+};
+
+class CulledSubtreesVisitSceneGraph : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(CulledSubtreesVisitSceneGraph);
+
+    CulledSubtreesVisitSceneGraph();
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    void setCullingEnabled(bool enabled);
+
+    cocos2d::Node* _world;
+    bool _cullingEnabled;
+};
+
+class ReorderFewChildren : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(ReorderFewChildren);
+
+    ReorderFewChildren();
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    cocos2d::Node* _container;
+    std::vector<std::pair<cocos2d::Node*, int>> _zOrders;
+};
+
+class ActionManagerUpdate : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(ActionManagerUpdate);
+
+    ActionManagerUpdate();
+    virtual ~ActionManagerUpdate();
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    virtual void runActions(cocos2d::Node* node);
+
+    cocos2d::Node* _container;
+    cocos2d::ActionManager* _actionManager;
+};
+
+class TweenBatchActionManagerUpdate : public ActionManagerUpdate
+{
+public:
+    CREATE_FUNC(TweenBatchActionManagerUpdate);
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    virtual void runActions(cocos2d::Node* node) override;
+};
+
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
@@ -0,0 +1,190 @@
+#include "PerformanceRendererTest.h"
+#include "Profile.h"
+
+USING_NS_CC;
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+#undef CC_PROFILER_START
+#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
+#undef CC_PROFILER_STOP
+#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
+#undef CC_PROFILER_RESET
+#define CC_PROFILER_RESET(__name__) ProfilingResetTimingBlock(__name__)
+
+static const int K_INFO_QUANTITY_TAG = 1581;
+static const int K_MAX_QUANTITY = 200000;
+
+static int autoTestQuantities[] = {
+    10000, 50000, 200000
+};
+
+PerformceRendererTests::PerformceRendererTests()
+{
+    ADD_TEST_CASE(RenderQueueRadixSortTest);
+    ADD_TEST_CASE(RenderQueueStdSortTest);
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceRendererLayer
+//
+////////////////////////////////////////////////////////
+void PerformanceRendererLayer::onEnter()
+{
+    TestCase::onEnter();
+    
+    CC_PROFILER_PURGE_ALL();
+    
+    if (isAutoTesting()) {
+        autoTestIndex = 0;
+        _quantity = autoTestQuantities[autoTestIndex];
+        Profile::getInstance()->testCaseBegin("RendererTest",
+                                              genStrVector("Type", "Quantity", nullptr),
+                                              genStrVector("Avg", "Min", "Max", nullptr));
+    }
+    
+    auto s = Director::getInstance()->getWinSize();
+    
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", CC_CALLBACK_1(PerformanceRendererLayer::subQuantity, this));
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", CC_CALLBACK_1(PerformanceRendererLayer::addQuantity, this));
+    increase->setColor(Color3B(0,200,20));
+    
+    auto menu = Menu::create(decrease, increase, nullptr);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(menu, 1);
+    
+    auto infoLabel = Label::createWithTTF("0", "fonts/Marker Felt.ttf", 30);
+    infoLabel->setColor(Color3B(0,200,20));
+    infoLabel->setPosition(Vec2(s.width/2, s.height/2 + 40));
+    addChild(infoLabel, 1, K_INFO_QUANTITY_TAG);
+    updateQuantityLabel();
+    updateQuantity();
+    
+    getScheduler()->schedule(CC_SCHEDULE_SELECTOR(PerformanceRendererLayer::doPerformanceTest), this, 0.0f, false);
+    getScheduler()->schedule(CC_SCHEDULE_SELECTOR(PerformanceRendererLayer::dumpProfilerInfo), this, 2, false);
+}
+
+void PerformanceRendererLayer::addQuantity(Ref *sender)
+{
+    _quantity = std::min(_quantity + _stepCount, K_MAX_QUANTITY);
+    CC_PROFILER_PURGE_ALL();
+    updateQuantityLabel();
+    updateQuantity();
+}
+
+void PerformanceRendererLayer::subQuantity(Ref *sender)
+{
+    _quantity = std::max(_quantity - _stepCount, _stepCount);
+    CC_PROFILER_PURGE_ALL();
+    updateQuantityLabel();
+    updateQuantity();
+}
+
+void PerformanceRendererLayer::updateQuantityLabel()
+{
+    auto infoLabel = (Label *) getChildByTag(K_INFO_QUANTITY_TAG);
+    char str[16] = {0};
+    sprintf(str, "%u", _quantity);
+    infoLabel->setString(str);
+}
+
+void PerformanceRendererLayer::dumpProfilerInfo(float dt)
+{
+    CC_PROFILER_DISPLAY_TIMERS();
+    
+    if (this->isAutoTesting()) {
+        // record the test result to class Profile
+        auto timer = Profiler::getInstance()->_activeTimers.at(_profileName);
+        auto numStr = genStr("%d", _quantity);
+        auto avgStr = genStr("%ldµ", timer->_averageTime2);
+        auto minStr = genStr("%ldµ", timer->minTime);
+        auto maxStr = genStr("%ldµ", timer->maxTime);
+        Profile::getInstance()->addTestResult(genStrVector(_profileName.c_str(), numStr.c_str(), nullptr),
+                                              genStrVector(avgStr.c_str(), minStr.c_str(), maxStr.c_str(), nullptr));
+
+        auto testsSize = sizeof(autoTestQuantities)/sizeof(int);
+        if (autoTestIndex >= (testsSize - 1)) {
+            this->setAutoTesting(false);
+            Profile::getInstance()->testCaseEnd();
+        }
+        else
+        {
+            // update the auto test index
+            autoTestIndex++;
+            _quantity = autoTestQuantities[autoTestIndex];
+            updateQuantityLabel();
+            updateQuantity();
+            CC_PROFILER_PURGE_ALL();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderQueueSortBase
+//
+////////////////////////////////////////////////////////
+void RenderQueueSortBase::updateQuantity()
+{
+    _queue.clear();
+    _commands = std::vector<CustomCommand>(_quantity);
+
+    // a few hundred distinct globalZ values, half of them negative, like a big 2D scene
+    srand(0);
+    for (auto& command : _commands)
+    {
+        command.init((rand() % 200) - 100 + 0.5f);
+    }
+}
+
+void RenderQueueSortBase::fillQueue()
+{
+    _queue.clear();
+    for (auto& command : _commands)
+    {
+        _queue.push_back(&command);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderQueueRadixSortTest
+//
+////////////////////////////////////////////////////////
+void RenderQueueRadixSortTest::doPerformanceTest(float dt)
+{
+    fillQueue();
+
+    CC_PROFILER_START(_profileName.c_str());
+    _queue.sort();
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderQueueStdSortTest
+//
+////////////////////////////////////////////////////////
+void RenderQueueStdSortTest::doPerformanceTest(float dt)
+{
+    fillQueue();
+
+    auto& negQueue = _queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_NEG);
+    auto& posQueue = _queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS);
+    auto compare = [](RenderCommand* a, RenderCommand* b) {
+        return a->getGlobalOrder() < b->getGlobalOrder();
+    };
+
+    CC_PROFILER_START(_profileName.c_str());
+    std::sort(std::begin(negQueue), std::end(negQueue), compare);
+    std::sort(std::begin(posQueue), std::end(posQueue), compare);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
@@ -0,0 +1,80 @@
+#ifndef __PERFORMANCE_RENDERER_TEST_H__
+#define __PERFORMANCE_RENDERER_TEST_H__
+
+#include "BaseTest.h"
+
+DEFINE_TEST_SUITE(PerformceRendererTests);
+
+class PerformanceRendererLayer : public TestCase
+{
+public:
+    PerformanceRendererLayer()
+    : autoTestIndex(0)
+    , _quantity(10000)
+    , _stepCount(10000)
+    , _profileName("")
+    {
+        
+    }
+    
+    virtual void onEnter() override;
+    
+    virtual std::string title() const override{ return "Renderer Performance Test"; }
+    virtual std::string subtitle() const override{ return "PerformanceRendererLayer subTitle"; }
+    
+    void addQuantity(cocos2d::Ref* sender);
+    void subQuantity(cocos2d::Ref* sender);
+protected:
+    virtual void doPerformanceTest(float dt) {};
+    virtual void updateQuantity() {};
+    
+    void dumpProfilerInfo(float dt);
+    void updateQuantityLabel();
+protected:
+    int autoTestIndex;
+    int _quantity;
+    int _stepCount;
+    std::string _profileName;
+};
+
+class RenderQueueSortBase : public PerformanceRendererLayer
+{
+protected:
+    virtual void updateQuantity() override;
+    void fillQueue();
+
+    std::vector<cocos2d::CustomCommand> _commands;
+    cocos2d::RenderQueue _queue;
+};
+
+class RenderQueueRadixSortTest : public RenderQueueSortBase
+{
+public:
+    CREATE_FUNC(RenderQueueRadixSortTest);
+
+    RenderQueueRadixSortTest()
+    {
+        _profileName = "RenderQueue::sort";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "RenderQueue::sort(), radix sort"; }
+};
+
+class RenderQueueStdSortTest : public RenderQueueSortBase
+{
+public:
+    CREATE_FUNC(RenderQueueStdSortTest);
+
+    RenderQueueStdSortTest()
+    {
+        _profileName = "std::sort";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "std::sort() by globalZ, for reference"; }
+};
+
+#endif //__PERFORMANCE_RENDERER_TEST_H__
@@ -1,11 +1,15 @@
 #include "PerformanceTextureTest.h"
 #include "Profile.h"
+#include "renderer/ccPixelConversion.h"
 
 USING_NS_CC;
 
 PerformceTextureTests::PerformceTextureTests()
 {
     ADD_TEST_CASE(TexturePerformceTest);
+    ADD_TEST_CASE(TextureAsyncLoadingPerformceTest);
+    ADD_TEST_CASE(TextureConversionPerformceTest);
+    ADD_TEST_CASE(SpriteFrameCacheLoadingPerformceTest);
 }
 
 static float calculateDeltaTime( struct timeval *lastUpdate )
@@ -332,3 +336,404 @@ std::string TexturePerformceTest::subtitle() const
 {
     return "See console for results";
 }
+
+////////////////////////////////////////////////////////
+//
+// TextureAsyncLoadingPerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kPreloadTextureCount = 200;
+static const int kAsyncWorkerCounts[] = { 1, 2, 4, 8 };
+
+TextureAsyncLoadingPerformceTest::TextureAsyncLoadingPerformceTest()
+: _runIndex(0)
+, _loadedCount(0)
+, _defaultWorkerCount(0)
+{
+}
+
+void TextureAsyncLoadingPerformceTest::prepareFiles()
+{
+    // TextureCache only loads a file once, so the preload list is made of copies with different names
+    static const char* images[] = {
+        "Images/grossini.png",
+        "Images/grossinis_sister1.png",
+        "Images/grossini_dance_01.png",
+        "Images/grossini_dance_02.png",
+        "Images/grossini_dance_03.png",
+        "Images/grossini_dance_04.png",
+        "Images/grossini_dance_05.png",
+        "Images/grossini_dance_06.png",
+        "Images/grossini_dance_atlas.png",
+        "Images/spritesheet1.png",
+        "Images/test_image.png",
+        "Images/texture512x512.png",
+    };
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string directory = fileUtils->getWritablePath() + "async_preload/";
+    fileUtils->createDirectory(directory);
+
+    _files.clear();
+    for (int i = 0; i < kPreloadTextureCount; ++i)
+    {
+        auto path = StringUtils::format("%spreload_%03d.png", directory.c_str(), i);
+        if (!fileUtils->isFileExist(path))
+        {
+            fileUtils->writeDataToFile(fileUtils->getDataFromFile(images[i % (sizeof(images) / sizeof(images[0]))]), path);
+        }
+        _files.push_back(path);
+    }
+}
+
+void TextureAsyncLoadingPerformceTest::startRun()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->setAsyncWorkerCount(kAsyncWorkerCounts[_runIndex]);
+
+    _loadedCount = 0;
+    gettimeofday(&_startTime, nullptr);
+    for (const auto& file : _files)
+    {
+        cache->addImageAsync(file, [this](Texture2D* texture) {
+            if (++_loadedCount == (int)_files.size())
+                finishRun();
+        });
+    }
+}
+
+void TextureAsyncLoadingPerformceTest::finishRun()
+{
+    auto dt = calculateDeltaTime(&_startTime);
+    int workers = kAsyncWorkerCounts[_runIndex];
+    log("%d textures, %d worker(s)  ms:%f", kPreloadTextureCount, workers, dt * 1000);
+    if (isAutoTesting())
+        Profile::getInstance()->addTestResult(genStrVector(genStr("%d", workers).c_str(), nullptr),
+                                              genStrVector(genStr("%fms", dt * 1000).c_str(), nullptr));
+
+    auto cache = Director::getInstance()->getTextureCache();
+    for (const auto& file : _files)
+    {
+        cache->removeTextureForKey(file);
+    }
+
+    // the next run starts on the next frame, out of the TextureCache callback
+    if (++_runIndex < (int)(sizeof(kAsyncWorkerCounts) / sizeof(kAsyncWorkerCounts[0])))
+    {
+        scheduleOnce([this](float dt) { startRun(); }, 0, "startRun");
+    }
+    else if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+void TextureAsyncLoadingPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("TextureAsyncLoadingTest",
+                                              genStrVector("Workers", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    _defaultWorkerCount = Director::getInstance()->getTextureCache()->getAsyncWorkerCount();
+    prepareFiles();
+    _runIndex = 0;
+    startRun();
+}
+
+void TextureAsyncLoadingPerformceTest::onExit()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    for (const auto& file : _files)
+    {
+        cache->cancelImageAsync(file);
+        cache->removeTextureForKey(file);
+    }
+    cache->setAsyncWorkerCount(_defaultWorkerCount);
+
+    TestCase::onExit();
+}
+
+std::string TextureAsyncLoadingPerformceTest::title() const
+{
+    return "Texture Async Loading Performance Test";
+}
+
+std::string TextureAsyncLoadingPerformceTest::subtitle() const
+{
+    return StringUtils::format("Loads %d textures with 1, 2, 4 and 8 threads. See console", kPreloadTextureCount);
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureConversionPerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kConversionImageSize = 2048;
+static const int kConversionLoops = 10;
+
+void TextureConversionPerformceTest::performTests()
+{
+    typedef void (*Conversion)(const unsigned char*, ssize_t, unsigned char*);
+    struct ConversionInfo
+    {
+        const char* name;
+        Conversion conversion;
+        int inBytes;
+        int outBytes;
+    };
+    static const ConversionInfo conversions[] = {
+        { "RGBA8888->RGB888", PixelConversion::convertRGBA8888ToRGB888, 4, 3 },
+        { "RGBA8888->RGB565", PixelConversion::convertRGBA8888ToRGB565, 4, 2 },
+        { "RGBA8888->A8", PixelConversion::convertRGBA8888ToA8, 4, 1 },
+        { "RGBA8888->RGBA4444", PixelConversion::convertRGBA8888ToRGBA4444, 4, 2 },
+        { "RGBA8888->RGB5A1", PixelConversion::convertRGBA8888ToRGB5A1, 4, 2 },
+        { "RGB888->RGBA8888", PixelConversion::convertRGB888ToRGBA8888, 3, 4 },
+        { "RGB888->RGB565", PixelConversion::convertRGB888ToRGB565, 3, 2 },
+    };
+    static const PixelConversion::InstructionSet instructionSets[] = {
+        PixelConversion::InstructionSet::SCALAR,
+        PixelConversion::InstructionSet::SSE2,
+        PixelConversion::InstructionSet::SSSE3,
+        PixelConversion::InstructionSet::NEON,
+    };
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("TextureConversionTest",
+                                              genStrVector("Conversion", "InstructionSet", nullptr),
+                                              genStrVector("MB/s", "Valid", nullptr));
+    }
+
+    // an odd pixel count so the SIMD versions also convert a tail with the scalar code
+    const ssize_t pixelCount = kConversionImageSize * kConversionImageSize - 7;
+    std::vector<unsigned char> source(pixelCount * 4);
+    for (auto& byte : source)
+    {
+        byte = (unsigned char)RandomHelper::random_int(0, 255);
+    }
+    std::vector<unsigned char> reference(pixelCount * 4);
+    std::vector<unsigned char> result(pixelCount * 4);
+
+    log("--- %d pixels, best instruction set: %s ---", (int)pixelCount,
+        PixelConversion::getInstructionSetName(PixelConversion::getBestInstructionSet()));
+
+    for (const auto& info : conversions)
+    {
+        const ssize_t dataLen = pixelCount * info.inBytes;
+        const ssize_t outLen = pixelCount * info.outBytes;
+        PixelConversion::setInstructionSet(PixelConversion::InstructionSet::SCALAR);
+        info.conversion(source.data(), dataLen, reference.data());
+
+        for (auto instructionSet : instructionSets)
+        {
+            if (!PixelConversion::setInstructionSet(instructionSet))
+                continue;
+
+            struct timeval now;
+            gettimeofday(&now, nullptr);
+            for (int i = 0; i < kConversionLoops; ++i)
+            {
+                info.conversion(source.data(), dataLen, result.data());
+            }
+            auto dt = calculateDeltaTime(&now);
+
+            bool valid = memcmp(reference.data(), result.data(), outLen) == 0;
+            float speed = dataLen * kConversionLoops / (1024.0f * 1024.0f) / dt;
+            const char* name = PixelConversion::getInstructionSetName(instructionSet);
+            log("%s %s  MB/s:%f %s", info.name, name, speed, valid ? "" : "INVALID RESULT");
+            if (isAutoTesting())
+                Profile::getInstance()->addTestResult(genStrVector(info.name, name, nullptr),
+                                                      genStrVector(genStr("%f", speed).c_str(), valid ? "yes" : "no", nullptr));
+        }
+    }
+
+    PixelConversion::setInstructionSet(PixelConversion::InstructionSet::SCALAR);
+    memcpy(reference.data(), source.data(), source.size());
+    PixelConversion::premultiplyAlpha(reference.data(), pixelCount);
+
+    for (auto instructionSet : instructionSets)
+    {
+        if (!PixelConversion::setInstructionSet(instructionSet))
+            continue;
+
+        struct timeval now;
+        float dt = 0;
+        bool valid = true;
+        for (int i = 0; i < kConversionLoops; ++i)
+        {
+            memcpy(result.data(), source.data(), source.size());
+            gettimeofday(&now, nullptr);
+            PixelConversion::premultiplyAlpha(result.data(), pixelCount);
+            dt += calculateDeltaTime(&now);
+            valid = valid && memcmp(reference.data(), result.data(), result.size()) == 0;
+        }
+
+        float speed = source.size() * kConversionLoops / (1024.0f * 1024.0f) / dt;
+        const char* name = PixelConversion::getInstructionSetName(instructionSet);
+        log("premultiplyAlpha %s  MB/s:%f %s", name, speed, valid ? "" : "INVALID RESULT");
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector("premultiplyAlpha", name, nullptr),
+                                                  genStrVector(genStr("%f", speed).c_str(), valid ? "yes" : "no", nullptr));
+    }
+
+    PixelConversion::setInstructionSet(PixelConversion::getBestInstructionSet());
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+void TextureConversionPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    performTests();
+}
+
+std::string TextureConversionPerformceTest::title() const
+{
+    return "Texture Conversion Performance Test";
+}
+
+std::string TextureConversionPerformceTest::subtitle() const
+{
+    return "Compares the SIMD conversions with the scalar ones. See console";
+}
+
+////////////////////////////////////////////////////////
+//
+// SpriteFrameCacheLoadingPerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kSheetFrameCount = 100000;
+static const int kSheetLoadingLoops = 3;
+static const int kSheetUsedPercent = 20;
+static const char* kSheetTexture = "Images/grossini_dance_atlas.png";
+
+void SpriteFrameCacheLoadingPerformceTest::prepareFiles()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string directory = fileUtils->getWritablePath() + "sprite_sheets/";
+    fileUtils->createDirectory(directory);
+    _plistFile = directory + StringUtils::format("frames_%d.plist", kSheetFrameCount);
+    _binaryFile = directory + StringUtils::format("frames_%d%s", kSheetFrameCount, SpriteSheetBinary::FILE_EXTENSION);
+
+    if (fileUtils->isFileExist(_plistFile) && fileUtils->isFileExist(_binaryFile))
+        return;
+
+    // a format 2 sheet, as written by most packers, with all the frames in the same texture
+    ValueMap frames;
+    frames.reserve(kSheetFrameCount);
+    for (int i = 0; i < kSheetFrameCount; ++i)
+    {
+        int x = (i % 10) * 85;
+        int y = (i / 10 % 10) * 121;
+        ValueMap frame;
+        frame["frame"] = StringUtils::format("{{%d,%d},{85,121}}", x, y);
+        frame["offset"] = "{0,0}";
+        frame["rotated"] = (i % 7) == 0;
+        frame["sourceSize"] = "{85,121}";
+        frames[StringUtils::format("frame_%06d.png", i)] = Value(std::move(frame));
+    }
+    ValueMap metadata;
+    metadata["format"] = 2;
+    ValueMap sheet;
+    sheet["frames"] = Value(std::move(frames));
+    sheet["metadata"] = Value(std::move(metadata));
+
+    fileUtils->writeToFile(sheet, _plistFile);
+
+    Data data;
+    SpriteSheetBinary::createWithDictionary(sheet, &data);
+    fileUtils->writeDataToFile(data, _binaryFile);
+}
+
+void SpriteFrameCacheLoadingPerformceTest::performTests()
+{
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("SpriteFrameCacheLoadingTest",
+                                              genStrVector("Format", "Loop", nullptr),
+                                              genStrVector("Load", "Use", nullptr));
+    }
+
+    prepareFiles();
+
+    auto texture = Director::getInstance()->getTextureCache()->addImage(kSheetTexture);
+    auto cache = SpriteFrameCache::getInstance();
+    bool lazyLoading = cache->isLazyLoadingEnabled();
+    struct Run
+    {
+        const char* format;
+        const std::string* file;
+        bool lazy;
+    };
+    const Run runs[] = {
+        { "plist", &_plistFile, false },
+        { "binary", &_binaryFile, false },
+        { "plist lazy", &_plistFile, true },
+        { "binary lazy", &_binaryFile, true },
+    };
+
+    log("--- %d frames, %d%% of them used ---", kSheetFrameCount, kSheetUsedPercent);
+    for (int loop = 0; loop < kSheetLoadingLoops; ++loop)
+    {
+        for (const auto& run : runs)
+        {
+            cache->setLazyLoadingEnabled(run.lazy);
+
+            struct timeval now;
+            gettimeofday(&now, nullptr);
+            cache->addSpriteFramesWithFile(*run.file, texture);
+            auto loadTime = calculateDeltaTime(&now);
+
+            // a level only uses some of the frames of its sheets
+            gettimeofday(&now, nullptr);
+            bool valid = true;
+            for (int i = 0; i < kSheetFrameCount; i += 100 / kSheetUsedPercent)
+            {
+                valid = cache->getSpriteFrameByName(StringUtils::format("frame_%06d.png", i)) != nullptr && valid;
+            }
+            auto useTime = calculateDeltaTime(&now);
+
+            log("%s loop %d  load ms:%f  use ms:%f %s", run.format, loop, loadTime * 1000, useTime * 1000, valid ? "" : "MISSING FRAMES");
+            if (loop == 0)
+                log("%s", cache->getCachedSpriteFrameInfo().c_str());
+            if (isAutoTesting())
+                Profile::getInstance()->addTestResult(genStrVector(run.format, genStr("%d", loop).c_str(), nullptr),
+                                                      genStrVector(genStr("%fms", loadTime * 1000).c_str(),
+                                                                   genStr("%fms", useTime * 1000).c_str(), nullptr));
+
+            cache->removeSpriteFramesFromFile(*run.file);
+        }
+    }
+    cache->setLazyLoadingEnabled(lazyLoading);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+void SpriteFrameCacheLoadingPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    performTests();
+}
+
+std::string SpriteFrameCacheLoadingPerformceTest::title() const
+{
+    return "SpriteFrameCache Loading Performance Test";
+}
+
+std::string SpriteFrameCacheLoadingPerformceTest::subtitle() const
+{
+    return StringUtils::format("Registers %d frames from a plist and from a binary sheet, eagerly and lazily. See console", kSheetFrameCount);
+}
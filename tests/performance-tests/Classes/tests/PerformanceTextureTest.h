@@ -18,4 +18,58 @@ public:
     virtual void onEnter() override;
 };
 
+class TextureAsyncLoadingPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureAsyncLoadingPerformceTest);
+
+    TextureAsyncLoadingPerformceTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+protected:
+    void prepareFiles();
+    void startRun();
+    void finishRun();
+
+    std::vector<std::string> _files;
+    int _runIndex;
+    int _loadedCount;
+    int _defaultWorkerCount;
+    struct timeval _startTime;
+};
+
+class TextureConversionPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureConversionPerformceTest);
+
+    virtual void performTests();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class SpriteFrameCacheLoadingPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(SpriteFrameCacheLoadingPerformceTest);
+
+    virtual void performTests();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+
+protected:
+    void prepareFiles();
+
+    std::string _plistFile;
+    std::string _binaryFile;
+};
+
 #endif
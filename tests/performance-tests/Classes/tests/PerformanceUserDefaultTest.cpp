@@ -0,0 +1,105 @@
+#include "PerformanceUserDefaultTest.h"
+#include "Profile.h"
+
+USING_NS_CC;
+
+static const int kUserDefaultOperationCount = 10000;
+// a game saving a few counters many times
+static const int kUserDefaultKeyCount = 100;
+static const int kUserDefaultLoops = 3;
+
+PerformceUserDefaultTests::PerformceUserDefaultTests()
+{
+    ADD_TEST_CASE(UserDefaultSetGetPerformceTest);
+}
+
+////////////////////////////////////////////////////////
+//
+// UserDefaultSetGetPerformceTest
+//
+////////////////////////////////////////////////////////
+static float calculateDeltaTime(struct timeval *lastUpdate)
+{
+    struct timeval now;
+
+    gettimeofday(&now, nullptr);
+
+    float dt = (now.tv_sec - lastUpdate->tv_sec) + (now.tv_usec - lastUpdate->tv_usec) / 1000000.0f;
+
+    return dt;
+}
+
+void UserDefaultSetGetPerformceTest::performTests()
+{
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("UserDefaultSetGetTest",
+                                              genStrVector("Loop", nullptr),
+                                              genStrVector("Set", "Get", "Flush", nullptr));
+    }
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < kUserDefaultKeyCount; ++i)
+    {
+        keys.push_back(StringUtils::format("perf_test_key_%d", i));
+    }
+
+    auto userDefault = UserDefault::getInstance();
+    log("--- %d operations on %d keys ---", kUserDefaultOperationCount, kUserDefaultKeyCount);
+    for (int loop = 0; loop < kUserDefaultLoops; ++loop)
+    {
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < kUserDefaultOperationCount; ++i)
+        {
+            userDefault->setIntegerForKey(keys[i % kUserDefaultKeyCount].c_str(), loop * kUserDefaultOperationCount + i);
+        }
+        auto setTime = calculateDeltaTime(&now);
+
+        gettimeofday(&now, nullptr);
+        int sum = 0;
+        for (int i = 0; i < kUserDefaultOperationCount; ++i)
+        {
+            sum += userDefault->getIntegerForKey(keys[i % kUserDefaultKeyCount].c_str());
+        }
+        auto getTime = calculateDeltaTime(&now);
+
+        gettimeofday(&now, nullptr);
+        userDefault->flush();
+        auto flushTime = calculateDeltaTime(&now);
+
+        log("loop %d  set ms:%f  get ms:%f  flush ms:%f  (%d)", loop, setTime * 1000, getTime * 1000, flushTime * 1000, sum);
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector(genStr("%d", loop).c_str(), nullptr),
+                                                  genStrVector(genStr("%fms", setTime * 1000).c_str(),
+                                                               genStr("%fms", getTime * 1000).c_str(),
+                                                               genStr("%fms", flushTime * 1000).c_str(), nullptr));
+    }
+
+    for (const auto& key : keys)
+    {
+        userDefault->deleteValueForKey(key.c_str());
+    }
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+void UserDefaultSetGetPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    performTests();
+}
+
+std::string UserDefaultSetGetPerformceTest::title() const
+{
+    return "UserDefault Set/Get Performance Test";
+}
+
+std::string UserDefaultSetGetPerformceTest::subtitle() const
+{
+    return StringUtils::format("Sets and gets %d integers. See console", kUserDefaultOperationCount);
+}
@@ -0,0 +1,20 @@
+#ifndef __PERFORMANCE_USERDEFAULT_TEST_H__
+#define __PERFORMANCE_USERDEFAULT_TEST_H__
+
+#include "BaseTest.h"
+
+DEFINE_TEST_SUITE(PerformceUserDefaultTests);
+
+class UserDefaultSetGetPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(UserDefaultSetGetPerformceTest);
+
+    virtual void performTests();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+#endif //__PERFORMANCE_USERDEFAULT_TEST_H__
@@ -32,6 +32,10 @@ public:
         addTest("Callback Tests", []() { return new PerformceCallbackTests(); });
         addTest("Math Tests", []() { return new PerformceMathTests(); });
         addTest("Container Tests", []() { return new PerformceContainerTests(); });
+        addTest("Renderer Tests", []() { return new PerformceRendererTests(); });
+        addTest("UserDefault Tests", []() { return new PerformceUserDefaultTests(); });
+        addTest("FileUtils Tests", []() { return new PerformceFileUtilsTests(); });
+        addTest("GLProgram Tests", []() { return new PerformceGLProgramTests(); });
     }
 };
 
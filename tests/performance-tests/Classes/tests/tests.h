@@ -14,5 +14,9 @@
 #include "PerformanceCallbackTest.h"
 #include "PerformanceMathTest.h"
 #include "PerformanceContainerTest.h"
+#include "PerformanceRendererTest.h"
+#include "PerformanceUserDefaultTest.h"
+#include "PerformanceFileUtilsTest.h"
+#include "PerformanceGLProgramTest.h"
 
 #endif
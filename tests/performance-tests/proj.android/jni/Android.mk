@@ -22,6 +22,10 @@ LOCAL_SRC_FILES := hellocpp/main.cpp \
                    ../../Classes/tests/PerformanceLabelTest.cpp \
                    ../../Classes/tests/VisibleRect.cpp \
                    ../../Classes/tests/PerformanceMathTest.cpp \
+                   ../../Classes/tests/PerformanceRendererTest.cpp \
+                   ../../Classes/tests/PerformanceUserDefaultTest.cpp \
+                   ../../Classes/tests/PerformanceFileUtilsTest.cpp \
+                   ../../Classes/tests/PerformanceGLProgramTest.cpp \
                    ../../Classes/tests/controller.cpp \
                    ../../Classes/tests/PerformanceNodeChildrenTest.cpp
 
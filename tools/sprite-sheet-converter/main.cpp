@@ -0,0 +1,112 @@
+/****************************************************************************
+Copyright (c) 2015 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+/* Converts sprite sheet .plist files to binary sprite sheets, see SpriteSheetBinary.
+ *
+ * usage: sprite-sheet-converter input.plist [output.ccsheet]
+ *
+ * Relative paths are relative to the current directory. The output is written next to the input
+ * with the .ccsheet extension when it is omitted.
+ * Binary sprite sheets are stored in the byte order of the machine running the converter,
+ * which is little endian on every platform cocos2d-x supports.
+ */
+
+#include <cstdio>
+#include <string>
+#ifdef _WIN32
+#include <direct.h>
+#define getcwd _getcwd
+#else
+#include <unistd.h>
+#endif
+
+#include "2d/CCSpriteSheetBinary.h"
+#include "platform/CCFileUtils.h"
+
+USING_NS_CC;
+
+// FileUtils resolves relative paths against its search paths (the resource root of the executable),
+// the paths given on the command line are relative to the current directory instead
+static std::string getAbsolutePath(const std::string& path)
+{
+    if (path.empty() || FileUtils::getInstance()->isAbsolutePath(path))
+        return path;
+
+    char cwd[4096];
+    if (!getcwd(cwd, sizeof(cwd)))
+        return path;
+
+    std::string absolutePath = cwd;
+    if (absolutePath.back() != '/' && absolutePath.back() != '\\')
+        absolutePath += '/';
+    if (path.compare(0, 2, "./") == 0 || path.compare(0, 2, ".\\") == 0)
+        return absolutePath + path.substr(2);
+    return absolutePath + path;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: %s input.plist [output%s]\n", argv[0], SpriteSheetBinary::FILE_EXTENSION);
+        return 1;
+    }
+
+    std::string input = getAbsolutePath(argv[1]);
+    std::string output;
+    if (argc == 3)
+    {
+        output = getAbsolutePath(argv[2]);
+    }
+    else
+    {
+        output = input.substr(0, input.find_last_of('.')) + SpriteSheetBinary::FILE_EXTENSION;
+    }
+
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(input))
+    {
+        fprintf(stderr, "can not find %s\n", input.c_str());
+        return 1;
+    }
+
+    ValueMap dictionary = fileUtils->getValueMapFromFile(input);
+    Data data;
+    if (!SpriteSheetBinary::createWithDictionary(dictionary, &data))
+    {
+        fprintf(stderr, "%s is not a sprite sheet\n", input.c_str());
+        return 1;
+    }
+
+    if (!fileUtils->writeDataToFile(data, output))
+    {
+        fprintf(stderr, "can not write %s\n", output.c_str());
+        return 1;
+    }
+
+    SpriteSheetBinary sheet;
+    sheet.initWithData(data.getBytes(), data.getSize());
+    printf("%s: %u frames, %u aliases, %ld bytes\n", output.c_str(), sheet.getFrameCount(), sheet.getAliasCount(), (long)data.getSize());
+    return 0;
+}